@@ -264,7 +264,7 @@ std::vector<PersonAttributes> AgeGenderAnalyzer::analyze(const std::vector<Perso
         return attributes;
     }
 
-    LOG_INFO() << "[AgeGenderAnalyzer] Starting analysis of " << persons.size() << " persons";
+    LOG_DEBUG() << "[AgeGenderAnalyzer] Starting analysis of " << persons.size() << " persons";
 
     auto start_time = std::chrono::high_resolution_clock::now();
 
@@ -292,7 +292,7 @@ std::vector<PersonAttributes> AgeGenderAnalyzer::analyze(const std::vector<Perso
         }
     }
 
-    LOG_INFO() << "[AgeGenderAnalyzer] Processing " << validCrops << " valid crops out of " << persons.size();
+    LOG_DEBUG() << "[AgeGenderAnalyzer] Processing " << validCrops << " valid crops out of " << persons.size();
 
     // Process in batches for efficiency
     attributes = processBatch(crops);
@@ -314,9 +314,9 @@ std::vector<PersonAttributes> AgeGenderAnalyzer::analyze(const std::vector<Perso
         }
     }
 
-    LOG_INFO() << "[AgeGenderAnalyzer] Completed analysis: " << successfulAnalyses
-               << " successful out of " << persons.size() << " persons in "
-               << m_inferenceTime << "ms";
+    LOG_DEBUG() << "[AgeGenderAnalyzer] Completed analysis: " << successfulAnalyses
+                << " successful out of " << persons.size() << " persons in "
+                << m_inferenceTime << "ms";
 
     return attributes;
 }
@@ -498,9 +498,9 @@ std::vector<PersonAttributes> AgeGenderAnalyzer::processBatch(const std::vector<
                 attributes = processInsightFaceResult(0, &multipleFaceData, nullptr, nullptr, nullptr);
 
                 if (attributes.isValid()) {
-                    LOG_INFO() << "[AgeGenderAnalyzer] Crop " << i << " analysis successful: "
-                              << "gender=" << attributes.gender << " (conf: " << attributes.gender_confidence
-                              << "), age=" << attributes.age_group << " (conf: " << attributes.age_confidence << ")";
+                    LOG_DEBUG() << "[AgeGenderAnalyzer] Crop " << i << " analysis successful: "
+                               << "gender=" << attributes.gender << " (conf: " << attributes.gender_confidence
+                               << "), age=" << attributes.age_group << " (conf: " << attributes.age_confidence << ")";
                 } else {
                     LOG_WARN() << "[AgeGenderAnalyzer] Crop " << i << " analysis failed - invalid attributes";
                 }
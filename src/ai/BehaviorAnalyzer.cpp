@@ -435,6 +435,22 @@ std::vector<ROI> BehaviorAnalyzer::getActiveROIs() const {
     return activeROIs;
 }
 
+cv::Rect BehaviorAnalyzer::getActiveROIBounds() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    cv::Rect bounds;
+    for (const auto& pair : m_rois) {
+        const ROI& roi = pair.second;
+        if (!roi.enabled || roi.polygon.empty() || !isROIActiveNow(roi)) {
+            continue;
+        }
+        cv::Rect box = cv::boundingRect(roi.polygon);
+        bounds = bounds.empty() ? box : (bounds | box);
+    }
+
+    return bounds;
+}
+
 void BehaviorAnalyzer::setMinObjectSize(int minWidth, int minHeight) {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_minObjectSize = cv::Size(minWidth, minHeight);
@@ -176,6 +176,7 @@ public:
     bool removeROI(const std::string& roiId);
     std::vector<ROI> getROIs() const;
     std::vector<ROI> getActiveROIs() const;  // Task 73: Get only currently active ROIs
+    cv::Rect getActiveROIBounds() const;     // Bounding box of the active ROI polygons, empty without any
 
     // Configuration
     void setMinObjectSize(int minWidth, int minHeight);
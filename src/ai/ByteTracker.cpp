@@ -8,74 +8,36 @@
 #include "../core/Logger.h"
 using namespace AISecurityVision;
 // Track implementation
-ByteTracker::Track::Track(int id, const cv::Rect& box, float conf, int cls)
+ByteTracker::Track::Track(int id, const cv::Rect& box, float conf, int cls, size_t slot)
     : trackId(id), bbox(box), confidence(conf), classId(cls)
-    , state(TrackState::New), framesSinceUpdate(0), age(0)
+    , state(TrackState::New), framesSinceUpdate(0), age(0), kalmanSlot(slot)
     , velocity(0, 0), hasReIDFeatures(false), lastReIDUpdate(0) {
-
-    // Initialize Kalman filter for this track
-    kalmanFilter.init(8, 4, 0); // 8 state variables, 4 measurements
-
-    // State: [x, y, w, h, vx, vy, vw, vh]
-    kalmanFilter.statePre = cv::Mat::zeros(8, 1, CV_32F);
-    kalmanFilter.statePre.at<float>(0) = box.x + box.width / 2.0f;  // center x
-    kalmanFilter.statePre.at<float>(1) = box.y + box.height / 2.0f; // center y
-    kalmanFilter.statePre.at<float>(2) = box.width;
-    kalmanFilter.statePre.at<float>(3) = box.height;
-
-    // Transition matrix (constant velocity model)
-    kalmanFilter.transitionMatrix = cv::Mat::eye(8, 8, CV_32F);
-    kalmanFilter.transitionMatrix.at<float>(0, 4) = 1; // x += vx
-    kalmanFilter.transitionMatrix.at<float>(1, 5) = 1; // y += vy
-    kalmanFilter.transitionMatrix.at<float>(2, 6) = 1; // w += vw
-    kalmanFilter.transitionMatrix.at<float>(3, 7) = 1; // h += vh
-
-    // Measurement matrix
-    kalmanFilter.measurementMatrix = cv::Mat::zeros(4, 8, CV_32F);
-    kalmanFilter.measurementMatrix.at<float>(0, 0) = 1; // measure x
-    kalmanFilter.measurementMatrix.at<float>(1, 1) = 1; // measure y
-    kalmanFilter.measurementMatrix.at<float>(2, 2) = 1; // measure w
-    kalmanFilter.measurementMatrix.at<float>(3, 3) = 1; // measure h
-
-    // Process noise covariance
-    cv::setIdentity(kalmanFilter.processNoiseCov, cv::Scalar::all(1e-2));
-
-    // Measurement noise covariance
-    cv::setIdentity(kalmanFilter.measurementNoiseCov, cv::Scalar::all(1e-1));
-
-    // Error covariance
-    cv::setIdentity(kalmanFilter.errorCovPost, cv::Scalar::all(1));
 }
 
-void ByteTracker::Track::predict() {
-    cv::Mat prediction = kalmanFilter.predict();
-
+void ByteTracker::Track::applyPrediction(const KalmanBoxBank& kalman) {
     // Update predicted bbox
-    float cx = prediction.at<float>(0);
-    float cy = prediction.at<float>(1);
-    float w = prediction.at<float>(2);
-    float h = prediction.at<float>(3);
+    float cx = kalman.cx(kalmanSlot);
+    float cy = kalman.cy(kalmanSlot);
+    float w = kalman.width(kalmanSlot);
+    float h = kalman.height(kalmanSlot);
 
     bbox = cv::Rect(cx - w/2, cy - h/2, w, h);
 
     // Update velocity
-    velocity.x = prediction.at<float>(4);
-    velocity.y = prediction.at<float>(5);
+    velocity.x = kalman.vx(kalmanSlot);
+    velocity.y = kalman.vy(kalmanSlot);
 
     framesSinceUpdate++;
     age++;
 }
 
-void ByteTracker::Track::update(const cv::Rect& box, float conf) {
-    // Measurement vector
-    cv::Mat measurement = cv::Mat::zeros(4, 1, CV_32F);
-    measurement.at<float>(0) = box.x + box.width / 2.0f;  // center x
-    measurement.at<float>(1) = box.y + box.height / 2.0f; // center y
-    measurement.at<float>(2) = box.width;
-    measurement.at<float>(3) = box.height;
-
-    // Update Kalman filter
-    kalmanFilter.correct(measurement);
+void ByteTracker::Track::update(KalmanBoxBank& kalman, const cv::Rect& box, float conf) {
+    // Update Kalman filter with the box center and size
+    kalman.update(kalmanSlot,
+                  box.x + box.width / 2.0f,
+                  box.y + box.height / 2.0f,
+                  static_cast<float>(box.width),
+                  static_cast<float>(box.height));
 
     // Update track properties
     bbox = box;
@@ -200,11 +162,63 @@ std::vector<int> ByteTracker::updateWithClasses(const std::vector<cv::Rect>& det
     return trackIds;
 }
 
+std::vector<int> ByteTracker::predict() {
+    m_frameCount++;
+
+    // No association: tracks coast on their Kalman state
+    predictTracks();
+
+    updateTrackStates();
+    removeDeadTracks();
+
+    std::vector<int> trackIds;
+    trackIds.reserve(m_activeTracks.size());
+    for (const auto& track : m_activeTracks) {
+        trackIds.push_back(track->trackId);
+    }
+
+    return trackIds;
+}
+
+bool ByteTracker::correctTrack(int trackId, const cv::Rect& box) {
+    auto it = m_tracks.find(trackId);
+    if (it == m_tracks.end()) {
+        return false;
+    }
+
+    // Kalman correction only: confidence, state and framesSinceUpdate stay as they are
+    Track& track = *it->second;
+    m_kalman.update(track.kalmanSlot,
+                    box.x + box.width / 2.0f,
+                    box.y + box.height / 2.0f,
+                    static_cast<float>(box.width),
+                    static_cast<float>(box.height));
+    track.bbox = box;
+    return true;
+}
+
 // Track management methods
 std::vector<std::shared_ptr<ByteTracker::Track>> ByteTracker::getActiveTracks() const {
     return m_activeTracks;
 }
 
+std::vector<int> ByteTracker::getDetectionTrackIds(const std::vector<cv::Rect>& detections) const {
+    // An update copies the detection's box into the track unchanged
+    std::vector<int> trackIds(detections.size(), -1);
+    std::vector<bool> taken(m_activeTracks.size(), false);
+    for (size_t d = 0; d < detections.size(); ++d) {
+        for (size_t t = 0; t < m_activeTracks.size(); ++t) {
+            const auto& track = *m_activeTracks[t];
+            if (!taken[t] && track.framesSinceUpdate == 0 && track.bbox == detections[d]) {
+                trackIds[d] = track.trackId;
+                taken[t] = true;
+                break;
+            }
+        }
+    }
+    return trackIds;
+}
+
 std::shared_ptr<ByteTracker::Track> ByteTracker::getTrack(int trackId) const {
     auto it = m_tracks.find(trackId);
     return (it != m_tracks.end()) ? it->second : nullptr;
@@ -224,6 +238,7 @@ void ByteTracker::removeTrack(int trackId) {
             m_lostTracks.end());
 
         // Remove from main tracks map
+        m_kalman.release(it->second->kalmanSlot);
         m_tracks.erase(it);
     }
 }
@@ -232,6 +247,7 @@ void ByteTracker::clearTracks() {
     m_tracks.clear();
     m_activeTracks.clear();
     m_lostTracks.clear();
+    m_kalman.clear();
     m_nextTrackId = 1;
     m_frameCount = 0;
 }
@@ -292,16 +308,26 @@ float ByteTracker::getAverageTrackLength() const {
 }
 
 // Internal methods
-std::vector<std::vector<float>> ByteTracker::computeIoUMatrix(
+AssignmentMatrix ByteTracker::computeIoUMatrix(
     const std::vector<cv::Rect>& detections,
     const std::vector<std::shared_ptr<Track>>& tracks) {
 
-    std::vector<std::vector<float>> iouMatrix(detections.size(),
-                                             std::vector<float>(tracks.size(), 0.0f));
+    AssignmentMatrix iouMatrix(static_cast<int>(detections.size()), static_cast<int>(tracks.size()));
+    if (iouMatrix.empty()) {
+        return iouMatrix;
+    }
 
-    for (size_t i = 0; i < detections.size(); ++i) {
-        for (size_t j = 0; j < tracks.size(); ++j) {
-            iouMatrix[i][j] = computeIoU(detections[i], tracks[j]->getPredictedBbox());
+    // Predicted boxes are fetched once instead of once per detection
+    std::vector<cv::Rect> trackBoxes;
+    trackBoxes.reserve(tracks.size());
+    for (const auto& track : tracks) {
+        trackBoxes.push_back(track->getPredictedBbox());
+    }
+
+    for (int i = 0; i < iouMatrix.rows; ++i) {
+        float* row = iouMatrix.row(i);
+        for (int j = 0; j < iouMatrix.cols; ++j) {
+            row[j] = computeIoU(detections[i], trackBoxes[j]);
         }
     }
 
@@ -309,54 +335,33 @@ std::vector<std::vector<float>> ByteTracker::computeIoUMatrix(
 }
 
 std::vector<std::pair<int, int>> ByteTracker::hungarianAssignment(
-    const std::vector<std::vector<float>>& costMatrix) {
-
-    // Simplified Hungarian algorithm implementation
-    // In a full implementation, this would use the Hungarian algorithm
-    // For now, use a greedy approach
-
-    std::vector<std::pair<int, int>> assignments;
-    std::vector<bool> detectionUsed(costMatrix.size(), false);
-    std::vector<bool> trackUsed(costMatrix.empty() ? 0 : costMatrix[0].size(), false);
-
-    // Find best matches greedily
-    for (int iter = 0; iter < static_cast<int>(costMatrix.size()); ++iter) {
-        float bestScore = 0.0f;
-        int bestDet = -1, bestTrack = -1;
-
-        for (size_t i = 0; i < costMatrix.size(); ++i) {
-            if (detectionUsed[i]) continue;
-
-            for (size_t j = 0; j < costMatrix[i].size(); ++j) {
-                if (trackUsed[j]) continue;
+    const AssignmentMatrix& similarityMatrix) {
 
-                if (costMatrix[i][j] > bestScore && costMatrix[i][j] > m_matchThreshold) {
-                    bestScore = costMatrix[i][j];
-                    bestDet = i;
-                    bestTrack = j;
-                }
-            }
-        }
+    if (similarityMatrix.empty()) {
+        return {};
+    }
 
-        if (bestDet >= 0 && bestTrack >= 0) {
-            assignments.push_back({bestDet, bestTrack});
-            detectionUsed[bestDet] = true;
-            trackUsed[bestTrack] = true;
-        } else {
-            break;
-        }
+    // Convert similarities to costs; pairs not above the match threshold are
+    // gated out so the solver never considers them
+    AssignmentMatrix costMatrix(similarityMatrix.rows, similarityMatrix.cols);
+    for (size_t k = 0; k < similarityMatrix.values.size(); ++k) {
+        float similarity = similarityMatrix.values[k];
+        costMatrix.values[k] = similarity > m_matchThreshold ? 1.0f - similarity : ASSIGNMENT_INFEASIBLE;
     }
 
-    return assignments;
+    return solveLinearAssignment(costMatrix, 1.0f - m_matchThreshold);
 }
 
 void ByteTracker::predictTracks() {
+    // Advance every filter in one pass, then refresh the tracks' boxes
+    m_kalman.predictAll();
+
     for (auto& track : m_activeTracks) {
-        track->predict();
+        track->applyPrediction(m_kalman);
     }
 
     for (auto& track : m_lostTracks) {
-        track->predict();
+        track->applyPrediction(m_kalman);
     }
 }
 
@@ -396,7 +401,7 @@ void ByteTracker::associateDetections(const std::vector<cv::Rect>& detections,
         int detIdx = assignment.first;
         int trackIdx = assignment.second;
 
-        m_activeTracks[trackIdx]->update(highDetections[detIdx], highConfidences[detIdx]);
+        m_activeTracks[trackIdx]->update(m_kalman, highDetections[detIdx], highConfidences[detIdx]);
         detectionMatched[detIdx] = true;
         trackMatched[trackIdx] = true;
     }
@@ -437,10 +442,7 @@ void ByteTracker::initNewTracks(const std::vector<cv::Rect>& unmatched_detection
                                const std::vector<int>& classIds) {
 
     for (size_t i = 0; i < unmatched_detections.size(); ++i) {
-        auto newTrack = std::make_shared<Track>(m_nextTrackId++,
-                                               unmatched_detections[i],
-                                               confidences[i],
-                                               classIds[i]);
+        auto newTrack = createTrack(unmatched_detections[i], confidences[i], classIds[i]);
 
         m_tracks[newTrack->trackId] = newTrack;
         m_activeTracks.push_back(newTrack);
@@ -468,6 +470,7 @@ void ByteTracker::removeDeadTracks() {
                 }
 
                 // Remove from main tracks map
+                m_kalman.release(track->kalmanSlot);
                 m_tracks.erase(track->trackId);
                 return true;
             }
@@ -488,33 +491,12 @@ float ByteTracker::computeIoU(const cv::Rect& box1, const cv::Rect& box2) const
     return intersectionArea / unionArea;
 }
 
-cv::KalmanFilter ByteTracker::createKalmanFilter(const cv::Rect& bbox) const {
-    cv::KalmanFilter kf(8, 4, 0);
-
-    // Initialize state with bbox center and size
-    kf.statePre.at<float>(0) = bbox.x + bbox.width / 2.0f;
-    kf.statePre.at<float>(1) = bbox.y + bbox.height / 2.0f;
-    kf.statePre.at<float>(2) = bbox.width;
-    kf.statePre.at<float>(3) = bbox.height;
-
-    // Set up matrices (same as in Track constructor)
-    kf.transitionMatrix = cv::Mat::eye(8, 8, CV_32F);
-    kf.transitionMatrix.at<float>(0, 4) = 1;
-    kf.transitionMatrix.at<float>(1, 5) = 1;
-    kf.transitionMatrix.at<float>(2, 6) = 1;
-    kf.transitionMatrix.at<float>(3, 7) = 1;
-
-    kf.measurementMatrix = cv::Mat::zeros(4, 8, CV_32F);
-    kf.measurementMatrix.at<float>(0, 0) = 1;
-    kf.measurementMatrix.at<float>(1, 1) = 1;
-    kf.measurementMatrix.at<float>(2, 2) = 1;
-    kf.measurementMatrix.at<float>(3, 3) = 1;
-
-    cv::setIdentity(kf.processNoiseCov, cv::Scalar::all(1e-2));
-    cv::setIdentity(kf.measurementNoiseCov, cv::Scalar::all(1e-1));
-    cv::setIdentity(kf.errorCovPost, cv::Scalar::all(1));
-
-    return kf;
+std::shared_ptr<ByteTracker::Track> ByteTracker::createTrack(const cv::Rect& box, float conf, int classId) {
+    size_t slot = m_kalman.acquire(box.x + box.width / 2.0f,
+                                   box.y + box.height / 2.0f,
+                                   static_cast<float>(box.width),
+                                   static_cast<float>(box.height));
+    return std::make_shared<Track>(m_nextTrackId++, box, conf, classId, slot);
 }
 
 // ReID-enhanced tracking methods
@@ -592,7 +574,7 @@ void ByteTracker::associateDetectionsWithReID(const std::vector<cv::Rect>& detec
         int detIdx = assignment.first;
         int trackIdx = assignment.second;
 
-        m_activeTracks[trackIdx]->update(highDetections[detIdx], highConfidences[detIdx]);
+        m_activeTracks[trackIdx]->update(m_kalman, highDetections[detIdx], highConfidences[detIdx]);
 
         // Update ReID features if available
         if (detIdx < static_cast<int>(highReIDFeatures.size())) {
@@ -644,10 +626,7 @@ void ByteTracker::initNewTracksWithReID(const std::vector<cv::Rect>& unmatched_d
                                        const std::vector<std::vector<float>>& reidFeatures) {
 
     for (size_t i = 0; i < unmatched_detections.size(); ++i) {
-        auto newTrack = std::make_shared<Track>(m_nextTrackId++,
-                                               unmatched_detections[i],
-                                               confidences[i],
-                                               classIds[i]);
+        auto newTrack = createTrack(unmatched_detections[i], confidences[i], classIds[i]);
 
         // Add ReID features if available
         if (i < reidFeatures.size() && !reidFeatures[i].empty()) {
@@ -661,17 +640,20 @@ void ByteTracker::initNewTracksWithReID(const std::vector<cv::Rect>& unmatched_d
 }
 
 // ReID utility methods
-std::vector<std::vector<float>> ByteTracker::computeReIDSimilarityMatrix(
+AssignmentMatrix ByteTracker::computeReIDSimilarityMatrix(
     const std::vector<std::vector<float>>& detectionFeatures,
     const std::vector<std::shared_ptr<Track>>& tracks) {
 
-    std::vector<std::vector<float>> similarityMatrix(detectionFeatures.size(),
-                                                    std::vector<float>(tracks.size(), 0.0f));
+    AssignmentMatrix similarityMatrix(static_cast<int>(detectionFeatures.size()), static_cast<int>(tracks.size()));
 
-    for (size_t i = 0; i < detectionFeatures.size(); ++i) {
-        for (size_t j = 0; j < tracks.size(); ++j) {
-            if (!detectionFeatures[i].empty() && tracks[j]->hasValidReIDFeatures()) {
-                similarityMatrix[i][j] = computeReIDSimilarity(detectionFeatures[i], tracks[j]->reidFeatures);
+    for (int i = 0; i < similarityMatrix.rows; ++i) {
+        if (detectionFeatures[i].empty()) {
+            continue;
+        }
+        float* row = similarityMatrix.row(i);
+        for (int j = 0; j < similarityMatrix.cols; ++j) {
+            if (tracks[j]->hasValidReIDFeatures()) {
+                row[j] = computeReIDSimilarity(detectionFeatures[i], tracks[j]->reidFeatures);
             }
         }
     }
@@ -679,24 +661,19 @@ std::vector<std::vector<float>> ByteTracker::computeReIDSimilarityMatrix(
     return similarityMatrix;
 }
 
-std::vector<std::vector<float>> ByteTracker::computeCombinedCostMatrix(
-    const std::vector<std::vector<float>>& iouMatrix,
-    const std::vector<std::vector<float>>& reidMatrix) {
+AssignmentMatrix ByteTracker::computeCombinedCostMatrix(
+    const AssignmentMatrix& iouMatrix,
+    const AssignmentMatrix& reidMatrix) {
 
-    if (iouMatrix.size() != reidMatrix.size() ||
-        (iouMatrix.size() > 0 && iouMatrix[0].size() != reidMatrix[0].size())) {
+    if (iouMatrix.rows != reidMatrix.rows || iouMatrix.cols != reidMatrix.cols) {
         return iouMatrix; // Fallback to IoU only
     }
 
-    std::vector<std::vector<float>> combinedMatrix(iouMatrix.size(),
-                                                  std::vector<float>(iouMatrix.empty() ? 0 : iouMatrix[0].size(), 0.0f));
-
-    for (size_t i = 0; i < iouMatrix.size(); ++i) {
-        for (size_t j = 0; j < iouMatrix[i].size(); ++j) {
-            // Combine IoU and ReID similarity with weights
-            float iouWeight = 1.0f - m_reidWeight;
-            combinedMatrix[i][j] = iouWeight * iouMatrix[i][j] + m_reidWeight * reidMatrix[i][j];
-        }
+    // Combine IoU and ReID similarity with weights
+    AssignmentMatrix combinedMatrix(iouMatrix.rows, iouMatrix.cols);
+    const float iouWeight = 1.0f - m_reidWeight;
+    for (size_t k = 0; k < iouMatrix.values.size(); ++k) {
+        combinedMatrix.values[k] = iouWeight * iouMatrix.values[k] + m_reidWeight * reidMatrix.values[k];
     }
 
     return combinedMatrix;
@@ -4,6 +4,8 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include "LinearAssignment.h"
+#include "KalmanBoxBank.h"
 
 // Forward declaration for ReID features
 class ReIDExtractor;
@@ -13,11 +15,12 @@ struct ReIDEmbedding;
  * @brief ByteTracker implementation for multi-object tracking
  *
  * This class implements the ByteTracker algorithm for robust multi-object tracking.
- * It uses Kalman filters for motion prediction and Hungarian algorithm for data association.
+ * It uses fixed-size Kalman filters for motion prediction and an optimal linear assignment
+ * (Jonker-Volgenant) over gated, contiguous score matrices for data association.
  *
  * Features:
  * - High-performance tracking with Kalman filters
- * - Robust data association using Hungarian algorithm
+ * - Optimal data association using Jonker-Volgenant linear assignment
  * - Track lifecycle management (birth, active, lost, deleted)
  * - Support for different object classes
  * - Configurable tracking parameters
@@ -42,16 +45,16 @@ public:
         TrackState state;
         int framesSinceUpdate;
         int age;
-        cv::KalmanFilter kalmanFilter;
+        size_t kalmanSlot;      // Motion state slot in the tracker's KalmanBoxBank
 
         // ReID features for cross-camera tracking
         std::vector<float> reidFeatures;
         bool hasReIDFeatures;
         int64_t lastReIDUpdate;
 
-        Track(int id, const cv::Rect& box, float conf, int cls);
-        void predict();
-        void update(const cv::Rect& box, float conf);
+        Track(int id, const cv::Rect& box, float conf, int cls, size_t slot);
+        void applyPrediction(const AISecurityVision::KalmanBoxBank& kalman);
+        void update(AISecurityVision::KalmanBoxBank& kalman, const cv::Rect& box, float conf);
         void updateReIDFeatures(const std::vector<float>& features);
         cv::Rect getPredictedBbox() const;
         bool hasValidReIDFeatures() const;
@@ -79,9 +82,21 @@ public:
                                            const std::vector<int>& classIds,
                                            const std::vector<std::vector<float>>& reidFeatures);
 
+    // Advance all tracks by their motion model without detections (frames
+    // whose detection was skipped); active tracks stay active
+    std::vector<int> predict();
+
+    // Correct a propagated track with an external measurement (e.g. optical
+    // flow) without counting it as a detection
+    bool correctTrack(int trackId, const cv::Rect& box);
+
     // Track management
     std::vector<std::shared_ptr<Track>> getActiveTracks() const;
     std::shared_ptr<Track> getTrack(int trackId) const;
+
+    // Track ID per detection of the last update (the active track that
+    // detection updated), -1 for detections that did not update a track
+    std::vector<int> getDetectionTrackIds(const std::vector<cv::Rect>& detections) const;
     void removeTrack(int trackId);
     void clearTracks();
 
@@ -122,17 +137,20 @@ private:
     int m_nextTrackId;
     int m_frameCount;
 
+    // Kalman state of all tracks, struct-of-arrays so prediction is one pass
+    AISecurityVision::KalmanBoxBank m_kalman;
+
     // Statistics
     size_t m_totalTracks;
     std::vector<int> m_trackLengths;
 
-    // Internal methods
-    std::vector<std::vector<float>> computeIoUMatrix(
+    // Internal methods (detections are rows, tracks are columns)
+    AISecurityVision::AssignmentMatrix computeIoUMatrix(
         const std::vector<cv::Rect>& detections,
         const std::vector<std::shared_ptr<Track>>& tracks);
 
     std::vector<std::pair<int, int>> hungarianAssignment(
-        const std::vector<std::vector<float>>& costMatrix);
+        const AISecurityVision::AssignmentMatrix& similarityMatrix);
 
     void predictTracks();
     void associateDetections(const std::vector<cv::Rect>& detections,
@@ -157,16 +175,16 @@ private:
     void removeDeadTracks();
 
     float computeIoU(const cv::Rect& box1, const cv::Rect& box2) const;
-    cv::KalmanFilter createKalmanFilter(const cv::Rect& bbox) const;
+    std::shared_ptr<Track> createTrack(const cv::Rect& box, float conf, int classId);
 
     // ReID utility methods
-    std::vector<std::vector<float>> computeReIDSimilarityMatrix(
+    AISecurityVision::AssignmentMatrix computeReIDSimilarityMatrix(
         const std::vector<std::vector<float>>& detectionFeatures,
         const std::vector<std::shared_ptr<Track>>& tracks);
 
-    std::vector<std::vector<float>> computeCombinedCostMatrix(
-        const std::vector<std::vector<float>>& iouMatrix,
-        const std::vector<std::vector<float>>& reidMatrix);
+    AISecurityVision::AssignmentMatrix computeCombinedCostMatrix(
+        const AISecurityVision::AssignmentMatrix& iouMatrix,
+        const AISecurityVision::AssignmentMatrix& reidMatrix);
 
     float computeReIDSimilarity(const std::vector<float>& features1,
                                const std::vector<float>& features2) const;
@@ -0,0 +1,273 @@
+/**
+ * @file InferenceScheduler.cpp
+ * @brief Cross-camera batched inference scheduler implementation
+ */
+
+#include "InferenceScheduler.h"
+#include "../core/Logger.h"
+#include <algorithm>
+
+#ifdef HAVE_TENSORRT
+#include "YOLOv8TensorRTDetector.h"
+#endif
+
+namespace AISecurityVision {
+
+namespace {
+
+constexpr double STATS_EMA_ALPHA = 0.1;
+
+double updateAverage(double average, double sample) {
+    return average == 0.0 ? sample : STATS_EMA_ALPHA * sample + (1.0 - STATS_EMA_ALPHA) * average;
+}
+
+} // namespace
+
+InferenceScheduler::InferenceScheduler() = default;
+
+InferenceScheduler::~InferenceScheduler() {
+    shutdown();
+}
+
+const std::vector<double>& InferenceScheduler::getQueueWaitBucketsMs() {
+    static const std::vector<double> buckets = {1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0};
+    return buckets;
+}
+
+bool InferenceScheduler::initialize(std::unique_ptr<YOLOv8Detector> detector,
+                                    const std::string& modelPath,
+                                    const InferenceSchedulerConfig& config) {
+    if (m_running.load()) {
+        LOG_WARN() << "[InferenceScheduler] Already running";
+        return true;
+    }
+
+    if (!detector) {
+        LOG_ERROR() << "[InferenceScheduler] No detector provided";
+        return false;
+    }
+
+    m_config = config;
+    m_config.maxBatchSize = std::max(1, m_config.maxBatchSize);
+    m_config.maxWaitMs = std::max(0, m_config.maxWaitMs);
+    m_config.maxQueueSize = std::max<size_t>(m_config.maxQueueSize, m_config.maxBatchSize);
+
+#ifdef HAVE_TENSORRT
+    // Size the engine's optimization profile for the batches we are going to send
+    if (detector->getCurrentBackend() == InferenceBackend::TENSORRT) {
+        auto* trtDetector = static_cast<YOLOv8TensorRTDetector*>(detector.get());
+        trtDetector->setMaxBatchSize(m_config.maxBatchSize);
+    }
+#endif
+
+    if (!detector->initialize(modelPath)) {
+        LOG_ERROR() << "[InferenceScheduler] Failed to initialize detector with model: " << modelPath;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_detectorMutex);
+        m_detector = std::move(detector);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_batchFillHistogram.assign(m_config.maxBatchSize + 1, 0);
+        m_queueWaitHistogram.assign(getQueueWaitBucketsMs().size() + 1, 0);
+    }
+
+    m_running.store(true);
+    m_thread = std::thread(&InferenceScheduler::schedulerThread, this);
+
+    LOG_INFO() << "[InferenceScheduler] Started with " << m_detector->getBackendName()
+               << " (max batch " << m_config.maxBatchSize
+               << ", native batch " << m_detector->getMaxBatchSize()
+               << ", max wait " << m_config.maxWaitMs << "ms)";
+    return true;
+}
+
+void InferenceScheduler::shutdown() {
+    {
+        // Under the queue lock so the scheduler thread cannot test its wait
+        // predicate between the store and the notification and sleep forever
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (!m_running.exchange(false)) {
+            return;
+        }
+    }
+
+    m_queueCondition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    // Release anyone still waiting on a result
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    for (auto& request : m_queue) {
+        request.promise.set_value({});
+    }
+    m_queue.clear();
+
+    LOG_INFO() << "[InferenceScheduler] Stopped";
+}
+
+std::future<std::vector<Detection>> InferenceScheduler::submit(const std::string& sourceId, const cv::Mat& frame) {
+    return submit(sourceId, frame, LetterboxInfo(), cv::Size());
+}
+
+std::future<std::vector<Detection>> InferenceScheduler::submit(const std::string& sourceId, const cv::Mat& frame,
+                                                               const LetterboxInfo& letterbox, const cv::Size& sourceSize) {
+    Request request;
+    request.sourceId = sourceId;
+    request.frame = frame;
+    request.letterbox = letterbox;
+    request.sourceSize = sourceSize;
+    request.enqueuedAt = std::chrono::steady_clock::now();
+    auto future = request.promise.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (!m_running.load() || frame.empty() || m_queue.size() >= m_config.maxQueueSize) {
+            m_rejected.fetch_add(1);
+            request.promise.set_value({});
+            return future;
+        }
+        m_queue.push_back(std::move(request));
+    }
+
+    m_queueCondition.notify_one();
+    return future;
+}
+
+void InferenceScheduler::schedulerThread() {
+    LOG_INFO() << "[InferenceScheduler] Scheduler thread started";
+
+    const size_t maxBatch = static_cast<size_t>(m_config.maxBatchSize);
+    const auto maxWait = std::chrono::milliseconds(m_config.maxWaitMs);
+    std::vector<Request> batch;
+    batch.reserve(maxBatch);
+
+    while (m_running.load()) {
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+
+            // Wait for the first request
+            m_queueCondition.wait(lock, [this] { return !m_queue.empty() || !m_running.load(); });
+            if (!m_running.load()) {
+                break;
+            }
+
+            // Let the batch fill until it is full or the oldest request hits its deadline
+            auto deadline = m_queue.front().enqueuedAt + maxWait;
+            m_queueCondition.wait_until(lock, deadline, [this, maxBatch] {
+                return m_queue.size() >= maxBatch || !m_running.load();
+            });
+
+            size_t count = std::min(maxBatch, m_queue.size());
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(std::move(m_queue.front()));
+                m_queue.pop_front();
+            }
+        }
+
+        if (!batch.empty()) {
+            runBatch(batch);
+            batch.clear();
+        }
+    }
+
+    LOG_INFO() << "[InferenceScheduler] Scheduler thread stopped";
+}
+
+void InferenceScheduler::runBatch(std::vector<Request>& batch) {
+    auto batchStart = std::chrono::steady_clock::now();
+
+    std::vector<cv::Mat> frames;
+    frames.reserve(batch.size());
+    for (const auto& request : batch) {
+        frames.push_back(request.frame);
+    }
+
+    std::vector<std::vector<Detection>> results;
+    try {
+        std::lock_guard<std::mutex> lock(m_detectorMutex);
+        results = m_detector->detectObjectsBatch(frames);
+    } catch (const std::exception& e) {
+        LOG_ERROR() << "[InferenceScheduler] Batch inference failed: " << e.what();
+    }
+    results.resize(batch.size());
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (!batch[i].sourceSize.empty()) {
+            YOLOv8Detector::mapFromLetterbox(results[i], batch[i].letterbox, batch[i].sourceSize);
+        }
+    }
+
+    auto batchEnd = std::chrono::steady_clock::now();
+    double batchMs = std::chrono::duration<double, std::milli>(batchEnd - batchStart).count();
+
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        const auto& buckets = getQueueWaitBucketsMs();
+
+        m_batches++;
+        m_frames += batch.size();
+        m_batchFillHistogram[std::min(batch.size(), m_batchFillHistogram.size() - 1)]++;
+        m_avgBatchLatencyMs = updateAverage(m_avgBatchLatencyMs, batchMs);
+
+        for (const auto& request : batch) {
+            double waitMs = std::chrono::duration<double, std::milli>(batchStart - request.enqueuedAt).count();
+            size_t bucket = std::lower_bound(buckets.begin(), buckets.end(), waitMs) - buckets.begin();
+            m_queueWaitHistogram[bucket]++;
+            m_avgQueueWaitMs = updateAverage(m_avgQueueWaitMs, waitMs);
+        }
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        batch[i].promise.set_value(std::move(results[i]));
+    }
+}
+
+void InferenceScheduler::setDetectionThresholds(float confidenceThreshold, float nmsThreshold) {
+    std::lock_guard<std::mutex> lock(m_detectorMutex);
+    if (m_detector) {
+        m_detector->setConfidenceThreshold(confidenceThreshold);
+        m_detector->setNMSThreshold(nmsThreshold);
+    }
+}
+
+std::vector<std::string> InferenceScheduler::getAvailableCategories() const {
+    std::lock_guard<std::mutex> lock(m_detectorMutex);
+    return m_detector ? m_detector->getAvailableCategories() : std::vector<std::string>{};
+}
+
+std::string InferenceScheduler::getBackendName() const {
+    std::lock_guard<std::mutex> lock(m_detectorMutex);
+    return m_detector ? m_detector->getBackendName() : std::string();
+}
+
+cv::Size InferenceScheduler::getInputSize() const {
+    std::lock_guard<std::mutex> lock(m_detectorMutex);
+    return m_detector ? m_detector->getInputSize() : cv::Size();
+}
+
+InferenceScheduler::Stats InferenceScheduler::getStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        stats.batches = m_batches;
+        stats.frames = m_frames;
+        stats.avgBatchLatencyMs = m_avgBatchLatencyMs;
+        stats.avgQueueWaitMs = m_avgQueueWaitMs;
+        stats.batchFillHistogram = m_batchFillHistogram;
+        stats.queueWaitHistogram = m_queueWaitHistogram;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        stats.queueDepth = m_queue.size();
+    }
+    stats.rejected = m_rejected.load();
+    return stats;
+}
+
+} // namespace AISecurityVision
@@ -0,0 +1,147 @@
+/**
+ * @file InferenceScheduler.h
+ * @brief Cross-camera batched inference scheduler
+ *
+ * A single shared YOLOv8 detector serves every VideoPipeline. Frames submitted
+ * by the pipelines are collected into dynamically sized batches: a batch is
+ * dispatched as soon as it is full or when the oldest queued frame has waited
+ * for the configured deadline, whichever comes first. Each pipeline receives
+ * its own detections through a future.
+ */
+
+#ifndef YOLOV8_INFERENCE_SCHEDULER_H
+#define YOLOV8_INFERENCE_SCHEDULER_H
+
+#include "YOLOv8Detector.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Batching configuration for InferenceScheduler
+ */
+struct InferenceSchedulerConfig {
+    int maxBatchSize = 4;        // Frames per batch (also fed to setMaxBatchSize on TensorRT)
+    int maxWaitMs = 8;           // Max time the oldest queued frame waits for a batch to fill
+    size_t maxQueueSize = 64;    // Requests beyond this are rejected with an empty result
+};
+
+/**
+ * @brief Shared inference service batching frames from all pipelines
+ */
+class InferenceScheduler {
+public:
+    /**
+     * @brief Scheduler statistics snapshot
+     */
+    struct Stats {
+        uint64_t batches = 0;
+        uint64_t frames = 0;
+        uint64_t rejected = 0;
+        size_t queueDepth = 0;
+        double avgBatchLatencyMs = 0.0;
+        double avgQueueWaitMs = 0.0;
+        std::vector<uint64_t> batchFillHistogram;   // [n] = number of batches holding n frames
+        std::vector<uint64_t> queueWaitHistogram;   // Bucketed by getQueueWaitBucketsMs()
+    };
+
+    InferenceScheduler();
+    ~InferenceScheduler();
+
+    InferenceScheduler(const InferenceScheduler&) = delete;
+    InferenceScheduler& operator=(const InferenceScheduler&) = delete;
+
+    /**
+     * @brief Take ownership of a detector, initialize it and start the scheduler thread
+     * @param detector Uninitialized detector instance
+     * @param modelPath Model file passed to detector->initialize()
+     * @param config Batching configuration
+     * @return true if the detector initialized and the scheduler is running
+     */
+    bool initialize(std::unique_ptr<YOLOv8Detector> detector,
+                    const std::string& modelPath,
+                    const InferenceSchedulerConfig& config);
+
+    /**
+     * @brief Stop the scheduler; pending requests complete with empty results
+     */
+    void shutdown();
+
+    bool isRunning() const { return m_running.load(); }
+
+    /**
+     * @brief Queue a frame for detection
+     * @param sourceId Submitting pipeline, for logging
+     * @param frame Input image (shared, not copied)
+     * @return Future resolving to the frame's detections (all categories)
+     */
+    std::future<std::vector<Detection>> submit(const std::string& sourceId, const cv::Mat& frame);
+
+    /**
+     * @brief Queue a frame already letterboxed to getInputSize()
+     * @param letterbox Mapping from the letterboxed frame to the source frame
+     * @param sourceSize Source frame size; detections are returned in source coordinates
+     */
+    std::future<std::vector<Detection>> submit(const std::string& sourceId, const cv::Mat& letterboxed,
+                                               const LetterboxInfo& letterbox, const cv::Size& sourceSize);
+
+    // Detector configuration, applied between batches
+    void setDetectionThresholds(float confidenceThreshold, float nmsThreshold);
+    std::vector<std::string> getAvailableCategories() const;
+    std::string getBackendName() const;
+    cv::Size getInputSize() const;
+
+    const InferenceSchedulerConfig& getConfig() const { return m_config; }
+    Stats getStats() const;
+
+    /**
+     * @brief Upper bounds (ms) of the queue-wait histogram buckets; the last bucket is open-ended
+     */
+    static const std::vector<double>& getQueueWaitBucketsMs();
+
+private:
+    struct Request {
+        std::string sourceId;
+        cv::Mat frame;
+        LetterboxInfo letterbox;
+        cv::Size sourceSize;    // Set when frame is letterboxed
+        std::promise<std::vector<Detection>> promise;
+        std::chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    void schedulerThread();
+    void runBatch(std::vector<Request>& batch);
+
+    std::unique_ptr<YOLOv8Detector> m_detector;
+    mutable std::mutex m_detectorMutex;
+    InferenceSchedulerConfig m_config;
+
+    std::deque<Request> m_queue;
+    mutable std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+
+    // Statistics
+    mutable std::mutex m_statsMutex;
+    uint64_t m_batches = 0;
+    uint64_t m_frames = 0;
+    double m_avgBatchLatencyMs = 0.0;
+    double m_avgQueueWaitMs = 0.0;
+    std::vector<uint64_t> m_batchFillHistogram;
+    std::vector<uint64_t> m_queueWaitHistogram;
+    std::atomic<uint64_t> m_rejected{0};
+};
+
+} // namespace AISecurityVision
+
+#endif // YOLOV8_INFERENCE_SCHEDULER_H
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Fixed-size constant-velocity Kalman kernel for bounding boxes
+ *
+ * State is [cx, cy, w, h, vcx, vcy, vw, vh] with measurement [cx, cy, w, h].
+ * With F = [I I; 0 I], H = [I 0], Q = q*I, R = r*I and an initial P = p0*I,
+ * every coordinate evolves independently and all four share the same 2x2
+ * (position, velocity) covariance. The 8x8 covariance is therefore carried
+ * exactly as three floats, and predict/update reduce to a handful of
+ * straight-line flops that need no matrix code or allocation. Prediction is
+ * done for all tracks at once by KalmanBoxBank::predictAll().
+ */
+struct KalmanBoxKernel {
+    static constexpr int STATE_DIM = 8;
+    static constexpr int MEASURE_DIM = 4;
+
+    struct Covariance {
+        float pp;   // position variance
+        float pv;   // position/velocity covariance
+        float vv;   // velocity variance
+    };
+
+    static constexpr Covariance initialCovariance(float p0) {
+        return {p0, 0.0f, p0};
+    }
+
+    // K = P H^T (H P H^T + R)^-1 ; x' = x + K (z - H x) ; P' = (I - K H) P
+    static constexpr void update(float* position, float* velocity, Covariance& p,
+                                 const float* measurement, float r) {
+        const float s = p.pp + r;
+        const float kp = p.pp / s;
+        const float kv = p.pv / s;
+        for (int k = 0; k < MEASURE_DIM; ++k) {
+            const float innovation = measurement[k] - position[k];
+            position[k] += kp * innovation;
+            velocity[k] += kv * innovation;
+        }
+        p = {(1.0f - kp) * p.pp, (1.0f - kp) * p.pv, p.vv - kv * p.pv};
+    }
+};
+
+/**
+ * @brief Struct-of-arrays store of Kalman box filters for all tracks of a tracker
+ *
+ * Each track owns a slot. predictAll() advances every slot in one pass over
+ * contiguous arrays, which the compiler vectorizes.
+ */
+class KalmanBoxBank {
+public:
+    explicit KalmanBoxBank(float processNoise = 1e-2f, float measurementNoise = 1e-1f,
+                           float initialVariance = 1.0f)
+        : m_q(processNoise), m_r(measurementNoise), m_p0(initialVariance) {}
+
+    KalmanBoxBank(const KalmanBoxBank&) = delete;
+    KalmanBoxBank& operator=(const KalmanBoxBank&) = delete;
+
+    /**
+     * @brief Start a filter at a measured box (center x/y, width, height) with zero velocity
+     * @return Slot index owned by the caller until release()
+     */
+    size_t acquire(float cx, float cy, float w, float h) {
+        size_t slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            slot = m_pp.size();
+            for (auto* component : m_state) {
+                component->push_back(0.0f);
+            }
+            m_pp.push_back(0.0f);
+            m_pv.push_back(0.0f);
+            m_vv.push_back(0.0f);
+        }
+
+        const float measurement[KalmanBoxKernel::MEASURE_DIM] = {cx, cy, w, h};
+        for (int k = 0; k < KalmanBoxKernel::MEASURE_DIM; ++k) {
+            (*m_state[k])[slot] = measurement[k];
+            (*m_state[k + KalmanBoxKernel::MEASURE_DIM])[slot] = 0.0f;
+        }
+        auto p = KalmanBoxKernel::initialCovariance(m_p0);
+        m_pp[slot] = p.pp;
+        m_pv[slot] = p.pv;
+        m_vv[slot] = p.vv;
+        return slot;
+    }
+
+    void release(size_t slot) {
+        m_freeSlots.push_back(slot);
+    }
+
+    void clear() {
+        for (auto* component : m_state) {
+            component->clear();
+        }
+        m_pp.clear();
+        m_pv.clear();
+        m_vv.clear();
+        m_freeSlots.clear();
+    }
+
+    /**
+     * @brief Predict every slot one step ahead (free slots are advanced too; they are never read)
+     *
+     * x' = F x ; P' = F P F^T + Q, one component array at a time.
+     */
+    void predictAll() {
+        const size_t n = m_pp.size();
+        const float q = m_q;
+        float* pos[4] = {m_cx.data(), m_cy.data(), m_w.data(), m_h.data()};
+        const float* vel[4] = {m_vcx.data(), m_vcy.data(), m_vw.data(), m_vh.data()};
+
+        for (int k = 0; k < KalmanBoxKernel::MEASURE_DIM; ++k) {
+            float* __restrict x = pos[k];
+            const float* __restrict v = vel[k];
+            for (size_t i = 0; i < n; ++i) {
+                x[i] += v[i];
+            }
+        }
+
+        float* __restrict pp = m_pp.data();
+        float* __restrict pv = m_pv.data();
+        float* __restrict vv = m_vv.data();
+        for (size_t i = 0; i < n; ++i) {
+            const float newPp = pp[i] + 2.0f * pv[i] + vv[i] + q;
+            const float newPv = pv[i] + vv[i];
+            pp[i] = newPp;
+            pv[i] = newPv;
+            vv[i] += q;
+        }
+    }
+
+    /**
+     * @brief Correct one slot with a measured box (center x/y, width, height)
+     */
+    void update(size_t slot, float cx, float cy, float w, float h) {
+        float position[4] = {m_cx[slot], m_cy[slot], m_w[slot], m_h[slot]};
+        float velocity[4] = {m_vcx[slot], m_vcy[slot], m_vw[slot], m_vh[slot]};
+        KalmanBoxKernel::Covariance p{m_pp[slot], m_pv[slot], m_vv[slot]};
+        const float measurement[4] = {cx, cy, w, h};
+
+        KalmanBoxKernel::update(position, velocity, p, measurement, m_r);
+
+        m_cx[slot] = position[0];  m_cy[slot] = position[1];
+        m_w[slot] = position[2];   m_h[slot] = position[3];
+        m_vcx[slot] = velocity[0]; m_vcy[slot] = velocity[1];
+        m_vw[slot] = velocity[2];  m_vh[slot] = velocity[3];
+        m_pp[slot] = p.pp;
+        m_pv[slot] = p.pv;
+        m_vv[slot] = p.vv;
+    }
+
+    // State accessors
+    float cx(size_t slot) const { return m_cx[slot]; }
+    float cy(size_t slot) const { return m_cy[slot]; }
+    float width(size_t slot) const { return m_w[slot]; }
+    float height(size_t slot) const { return m_h[slot]; }
+    float vx(size_t slot) const { return m_vcx[slot]; }
+    float vy(size_t slot) const { return m_vcy[slot]; }
+
+    size_t slotCount() const { return m_pp.size(); }
+    size_t activeCount() const { return m_pp.size() - m_freeSlots.size(); }
+
+private:
+    float m_q;
+    float m_r;
+    float m_p0;
+
+    // One contiguous array per state component
+    std::vector<float> m_cx, m_cy, m_w, m_h;
+    std::vector<float> m_vcx, m_vcy, m_vw, m_vh;
+    std::vector<float>* const m_state[KalmanBoxKernel::STATE_DIM] = {
+        &m_cx, &m_cy, &m_w, &m_h, &m_vcx, &m_vcy, &m_vw, &m_vh};
+
+    // Shared per-coordinate covariance (see KalmanBoxKernel)
+    std::vector<float> m_pp, m_pv, m_vv;
+
+    std::vector<size_t> m_freeSlots;
+};
+
+} // namespace AISecurityVision
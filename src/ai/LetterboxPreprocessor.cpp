@@ -0,0 +1,237 @@
+#include "LetterboxPreprocessor.h"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <xmmintrin.h>
+#endif
+
+namespace AISecurityVision {
+
+namespace {
+
+// out[i] = (a[i] + (b[i] - a[i]) * weight) * scale
+void blendRows(const float* a, const float* b, float weight, float scale, float* out, int count) {
+    int i = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+    const __m256 w = _mm256_set1_ps(weight);
+    const __m256 s = _mm256_set1_ps(scale);
+    for (; i + 8 <= count; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 v = _mm256_fmadd_ps(_mm256_sub_ps(_mm256_loadu_ps(b + i), va), w, va);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(v, s));
+    }
+#elif defined(__ARM_NEON)
+    const float32x4_t w = vdupq_n_f32(weight);
+    const float32x4_t s = vdupq_n_f32(scale);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t va = vld1q_f32(a + i);
+        float32x4_t v = vmlaq_f32(va, vsubq_f32(vld1q_f32(b + i), va), w);
+        vst1q_f32(out + i, vmulq_f32(v, s));
+    }
+#elif defined(__SSE2__)
+    const __m128 w = _mm_set1_ps(weight);
+    const __m128 s = _mm_set1_ps(scale);
+    for (; i + 4 <= count; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 v = _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + i), va), w));
+        _mm_storeu_ps(out + i, _mm_mul_ps(v, s));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = (a[i] + (b[i] - a[i]) * weight) * scale;
+    }
+}
+
+// Bilinear taps of cv::resize INTER_LINEAR: pixel centres aligned, clamped at the borders
+void buildTaps(int sourceLength, int targetLength, std::vector<int>& taps, std::vector<float>& weights) {
+    taps.resize(static_cast<size_t>(targetLength) * 2);
+    weights.resize(targetLength);
+    const double ratio = static_cast<double>(sourceLength) / targetLength;
+    for (int i = 0; i < targetLength; ++i) {
+        double position = (i + 0.5) * ratio - 0.5;
+        int first = static_cast<int>(std::floor(position));
+        float weight = static_cast<float>(position - first);
+        if (first < 0) {
+            first = 0;
+            weight = 0.0f;
+        }
+        if (first >= sourceLength - 1) {
+            first = sourceLength - 1;
+            weight = 0.0f;
+        }
+        taps[2 * i] = first;
+        taps[2 * i + 1] = std::min(first + 1, sourceLength - 1);
+        weights[i] = weight;
+    }
+}
+
+} // namespace
+
+LetterboxPreprocessor::LetterboxPreprocessor() = default;
+
+LetterboxPreprocessor::LetterboxPreprocessor(const Options& options)
+    : m_options(options) {
+}
+
+void LetterboxPreprocessor::prepare(const cv::Size& source, const cv::Size& target) {
+    if (source == m_source && target == m_target) {
+        return;
+    }
+
+    m_source = source;
+    m_target = target;
+    m_geometry = LetterboxGeometry::fit(source, target);
+    m_identity = m_geometry.scaled == source;
+
+    const cv::Size& scaled = m_geometry.scaled;
+    buildTaps(source.width, scaled.width, m_xOffsets, m_xWeights);
+    for (int& offset : m_xOffsets) {
+        offset *= 3;
+    }
+    buildTaps(source.height, scaled.height, m_yRows, m_yWeights);
+
+    m_rowCache.assign(static_cast<size_t>(scaled.width) * 3 * 2, 0.0f);
+}
+
+void LetterboxPreprocessor::resampleRow(const uint8_t* src, float* dst) const {
+    const int width = m_geometry.scaled.width;
+    float* b = dst;
+    float* g = dst + width;
+    float* r = dst + 2 * width;
+    const int* offsets = m_xOffsets.data();
+    const float* weights = m_xWeights.data();
+
+    for (int x = 0; x < width; ++x) {
+        const uint8_t* p0 = src + offsets[2 * x];
+        const uint8_t* p1 = src + offsets[2 * x + 1];
+        const float w = weights[x];
+        b[x] = p0[0] + (static_cast<float>(p1[0]) - p0[0]) * w;
+        g[x] = p0[1] + (static_cast<float>(p1[1]) - p0[1]) * w;
+        r[x] = p0[2] + (static_cast<float>(p1[2]) - p0[2]) * w;
+    }
+}
+
+// Resampled source row, resampling it into the slot other than keepSlot on a miss
+const float* LetterboxPreprocessor::cachedRow(int row, int keepSlot, const uint8_t* data, size_t step, int& slot) {
+    const size_t slotSize = static_cast<size_t>(m_geometry.scaled.width) * 3;
+    if (m_cachedRows[0] == row) {
+        slot = 0;
+    } else if (m_cachedRows[1] == row) {
+        slot = 1;
+    } else {
+        slot = (keepSlot == 0) ? 1 : (keepSlot == 1) ? 0 : (m_cachedRows[0] < m_cachedRows[1] ? 0 : 1);
+        resampleRow(data + static_cast<size_t>(row) * step, m_rowCache.data() + slot * slotSize);
+        m_cachedRows[slot] = row;
+    }
+    return m_rowCache.data() + slot * slotSize;
+}
+
+LetterboxInfo LetterboxPreprocessor::toPlanarFloat(const cv::Mat& image, const cv::Size& target, float* output) {
+    const cv::Mat* source = &image;
+    if (image.type() == CV_8UC1) {
+        cv::cvtColor(image, m_converted, cv::COLOR_GRAY2BGR);
+        source = &m_converted;
+    } else if (image.type() == CV_8UC4) {
+        cv::cvtColor(image, m_converted, cv::COLOR_BGRA2BGR);
+        source = &m_converted;
+    } else if (image.type() != CV_8UC3) {
+        return LetterboxInfo();
+    }
+    return toPlanarFloat(source->data, source->cols, source->rows, source->step, target, output);
+}
+
+LetterboxInfo LetterboxPreprocessor::toPlanarFloat(const uint8_t* data, int width, int height, size_t step,
+                                                   const cv::Size& target, float* output) {
+    if (!data || width <= 0 || height <= 0 || target.width <= 0 || target.height <= 0 || !output) {
+        return LetterboxInfo();
+    }
+
+    prepare(cv::Size(width, height), target);
+    m_cachedRows[0] = m_cachedRows[1] = -1;    // Rows are cached per frame only
+
+    const size_t planeSize = static_cast<size_t>(target.width) * target.height;
+    float* planes[3];
+    for (int c = 0; c < 3; ++c) {
+        planes[c] = output + planeSize * (m_options.swapRB ? 2 - c : c);
+    }
+
+    const cv::Rect content = m_geometry.roi();
+    const float scale = m_options.scale;
+    const float pad = m_options.padValue * scale;
+
+    for (int y = 0; y < target.height; ++y) {
+        const size_t rowOffset = static_cast<size_t>(y) * target.width;
+        const int contentRow = y - content.y;
+
+        if (contentRow < 0 || contentRow >= content.height) {
+            for (int c = 0; c < 3; ++c) {
+                std::fill_n(planes[c] + rowOffset, target.width, pad);
+            }
+            continue;
+        }
+
+        for (int c = 0; c < 3; ++c) {
+            float* row = planes[c] + rowOffset;
+            std::fill_n(row, content.x, pad);
+            std::fill(row + content.x + content.width, row + target.width, pad);
+        }
+
+        if (m_identity) {
+            // Deinterleave and scale straight from the source row
+            const uint8_t* src = data + static_cast<size_t>(contentRow) * step;
+            float* b = planes[0] + rowOffset + content.x;
+            float* g = planes[1] + rowOffset + content.x;
+            float* r = planes[2] + rowOffset + content.x;
+            for (int x = 0; x < content.width; ++x) {
+                b[x] = src[3 * x] * scale;
+                g[x] = src[3 * x + 1] * scale;
+                r[x] = src[3 * x + 2] * scale;
+            }
+            continue;
+        }
+
+        const int row0 = m_yRows[2 * contentRow];
+        const int row1 = m_yRows[2 * contentRow + 1];
+        int slot0 = -1;
+        int slot1 = -1;
+        const float* top = cachedRow(row0, -1, data, step, slot0);
+        const float* bottom = (row1 == row0) ? top : cachedRow(row1, slot0, data, step, slot1);
+        const float weight = m_yWeights[contentRow];
+
+        for (int c = 0; c < 3; ++c) {
+            const size_t channel = static_cast<size_t>(c) * content.width;
+            blendRows(top + channel, bottom + channel, weight, scale,
+                      planes[c] + rowOffset + content.x, content.width);
+        }
+    }
+
+    return m_geometry.info;
+}
+
+LetterboxInfo LetterboxPreprocessor::toInterleavedU8(const cv::Mat& image, const cv::Size& target, cv::Mat& output) {
+    if (image.empty() || target.width <= 0 || target.height <= 0) {
+        return LetterboxInfo();
+    }
+
+    LetterboxGeometry geometry = LetterboxGeometry::fit(image.size(), target);
+    output.create(target, CV_8UC3);
+
+    // Resize straight into the content area, then pad only the bands around it
+    cv::Mat content = output(geometry.roi());
+    if (image.size() == content.size()) {
+        image.copyTo(content);
+    } else {
+        cv::resize(image, content, content.size(), 0, 0, cv::INTER_LINEAR);
+    }
+    geometry.fillPadding(output);
+
+    return geometry.info;
+}
+
+} // namespace AISecurityVision
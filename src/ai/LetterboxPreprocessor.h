@@ -0,0 +1,100 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "../core/FrameBundle.h"
+
+namespace AISecurityVision {
+
+/**
+ * @brief Letterbox preprocessing shared by the detector backends
+ *
+ * toPlanarFloat() resizes, pads, scales and transposes a BGR frame into a
+ * planar (CHW) float tensor in a single pass over the output, writing straight
+ * into the backend's input buffer. It replaces the resize / pad / convertTo /
+ * split / memcpy chain, which touched every pixel five times and allocated
+ * three intermediate images per frame.
+ *
+ * Resampling is bilinear with the pixel-centre convention of cv::resize
+ * INTER_LINEAR and the geometry is LetterboxGeometry::fit(), so the output
+ * matches the former path up to 8-bit rounding. Each source row is resampled
+ * horizontally once into a two-row cache (deinterleaving the channels on the
+ * way); every output row is then a vertical blend of two cached rows, which
+ * runs SIMD over contiguous floats together with the scaling and the store.
+ *
+ * Sampling tables and the row cache are kept between calls and only rebuilt
+ * when the source or target size changes, so steady-state preprocessing does
+ * not allocate. Not thread-safe: use one instance per detector.
+ */
+class LetterboxPreprocessor {
+public:
+    struct Options {
+        bool swapRB = false;        // Emit R,G,B planes from a BGR frame
+        float scale = 1.0f / 255.0f;
+        float padValue = static_cast<float>(LetterboxGeometry::PAD_VALUE);  // Before scaling
+    };
+
+    LetterboxPreprocessor();
+    explicit LetterboxPreprocessor(const Options& options);
+
+    /**
+     * @brief Letterbox a frame into a planar float tensor
+     * @param image BGR (CV_8UC3) frame; gray and BGRA frames are converted first
+     * @param target Network input size
+     * @param output 3 * target.area() floats: three target-sized planes
+     * @return Letterbox mapping output coordinates back to the frame
+     */
+    LetterboxInfo toPlanarFloat(const cv::Mat& image, const cv::Size& target, float* output);
+
+    /**
+     * @brief Raw-buffer variant of toPlanarFloat() for packed 8-bit BGR data
+     */
+    LetterboxInfo toPlanarFloat(const uint8_t* data, int width, int height, size_t step,
+                                const cv::Size& target, float* output);
+
+    /**
+     * @brief Letterbox a frame into an interleaved 8-bit canvas
+     *
+     * For backends that take uint8 NHWC input. Same geometry and resampling
+     * as toPlanarFloat(); the canvas keeps BGR order and is padded with
+     * LetterboxGeometry::PAD_VALUE. Options do not apply.
+     *
+     * @param image BGR (CV_8UC3) frame
+     * @param target Network input size
+     * @param output Canvas, (re)allocated only if its size or type differs
+     */
+    LetterboxInfo toInterleavedU8(const cv::Mat& image, const cv::Size& target, cv::Mat& output);
+
+    const Options& options() const { return m_options; }
+
+private:
+    void prepare(const cv::Size& source, const cv::Size& target);
+    void resampleRow(const uint8_t* src, float* dst) const;
+    const float* cachedRow(int row, int keepSlot, const uint8_t* data, size_t step, int& slot);
+
+    Options m_options;
+
+    // Geometry the tables were built for
+    cv::Size m_source;
+    cv::Size m_target;
+    LetterboxGeometry m_geometry;
+    bool m_identity = false;            // Source already fits the content area 1:1
+
+    // Horizontal taps: byte offsets of the two source pixels and the weight of the second
+    std::vector<int> m_xOffsets;        // 2 per output column
+    std::vector<float> m_xWeights;
+    // Vertical taps: the two source rows and the weight of the second
+    std::vector<int> m_yRows;           // 2 per output row
+    std::vector<float> m_yWeights;
+
+    // Two horizontally resampled source rows, each as three channel planes
+    std::vector<float> m_rowCache;
+    int m_cachedRows[2] = {-1, -1};
+
+    cv::Mat m_converted;                // Non-BGR input converted to CV_8UC3
+};
+
+} // namespace AISecurityVision
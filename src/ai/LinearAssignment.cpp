@@ -0,0 +1,107 @@
+#include "LinearAssignment.h"
+#include <algorithm>
+
+namespace AISecurityVision {
+
+std::vector<std::pair<int, int>> solveLinearAssignment(const AssignmentMatrix& cost, float costLimit) {
+    std::vector<std::pair<int, int>> assignments;
+    if (cost.empty()) {
+        return assignments;
+    }
+
+    // Extend every row with a private "unmatched" column costing costLimit.
+    // Matching a pair then only pays off when its cost is below the limit,
+    // which is equivalent to charging costLimit / 2 per unmatched row and
+    // column. With these columns rows <= columns always holds.
+    const int n = cost.rows;
+    const int realCols = cost.cols;
+    const int m = realCols + n;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    // 1-based arrays as in the classic formulation; index 0 is the virtual root
+    std::vector<double> u(n + 1, 0.0), v(m + 1, 0.0), minv(m + 1);
+    std::vector<int> p(m + 1, 0), way(m + 1, 0);
+    std::vector<char> used(m + 1);
+
+    for (int i = 1; i <= n; ++i) {
+        p[0] = i;
+        int j0 = 0;
+        std::fill(minv.begin(), minv.end(), inf);
+        std::fill(used.begin(), used.end(), 0);
+
+        // Dijkstra-like search for the shortest augmenting path from row i
+        do {
+            used[j0] = 1;
+            const int i0 = p[j0];
+            const float* costRow = cost.row(i0 - 1);
+            double delta = inf;
+            int j1 = 0;
+
+            for (int j = 1; j <= realCols; ++j) {
+                if (used[j]) {
+                    continue;
+                }
+                const float c = costRow[j - 1];
+                if (c < costLimit) {
+                    const double reduced = c - u[i0] - v[j];
+                    if (reduced < minv[j]) {
+                        minv[j] = reduced;
+                        way[j] = j0;
+                    }
+                }
+                if (minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+
+            // Only row i0's own unmatched column is admissible from i0
+            const int dummy = realCols + i0;
+            if (!used[dummy]) {
+                const double reduced = costLimit - u[i0] - v[dummy];
+                if (reduced < minv[dummy]) {
+                    minv[dummy] = reduced;
+                    way[dummy] = j0;
+                }
+            }
+            for (int j = realCols + 1; j <= m; ++j) {
+                if (!used[j] && minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+
+            if (j1 == 0) {
+                // Unreachable: the row's unmatched column is always admissible
+                break;
+            }
+
+            for (int j = 0; j <= m; ++j) {
+                if (used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+
+        // Flip the augmenting path
+        do {
+            const int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    for (int j = 1; j <= realCols; ++j) {
+        if (p[j] != 0) {
+            assignments.emplace_back(p[j] - 1, j - 1);
+        }
+    }
+
+    return assignments;
+}
+
+} // namespace AISecurityVision
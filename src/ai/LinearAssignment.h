@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <limits>
+#include <cstddef>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Contiguous row-major float matrix used for association scores and costs
+ */
+struct AssignmentMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<float> values;
+
+    AssignmentMatrix() = default;
+    AssignmentMatrix(int r, int c, float fill = 0.0f)
+        : rows(r), cols(c), values(static_cast<size_t>(r) * c, fill) {}
+
+    void assign(int r, int c, float fill) {
+        rows = r;
+        cols = c;
+        values.assign(static_cast<size_t>(r) * c, fill);
+    }
+
+    bool empty() const { return rows == 0 || cols == 0; }
+
+    float* row(int r) { return values.data() + static_cast<size_t>(r) * cols; }
+    const float* row(int r) const { return values.data() + static_cast<size_t>(r) * cols; }
+
+    float& at(int r, int c) { return values[static_cast<size_t>(r) * cols + c]; }
+    float at(int r, int c) const { return values[static_cast<size_t>(r) * cols + c]; }
+};
+
+/**
+ * @brief Gated minimum-cost linear assignment (Jonker-Volgenant shortest augmenting path)
+ *
+ * Finds the matching that minimises the total cost, where leaving a row or a
+ * column unmatched costs costLimit / 2 each. A pair is therefore only matched
+ * when its cost is below costLimit, and pairs at or above the limit (or
+ * infinite) are gated out and never examined by the augmentation.
+ *
+ * Runs in O(n^2 * m) worst case on the contiguous cost matrix, usually close
+ * to O(n * m) for tracking workloads where most rows have a distinct best column.
+ *
+ * @param cost Row-major cost matrix
+ * @param costLimit Maximum cost of an admissible pair
+ * @return Matched (row, column) pairs
+ */
+std::vector<std::pair<int, int>> solveLinearAssignment(const AssignmentMatrix& cost, float costLimit);
+
+constexpr float ASSIGNMENT_INFEASIBLE = std::numeric_limits<float>::infinity();
+
+} // namespace AISecurityVision
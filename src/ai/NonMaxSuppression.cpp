@@ -0,0 +1,340 @@
+#include "NonMaxSuppression.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <xmmintrin.h>
+#endif
+
+namespace AISecurityVision {
+
+namespace {
+
+// out[j] = IoU of the reference box with box j; 0 where the union is empty.
+// Evaluated in the same order as the former scalar implementations
+// (intersection side = min - max + offset, union = (area0 + area1) - intersection),
+// so every vector lane rounds exactly like the scalar tail.
+void iouRow(float rx1, float ry1, float rx2, float ry2, float rarea,
+            const float* x1, const float* y1, const float* x2, const float* y2, const float* area,
+            float offset, float* out, size_t count) {
+    size_t j = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+    const __m256 bx1 = _mm256_set1_ps(rx1);
+    const __m256 by1 = _mm256_set1_ps(ry1);
+    const __m256 bx2 = _mm256_set1_ps(rx2);
+    const __m256 by2 = _mm256_set1_ps(ry2);
+    const __m256 barea = _mm256_set1_ps(rarea);
+    const __m256 off = _mm256_set1_ps(offset);
+    const __m256 zero = _mm256_setzero_ps();
+    for (; j + 8 <= count; j += 8) {
+        __m256 w = _mm256_sub_ps(_mm256_min_ps(bx2, _mm256_loadu_ps(x2 + j)), _mm256_max_ps(bx1, _mm256_loadu_ps(x1 + j)));
+        __m256 h = _mm256_sub_ps(_mm256_min_ps(by2, _mm256_loadu_ps(y2 + j)), _mm256_max_ps(by1, _mm256_loadu_ps(y1 + j)));
+        w = _mm256_max_ps(zero, _mm256_add_ps(w, off));
+        h = _mm256_max_ps(zero, _mm256_add_ps(h, off));
+        __m256 inter = _mm256_mul_ps(w, h);
+        __m256 uni = _mm256_sub_ps(_mm256_add_ps(barea, _mm256_loadu_ps(area + j)), inter);
+        __m256 valid = _mm256_cmp_ps(uni, zero, _CMP_GT_OQ);
+        _mm256_storeu_ps(out + j, _mm256_and_ps(_mm256_div_ps(inter, uni), valid));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t bx1 = vdupq_n_f32(rx1);
+    const float32x4_t by1 = vdupq_n_f32(ry1);
+    const float32x4_t bx2 = vdupq_n_f32(rx2);
+    const float32x4_t by2 = vdupq_n_f32(ry2);
+    const float32x4_t barea = vdupq_n_f32(rarea);
+    const float32x4_t off = vdupq_n_f32(offset);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; j + 4 <= count; j += 4) {
+        float32x4_t w = vsubq_f32(vminq_f32(bx2, vld1q_f32(x2 + j)), vmaxq_f32(bx1, vld1q_f32(x1 + j)));
+        float32x4_t h = vsubq_f32(vminq_f32(by2, vld1q_f32(y2 + j)), vmaxq_f32(by1, vld1q_f32(y1 + j)));
+        w = vmaxq_f32(zero, vaddq_f32(w, off));
+        h = vmaxq_f32(zero, vaddq_f32(h, off));
+        float32x4_t inter = vmulq_f32(w, h);
+        float32x4_t uni = vsubq_f32(vaddq_f32(barea, vld1q_f32(area + j)), inter);
+        uint32x4_t valid = vcgtq_f32(uni, zero);
+        float32x4_t iou = vdivq_f32(inter, uni);
+        vst1q_f32(out + j, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(iou), valid)));
+    }
+#elif defined(__SSE2__)
+    const __m128 bx1 = _mm_set1_ps(rx1);
+    const __m128 by1 = _mm_set1_ps(ry1);
+    const __m128 bx2 = _mm_set1_ps(rx2);
+    const __m128 by2 = _mm_set1_ps(ry2);
+    const __m128 barea = _mm_set1_ps(rarea);
+    const __m128 off = _mm_set1_ps(offset);
+    const __m128 zero = _mm_setzero_ps();
+    for (; j + 4 <= count; j += 4) {
+        __m128 w = _mm_sub_ps(_mm_min_ps(bx2, _mm_loadu_ps(x2 + j)), _mm_max_ps(bx1, _mm_loadu_ps(x1 + j)));
+        __m128 h = _mm_sub_ps(_mm_min_ps(by2, _mm_loadu_ps(y2 + j)), _mm_max_ps(by1, _mm_loadu_ps(y1 + j)));
+        w = _mm_max_ps(zero, _mm_add_ps(w, off));
+        h = _mm_max_ps(zero, _mm_add_ps(h, off));
+        __m128 inter = _mm_mul_ps(w, h);
+        __m128 uni = _mm_sub_ps(_mm_add_ps(barea, _mm_loadu_ps(area + j)), inter);
+        __m128 valid = _mm_cmpgt_ps(uni, zero);
+        _mm_storeu_ps(out + j, _mm_and_ps(_mm_div_ps(inter, uni), valid));
+    }
+#endif
+    for (; j < count; ++j) {
+        float w = std::max(0.0f, std::min(rx2, x2[j]) - std::max(rx1, x1[j]) + offset);
+        float h = std::max(0.0f, std::min(ry2, y2[j]) - std::max(ry1, y1[j]) + offset);
+        float inter = w * h;
+        float uni = rarea + area[j] - inter;
+        out[j] = uni > 0.0f ? inter / uni : 0.0f;
+    }
+}
+
+} // namespace
+
+void NonMaxSuppression::Batch::resize(size_t n) {
+    x1.resize(n);
+    y1.resize(n);
+    x2.resize(n);
+    y2.resize(n);
+    area.resize(n);
+    score.resize(n);
+    index.resize(n);
+    count = n;
+}
+
+void NonMaxSuppression::Batch::move(size_t from, size_t to) {
+    x1[to] = x1[from];
+    y1[to] = y1[from];
+    x2[to] = x2[from];
+    y2[to] = y2[from];
+    area[to] = area[from];
+    score[to] = score[from];
+    index[to] = index[from];
+}
+
+void NonMaxSuppression::Batch::swap(size_t a, size_t b) {
+    std::swap(x1[a], x1[b]);
+    std::swap(y1[a], y1[b]);
+    std::swap(x2[a], x2[b]);
+    std::swap(y2[a], y2[b]);
+    std::swap(area[a], area[b]);
+    std::swap(score[a], score[b]);
+    std::swap(index[a], index[b]);
+}
+
+void NonMaxSuppression::clear() {
+    m_x1.clear();
+    m_y1.clear();
+    m_x2.clear();
+    m_y2.clear();
+    m_score.clear();
+    m_classId.clear();
+    m_keep.clear();
+}
+
+void NonMaxSuppression::reserve(size_t candidates) {
+    m_x1.reserve(candidates);
+    m_y1.reserve(candidates);
+    m_x2.reserve(candidates);
+    m_y2.reserve(candidates);
+    m_score.reserve(candidates);
+    m_classId.reserve(candidates);
+}
+
+void NonMaxSuppression::add(float x1, float y1, float x2, float y2, float score, int classId) {
+    m_x1.push_back(x1);
+    m_y1.push_back(y1);
+    m_x2.push_back(x2);
+    m_y2.push_back(y2);
+    m_score.push_back(score);
+    m_classId.push_back(classId);
+}
+
+void NonMaxSuppression::add(const cv::Rect& box, float score, int classId) {
+    add(static_cast<float>(box.x), static_cast<float>(box.y),
+        static_cast<float>(box.x + box.width), static_cast<float>(box.y + box.height), score, classId);
+}
+
+const std::vector<int>& NonMaxSuppression::run(const Config& config) {
+    m_keep.clear();
+    m_finalScore = m_score;
+    const size_t n = size();
+    if (n == 0) {
+        return m_keep;
+    }
+
+    // One sort orders every class batch by descending score
+    m_order.resize(n);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    if (config.classAware) {
+        std::stable_sort(m_order.begin(), m_order.end(), [this](int a, int b) {
+            if (m_classId[a] != m_classId[b]) {
+                return m_classId[a] < m_classId[b];
+            }
+            return m_score[a] > m_score[b];
+        });
+    } else {
+        std::stable_sort(m_order.begin(), m_order.end(), [this](int a, int b) {
+            return m_score[a] > m_score[b];
+        });
+    }
+
+    const float offset = config.inclusiveCoordinates ? 1.0f : 0.0f;
+    size_t begin = 0;
+    while (begin < n) {
+        size_t end = begin + 1;
+        if (config.classAware) {
+            while (end < n && m_classId[m_order[end]] == m_classId[m_order[begin]]) {
+                ++end;
+            }
+        } else {
+            end = n;
+        }
+
+        // Scores are sorted, so everything after the first one below the threshold goes too
+        auto first = m_order.begin() + begin;
+        auto last = std::partition_point(first, m_order.begin() + end, [this, &config](int i) {
+            return m_score[i] >= config.scoreThreshold;
+        });
+
+        if (last != first) {
+            loadBatch(&m_order[begin], static_cast<size_t>(last - first), offset);
+            if (config.method == Method::HARD) {
+                runHard(config);
+            } else {
+                runSoft(config);
+            }
+        }
+        begin = end;
+    }
+
+    if (config.classAware || config.method != Method::HARD) {
+        std::stable_sort(m_keep.begin(), m_keep.end(), [this](int a, int b) {
+            return m_finalScore[a] > m_finalScore[b];
+        });
+    }
+    return m_keep;
+}
+
+void NonMaxSuppression::loadBatch(const int* order, size_t count, float offset) {
+    m_batch.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        const int i = order[k];
+        m_batch.x1[k] = m_x1[i];
+        m_batch.y1[k] = m_y1[i];
+        m_batch.x2[k] = m_x2[i];
+        m_batch.y2[k] = m_y2[i];
+        m_batch.area[k] = (m_x2[i] - m_x1[i] + offset) * (m_y2[i] - m_y1[i] + offset);
+        m_batch.score[k] = m_score[i];
+        m_batch.index[k] = i;
+    }
+    if (m_overlaps.size() < count) {
+        m_overlaps.resize(count);
+    }
+}
+
+void NonMaxSuppression::computeOverlaps(size_t reference, size_t begin, size_t end, const Config& config) {
+    const Batch& b = m_batch;
+    const float offset = config.inclusiveCoordinates ? 1.0f : 0.0f;
+    iouRow(b.x1[reference], b.y1[reference], b.x2[reference], b.y2[reference], b.area[reference],
+           &b.x1[begin], &b.y1[begin], &b.x2[begin], &b.y2[begin], &b.area[begin],
+           offset, &m_overlaps[begin], end - begin);
+
+    if (config.overlap == Overlap::DIOU) {
+        const float cx = b.x1[reference] + b.x2[reference];
+        const float cy = b.y1[reference] + b.y2[reference];
+        for (size_t j = begin; j < end; ++j) {
+            // Centre distance over the enclosing box diagonal, both squared (centres doubled on both sides)
+            float dx = cx - (b.x1[j] + b.x2[j]);
+            float dy = cy - (b.y1[j] + b.y2[j]);
+            float ew = std::max(b.x2[reference], b.x2[j]) - std::min(b.x1[reference], b.x1[j]);
+            float eh = std::max(b.y2[reference], b.y2[j]) - std::min(b.y1[reference], b.y1[j]);
+            float diagonal = 4.0f * (ew * ew + eh * eh);
+            if (diagonal > 0.0f) {
+                m_overlaps[j] -= (dx * dx + dy * dy) / diagonal;
+            }
+        }
+    } else if (config.overlap == Overlap::IOS) {
+        // Recover the intersection from the IoU: iou = i / (a + b - i)
+        const float rarea = b.area[reference];
+        for (size_t j = begin; j < end; ++j) {
+            float iou = m_overlaps[j];
+            float smaller = std::min(rarea, b.area[j]);
+            m_overlaps[j] = smaller > 0.0f ? iou * (rarea + b.area[j]) / (1.0f + iou) / smaller : 0.0f;
+        }
+    }
+}
+
+void NonMaxSuppression::runHard(const Config& config) {
+    Batch& b = m_batch;
+    size_t count = b.count;
+    size_t kept = 0;
+
+    for (size_t k = 0; k < count; ++k) {
+        m_keep.push_back(b.index[k]);
+        if ((config.maxDetections > 0 && ++kept >= config.maxDetections) || k + 1 == count) {
+            break;
+        }
+
+        // Survivors of this box are compacted behind it
+        computeOverlaps(k, k + 1, count, config);
+        size_t survivors = k + 1;
+        for (size_t j = k + 1; j < count; ++j) {
+            if (!(m_overlaps[j] > config.iouThreshold)) {
+                if (survivors != j) {
+                    b.move(j, survivors);
+                }
+                ++survivors;
+            }
+        }
+        count = survivors;
+    }
+}
+
+void NonMaxSuppression::runSoft(const Config& config) {
+    Batch& b = m_batch;
+    size_t count = b.count;
+    size_t kept = 0;
+
+    for (size_t k = 0; k < count; ++k) {
+        // Decayed scores are no longer sorted: bring the best remaining box forward
+        size_t best = k;
+        for (size_t j = k + 1; j < count; ++j) {
+            if (b.score[j] > b.score[best]) {
+                best = j;
+            }
+        }
+        if (best != k) {
+            b.swap(k, best);
+        }
+
+        m_keep.push_back(b.index[k]);
+        m_finalScore[b.index[k]] = b.score[k];
+        if ((config.maxDetections > 0 && ++kept >= config.maxDetections) || k + 1 == count) {
+            break;
+        }
+
+        computeOverlaps(k, k + 1, count, config);
+        size_t survivors = k + 1;
+        for (size_t j = k + 1; j < count; ++j) {
+            float overlap = std::max(0.0f, m_overlaps[j]);
+            float score = b.score[j];
+            if (config.method == Method::SOFT_LINEAR) {
+                if (overlap > config.iouThreshold) {
+                    score *= 1.0f - overlap;
+                }
+            } else {
+                score *= std::exp(-(overlap * overlap) / config.sigma);
+            }
+            if (score >= config.scoreThreshold) {
+                b.score[j] = score;
+                if (survivors != j) {
+                    b.move(j, survivors);
+                }
+                ++survivors;
+            }
+        }
+        count = survivors;
+    }
+}
+
+} // namespace AISecurityVision
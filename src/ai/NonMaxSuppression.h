@@ -0,0 +1,109 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include <cstddef>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Class-aware non-maximum suppression shared by the detector backends
+ *
+ * Candidates are stored structure-of-arrays (corners, area, score, class),
+ * so the overlap of one box against all remaining boxes is a SIMD loop over
+ * contiguous floats. With class awareness on, candidates are ordered by
+ * (class, score) once and every class runs as an independent batch over its
+ * own contiguous slice.
+ *
+ * Greedy suppression compacts the surviving boxes after each kept box, so
+ * later passes only touch boxes that can still be kept. Scores are sorted up
+ * front, which lets the run stop at the first candidate below the score
+ * threshold and once maxDetections boxes of a class are kept. Results are
+ * those of the textbook greedy loop: a box is suppressed by a higher-scoring
+ * kept box when their overlap is strictly greater than the IoU threshold.
+ *
+ * Soft-NMS (linear or Gaussian score decay), DIoU and intersection-over-smaller
+ * overlap are optional.
+ *
+ * Not thread-safe: the candidate arrays and scratch buffers are reused
+ * between runs, use one instance per detector.
+ */
+class NonMaxSuppression {
+public:
+    enum class Method {
+        HARD,           // Drop boxes overlapping a kept box
+        SOFT_LINEAR,    // Scale scores of overlapping boxes by (1 - overlap)
+        SOFT_GAUSSIAN   // Scale all scores by exp(-overlap^2 / sigma)
+    };
+
+    enum class Overlap {
+        IOU,
+        DIOU,           // IoU minus normalised centre distance
+        IOS             // Intersection over the smaller box: a box cut off by a tile edge overlaps the whole one
+    };
+
+    struct Config {
+        float iouThreshold = 0.45f;
+        float scoreThreshold = 0.0f;    // Candidates (and decayed scores) below this are dropped
+        Method method = Method::HARD;
+        Overlap overlap = Overlap::IOU;
+        float sigma = 0.5f;             // SOFT_GAUSSIAN only
+        bool classAware = true;         // Only boxes of the same class suppress each other
+        bool inclusiveCoordinates = false;  // Corners are pixel indices: width = x2 - x1 + 1
+        size_t maxDetections = 0;       // Per class when class-aware, 0 = unlimited
+    };
+
+    NonMaxSuppression() = default;
+
+    void clear();
+    void reserve(size_t candidates);
+
+    /**
+     * @brief Add a candidate by its corners
+     */
+    void add(float x1, float y1, float x2, float y2, float score, int classId);
+    void add(const cv::Rect& box, float score, int classId);
+
+    size_t size() const { return m_score.size(); }
+
+    /**
+     * @brief Suppress the added candidates
+     * @return Indices (in add() order) of the kept candidates, highest score first.
+     *         Valid until the next clear() or run()
+     */
+    const std::vector<int>& run(const Config& config);
+
+    /**
+     * @brief Score of a candidate after run(); differs from the added score only with Soft-NMS
+     */
+    float score(int index) const { return m_finalScore[index]; }
+
+private:
+    // Sorted working copy of one class batch
+    struct Batch {
+        std::vector<float> x1, y1, x2, y2, area, score;
+        std::vector<int> index;
+        size_t count = 0;
+
+        void resize(size_t n);
+        void move(size_t from, size_t to);
+        void swap(size_t a, size_t b);
+    };
+
+    void loadBatch(const int* order, size_t count, float offset);
+    void computeOverlaps(size_t reference, size_t begin, size_t end, const Config& config);
+    void runHard(const Config& config);
+    void runSoft(const Config& config);
+
+    // Candidates in add() order
+    std::vector<float> m_x1, m_y1, m_x2, m_y2, m_score;
+    std::vector<int> m_classId;
+
+    std::vector<int> m_order;
+    std::vector<int> m_keep;
+    std::vector<float> m_finalScore;
+    std::vector<float> m_overlaps;
+    Batch m_batch;
+};
+
+} // namespace AISecurityVision
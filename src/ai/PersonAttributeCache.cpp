@@ -0,0 +1,141 @@
+#include "PersonAttributeCache.h"
+#include "AgeGenderAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AISecurityVision {
+
+namespace {
+
+const std::array<const char*, 2> GENDERS = {"male", "female"};
+const std::array<const char*, 4> AGE_GROUPS = {"child", "young", "middle", "senior"};
+
+template <size_t N>
+int labelIndex(const std::array<const char*, N>& labels, const std::string& label) {
+    for (size_t i = 0; i < N; ++i) {
+        if (label == labels[i]) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Leading label and its share of the accumulated score
+template <size_t N>
+std::pair<size_t, float> leading(const std::array<float, N>& scores) {
+    size_t best = 0;
+    float total = 0.0f;
+    for (size_t i = 0; i < N; ++i) {
+        total += scores[i];
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    return {best, total > 0.0f ? scores[best] / total : 0.0f};
+}
+
+} // namespace
+
+void PersonAttributeCache::beginFrame() {
+    ++m_frame;
+    size_t confident = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (m_frame - it->second.seenFrame > static_cast<uint64_t>(RETENTION_FRAMES)) {
+            it = m_entries.erase(it);
+        } else {
+            confident += it->second.confident ? 1 : 0;
+            ++it;
+        }
+    }
+    m_trackCount.store(m_entries.size());
+    m_confidentCount.store(confident);
+}
+
+bool PersonAttributeCache::wantsAnalysis(int trackId, float quality) {
+    m_persons.fetch_add(1);
+    if (trackId < 0) {
+        return true;
+    }
+
+    Entry& entry = m_entries[trackId];
+    entry.seenFrame = m_frame;
+    if (entry.confident) {
+        return false;
+    }
+    if (entry.attempts == 0 || quality >= entry.bestQuality * QUALITY_GAIN) {
+        return true;
+    }
+    return m_frame - entry.analysedFrame >= static_cast<uint64_t>(RETRY_FRAMES) &&
+           quality >= entry.bestQuality * RETRY_QUALITY;
+}
+
+void PersonAttributeCache::update(int trackId, const PersonAttributes& attributes, float quality) {
+    m_analysed.fetch_add(1);
+    if (trackId < 0) {
+        return;
+    }
+
+    Entry& entry = m_entries[trackId];
+    entry.seenFrame = m_frame;
+    entry.analysedFrame = m_frame;
+    entry.bestQuality = std::max(entry.bestQuality, quality);
+    ++entry.attempts;
+
+    int gender = labelIndex(GENDERS, attributes.gender);
+    int age = labelIndex(AGE_GROUPS, attributes.age_group);
+    if (attributes.isValid() && gender >= 0 && age >= 0) {
+        const float weight = std::max(quality, 0.05f);
+        entry.gender[gender] += weight * attributes.gender_confidence;
+        entry.age[age] += weight * attributes.age_confidence;
+        ++entry.samples;
+    }
+
+    entry.confident = entry.attempts >= MAX_ATTEMPTS || entry.samples >= MAX_SAMPLES ||
+        (entry.samples >= MIN_SAMPLES &&
+         leading(entry.gender).second >= CONFIDENT_SHARE &&
+         leading(entry.age).second >= CONFIDENT_SHARE);
+}
+
+bool PersonAttributeCache::lookup(int trackId, PersonAttributes& attributes) const {
+    auto it = m_entries.find(trackId);
+    if (it == m_entries.end() || it->second.samples == 0) {
+        return false;
+    }
+
+    auto gender = leading(it->second.gender);
+    auto age = leading(it->second.age);
+    attributes.gender = GENDERS[gender.first];
+    attributes.gender_confidence = gender.second;
+    attributes.age_group = AGE_GROUPS[age.first];
+    attributes.age_confidence = age.second;
+    attributes.quality_score = it->second.bestQuality;
+    attributes.track_id = trackId;
+    return true;
+}
+
+PersonAttributeStats PersonAttributeCache::getStats() const {
+    PersonAttributeStats stats;
+    stats.persons = m_persons.load();
+    stats.analysed = m_analysed.load();
+    stats.hitRate = stats.persons > 0
+        ? 1.0 - static_cast<double>(std::min(stats.analysed, stats.persons)) / stats.persons : 0.0;
+    stats.tracks = m_trackCount.load();
+    stats.confidentTracks = m_confidentCount.load();
+    return stats;
+}
+
+float PersonAttributeCache::cropQuality(const cv::Rect& box, const cv::Size& frameSize) {
+    if (box.width <= 0 || box.height <= 0) {
+        return 0.0f;
+    }
+
+    float size = std::min(1.0f, box.height / REFERENCE_HEIGHT);
+    float aspect = static_cast<float>(box.width) / box.height;
+    float shape = std::max(0.2f, 1.0f - std::abs(aspect - PERSON_ASPECT) / PERSON_ASPECT);
+    bool cut = box.x <= 0 || box.y <= 0 ||
+               box.x + box.width >= frameSize.width || box.y + box.height >= frameSize.height;
+    return size * shape * (cut ? 0.5f : 1.0f);
+}
+
+} // namespace AISecurityVision
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+namespace AISecurityVision {
+
+struct PersonAttributes;
+
+/**
+ * @brief Person attribute analysis counters
+ */
+struct PersonAttributeStats {
+    uint64_t persons = 0;           // Person observations
+    uint64_t analysed = 0;          // Crops sent to the age/gender analyzer
+    double hitRate = 0.0;           // Share of observations served without analysis
+    size_t tracks = 0;
+    size_t confidentTracks = 0;     // Tracks no longer analysed
+};
+
+/**
+ * @brief Per-track age/gender attribute cache with best-shot selection
+ *
+ * Age and gender of a tracked person do not change between frames, so each
+ * analysis is accumulated into the track's label scores (weighted by the
+ * analyzer confidence and the crop quality) and the track reports the leading
+ * labels. A track is analysed again only for a better shot (crop quality up
+ * by QUALITY_GAIN over the best analysed one), or every RETRY_FRAMES with a
+ * comparable shot while its labels are still uncertain; once they are
+ * confident (or MAX_ATTEMPTS analyses were spent) it is never analysed again.
+ * Untracked persons (track ID < 0) are always analysed.
+ *
+ * Not thread-safe: one instance per pipeline, used by the output stage;
+ * the counters may be read from any thread.
+ */
+class PersonAttributeCache {
+public:
+    /**
+     * @brief Start a frame: ages out tracks not seen for RETENTION_FRAMES
+     */
+    void beginFrame();
+
+    /**
+     * @brief Whether this frame's crop of a person should be analysed
+     * @param quality Crop quality from cropQuality()
+     */
+    bool wantsAnalysis(int trackId, float quality);
+
+    /**
+     * @brief Fold an analysis result (valid or not) into the track
+     */
+    void update(int trackId, const PersonAttributes& attributes, float quality);
+
+    /**
+     * @brief Accumulated attributes of a track
+     * @return false if the track has no valid analysis yet; attributes is left unchanged
+     */
+    bool lookup(int trackId, PersonAttributes& attributes) const;
+
+    PersonAttributeStats getStats() const;
+
+    /**
+     * @brief Suitability of a person box for attribute analysis, 0..1
+     *
+     * Favours tall boxes with an upright-person aspect ratio; boxes cut by the
+     * frame border score half.
+     */
+    static float cropQuality(const cv::Rect& box, const cv::Size& frameSize);
+
+    static constexpr float QUALITY_GAIN = 1.2f;
+    static constexpr float RETRY_QUALITY = 0.9f;        // Retry shots must reach this share of the best one
+    static constexpr int RETRY_FRAMES = 15;
+    static constexpr int MIN_SAMPLES = 3;
+    static constexpr int MAX_SAMPLES = 8;
+    static constexpr int MAX_ATTEMPTS = 12;
+    static constexpr float CONFIDENT_SHARE = 0.8f;      // Leading label's share of the accumulated score
+    static constexpr int RETENTION_FRAMES = 90;
+    static constexpr float REFERENCE_HEIGHT = 256.0f;   // Box height with full size quality
+    static constexpr float PERSON_ASPECT = 0.4f;        // Width / height of an upright person
+
+private:
+    struct Entry {
+        std::array<float, 2> gender{};  // male, female
+        std::array<float, 4> age{};     // child, young, middle, senior
+        int samples = 0;                // Valid analyses
+        int attempts = 0;
+        float bestQuality = 0.0f;
+        uint64_t analysedFrame = 0;
+        uint64_t seenFrame = 0;
+        bool confident = false;
+    };
+
+    std::unordered_map<int, Entry> m_entries;
+    uint64_t m_frame = 0;
+
+    std::atomic<uint64_t> m_persons{0};
+    std::atomic<uint64_t> m_analysed{0};
+    std::atomic<size_t> m_trackCount{0};
+    std::atomic<size_t> m_confidentCount{0};
+};
+
+} // namespace AISecurityVision
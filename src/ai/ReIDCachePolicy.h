@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AISecurityVision {
+
+/**
+ * @brief When a track's cached ReID embedding is reused instead of re-extracted
+ *
+ * A detection reuses the embedding of the track it continues unless:
+ *  - refreshFrames detection frames have passed since the track's last extraction
+ *  - its box area or aspect ratio changed by more than sizeChange / aspectChange
+ *    since that extraction (pose, occlusion, distance)
+ *  - it is at risk of an identity switch: another track is within
+ *    proximityMargin box sizes, or the track was lost and recovered during
+ *    the last recoveryFrames frames
+ * refreshFrames = 0 disables the cache (every detection is extracted).
+ */
+struct ReIDCachePolicy {
+    int refreshFrames = 10;
+    float sizeChange = 0.25f;       // Relative area change
+    float aspectChange = 0.15f;     // Relative width/height change
+    float proximityMargin = 0.25f;  // Detection box grown by this fraction per side
+    int recoveryFrames = 3;
+    float emaAlpha = 0.3f;          // Weight of a fresh extraction in the track embedding
+    int retentionFrames = 30;       // Entries of vanished tracks are kept this long
+};
+
+/**
+ * @brief ReID cache counters
+ */
+struct ReIDCacheStats {
+    uint64_t lookups = 0;           // Detections that needed an embedding
+    uint64_t hits = 0;              // Served from the cache
+    double hitRate = 0.0;
+    double avgExtractionMs = 0.0;   // Per crop
+    double savedMs = 0.0;           // Estimated extraction time avoided
+    size_t entries = 0;
+};
+
+} // namespace AISecurityVision
@@ -0,0 +1,226 @@
+#include "ReIDEmbeddingCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AISecurityVision {
+
+namespace {
+
+float iou(const cv::Rect& a, const cv::Rect& b) {
+    int intersection = (a & b).area();
+    int unionArea = a.area() + b.area() - intersection;
+    return unionArea > 0 ? static_cast<float>(intersection) / unionArea : 0.0f;
+}
+
+float relativeChange(float current, float reference) {
+    return reference > 0.0f ? std::abs(current - reference) / reference : 1.0f;
+}
+
+void normalize(std::vector<float>& features) {
+    float norm = 0.0f;
+    for (float value : features) {
+        norm += value * value;
+    }
+    if (norm > 0.0f) {
+        float inverse = 1.0f / std::sqrt(norm);
+        for (float& value : features) {
+            value *= inverse;
+        }
+    }
+}
+
+} // namespace
+
+ReIDEmbeddingCache::ReIDEmbeddingCache()
+    : m_policy(std::make_shared<const ReIDCachePolicy>()) {
+}
+
+void ReIDEmbeddingCache::setPolicy(const ReIDCachePolicy& policy) {
+    ReIDCachePolicy sanitized = policy;
+    sanitized.refreshFrames = std::max(0, sanitized.refreshFrames);
+    sanitized.recoveryFrames = std::max(0, sanitized.recoveryFrames);
+    sanitized.retentionFrames = std::max(1, sanitized.retentionFrames);
+    sanitized.emaAlpha = std::min(1.0f, std::max(0.0f, sanitized.emaAlpha));
+    std::atomic_store(&m_policy, std::shared_ptr<const ReIDCachePolicy>(
+        std::make_shared<ReIDCachePolicy>(sanitized)));
+}
+
+ReIDCachePolicy ReIDEmbeddingCache::getPolicy() const {
+    return *std::atomic_load(&m_policy);
+}
+
+void ReIDEmbeddingCache::matchTracks(const std::vector<cv::Rect>& detections, const std::vector<int>& classIds,
+                                     const TrackList& tracks, float minIoU, bool updatedOnly) {
+    m_pairs.clear();
+    for (size_t d = 0; d < detections.size(); ++d) {
+        for (size_t t = 0; t < tracks.size(); ++t) {
+            const auto& track = *tracks[t];
+            if ((updatedOnly && track.framesSinceUpdate != 0) ||
+                (d < classIds.size() && classIds[d] != track.classId)) {
+                continue;
+            }
+            float overlap = iou(detections[d], track.bbox);
+            if (overlap >= minIoU) {
+                m_pairs.push_back({overlap, {d, t}});
+            }
+        }
+    }
+    std::sort(m_pairs.begin(), m_pairs.end(),
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    m_detectionTrack.assign(detections.size(), -1);
+    std::vector<bool> trackTaken(tracks.size(), false);
+    for (const auto& pair : m_pairs) {
+        size_t d = pair.second.first;
+        size_t t = pair.second.second;
+        if (m_detectionTrack[d] < 0 && !trackTaken[t]) {
+            m_detectionTrack[d] = static_cast<int>(t);
+            trackTaken[t] = true;
+        }
+    }
+}
+
+bool ReIDEmbeddingCache::needsExtraction(const Entry& entry, const cv::Rect& box, size_t detection,
+                                         const std::vector<cv::Rect>& detections, const TrackList& tracks,
+                                         const ReIDCachePolicy& policy) const {
+    if (entry.features.empty() || m_frame - entry.extractedFrame >= static_cast<uint64_t>(policy.refreshFrames)) {
+        return true;
+    }
+
+    // Appearance changed: the crop now shows the object differently
+    const cv::Rect& reference = entry.extractedBox;
+    if (relativeChange(static_cast<float>(box.area()), static_cast<float>(reference.area())) > policy.sizeChange) {
+        return true;
+    }
+    float aspect = box.height > 0 ? static_cast<float>(box.width) / box.height : 0.0f;
+    float referenceAspect = reference.height > 0 ? static_cast<float>(reference.width) / reference.height : 0.0f;
+    if (relativeChange(aspect, referenceAspect) > policy.aspectChange) {
+        return true;
+    }
+
+    // Identity at risk: recently recovered, or close enough to another object to be swapped with it
+    if (entry.hasRecovered && m_frame - entry.recoveredFrame < static_cast<uint64_t>(policy.recoveryFrames)) {
+        return true;
+    }
+    int mx = static_cast<int>(box.width * policy.proximityMargin);
+    int my = static_cast<int>(box.height * policy.proximityMargin);
+    cv::Rect neighbourhood(box.x - mx, box.y - my, box.width + 2 * mx, box.height + 2 * my);
+    const int own = m_detectionTrack[detection];
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        if (static_cast<int>(t) != own && (neighbourhood & tracks[t]->bbox).area() > 0) {
+            return true;
+        }
+    }
+    for (size_t d = 0; d < detections.size(); ++d) {
+        if (d != detection && (neighbourhood & detections[d]).area() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<size_t>& ReIDEmbeddingCache::plan(const std::vector<cv::Rect>& detections,
+                                                    const std::vector<int>& classIds,
+                                                    const TrackList& tracks,
+                                                    std::vector<std::vector<float>>& features) {
+    auto policy = std::atomic_load(&m_policy);
+    ++m_frame;
+    m_extract.clear();
+    m_extractedNow.assign(detections.size(), false);
+    features.assign(detections.size(), std::vector<float>());
+
+    if (policy->refreshFrames > 0) {
+        matchTracks(detections, classIds, tracks, MATCH_IOU, false);
+    } else {
+        m_detectionTrack.assign(detections.size(), -1);
+    }
+
+    for (size_t d = 0; d < detections.size(); ++d) {
+        bool extract = true;
+        if (m_detectionTrack[d] >= 0) {
+            auto entry = m_entries.find(tracks[m_detectionTrack[d]]->trackId);
+            if (entry != m_entries.end() &&
+                !needsExtraction(entry->second, detections[d], d, detections, tracks, *policy)) {
+                features[d] = entry->second.features;
+                extract = false;
+            }
+        }
+        if (extract) {
+            m_extract.push_back(d);
+            m_extractedNow[d] = true;
+        }
+    }
+
+    m_lookups.fetch_add(detections.size());
+    m_hits.fetch_add(detections.size() - m_extract.size());
+    return m_extract;
+}
+
+void ReIDEmbeddingCache::recordExtraction(size_t crops, double elapsedMs) {
+    if (crops == 0) {
+        return;
+    }
+    double perCrop = elapsedMs / crops;
+    double average = m_extractionMs.load();
+    m_extractionMs.store(average > 0.0 ? average + EXTRACTION_EMA_ALPHA * (perCrop - average) : perCrop);
+}
+
+void ReIDEmbeddingCache::commit(const std::vector<cv::Rect>& detections,
+                                const std::vector<int>& classIds,
+                                const std::vector<std::vector<float>>& features,
+                                const TrackList& tracks) {
+    auto policy = std::atomic_load(&m_policy);
+
+    // Tracks updated this frame carry their detection's box exactly
+    matchTracks(detections, classIds, tracks, 0.5f, true);
+    for (size_t d = 0; d < detections.size() && d < features.size(); ++d) {
+        if (m_detectionTrack[d] < 0) {
+            continue;
+        }
+
+        Entry& entry = m_entries[tracks[m_detectionTrack[d]]->trackId];
+        if (entry.seenFrame > 0 && entry.seenFrame + 1 < m_frame) {
+            entry.recoveredFrame = m_frame;
+            entry.hasRecovered = true;
+        }
+        entry.seenFrame = m_frame;
+
+        if (d >= m_extractedNow.size() || !m_extractedNow[d] || features[d].empty()) {
+            continue;
+        }
+        if (entry.features.size() != features[d].size()) {
+            entry.features = features[d];
+        } else {
+            const float alpha = policy->emaAlpha;
+            for (size_t i = 0; i < entry.features.size(); ++i) {
+                entry.features[i] += alpha * (features[d][i] - entry.features[i]);
+            }
+        }
+        normalize(entry.features);
+        entry.extractedBox = detections[d];
+        entry.extractedFrame = m_frame;
+    }
+
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (m_frame - it->second.seenFrame > static_cast<uint64_t>(policy->retentionFrames)) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_entryCount.store(m_entries.size());
+}
+
+ReIDCacheStats ReIDEmbeddingCache::getStats() const {
+    ReIDCacheStats stats;
+    stats.lookups = m_lookups.load();
+    stats.hits = m_hits.load();
+    stats.hitRate = stats.lookups > 0 ? static_cast<double>(stats.hits) / stats.lookups : 0.0;
+    stats.avgExtractionMs = m_extractionMs.load();
+    stats.savedMs = stats.hits * stats.avgExtractionMs;
+    stats.entries = m_entryCount.load();
+    return stats;
+}
+
+} // namespace AISecurityVision
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+
+#include "ReIDCachePolicy.h"
+#include "ByteTracker.h"
+
+namespace AISecurityVision {
+
+/**
+ * @brief Per-track ReID embedding cache
+ *
+ * Embeddings are needed before the tracker update (they feed the association)
+ * while track IDs are only known after it. plan() therefore matches the
+ * detections to the tracks' last boxes by IoU to decide which detections
+ * reuse their track's embedding; commit() matches the updated tracks to the
+ * detections that updated them and folds fresh extractions into the track's
+ * embedding as an exponential moving average (renormalised).
+ *
+ * Not thread-safe: one instance per pipeline, used by the analytics stage;
+ * the counters may be read from any thread.
+ */
+class ReIDEmbeddingCache {
+public:
+    using TrackList = std::vector<std::shared_ptr<ByteTracker::Track>>;
+
+    ReIDEmbeddingCache();
+
+    void setPolicy(const ReIDCachePolicy& policy);
+    ReIDCachePolicy getPolicy() const;
+
+    /**
+     * @brief Choose the detections to extract and serve the others from the cache
+     * @param tracks Active tracks before the tracker update
+     * @param features Resized to the detections; cached embeddings are filled in
+     * @return Indices of the detections whose embedding must be extracted
+     */
+    const std::vector<size_t>& plan(const std::vector<cv::Rect>& detections,
+                                    const std::vector<int>& classIds,
+                                    const TrackList& tracks,
+                                    std::vector<std::vector<float>>& features);
+
+    /**
+     * @brief Record the time spent extracting the planned crops
+     */
+    void recordExtraction(size_t crops, double elapsedMs);
+
+    /**
+     * @brief Store this frame's embeddings with the tracks they updated
+     * @param features All detections' embeddings (fresh or cached)
+     * @param tracks Active tracks after the tracker update
+     */
+    void commit(const std::vector<cv::Rect>& detections,
+                const std::vector<int>& classIds,
+                const std::vector<std::vector<float>>& features,
+                const TrackList& tracks);
+
+    ReIDCacheStats getStats() const;
+
+    static constexpr float MATCH_IOU = 0.3f;
+    static constexpr double EXTRACTION_EMA_ALPHA = 0.1;
+
+private:
+    struct Entry {
+        std::vector<float> features;    // EMA of the extractions, unit length
+        cv::Rect extractedBox;          // Box of the last extraction
+        uint64_t extractedFrame = 0;
+        uint64_t seenFrame = 0;
+        uint64_t recoveredFrame = 0;    // Last reappearance after a gap, 0 = never
+        bool hasRecovered = false;
+    };
+
+    // Greedy one-to-one IoU matching of detections to track boxes (same class)
+    void matchTracks(const std::vector<cv::Rect>& detections, const std::vector<int>& classIds,
+                     const TrackList& tracks, float minIoU, bool updatedOnly);
+    bool needsExtraction(const Entry& entry, const cv::Rect& box, size_t detection,
+                         const std::vector<cv::Rect>& detections, const TrackList& tracks,
+                         const ReIDCachePolicy& policy) const;
+
+    std::shared_ptr<const ReIDCachePolicy> m_policy;
+
+    std::unordered_map<int, Entry> m_entries;
+    uint64_t m_frame = 0;
+    std::vector<size_t> m_extract;
+    std::vector<bool> m_extractedNow;   // Per detection of the current frame
+    std::vector<int> m_detectionTrack;  // Matched track index per detection, -1 = none
+    std::vector<std::pair<float, std::pair<size_t, size_t>>> m_pairs;
+
+    std::atomic<uint64_t> m_lookups{0};
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<double> m_extractionMs{0.0};
+    std::atomic<size_t> m_entryCount{0};
+};
+
+} // namespace AISecurityVision
@@ -16,6 +16,8 @@ ReIDExtractor::ReIDExtractor()
     , m_stream(nullptr)
     , m_inputBuffer(nullptr)
     , m_outputBuffer(nullptr)
+    , m_networkLoaded(false)
+    , m_maxBatchSize(1)
     , m_initialized(false)
     , m_normalizationEnabled(true)
     , m_inputWidth(128)
@@ -41,21 +43,35 @@ bool ReIDExtractor::initialize(const std::string& modelPath) {
 
     try {
         m_modelPath = modelPath;
+        m_networkLoaded = false;
 
-        // Always use built-in feature extraction to avoid protobuf dependency issues
-        LOG_INFO() << "[ReIDExtractor] Using built-in feature extraction (protobuf-free)";
-
-        // Check if model file exists (for logging purposes only)
+#ifndef DISABLE_OPENCV_DNN
+        // Any torchreid ONNX export works (ResNet50, OSNet); the feature
+        // dimension is taken from the network's output
         std::ifstream modelFile(modelPath);
         if (modelFile.good()) {
-            LOG_INFO() << "[ReIDExtractor] Model file found but using built-in extraction for compatibility";
+            try {
+                m_net = cv::dnn::readNetFromONNX(modelPath);
+                if (!m_net.empty()) {
+                    m_net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+                    m_net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+                    m_networkLoaded = probeBatchSize();
+                }
+            } catch (const cv::Exception& e) {
+                LOG_ERROR() << "[ReIDExtractor] Failed to load ReID model " << modelPath << ": " << e.what();
+            }
         } else {
-            LOG_INFO() << "[ReIDExtractor] Model file not found, using built-in feature extraction";
+            LOG_INFO() << "[ReIDExtractor] Model file not found";
         }
+#else
+        LOG_INFO() << "[ReIDExtractor] Built with DISABLE_OPENCV_DNN";
+#endif
 
-        // Skip OpenCV DNN loading to avoid protobuf dependency issues
-        // This prevents the hanging issue during initialization
-        LOG_INFO() << "[ReIDExtractor] Skipping OpenCV DNN to avoid protobuf dependency issues";
+        if (m_networkLoaded) {
+            LOG_INFO() << "[ReIDExtractor] Using OpenCV DNN (CPU), batches of up to " << m_maxBatchSize << " crops";
+        } else {
+            LOG_INFO() << "[ReIDExtractor] Using built-in hand-crafted feature extraction";
+        }
 
         // Calculate buffer sizes
         m_inputSize = m_inputWidth * m_inputHeight * 3 * sizeof(float);
@@ -76,6 +92,11 @@ bool ReIDExtractor::initialize(const std::string& modelPath) {
 
 void ReIDExtractor::cleanup() {
     deallocateBuffers();
+#ifndef DISABLE_OPENCV_DNN
+    m_net = cv::dnn::Net();
+#endif
+    m_networkLoaded = false;
+    m_blob.release();
     m_initialized = false;
     LOG_INFO() << "[ReIDExtractor] Cleanup completed";
 }
@@ -99,38 +120,37 @@ std::vector<ReIDExtractor::ReIDEmbedding> ReIDExtractor::extractFeatures(
         return embeddings;
     }
 
-    // Ensure all vectors have the same size
-    size_t numDetections = detections.size();
-    std::vector<int> actualTrackIds = trackIds;
-    std::vector<int> actualClassIds = classIds;
-    std::vector<float> actualConfidences = confidences;
-
-    // Fill missing data with defaults
-    if (actualTrackIds.size() != numDetections) {
-        actualTrackIds.resize(numDetections, -1);
-    }
-    if (actualClassIds.size() != numDetections) {
-        actualClassIds.resize(numDetections, 0);
-    }
-    if (actualConfidences.size() != numDetections) {
-        actualConfidences.resize(numDetections, 1.0f);
-    }
-
-    // Extract features for each detection
-    for (size_t i = 0; i < numDetections; ++i) {
-        const cv::Rect& bbox = detections[i];
-
-        // Validate detection
-        if (!isValidDetection(bbox)) {
+    // Crops of all valid detections, extracted as one batch
+    std::vector<size_t> indices;
+    std::vector<cv::Mat> crops;
+    for (size_t i = 0; i < detections.size(); ++i) {
+        if (!isValidDetection(detections[i])) {
             continue;
         }
+        cv::Mat roi = extractROI(frame, detections[i]);
+        if (!roi.empty()) {
+            indices.push_back(i);
+            crops.push_back(roi);
+        }
+    }
+
+    std::vector<std::vector<float>> features;
+    extractCrops(crops, features);
 
-        // Extract single feature
-        ReIDEmbedding embedding = extractSingleFeature(
-            frame, bbox, actualTrackIds[i], actualClassIds[i], actualConfidences[i]);
+    int64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (size_t k = 0; k < indices.size(); ++k) {
+        size_t i = indices[k];
+        ReIDEmbedding embedding;
+        embedding.trackId = i < trackIds.size() ? trackIds[i] : -1;
+        embedding.classId = i < classIds.size() ? classIds[i] : 0;
+        embedding.bbox = detections[i];
+        embedding.confidence = i < confidences.size() ? confidences[i] : 1.0f;
+        embedding.timestamp = timestamp;
+        embedding.features = std::move(features[k]);
 
         if (embedding.isValid()) {
-            embeddings.push_back(embedding);
+            embeddings.push_back(std::move(embedding));
         }
     }
 
@@ -144,8 +164,8 @@ std::vector<ReIDExtractor::ReIDEmbedding> ReIDExtractor::extractFeatures(
         m_inferenceTimes.erase(m_inferenceTimes.begin());
     }
 
-    LOG_INFO() << "[ReIDExtractor] Extracted " << embeddings.size()
-              << " embeddings in " << m_inferenceTime << "ms";
+    LOG_DEBUG() << "[ReIDExtractor] Extracted " << embeddings.size()
+               << " embeddings in " << m_inferenceTime << "ms";
 
     return embeddings;
 }
@@ -176,13 +196,9 @@ ReIDExtractor::ReIDEmbedding ReIDExtractor::extractSingleFeature(
             return embedding;
         }
 
-        // Extract features from ROI
-        embedding.features = extractFeaturesFromROI(roi);
-
-        // Normalize features if enabled
-        if (m_normalizationEnabled && !embedding.features.empty()) {
-            embedding.features = normalizeFeatures(embedding.features);
-        }
+        std::vector<std::vector<float>> features;
+        extractCrops({roi}, features);
+        embedding.features = std::move(features.front());
 
     } catch (const std::exception& e) {
         LOG_ERROR() << "[ReIDExtractor] Exception in extractSingleFeature: " << e.what();
@@ -191,24 +207,113 @@ ReIDExtractor::ReIDEmbedding ReIDExtractor::extractSingleFeature(
     return embedding;
 }
 
-std::vector<float> ReIDExtractor::extractFeaturesFromROI(const cv::Mat& roi) {
-    std::vector<float> features;
+void ReIDExtractor::extractCrops(const std::vector<cv::Mat>& crops, std::vector<std::vector<float>>& features) {
+    features.assign(crops.size(), std::vector<float>());
 
-    if (roi.empty()) {
-        return features;
+    for (size_t begin = 0; begin < crops.size();) {
+        size_t count = m_networkLoaded ? std::min(crops.size() - begin, static_cast<size_t>(m_maxBatchSize)) : 1;
+        if (!m_networkLoaded || !runNetwork(crops, begin, count, features)) {
+            for (size_t i = begin; i < begin + count; ++i) {
+                features[i] = generateHandcraftedFeatures(crops[i]);
+            }
+        }
+        begin += count;
+    }
+
+    if (m_normalizationEnabled) {
+        for (auto& feature : features) {
+            if (!feature.empty()) {
+                feature = normalizeFeatures(feature);
+            }
+        }
+    }
+}
+
+bool ReIDExtractor::runNetwork(const std::vector<cv::Mat>& crops, size_t begin, size_t count,
+                               std::vector<std::vector<float>>& features) {
+#ifndef DISABLE_OPENCV_DNN
+    const int blobShape[] = {m_maxBatchSize, 3, m_inputHeight, m_inputWidth};
+    if (m_blob.dims != 4 || m_blob.size[0] != m_maxBatchSize ||
+        m_blob.size[2] != m_inputHeight || m_blob.size[3] != m_inputWidth) {
+        m_blob.create(4, blobShape, CV_32F);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        fillBlob(crops[begin + i], static_cast<int>(i));
     }
 
+    // The first count slots of the blob, without copying
+    const int inputShape[] = {static_cast<int>(count), 3, m_inputHeight, m_inputWidth};
+    cv::Mat input(4, inputShape, CV_32F, m_blob.ptr<float>());
+
     try {
-        // Always use hand-crafted features to avoid protobuf dependency issues
-        features = generateHandcraftedFeatures(roi);
+        m_net.setInput(input);
+        cv::Mat output = m_net.forward();
+        cv::Mat rows = output.reshape(1, static_cast<int>(count));
+        for (size_t i = 0; i < count; ++i) {
+            features[begin + i] = postprocessFeatures(rows.row(static_cast<int>(i)));
+        }
+    } catch (const cv::Exception& e) {
+        LOG_ERROR() << "[ReIDExtractor] Inference failed: " << e.what();
+        return false;
+    }
+    return true;
+#else
+    (void)crops;
+    (void)begin;
+    (void)count;
+    (void)features;
+    return false;
+#endif
+}
 
-    } catch (const std::exception& e) {
-        LOG_ERROR() << "[ReIDExtractor] Exception in extractFeaturesFromROI: " << e.what();
-        // Fallback to hand-crafted features
-        features = generateHandcraftedFeatures(roi);
+void ReIDExtractor::fillBlob(const cv::Mat& crop, int slot) {
+    // Plain resize (ReID models are trained on stretched crops), then BGR to
+    // planar RGB with the mean / std folded into one multiply-add per value
+    cv::resize(crop, m_resized, cv::Size(m_inputWidth, m_inputHeight), 0, 0, cv::INTER_LINEAR);
+
+    float scale[3], bias[3];
+    for (int c = 0; c < 3; ++c) {
+        scale[c] = 1.0f / (255.0f * STD_RGB[c]);
+        bias[c] = -MEAN_RGB[c] / STD_RGB[c];
     }
 
-    return features;
+    float* r = m_blob.ptr<float>(slot, 0);
+    float* g = m_blob.ptr<float>(slot, 1);
+    float* b = m_blob.ptr<float>(slot, 2);
+    for (int y = 0; y < m_inputHeight; ++y) {
+        const uchar* bgr = m_resized.ptr<uchar>(y);
+        const int offset = y * m_inputWidth;
+        for (int x = 0; x < m_inputWidth; ++x) {
+            b[offset + x] = bgr[3 * x] * scale[2] + bias[2];
+            g[offset + x] = bgr[3 * x + 1] * scale[1] + bias[1];
+            r[offset + x] = bgr[3 * x + 2] * scale[0] + bias[0];
+        }
+    }
+}
+
+bool ReIDExtractor::probeBatchSize() {
+#ifndef DISABLE_OPENCV_DNN
+    // Models exported with a fixed batch dimension only accept one crop per forward
+    for (int batch : {2, 1}) {
+        const int shape[] = {batch, 3, m_inputHeight, m_inputWidth};
+        cv::Mat probe(4, shape, CV_32F, cv::Scalar(0.0f));
+        try {
+            m_net.setInput(probe);
+            cv::Mat output = m_net.forward();
+            int dimension = static_cast<int>(output.total() / batch);
+            if (dimension <= 0) {
+                return false;
+            }
+            m_featureDimension = dimension;
+            m_maxBatchSize = batch > 1 ? MAX_BATCH_SIZE : 1;
+            return true;
+        } catch (const cv::Exception& e) {
+            LOG_DEBUG() << "[ReIDExtractor] Batch " << batch << " rejected by the model: " << e.what();
+        }
+    }
+#endif
+    return false;
 }
 
 std::vector<float> ReIDExtractor::generateHandcraftedFeatures(const cv::Mat& roi) {
@@ -218,125 +323,117 @@ std::vector<float> ReIDExtractor::generateHandcraftedFeatures(const cv::Mat& roi
         return features;
     }
 
+    // Appends an L2-normalised histogram if `reserve` features are still free
+    int featureIdx = 0;
+    auto append = [&features, &featureIdx, this](const float* hist, int bins, int reserve) {
+        if (featureIdx >= m_featureDimension - reserve) {
+            return;
+        }
+        float norm = 0.0f;
+        for (int i = 0; i < bins; ++i) {
+            norm += hist[i] * hist[i];
+        }
+        float inverse = norm > 0.0f ? 1.0f / std::sqrt(norm) : 0.0f;
+        for (int i = 0; i < bins && featureIdx < m_featureDimension; ++i) {
+            features[featureIdx++] = hist[i] * inverse;
+        }
+    };
+
     try {
         // Resize ROI to standard size
-        cv::Mat resized;
-        cv::resize(roi, resized, cv::Size(m_inputWidth, m_inputHeight));
-
-        // Convert to different color spaces for feature extraction
-        cv::Mat hsv, lab, gray;
-        cv::cvtColor(resized, hsv, cv::COLOR_BGR2HSV);
-        cv::cvtColor(resized, lab, cv::COLOR_BGR2Lab);
-        cv::cvtColor(resized, gray, cv::COLOR_BGR2GRAY);
-
-        int featureIdx = 0;
-
-        // Color histogram features (RGB, HSV, Lab)
-        std::vector<cv::Mat> channels;
-
-        // BGR histogram
-        cv::split(resized, channels);
-        for (int c = 0; c < 3 && featureIdx < m_featureDimension - 16; ++c) {
-            cv::Mat hist;
-            int histSize = 16;
-            float range[] = {0, 256};
-            const float* histRange = {range};
-            cv::calcHist(&channels[c], 1, 0, cv::Mat(), hist, 1, &histSize, &histRange);
-            cv::normalize(hist, hist, 0, 1, cv::NORM_L2);
-
-            for (int i = 0; i < histSize && featureIdx < m_featureDimension; ++i) {
-                features[featureIdx++] = hist.at<float>(i);
+        cv::resize(roi, m_resized, cv::Size(m_inputWidth, m_inputHeight));
+        cv::cvtColor(m_resized, m_hsv, cv::COLOR_BGR2HSV);
+        cv::cvtColor(m_resized, m_gray, cv::COLOR_BGR2GRAY);
+
+        // Colour histograms (BGR, HSV; 16 bins each) in one pass over the packed
+        // pixels instead of a split() and a calcHist() per channel
+        constexpr int COLOR_BINS = 16;
+        float color[6][COLOR_BINS] = {};
+        for (int y = 0; y < m_resized.rows; ++y) {
+            const uchar* bgr = m_resized.ptr<uchar>(y);
+            const uchar* hsv = m_hsv.ptr<uchar>(y);
+            for (int x = 0; x < 3 * m_resized.cols; x += 3) {
+                color[0][bgr[x] >> 4] += 1.0f;
+                color[1][bgr[x + 1] >> 4] += 1.0f;
+                color[2][bgr[x + 2] >> 4] += 1.0f;
+                color[3][hsv[x] * COLOR_BINS / 180] += 1.0f;   // Hue range is 0-180
+                color[4][hsv[x + 1] >> 4] += 1.0f;
+                color[5][hsv[x + 2] >> 4] += 1.0f;
             }
         }
-
-        // HSV histogram
-        cv::split(hsv, channels);
-        for (int c = 0; c < 3 && featureIdx < m_featureDimension - 16; ++c) {
-            cv::Mat hist;
-            int histSize = 16;
-            float range[] = {0.0f, c == 0 ? 180.0f : 256.0f}; // Hue range is 0-180
-            const float* histRange = {range};
-            cv::calcHist(&channels[c], 1, 0, cv::Mat(), hist, 1, &histSize, &histRange);
-            cv::normalize(hist, hist, 0, 1, cv::NORM_L2);
-
-            for (int i = 0; i < histSize && featureIdx < m_featureDimension; ++i) {
-                features[featureIdx++] = hist.at<float>(i);
-            }
+        for (int h = 0; h < 6; ++h) {
+            append(color[h], COLOR_BINS, COLOR_BINS);
         }
 
-        // Texture features using LBP (Local Binary Patterns)
+        // Texture features using LBP (Local Binary Patterns), 32 bins
         if (featureIdx < m_featureDimension - 32) {
-            cv::Mat lbp = computeLBP(gray);
-            cv::Mat hist;
-            int histSize = 32;
-            float range[] = {0, 256};
-            const float* histRange = {range};
-            cv::calcHist(&lbp, 1, 0, cv::Mat(), hist, 1, &histSize, &histRange);
-            cv::normalize(hist, hist, 0, 1, cv::NORM_L2);
-
-            for (int i = 0; i < histSize && featureIdx < m_featureDimension; ++i) {
-                features[featureIdx++] = hist.at<float>(i);
+            computeLBP(m_gray, m_lbp);
+            float texture[32] = {};
+            for (int y = 0; y < m_lbp.rows; ++y) {
+                const uchar* code = m_lbp.ptr<uchar>(y);
+                for (int x = 0; x < m_lbp.cols; ++x) {
+                    texture[code[x] >> 3] += 1.0f;
+                }
             }
+            append(texture, 32, 32);
         }
 
         // Gradient features (HOG-like)
         if (featureIdx < m_featureDimension - 16) {
-            cv::Mat gradX, gradY, magnitude, angle;
-            cv::Sobel(gray, gradX, CV_32F, 1, 0, 3);
-            cv::Sobel(gray, gradY, CV_32F, 0, 1, 3);
-            cv::cartToPolar(gradX, gradY, magnitude, angle, true);
+            cv::Sobel(m_gray, m_gradX, CV_32F, 1, 0, 3);
+            cv::Sobel(m_gray, m_gradY, CV_32F, 0, 1, 3);
+            cv::cartToPolar(m_gradX, m_gradY, m_magnitude, m_angle, true);
 
             cv::Mat hist;
             int histSize = 16;
             float range[] = {0, 360};
             const float* histRange = {range};
-            cv::calcHist(&angle, 1, 0, cv::Mat(), hist, 1, &histSize, &histRange);
-            cv::normalize(hist, hist, 0, 1, cv::NORM_L2);
-
-            for (int i = 0; i < histSize && featureIdx < m_featureDimension; ++i) {
-                features[featureIdx++] = hist.at<float>(i);
-            }
+            cv::calcHist(&m_angle, 1, 0, cv::Mat(), hist, 1, &histSize, &histRange);
+            append(hist.ptr<float>(), histSize, histSize);
         }
 
-        // Fill remaining features with spatial information
-        while (featureIdx < m_featureDimension) {
-            features[featureIdx] = static_cast<float>(featureIdx) / m_featureDimension;
-            featureIdx++;
-        }
+        // Remaining features stay zero, so they do not add to the similarity
 
     } catch (const std::exception& e) {
         LOG_ERROR() << "[ReIDExtractor] Exception in generateHandcraftedFeatures: " << e.what();
-        // Fill with default values
-        for (int i = 0; i < m_featureDimension; ++i) {
-            features[i] = static_cast<float>(i) / m_featureDimension;
-        }
+        std::fill(features.begin(), features.end(), 0.0f);
     }
 
     return features;
 }
 
-cv::Mat ReIDExtractor::computeLBP(const cv::Mat& gray) {
-    cv::Mat lbp = cv::Mat::zeros(gray.size(), CV_8UC1);
+void ReIDExtractor::computeLBP(const cv::Mat& gray, cv::Mat& lbp) {
+    lbp.create(gray.size(), CV_8UC1);
+    if (gray.rows < 3 || gray.cols < 3) {
+        lbp.setTo(0);
+        return;
+    }
+
+    const int cols = gray.cols;
+    std::fill(lbp.ptr<uchar>(0), lbp.ptr<uchar>(0) + cols, 0);
+    std::fill(lbp.ptr<uchar>(gray.rows - 1), lbp.ptr<uchar>(gray.rows - 1) + cols, 0);
 
+    // Branch-free over three row pointers, so the inner loop vectorizes
     for (int i = 1; i < gray.rows - 1; ++i) {
-        for (int j = 1; j < gray.cols - 1; ++j) {
-            uchar center = gray.at<uchar>(i, j);
-            uchar code = 0;
-
-            code |= (gray.at<uchar>(i-1, j-1) >= center) << 7;
-            code |= (gray.at<uchar>(i-1, j) >= center) << 6;
-            code |= (gray.at<uchar>(i-1, j+1) >= center) << 5;
-            code |= (gray.at<uchar>(i, j+1) >= center) << 4;
-            code |= (gray.at<uchar>(i+1, j+1) >= center) << 3;
-            code |= (gray.at<uchar>(i+1, j) >= center) << 2;
-            code |= (gray.at<uchar>(i+1, j-1) >= center) << 1;
-            code |= (gray.at<uchar>(i, j-1) >= center) << 0;
-
-            lbp.at<uchar>(i, j) = code;
+        const uchar* up = gray.ptr<uchar>(i - 1);
+        const uchar* row = gray.ptr<uchar>(i);
+        const uchar* down = gray.ptr<uchar>(i + 1);
+        uchar* out = lbp.ptr<uchar>(i);
+        out[0] = 0;
+        out[cols - 1] = 0;
+
+        for (int j = 1; j < cols - 1; ++j) {
+            const uchar center = row[j];
+            out[j] = static_cast<uchar>(((up[j - 1] >= center) << 7) |
+                                        ((up[j] >= center) << 6) |
+                                        ((up[j + 1] >= center) << 5) |
+                                        ((row[j + 1] >= center) << 4) |
+                                        ((down[j + 1] >= center) << 3) |
+                                        ((down[j] >= center) << 2) |
+                                        ((down[j - 1] >= center) << 1) |
+                                        (row[j - 1] >= center));
         }
     }
-
-    return lbp;
 }
 
 // Cosine similarity implementation for ReIDEmbedding
@@ -344,20 +441,49 @@ float ReIDExtractor::ReIDEmbedding::cosineSimilarity(const ReIDEmbedding& other)
     return ReIDExtractor::computeCosineSimilarity(this->features, other.features);
 }
 
-// Batch processing
+// Batch processing: the crops of all frames are extracted together
 std::vector<std::vector<ReIDExtractor::ReIDEmbedding>> ReIDExtractor::extractBatch(
     const std::vector<cv::Mat>& frames,
     const std::vector<std::vector<cv::Rect>>& detections,
     const std::vector<std::vector<int>>& trackIds) {
 
-    std::vector<std::vector<ReIDEmbedding>> results;
+    std::vector<std::vector<ReIDEmbedding>> results(frames.size());
+    if (!m_initialized) {
+        return results;
+    }
 
-    for (size_t i = 0; i < frames.size(); ++i) {
-        std::vector<int> emptyTrackIds;
-        if (i < trackIds.size()) {
-            results.push_back(extractFeatures(frames[i], detections[i], trackIds[i]));
-        } else {
-            results.push_back(extractFeatures(frames[i], detections[i], emptyTrackIds));
+    std::vector<std::pair<size_t, size_t>> sources;     // (frame, detection) per crop
+    std::vector<cv::Mat> crops;
+    for (size_t f = 0; f < frames.size() && f < detections.size(); ++f) {
+        for (size_t i = 0; i < detections[f].size(); ++i) {
+            if (frames[f].empty() || !isValidDetection(detections[f][i])) {
+                continue;
+            }
+            cv::Mat roi = extractROI(frames[f], detections[f][i]);
+            if (!roi.empty()) {
+                sources.emplace_back(f, i);
+                crops.push_back(roi);
+            }
+        }
+    }
+
+    std::vector<std::vector<float>> features;
+    extractCrops(crops, features);
+
+    int64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (size_t k = 0; k < sources.size(); ++k) {
+        size_t f = sources[k].first;
+        size_t i = sources[k].second;
+        ReIDEmbedding embedding;
+        embedding.trackId = f < trackIds.size() && i < trackIds[f].size() ? trackIds[f][i] : -1;
+        embedding.classId = 0;
+        embedding.bbox = detections[f][i];
+        embedding.confidence = 1.0f;
+        embedding.timestamp = timestamp;
+        embedding.features = std::move(features[k]);
+        if (embedding.isValid()) {
+            results[f].push_back(std::move(embedding));
         }
     }
 
@@ -503,7 +629,8 @@ cv::Mat ReIDExtractor::extractROI(const cv::Mat& frame, const cv::Rect& bbox) {
         return cv::Mat();
     }
 
-    cv::Mat roi = frame(safeBbox).clone();
+    // A view: crops are resized into the network blob or the feature buffers anyway
+    cv::Mat roi = frame(safeBbox);
 
     // Ensure ROI is large enough for feature extraction
     if (!roi.empty() && (roi.cols < 32 || roi.rows < 64)) {
@@ -12,13 +12,14 @@
  * @brief ReID (Re-Identification) feature extractor using pre-trained ResNet50 model
  *
  * This class implements person/object re-identification feature extraction
- * using a pre-trained ResNet50 model optimized for TensorRT inference.
+ * with an ONNX ReID network (ResNet50 or OSNet) run through OpenCV DNN on CPU.
  *
  * Features:
- * - ResNet50-based feature extraction
- * - 128-2048 dimensional embedding vectors
- * - TensorRT optimization support
- * - Batch processing capability
+ * - ResNet50 / OSNet feature extraction
+ * - 128-2048 dimensional embedding vectors (the network's output dimension)
+ * - Batch processing: all crops of a call form one NCHW blob
+ * - Hand-crafted colour/texture features when no network is available
+ *   (model missing, or built with DISABLE_OPENCV_DNN)
  * - Cross-camera tracking preparation
  * - Integration with ByteTracker
  */
@@ -104,8 +105,22 @@ private:
     void* m_inputBuffer;
     void* m_outputBuffer;
 
-    // OpenCV DNN network disabled to avoid protobuf dependency issues
-    // cv::dnn::Net m_net; // Commented out to prevent linking issues
+#ifndef DISABLE_OPENCV_DNN
+    cv::dnn::Net m_net;
+#endif
+    bool m_networkLoaded;
+    int m_maxBatchSize;             // 1 for models exported with a fixed batch
+    cv::Mat m_blob;                 // m_maxBatchSize x 3 x H x W network input, reused
+
+    // Per-crop scratch buffers, reused between crops and calls
+    cv::Mat m_resized;
+    cv::Mat m_hsv;
+    cv::Mat m_gray;
+    cv::Mat m_lbp;
+    cv::Mat m_gradX;
+    cv::Mat m_gradY;
+    cv::Mat m_magnitude;
+    cv::Mat m_angle;
 
     // Configuration
     bool m_initialized;
@@ -138,8 +153,17 @@ private:
     void deallocateBuffers();
 
     // Feature extraction helpers
-    std::vector<float> extractFeaturesFromROI(const cv::Mat& roi);
+    void extractCrops(const std::vector<cv::Mat>& crops, std::vector<std::vector<float>>& features);
+    bool runNetwork(const std::vector<cv::Mat>& crops, size_t begin, size_t count,
+                    std::vector<std::vector<float>>& features);
+    void fillBlob(const cv::Mat& crop, int slot);
+    bool probeBatchSize();
     std::vector<float> generateHandcraftedFeatures(const cv::Mat& roi);
-    cv::Mat computeLBP(const cv::Mat& gray);
+    void computeLBP(const cv::Mat& gray, cv::Mat& lbp);
+
+    // torchreid preprocessing: RGB, ImageNet mean / std
+    static constexpr float MEAN_RGB[3] = {0.485f, 0.456f, 0.406f};
+    static constexpr float STD_RGB[3] = {0.229f, 0.224f, 0.225f};
+    static constexpr int MAX_BATCH_SIZE = 16;
     cv::Mat resizeAndPad(const cv::Mat& image, cv::Size targetSize);
 };
@@ -0,0 +1,153 @@
+#include "RegionInference.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AISecurityVision {
+
+const char* RegionInferencePolicy::modeName(Mode mode) {
+    switch (mode) {
+        case Mode::ROI_CROP: return "roi";
+        case Mode::TILED: return "tiled";
+        default: return "full";
+    }
+}
+
+bool RegionInferencePolicy::parseMode(const std::string& name, Mode& mode) {
+    if (name == "full") {
+        mode = Mode::FULL_FRAME;
+    } else if (name == "roi") {
+        mode = Mode::ROI_CROP;
+    } else if (name == "tiled") {
+        mode = Mode::TILED;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::vector<cv::Rect> RegionInference::planTiles(const cv::Size& frame, int tileSize, float overlap) {
+    overlap = std::min(MAX_TILE_OVERLAP, std::max(0.0f, overlap));
+    const int stride = std::max(1, static_cast<int>(tileSize * (1.0f - overlap)));
+
+    // Tile origins along one axis: the first flush with the start, the last
+    // flush with the end, the others evenly spaced so every overlap is >= the requested one
+    auto origins = [tileSize, stride](int length) {
+        std::vector<int> result;
+        if (length <= tileSize) {
+            result.push_back(0);
+            return result;
+        }
+        int count = (length - tileSize + stride - 1) / stride + 1;
+        for (int i = 0; i < count; ++i) {
+            result.push_back(static_cast<int>(std::lround(static_cast<double>(length - tileSize) * i / (count - 1))));
+        }
+        return result;
+    };
+
+    std::vector<cv::Rect> tiles;
+    for (int y : origins(frame.height)) {
+        for (int x : origins(frame.width)) {
+            tiles.emplace_back(x, y, std::min(tileSize, frame.width), std::min(tileSize, frame.height));
+        }
+    }
+    return tiles;
+}
+
+const std::vector<RegionInference::Region>& RegionInference::prepare(const cv::Mat& frame, const cv::Size& inputSize,
+                                                                     const RegionInferencePolicy& policy,
+                                                                     const cv::Rect& roiBounds) {
+    const cv::Rect bounds(0, 0, frame.cols, frame.rows);
+    std::vector<cv::Rect> areas;
+    bool tiled = false;
+
+    if (policy.mode == RegionInferencePolicy::Mode::ROI_CROP && !roiBounds.empty()) {
+        int margin = std::max(0, policy.roiMargin);
+        cv::Rect area = cv::Rect(roiBounds.x - margin, roiBounds.y - margin,
+                                 roiBounds.width + 2 * margin, roiBounds.height + 2 * margin) & bounds;
+        if (!area.empty() && area.area() < ROI_FULL_FRAME_RATIO * bounds.area()) {
+            areas.push_back(area);
+        }
+    } else if (policy.mode == RegionInferencePolicy::Mode::TILED) {
+        int tileSize = policy.tileSize > 0 ? policy.tileSize : 2 * std::max(inputSize.width, inputSize.height);
+        if (frame.cols > tileSize || frame.rows > tileSize) {
+            areas = planTiles(frame.size(), tileSize, policy.tileOverlap);
+            tiled = true;
+            if (policy.includeFullFrame) {
+                areas.push_back(bounds);
+            }
+        }
+    }
+
+    m_regions.resize(areas.size());
+    for (size_t i = 0; i < areas.size(); ++i) {
+        Region& region = m_regions[i];
+        region.area = areas[i];
+        region.tile = tiled && areas[i] != bounds;
+        letterboxRegion(region, frame, inputSize);
+    }
+    return m_regions;
+}
+
+void RegionInference::letterboxRegion(Region& region, const cv::Mat& frame, const cv::Size& inputSize) {
+    LetterboxInfo info = m_preprocessor.toInterleavedU8(frame(region.area), inputSize, region.input);
+
+    // Shift the padding by the region's scaled offset: (p - pad') / scale = (p - pad) / scale + offset
+    info.x_pad -= region.area.x * info.scale;
+    info.y_pad -= region.area.y * info.scale;
+    region.letterbox = info;
+}
+
+std::vector<Detection> RegionInference::detect(YOLOv8Detector& detector, const cv::Size& frameSize,
+                                               float mergeThreshold) {
+    std::vector<cv::Mat> inputs;
+    inputs.reserve(m_regions.size());
+    for (const auto& region : m_regions) {
+        inputs.push_back(region.input);
+    }
+
+    // At the model input size the backend's letterbox is the identity
+    auto perRegion = detector.detectObjectsBatch(inputs);
+    perRegion.resize(m_regions.size());
+    for (size_t i = 0; i < perRegion.size(); ++i) {
+        YOLOv8Detector::mapFromLetterbox(perRegion[i], m_regions[i].letterbox, frameSize);
+    }
+    return merge(perRegion, frameSize, mergeThreshold);
+}
+
+std::vector<Detection> RegionInference::merge(std::vector<std::vector<Detection>>& perRegion,
+                                              const cv::Size& frameSize, float mergeThreshold) {
+    if (perRegion.size() == 1) {
+        return std::move(perRegion.front());
+    }
+
+    // An object cut by a tile edge is found whole by the neighbouring tile (or
+    // the full-frame pass); cut boxes rank lower so the whole box is kept
+    std::vector<const Detection*> candidates;
+    m_nms.clear();
+    for (size_t i = 0; i < perRegion.size() && i < m_regions.size(); ++i) {
+        const cv::Rect& area = m_regions[i].area;
+        for (const auto& detection : perRegion[i]) {
+            const cv::Rect& box = detection.bbox;
+            bool cut = m_regions[i].tile &&
+                ((box.x <= area.x && area.x > 0) ||
+                 (box.y <= area.y && area.y > 0) ||
+                 (box.br().x >= area.br().x && area.br().x < frameSize.width) ||
+                 (box.br().y >= area.br().y && area.br().y < frameSize.height));
+            m_nms.add(box, cut ? detection.confidence * CUT_EDGE_RANK : detection.confidence, detection.classId);
+            candidates.push_back(&detection);
+        }
+    }
+
+    NonMaxSuppression::Config config;
+    config.iouThreshold = mergeThreshold;
+    config.overlap = NonMaxSuppression::Overlap::IOS;
+
+    std::vector<Detection> merged;
+    for (int index : m_nms.run(config)) {
+        merged.push_back(*candidates[index]);
+    }
+    return merged;
+}
+
+} // namespace AISecurityVision
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+#include "RegionInferencePolicy.h"
+#include "LetterboxPreprocessor.h"
+#include "NonMaxSuppression.h"
+#include "YOLOv8Detector.h"
+
+namespace AISecurityVision {
+
+/**
+ * @brief Runs a detector on the regions selected by a RegionInferencePolicy
+ *
+ * Each region is letterboxed to the model input with the shared
+ * LetterboxPreprocessor. Its LetterboxInfo absorbs the region's offset in the
+ * frame, so YOLOv8Detector::mapFromLetterbox() (and the inference scheduler)
+ * map region detections straight to full-frame coordinates.
+ *
+ * Canvases are reused between frames. Not thread-safe: one instance per
+ * pipeline, used by the inference stage.
+ */
+class RegionInference {
+public:
+    struct Region {
+        cv::Rect area;              // Source-frame rectangle
+        cv::Mat input;              // area letterboxed to the model input
+        LetterboxInfo letterbox;    // Model-input coordinates to full-frame coordinates
+        bool tile = false;          // Part of a tiling; cut edges rank lower when merging
+    };
+
+    /**
+     * @brief Plan and letterbox the regions of a frame
+     * @param roiBounds Bounding box of the active ROIs (ROI_CROP), empty if none
+     * @return Regions to detect on; empty when the whole frame should run as usual
+     */
+    const std::vector<Region>& prepare(const cv::Mat& frame, const cv::Size& inputSize,
+                                       const RegionInferencePolicy& policy, const cv::Rect& roiBounds);
+
+    /**
+     * @brief Detect on the prepared regions as one detector batch
+     * @return Merged detections in full-frame coordinates
+     */
+    std::vector<Detection> detect(YOLOv8Detector& detector, const cv::Size& frameSize, float mergeThreshold);
+
+    /**
+     * @brief Merge per-region detections (full-frame coordinates) with cross-region NMS
+     */
+    std::vector<Detection> merge(std::vector<std::vector<Detection>>& perRegion, const cv::Size& frameSize,
+                                 float mergeThreshold);
+
+    /**
+     * @brief Overlapping tiles covering a frame, evenly spaced along each axis
+     */
+    static std::vector<cv::Rect> planTiles(const cv::Size& frame, int tileSize, float overlap);
+
+    static constexpr float MAX_TILE_OVERLAP = 0.5f;
+    static constexpr double ROI_FULL_FRAME_RATIO = 0.8;    // Larger crops gain too little to bother
+    static constexpr float CUT_EDGE_RANK = 0.5f;            // Ranking weight of boxes touching an inner tile edge
+
+private:
+    void letterboxRegion(Region& region, const cv::Mat& frame, const cv::Size& inputSize);
+
+    LetterboxPreprocessor m_preprocessor;
+    std::vector<Region> m_regions;  // Canvases are reused while the region count stays the same
+    NonMaxSuppression m_nms;
+};
+
+} // namespace AISecurityVision
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Per-camera choice of the frame regions detection runs on
+ *
+ * A high-resolution frame letterboxed whole into the model input shrinks small
+ * objects below what the model can find (a 4K frame into 640x640 is a 6x
+ * downscale). Two modes trade extra inference for resolution where it matters:
+ *  - ROI_CROP: only the bounding box of the active ROIs (plus roiMargin) is
+ *    letterboxed. Objects outside every ROI are not detected, which the
+ *    behaviour rules ignore anyway. Without active ROIs the whole frame runs.
+ *  - TILED: the frame is split into tileSize squares overlapping by
+ *    tileOverlap, all run as one batch and merged with cross-tile NMS.
+ *    Frames that fit in one tile run whole.
+ */
+struct RegionInferencePolicy {
+    enum class Mode {
+        FULL_FRAME,
+        ROI_CROP,
+        TILED
+    };
+
+    Mode mode = Mode::FULL_FRAME;
+    int roiMargin = 32;             // Source pixels kept around the ROI bounding box
+    int tileSize = 0;               // Tile side in source pixels, 0 = twice the model input
+    float tileOverlap = 0.2f;       // Fraction of a tile shared with its neighbour
+    bool includeFullFrame = true;   // TILED: also run the whole frame, for objects larger than a tile
+    float mergeThreshold = 0.6f;    // Cross-tile NMS, intersection over the smaller box
+
+    static const char* modeName(Mode mode);
+    static bool parseMode(const std::string& name, Mode& mode);
+};
+
+/**
+ * @brief Region inference counters
+ */
+struct RegionInferenceStats {
+    std::string mode = "full";
+    uint64_t regionFrames = 0;      // Frames detected on regions instead of the whole frame
+    size_t lastRegionCount = 0;     // Regions of the last such frame
+};
+
+} // namespace AISecurityVision
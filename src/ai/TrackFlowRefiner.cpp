@@ -0,0 +1,116 @@
+#include "TrackFlowRefiner.h"
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace AISecurityVision {
+
+namespace {
+
+const cv::Size LK_WINDOW(15, 15);
+constexpr int LK_LEVELS = 2;
+
+float median(std::vector<float>& values) {
+    auto middle = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+} // namespace
+
+void TrackFlowRefiner::setFrame(const cv::Mat& frame) {
+    if (frame.empty()) {
+        reset();
+        return;
+    }
+
+    std::swap(m_previous, m_current);
+
+    m_scale = std::min(1.0f, static_cast<float>(ANALYSIS_WIDTH) / frame.cols);
+    const cv::Mat* source = &frame;
+    if (m_scale < 1.0f) {
+        cv::Size size(ANALYSIS_WIDTH, std::max(1, static_cast<int>(std::lround(frame.rows * m_scale))));
+        cv::resize(frame, m_scaled, size, 0, 0, cv::INTER_AREA);
+        source = &m_scaled;
+    }
+    if (source->channels() == 1) {
+        source->copyTo(m_current);
+    } else {
+        cv::cvtColor(*source, m_current, source->channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    }
+
+    m_hasPair = !m_previous.empty() && m_previous.size() == m_current.size();
+}
+
+std::vector<cv::Rect> TrackFlowRefiner::refine(const std::vector<cv::Rect>& boxes) {
+    std::vector<cv::Rect> refined(boxes.size());
+    if (!m_hasPair || boxes.empty()) {
+        return refined;
+    }
+
+    // Grid points of every box, scaled to the analysis frame
+    const cv::Rect bounds(0, 0, m_current.cols, m_current.rows);
+    m_scaledBoxes.clear();
+    m_points.clear();
+    for (const auto& box : boxes) {
+        cv::Rect scaled(static_cast<int>(box.x * m_scale), static_cast<int>(box.y * m_scale),
+                        static_cast<int>(box.width * m_scale), static_cast<int>(box.height * m_scale));
+        scaled &= bounds;
+        m_scaledBoxes.push_back(scaled);
+        for (int gy = 0; gy < GRID_POINTS; ++gy) {
+            for (int gx = 0; gx < GRID_POINTS; ++gx) {
+                m_points.emplace_back(scaled.x + (gx + 0.5f) * scaled.width / GRID_POINTS,
+                                      scaled.y + (gy + 0.5f) * scaled.height / GRID_POINTS);
+            }
+        }
+    }
+
+    // Forward, then backward to reject points that did not track consistently
+    cv::calcOpticalFlowPyrLK(m_previous, m_current, m_points, m_forward, m_status, m_error,
+                             LK_WINDOW, LK_LEVELS);
+    cv::calcOpticalFlowPyrLK(m_current, m_previous, m_forward, m_backward, m_backStatus, m_error,
+                             LK_WINDOW, LK_LEVELS);
+
+    constexpr int pointsPerBox = GRID_POINTS * GRID_POINTS;
+    for (size_t b = 0; b < boxes.size(); ++b) {
+        if (m_scaledBoxes[b].width < 2 || m_scaledBoxes[b].height < 2) {
+            continue;
+        }
+
+        m_dx.clear();
+        m_dy.clear();
+        for (size_t i = b * pointsPerBox; i < (b + 1) * pointsPerBox; ++i) {
+            if (!m_status[i] || !m_backStatus[i]) {
+                continue;
+            }
+            cv::Point2f roundTrip = m_backward[i] - m_points[i];
+            if (roundTrip.x * roundTrip.x + roundTrip.y * roundTrip.y > FB_ERROR_PX * FB_ERROR_PX) {
+                continue;
+            }
+            m_dx.push_back(m_forward[i].x - m_points[i].x);
+            m_dy.push_back(m_forward[i].y - m_points[i].y);
+        }
+
+        if (static_cast<int>(m_dx.size()) < MIN_TRACKED_POINTS) {
+            continue;
+        }
+
+        float dx = median(m_dx) / m_scale;
+        float dy = median(m_dy) / m_scale;
+        refined[b] = cv::Rect(static_cast<int>(std::lround(boxes[b].x + dx)),
+                              static_cast<int>(std::lround(boxes[b].y + dy)),
+                              boxes[b].width, boxes[b].height);
+    }
+
+    return refined;
+}
+
+void TrackFlowRefiner::reset() {
+    m_previous.release();
+    m_current.release();
+    m_hasPair = false;
+}
+
+} // namespace AISecurityVision
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Sparse optical-flow correction of propagated track boxes
+ *
+ * Between detections the tracker only extrapolates its Kalman state, which
+ * drifts as soon as an object turns or changes speed. For every track a
+ * regular grid of points inside its last box is followed into the current
+ * frame with pyramidal Lucas-Kanade; the median displacement of the points
+ * that were tracked (and tracked back to within FB_ERROR_PX) moves the box.
+ *
+ * Frames are compared on a grey copy downscaled to ANALYSIS_WIDTH, so the
+ * cost is one resize per frame plus a few hundred points per camera.
+ * Not thread-safe: one instance per pipeline, used by the analytics stage.
+ */
+class TrackFlowRefiner {
+public:
+    /**
+     * @brief Make frame the current frame; the previous one becomes the reference
+     *
+     * Must be called for every frame, detected or not, so consecutive frames are compared.
+     */
+    void setFrame(const cv::Mat& frame);
+
+    /**
+     * @brief Move boxes from the previous frame to the current one
+     *
+     * All boxes are tracked in one pyramidal LK pass per direction.
+     *
+     * @param boxes Boxes in source-frame coordinates on the previous frame
+     * @return Displaced boxes on the current frame; an empty rect where too few points were tracked
+     */
+    std::vector<cv::Rect> refine(const std::vector<cv::Rect>& boxes);
+
+    void reset();
+
+    static constexpr int ANALYSIS_WIDTH = 480;
+    static constexpr int GRID_POINTS = 5;       // Per side
+    static constexpr int MIN_TRACKED_POINTS = 6;
+    static constexpr float FB_ERROR_PX = 1.0f;  // Forward-backward consistency, analysis pixels
+
+private:
+    cv::Mat m_previous;
+    cv::Mat m_current;
+    cv::Mat m_scaled;
+    float m_scale = 1.0f;       // Analysis pixels per source pixel
+    bool m_hasPair = false;
+
+    std::vector<cv::Rect> m_scaledBoxes;
+    std::vector<cv::Point2f> m_points;
+    std::vector<cv::Point2f> m_forward;
+    std::vector<cv::Point2f> m_backward;
+    std::vector<unsigned char> m_status;
+    std::vector<unsigned char> m_backStatus;
+    std::vector<float> m_error;
+    std::vector<float> m_dx;
+    std::vector<float> m_dy;
+};
+
+} // namespace AISecurityVision
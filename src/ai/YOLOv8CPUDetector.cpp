@@ -1,19 +1,23 @@
 /**
  * @file YOLOv8CPUDetector.cpp
- * @brief YOLOv8 CPU Implementation (Fallback)
+ * @brief YOLOv8 CPU Implementation (OpenCV DNN)
  */
 
 #include "YOLOv8CPUDetector.h"
+#include "../core/Logger.h"
 #include <chrono>
-#include <random>
-#include <thread>
-#include <iostream>
+#include <algorithm>
 
 namespace AISecurityVision {
 
 YOLOv8CPUDetector::YOLOv8CPUDetector() {
     m_backend = InferenceBackend::CPU;
     initializeDefaultClassNames();
+
+    // The ONNX export expects RGB input
+    LetterboxPreprocessor::Options options;
+    options.swapRB = true;
+    m_preprocessor = LetterboxPreprocessor(options);
 }
 
 YOLOv8CPUDetector::~YOLOv8CPUDetector() {
@@ -22,31 +26,66 @@ YOLOv8CPUDetector::~YOLOv8CPUDetector() {
 
 bool YOLOv8CPUDetector::initialize(const std::string& modelPath) {
     m_modelPath = modelPath;
+
+#ifndef DISABLE_OPENCV_DNN
+    try {
+        m_net = cv::dnn::readNetFromONNX(modelPath);
+    } catch (const cv::Exception& e) {
+        LOG_ERROR() << "[CPU Detector] Failed to load ONNX model " << modelPath << ": " << e.what();
+        return false;
+    }
+
+    if (m_net.empty()) {
+        LOG_ERROR() << "[CPU Detector] Failed to load ONNX model: " << modelPath;
+        return false;
+    }
+
+    m_net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+    m_net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    m_outputNames = m_net.getUnconnectedOutLayersNames();
+
+    const int blobShape[] = {1, 3, m_inputHeight, m_inputWidth};
+    m_blob.create(4, blobShape, CV_32F);
     m_initialized = true;
-    
-    std::cout << "[CPU Detector] Initialized with model: " << modelPath << std::endl;
-    std::cout << "[CPU Detector] Note: This is a placeholder implementation" << std::endl;
-    std::cout << "[CPU Detector] For real CPU inference, consider using ONNX Runtime" << std::endl;
-    
+
+    LOG_INFO() << "[CPU Detector] Initialized OpenCV DNN with model: " << modelPath
+               << " (" << cv::getNumThreads() << " threads)";
+#else
+    // Keep pipelines running, but never report made-up detections
+    m_initialized = true;
+    LOG_WARN() << "[CPU Detector] Built with DISABLE_OPENCV_DNN, CPU inference is unavailable "
+               << "and no detections will be produced (configure with -DENABLE_OPENCV_DNN=ON)";
+#endif
+
     return true;
 }
 
 std::vector<Detection> YOLOv8CPUDetector::detectObjects(const cv::Mat& frame) {
-    if (!m_initialized) {
+    if (!m_initialized || frame.empty()) {
         return {};
     }
-    
+
+#ifndef DISABLE_OPENCV_DNN
     auto startTime = std::chrono::high_resolution_clock::now();
-    
-    // Simulate preprocessing
-    cv::Mat processed = preprocessImage(frame);
-    
-    // Simulate inference delay (20-50ms for CPU)
-    std::this_thread::sleep_for(std::chrono::milliseconds(30));
-    
-    // Generate some dummy detections for testing
-    auto detections = generateDummyDetections(frame);
-    
+
+    LetterboxInfo letterbox;
+    preprocessImage(frame, letterbox);
+
+    std::vector<cv::Mat> outputs;
+    try {
+        m_net.setInput(m_blob);
+        m_net.forward(outputs, m_outputNames);
+    } catch (const cv::Exception& e) {
+        LOG_ERROR() << "[CPU Detector] Inference failed: " << e.what();
+        return {};
+    }
+
+    if (outputs.empty()) {
+        return {};
+    }
+
+    auto detections = postprocessResults(outputs[0], frame.size(), letterbox);
+
     // Update timing
     auto endTime = std::chrono::high_resolution_clock::now();
     m_inferenceTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
@@ -54,54 +93,132 @@ std::vector<Detection> YOLOv8CPUDetector::detectObjects(const cv::Mat& frame) {
     if (m_inferenceTimes.size() > 100) {
         m_inferenceTimes.erase(m_inferenceTimes.begin());
     }
-    
+
     m_detectionCount += detections.size();
-    
-    return filterDetectionsByCategory(detections);
+
+    return detections;
+#else
+    return {};
+#endif
 }
 
-cv::Mat YOLOv8CPUDetector::preprocessImage(const cv::Mat& image) {
-    cv::Mat resized;
-    cv::resize(image, resized, cv::Size(m_inputWidth, m_inputHeight));
-    
-    cv::Mat normalized;
-    resized.convertTo(normalized, CV_32FC3, 1.0 / 255.0);
-    
-    return normalized;
+void YOLOv8CPUDetector::preprocessImage(const cv::Mat& frame, LetterboxInfo& letterbox) {
+    // BGR -> RGB, [0,255] -> [0,1], HWC -> NCHW in one pass over m_blob's storage
+    letterbox = m_preprocessor.toPlanarFloat(frame, cv::Size(m_inputWidth, m_inputHeight),
+                                             m_blob.ptr<float>());
 }
 
-std::vector<Detection> YOLOv8CPUDetector::generateDummyDetections(const cv::Mat& frame) {
+std::vector<Detection> YOLOv8CPUDetector::postprocessResults(const cv::Mat& output,
+                                                             const cv::Size& originalSize,
+                                                             const LetterboxInfo& letterbox) {
     std::vector<Detection> detections;
-    
-    // Random number generator
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_real_distribution<> conf_dist(0.3, 0.9);
-    std::uniform_int_distribution<> class_dist(0, 5); // Only first 6 classes
-    std::uniform_int_distribution<> count_dist(0, 3);
-    
-    int numDetections = count_dist(gen);
-    
-    for (int i = 0; i < numDetections; ++i) {
+    if (output.dims != 3) {
+        LOG_ERROR() << "[CPU Detector] Unexpected output dims: " << output.dims;
+        return detections;
+    }
+
+    // View the output as [4 + numClasses, numAnchors] so every class is one contiguous row
+    cv::Mat predictions(output.size[1], output.size[2], CV_32F, const_cast<float*>(output.ptr<float>()));
+    if (predictions.rows > predictions.cols) {
+        cv::transpose(predictions, m_transposed);
+        predictions = m_transposed;
+    }
+
+    const int numClasses = predictions.rows - 4;
+    const int numAnchors = predictions.cols;
+    if (numClasses <= 0) {
+        return detections;
+    }
+
+    // Best class score per anchor, reduced a whole row at a time (SIMD in cv::max)
+    predictions.row(4).copyTo(m_maxScores);
+    for (int c = 1; c < numClasses; ++c) {
+        cv::max(predictions.row(4 + c), m_maxScores, m_maxScores);
+    }
+
+    // Threshold all anchors at once; only the survivors are decoded below
+    cv::Mat candidateMask;
+    cv::compare(m_maxScores, m_confidenceThreshold, candidateMask, cv::CMP_GE);
+    if (cv::countNonZero(candidateMask) == 0) {
+        return detections;
+    }
+
+    std::vector<cv::Point> candidates;
+    cv::findNonZero(candidateMask, candidates);
+
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    std::vector<int> classIds;
+    boxes.reserve(candidates.size());
+    scores.reserve(candidates.size());
+    classIds.reserve(candidates.size());
+    m_nms.clear();
+    m_nms.reserve(candidates.size());
+    auto enabledClasses = getEnabledClassMask();
+
+    const float* cxRow = predictions.ptr<float>(0);
+    const float* cyRow = predictions.ptr<float>(1);
+    const float* wRow = predictions.ptr<float>(2);
+    const float* hRow = predictions.ptr<float>(3);
+
+    for (const auto& candidate : candidates) {
+        const int i = candidate.x;
+        const float bestScore = m_maxScores.at<float>(0, i);
+
+        int bestClass = 0;
+        for (int c = 0; c < numClasses; ++c) {
+            if (predictions.at<float>(4 + c, i) == bestScore) {
+                bestClass = c;
+                break;
+            }
+        }
+
+        // Disabled classes never reach box decoding or NMS
+        if (!isClassEnabled(*enabledClasses, bestClass)) {
+            continue;
+        }
+
+        // Outputs are in network input pixels; undo the letterbox
+        float halfW = wRow[i] * 0.5f;
+        float halfH = hRow[i] * 0.5f;
+        float x1 = (cxRow[i] - halfW - letterbox.x_pad) / letterbox.scale;
+        float y1 = (cyRow[i] - halfH - letterbox.y_pad) / letterbox.scale;
+        float x2 = (cxRow[i] + halfW - letterbox.x_pad) / letterbox.scale;
+        float y2 = (cyRow[i] + halfH - letterbox.y_pad) / letterbox.scale;
+
+        x1 = std::max(0.0f, std::min(x1, static_cast<float>(originalSize.width - 1)));
+        y1 = std::max(0.0f, std::min(y1, static_cast<float>(originalSize.height - 1)));
+        x2 = std::max(0.0f, std::min(x2, static_cast<float>(originalSize.width - 1)));
+        y2 = std::max(0.0f, std::min(y2, static_cast<float>(originalSize.height - 1)));
+
+        cv::Rect box(static_cast<int>(x1), static_cast<int>(y1),
+                     static_cast<int>(x2 - x1), static_cast<int>(y2 - y1));
+        if (box.width <= 0 || box.height <= 0) {
+            continue;
+        }
+
+        boxes.push_back(box);
+        scores.push_back(bestScore);
+        classIds.push_back(bestClass);
+        m_nms.add(box, bestScore, bestClass);
+    }
+
+    NonMaxSuppression::Config nmsConfig;
+    nmsConfig.iouThreshold = m_nmsThreshold;
+    const std::vector<int>& keep = m_nms.run(nmsConfig);
+
+    detections.reserve(keep.size());
+    for (int idx : keep) {
         Detection det;
-        
-        // Generate random bbox
-        int x = frame.cols / 4 + (i * frame.cols / 4);
-        int y = frame.rows / 4;
-        int w = frame.cols / 6;
-        int h = frame.rows / 3;
-        
-        det.bbox = cv::Rect(x, y, w, h);
-        det.confidence = conf_dist(gen);
-        det.classId = class_dist(gen);
-        
-        if (det.classId < m_classNames.size()) {
+        det.bbox = boxes[idx];
+        det.confidence = scores[idx];
+        det.classId = classIds[idx];
+        if (det.classId < static_cast<int>(m_classNames.size())) {
             det.className = m_classNames[det.classId];
         }
-        
         detections.push_back(det);
     }
-    
+
     return detections;
 }
 
@@ -114,21 +231,34 @@ InferenceBackend YOLOv8CPUDetector::getCurrentBackend() const {
 }
 
 std::string YOLOv8CPUDetector::getBackendName() const {
-    return "CPU (Fallback)";
+#ifndef DISABLE_OPENCV_DNN
+    return "CPU (OpenCV DNN)";
+#else
+    return "CPU (disabled)";
+#endif
 }
 
 void YOLOv8CPUDetector::cleanup() {
+#ifndef DISABLE_OPENCV_DNN
+    m_net = cv::dnn::Net();
+    m_outputNames.clear();
+#endif
+    m_blob.release();
+    m_maxScores.release();
+    m_transposed.release();
     m_initialized = false;
 }
 
 std::vector<std::string> YOLOv8CPUDetector::getModelInfo() const {
     std::vector<std::string> info;
-    
-    info.push_back("Backend: CPU (Fallback implementation)");
+
+    info.push_back("Backend: " + getBackendName());
     info.push_back("Model: " + m_modelPath);
     info.push_back("Input size: " + std::to_string(m_inputWidth) + "x" + std::to_string(m_inputHeight));
-    info.push_back("Note: This is a placeholder - consider using ONNX Runtime for real CPU inference");
-    
+#ifndef DISABLE_OPENCV_DNN
+    info.push_back("Threads: " + std::to_string(cv::getNumThreads()));
+#endif
+
     return info;
 }
 
@@ -1,24 +1,34 @@
 /**
  * @file YOLOv8CPUDetector.h
- * @brief YOLOv8 CPU Implementation (Fallback)
+ * @brief YOLOv8 CPU Implementation (OpenCV DNN)
  *
- * This file implements a basic CPU detector as a fallback
- * when hardware acceleration is not available.
+ * This file implements CPU inference for YOLOv8 ONNX models using the
+ * OpenCV DNN module, for hosts without a GPU or NPU.
  */
 
 #ifndef YOLOV8_CPU_DETECTOR_H
 #define YOLOV8_CPU_DETECTOR_H
 
 #include "YOLOv8Detector.h"
+#include "LetterboxPreprocessor.h"
+
+#ifndef DISABLE_OPENCV_DNN
+#include <opencv2/dnn.hpp>
+#endif
 
 namespace AISecurityVision {
 
 /**
  * @brief YOLOv8 detector implementation using CPU
  *
- * This is a placeholder implementation that provides basic functionality
- * when neither TensorRT nor RKNN is available. In a real implementation,
- * this could use ONNX Runtime or OpenCV DNN module.
+ * Loads an exported YOLOv8 ONNX model (e.g. models/yolov8n.onnx) with
+ * OpenCV DNN. Frames are letterboxed into a reusable input blob and the raw
+ * [84 x 8400] output is decoded with vectorized score thresholding: the
+ * per-anchor best class score is reduced over whole class rows, and only
+ * anchors above the confidence threshold are decoded and passed to NMS.
+ *
+ * When built with DISABLE_OPENCV_DNN the detector still initializes so that
+ * pipelines keep running, but it returns no detections.
  */
 class YOLOv8CPUDetector : public YOLOv8Detector {
 public:
@@ -35,14 +45,36 @@ public:
     std::vector<std::string> getModelInfo() const override;
 
 private:
-    // Placeholder for model data
     std::string m_modelPath;
-    
-    // Simple preprocessing
-    cv::Mat preprocessImage(const cv::Mat& image);
-    
-    // Generate dummy detections for testing
-    std::vector<Detection> generateDummyDetections(const cv::Mat& frame);
+
+#ifndef DISABLE_OPENCV_DNN
+    cv::dnn::Net m_net;
+    std::vector<std::string> m_outputNames;
+#endif
+
+    // Reused across frames to avoid per-frame allocations
+    LetterboxPreprocessor m_preprocessor;   // RGB order, [0,1]
+    cv::Mat m_blob;             // 1x3xHxW float blob fed to the network
+    cv::Mat m_maxScores;        // 1 x numAnchors best class score per anchor
+    cv::Mat m_transposed;       // Output converted to [84 x numAnchors] if needed
+
+    /**
+     * @brief Letterbox a frame straight into m_blob
+     * @param frame Input image
+     * @param letterbox Receives the scale and padding applied
+     */
+    void preprocessImage(const cv::Mat& frame, LetterboxInfo& letterbox);
+
+    /**
+     * @brief Decode the raw network output into detections and run NMS
+     * @param output Network output, [1, 84, N] or [1, N, 84]
+     * @param originalSize Size of the input frame
+     * @param letterbox Letterbox applied during preprocessing
+     * @return Detections in original frame coordinates
+     */
+    std::vector<Detection> postprocessResults(const cv::Mat& output,
+                                              const cv::Size& originalSize,
+                                              const LetterboxInfo& letterbox);
 };
 
 } // namespace AISecurityVision
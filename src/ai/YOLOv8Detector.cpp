@@ -11,6 +11,7 @@
 #include <fstream>
 #include <sstream>
 #include <numeric>
+#include <algorithm>
 
 namespace AISecurityVision {
 
@@ -18,6 +19,7 @@ YOLOv8Detector::YOLOv8Detector() {
     initializeDefaultClassNames();
     // By default, enable all categories
     m_enabledCategories = m_classNames;
+    publishClassMask();
 }
 
 YOLOv8Detector::~YOLOv8Detector() {
@@ -25,6 +27,45 @@ YOLOv8Detector::~YOLOv8Detector() {
     // Derived classes should handle cleanup in their own destructors
 }
 
+std::vector<std::vector<Detection>> YOLOv8Detector::detectObjectsBatch(const std::vector<cv::Mat>& frames) {
+    std::vector<std::vector<Detection>> results;
+    results.reserve(frames.size());
+
+    for (const auto& frame : frames) {
+        results.push_back(detectObjects(frame));
+    }
+
+    return results;
+}
+
+std::vector<Detection> YOLOv8Detector::detectObjectsLetterboxed(const cv::Mat& letterboxed,
+                                                                const LetterboxInfo& letterbox,
+                                                                const cv::Size& sourceSize) {
+    // At the model input size the backend's own letterbox is the identity,
+    // so its boxes are in letterboxed coordinates
+    auto detections = detectObjects(letterboxed);
+    mapFromLetterbox(detections, letterbox, sourceSize);
+    return detections;
+}
+
+void YOLOv8Detector::mapFromLetterbox(std::vector<Detection>& detections, const LetterboxInfo& letterbox,
+                                      const cv::Size& sourceSize) {
+    const cv::Rect bounds(0, 0, sourceSize.width, sourceSize.height);
+    const float inverseScale = letterbox.scale > 0.0f ? 1.0f / letterbox.scale : 1.0f;
+
+    for (auto& detection : detections) {
+        float x1 = (detection.bbox.x - letterbox.x_pad) * inverseScale;
+        float y1 = (detection.bbox.y - letterbox.y_pad) * inverseScale;
+        float x2 = (detection.bbox.x + detection.bbox.width - letterbox.x_pad) * inverseScale;
+        float y2 = (detection.bbox.y + detection.bbox.height - letterbox.y_pad) * inverseScale;
+        detection.bbox = cv::Rect(cv::Point(static_cast<int>(x1), static_cast<int>(y1)),
+                                  cv::Point(static_cast<int>(x2), static_cast<int>(y2))) & bounds;
+    }
+
+    detections.erase(std::remove_if(detections.begin(), detections.end(),
+        [](const Detection& detection) { return detection.bbox.area() <= 0; }), detections.end());
+}
+
 double YOLOv8Detector::getAverageInferenceTime() const {
     if (m_inferenceTimes.empty()) {
         return 0.0;
@@ -52,6 +93,7 @@ bool YOLOv8Detector::loadClassNames(const std::string& labelPath) {
     }
 
     LOG_INFO() << "[YOLOv8Detector] Loaded " << m_classNames.size() << " class names from " << labelPath;
+    publishClassMask();
     return true;
 }
 
@@ -73,42 +115,82 @@ void YOLOv8Detector::initializeDefaultClassNames() {
     };
 
     LOG_INFO() << "[YOLOv8Detector] Initialized with " << m_classNames.size() << " COCO class names";
+    publishClassMask();
+}
+
+void YOLOv8Detector::setClassNames(const std::vector<std::string>& classNames) {
+    m_classNames = classNames;
+    publishClassMask();
 }
 
 void YOLOv8Detector::setEnabledCategories(const std::vector<std::string>& categories) {
-    m_enabledCategories.clear();
+    std::vector<std::string> enabled;
 
     // Validate that all provided categories exist in the class names
     for (const auto& category : categories) {
         auto it = std::find(m_classNames.begin(), m_classNames.end(), category);
         if (it != m_classNames.end()) {
-            m_enabledCategories.push_back(category);
+            enabled.push_back(category);
         } else {
             LOG_WARN() << "[YOLOv8Detector] Unknown category ignored: " << category;
         }
     }
 
-    LOG_INFO() << "[YOLOv8Detector] Enabled " << m_enabledCategories.size()
+    {
+        std::lock_guard<std::mutex> lock(m_categoryMutex);
+        m_enabledCategories = enabled;
+    }
+    publishClassMask();
+
+    LOG_INFO() << "[YOLOv8Detector] Enabled " << enabled.size()
                << " out of " << m_classNames.size() << " available categories";
 }
 
+std::vector<std::string> YOLOv8Detector::getEnabledCategories() const {
+    std::lock_guard<std::mutex> lock(m_categoryMutex);
+    return m_enabledCategories;
+}
+
 bool YOLOv8Detector::isCategoryEnabled(const std::string& category) const {
-    return std::find(m_enabledCategories.begin(), m_enabledCategories.end(), category)
-           != m_enabledCategories.end();
+    auto it = std::find(m_classNames.begin(), m_classNames.end(), category);
+    if (it == m_classNames.end()) {
+        return false;
+    }
+    return isCategoryEnabled(static_cast<int>(it - m_classNames.begin()));
 }
 
 bool YOLOv8Detector::isCategoryEnabled(int classId) const {
-    if (classId < 0 || classId >= static_cast<int>(m_classNames.size())) {
-        return false;
+    auto mask = getEnabledClassMask();
+    return mask && isClassEnabled(*mask, classId);
+}
+
+YOLOv8Detector::ClassMask YOLOv8Detector::compileClassMask(const std::vector<std::string>& classNames,
+                                                           const std::vector<std::string>& categories) {
+    ClassMask mask;
+    const size_t count = std::min(classNames.size(), mask.size());
+    for (size_t id = 0; id < count; ++id) {
+        if (std::find(categories.begin(), categories.end(), classNames[id]) != categories.end()) {
+            mask.set(id);
+        }
     }
-    return isCategoryEnabled(m_classNames[classId]);
+    return mask;
+}
+
+void YOLOv8Detector::publishClassMask() {
+    std::lock_guard<std::mutex> lock(m_categoryMutex);
+    std::atomic_store(&m_enabledClassMask,
+                      std::make_shared<const ClassMask>(compileClassMask(m_classNames, m_enabledCategories)));
 }
 
 std::vector<Detection> YOLOv8Detector::filterDetectionsByCategory(const std::vector<Detection>& detections) const {
     std::vector<Detection> filteredDetections;
+    auto mask = getEnabledClassMask();
+    if (!mask) {
+        return filteredDetections;
+    }
 
     for (const auto& detection : detections) {
-        if (isCategoryEnabled(detection.className)) {
+        if (isClassEnabled(*mask, detection.classId)) {
             filteredDetections.push_back(detection);
         }
     }
@@ -119,4 +201,27 @@ std::vector<Detection> YOLOv8Detector::filterDetectionsByCategory(const std::vec
     return filteredDetections;
 }
 
+std::vector<Detection> YOLOv8Detector::applyNMS(const std::vector<Detection>& detections) {
+    std::vector<Detection> result;
+    if (detections.empty()) {
+        return result;
+    }
+
+    m_nms.clear();
+    m_nms.reserve(detections.size());
+    for (const auto& detection : detections) {
+        m_nms.add(detection.bbox, detection.confidence, detection.classId);
+    }
+
+    NonMaxSuppression::Config config;
+    config.iouThreshold = m_nmsThreshold;
+    const auto& keep = m_nms.run(config);
+
+    result.reserve(keep.size());
+    for (int index : keep) {
+        result.push_back(detections[index]);
+    }
+    return result;
+}
+
 } // namespace AISecurityVision
\ No newline at end of file
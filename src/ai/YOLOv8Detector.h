@@ -12,7 +12,11 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <bitset>
 #include <opencv2/opencv.hpp>
+#include "../core/FrameBundle.h"  // LetterboxInfo
+#include "NonMaxSuppression.h"
 
 namespace AISecurityVision {
 
@@ -37,17 +41,6 @@ struct Detection {
     Detection() : confidence(0.0f), classId(-1) {}
 };
 
-/**
- * @brief Letterbox information for maintaining aspect ratio
- */
-struct LetterboxInfo {
-    float scale;    // Scale factor
-    float x_pad;    // X padding
-    float y_pad;    // Y padding
-
-    LetterboxInfo() : scale(1.0f), x_pad(0.0f), y_pad(0.0f) {}
-};
-
 /**
  * @brief Base class for YOLOv8 object detection
  *
@@ -73,6 +66,43 @@ public:
      */
     virtual std::vector<Detection> detectObjects(const cv::Mat& frame) = 0;
 
+    /**
+     * @brief Detect objects in a batch of images
+     *
+     * The default implementation calls detectObjects() once per image.
+     * Backends with native batch support override this.
+     * @param frames Input images
+     * @return One detection vector per input image, in input order
+     */
+    virtual std::vector<std::vector<Detection>> detectObjectsBatch(const std::vector<cv::Mat>& frames);
+
+    /**
+     * @brief Detect objects in a frame already letterboxed to getInputSize()
+     *
+     * For callers that produce the model input themselves, e.g. the decoder's
+     * model plane. The frame is letterbox-neutral for the backend (scale 1, no
+     * padding), and the boxes are mapped back to source coordinates.
+     * @param letterboxed Model-input-sized image
+     * @param letterbox Mapping from the letterboxed image to the source frame
+     * @param sourceSize Source frame size, for clipping
+     * @return Detections in source coordinates
+     */
+    std::vector<Detection> detectObjectsLetterboxed(const cv::Mat& letterboxed,
+                                                    const LetterboxInfo& letterbox,
+                                                    const cv::Size& sourceSize);
+
+    /**
+     * @brief Map detections from letterboxed to source coordinates, clipped to the source frame
+     */
+    static void mapFromLetterbox(std::vector<Detection>& detections, const LetterboxInfo& letterbox,
+                                 const cv::Size& sourceSize);
+
+    /**
+     * @brief Get the number of images a single native inference call accepts
+     * @return Native batch size (1 if the backend does not batch)
+     */
+    virtual int getMaxBatchSize() const { return 1; }
+
     /**
      * @brief Check if detector is initialized
      * @return true if initialized, false otherwise
@@ -96,22 +126,48 @@ public:
      */
     virtual void cleanup() = 0;
 
+    /**
+     * @brief Enabled classes, indexed by class ID
+     */
+    using ClassMask = std::bitset<1024>;
+
     // Configuration methods
     void setConfidenceThreshold(float threshold) { m_confidenceThreshold = threshold; }
     void setNMSThreshold(float threshold) { m_nmsThreshold = threshold; }
-    void setClassNames(const std::vector<std::string>& classNames) { m_classNames = classNames; }
+    void setClassNames(const std::vector<std::string>& classNames);
 
     float getConfidenceThreshold() const { return m_confidenceThreshold; }
+    cv::Size getInputSize() const { return cv::Size(m_inputWidth, m_inputHeight); }
     float getNMSThreshold() const { return m_nmsThreshold; }
     const std::vector<std::string>& getClassNames() const { return m_classNames; }
 
     // Category filtering methods
     void setEnabledCategories(const std::vector<std::string>& categories);
-    const std::vector<std::string>& getEnabledCategories() const { return m_enabledCategories; }
+    std::vector<std::string> getEnabledCategories() const;
     const std::vector<std::string>& getAvailableCategories() const { return m_classNames; }
     bool isCategoryEnabled(const std::string& category) const;
     bool isCategoryEnabled(int classId) const;
 
+    /**
+     * @brief Current enabled-class mask
+     *
+     * Compiled from the enabled category names whenever they or the class
+     * names change, and published atomically: decoders load it once per frame
+     * and drop disabled classes before box decoding and NMS, while the API
+     * may replace it concurrently.
+     */
+    std::shared_ptr<const ClassMask> getEnabledClassMask() const { return std::atomic_load(&m_enabledClassMask); }
+
+    /**
+     * @brief Build a mask with the bits of the classes named in categories set
+     */
+    static ClassMask compileClassMask(const std::vector<std::string>& classNames,
+                                      const std::vector<std::string>& categories);
+
+    static bool isClassEnabled(const ClassMask& mask, int classId) {
+        return classId >= 0 && static_cast<size_t>(classId) < mask.size() && mask.test(classId);
+    }
+
     // Performance metrics
     double getLastInferenceTime() const { return m_inferenceTime; }
     double getAverageInferenceTime() const;
@@ -133,8 +189,10 @@ protected:
     // Class names (COCO dataset by default)
     std::vector<std::string> m_classNames;
 
-    // Category filtering
+    // Category filtering; the names are the source of truth, the mask is what decoders read
+    mutable std::mutex m_categoryMutex;
     std::vector<std::string> m_enabledCategories;
+    std::shared_ptr<const ClassMask> m_enabledClassMask;   // std::atomic_load / std::atomic_store
 
     // State
     bool m_initialized = false;
@@ -145,6 +203,9 @@ protected:
     std::vector<double> m_inferenceTimes;
     size_t m_detectionCount = 0;
 
+    // Shared class-aware NMS; candidate storage is reused across frames
+    NonMaxSuppression m_nms;
+
     /**
      * @brief Load COCO class names
      * @param labelPath Path to label file
@@ -154,11 +215,26 @@ protected:
 
     /**
      * @brief Filter detections based on enabled categories
+     *
+     * For decoders that cannot apply getEnabledClassMask() themselves; the
+     * built-in backends drop disabled classes while decoding.
      * @param detections Input detections to filter
      * @return Filtered detections containing only enabled categories
      */
     std::vector<Detection> filterDetectionsByCategory(const std::vector<Detection>& detections) const;
 
+    /**
+     * @brief Recompile and publish the class mask from the current names
+     */
+    void publishClassMask();
+
+    /**
+     * @brief Class-aware greedy NMS over decoded detections using m_nmsThreshold
+     * @param detections Candidate detections
+     * @return Kept detections, highest confidence first
+     */
+    std::vector<Detection> applyNMS(const std::vector<Detection>& detections);
+
     /**
      * @brief Initialize default COCO class names
      */
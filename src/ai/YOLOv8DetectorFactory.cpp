@@ -123,7 +123,7 @@ std::string YOLOv8DetectorFactory::getBackendName(InferenceBackend backend) {
         case InferenceBackend::RKNN:
             return "RKNN NPU";
         case InferenceBackend::ONNX:
-            return "ONNX Runtime";
+            return "ONNX (OpenCV DNN)";
         case InferenceBackend::CPU:
             return "CPU";
         default:
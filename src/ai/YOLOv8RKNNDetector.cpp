@@ -15,7 +15,6 @@
 #include <iomanip>
 #include <cmath>
 #include <numeric>
-#include <set>
 #include <map>
 #include <sstream>
 
@@ -58,79 +57,6 @@ const char* get_format_string(int fmt) {
 
 namespace AISecurityVision {
 
-// Static utility functions (matching reference implementation exactly)
-float YOLOv8RKNNDetector::calculateOverlap(float xmin0, float ymin0, float xmax0, float ymax0,
-                                           float xmin1, float ymin1, float xmax1, float ymax1) {
-    float w = std::max(0.0f, std::min(xmax0, xmax1) - std::max(xmin0, xmin1) + 1.0f);
-    float h = std::max(0.0f, std::min(ymax0, ymax1) - std::max(ymin0, ymin1) + 1.0f);
-    float i = w * h;
-    float u = (xmax0 - xmin0 + 1.0f) * (ymax0 - ymin0 + 1.0f) +
-              (xmax1 - xmin1 + 1.0f) * (ymax1 - ymin1 + 1.0f) - i;
-    return u <= 0.0f ? 0.0f : (i / u);
-}
-
-int YOLOv8RKNNDetector::nms(int validCount, std::vector<float>& outputLocations,
-                           std::vector<int>& classIds, std::vector<int>& order,
-                           int filterId, float threshold) {
-    for (int i = 0; i < validCount; ++i) {
-        int n = order[i];
-        if (n == -1 || classIds[n] != filterId) {
-            continue;
-        }
-        for (int j = i + 1; j < validCount; ++j) {
-            int m = order[j];
-            if (m == -1 || classIds[m] != filterId) {
-                continue;
-            }
-            float xmin0 = outputLocations[n * 4 + 0];
-            float ymin0 = outputLocations[n * 4 + 1];
-            float xmax0 = outputLocations[n * 4 + 0] + outputLocations[n * 4 + 2];
-            float ymax0 = outputLocations[n * 4 + 1] + outputLocations[n * 4 + 3];
-
-            float xmin1 = outputLocations[m * 4 + 0];
-            float ymin1 = outputLocations[m * 4 + 1];
-            float xmax1 = outputLocations[m * 4 + 0] + outputLocations[m * 4 + 2];
-            float ymax1 = outputLocations[m * 4 + 1] + outputLocations[m * 4 + 3];
-
-            float iou = calculateOverlap(xmin0, ymin0, xmax0, ymax0, xmin1, ymin1, xmax1, ymax1);
-
-            if (iou > threshold) {
-                order[j] = -1;
-            }
-        }
-    }
-    return 0;
-}
-
-int YOLOv8RKNNDetector::quickSortIndiceInverse(std::vector<float>& input, int left, int right,
-                                              std::vector<int>& indices) {
-    float key;
-    int key_index;
-    int low = left;
-    int high = right;
-    if (left < right) {
-        key_index = indices[left];
-        key = input[left];
-        while (low < high) {
-            while (low < high && input[high] <= key) {
-                high--;
-            }
-            input[low] = input[high];
-            indices[low] = indices[high];
-            while (low < high && input[low] >= key) {
-                low++;
-            }
-            input[high] = input[low];
-            indices[high] = indices[low];
-        }
-        input[low] = key;
-        indices[low] = key_index;
-        quickSortIndiceInverse(input, left, low - 1, indices);
-        quickSortIndiceInverse(input, low + 1, right, indices);
-    }
-    return low;
-}
-
 void YOLOv8RKNNDetector::computeDFL(float* tensor, int dfl_len, float* box) {
     for (int b = 0; b < 4; b++) {
         float exp_t[dfl_len];
@@ -164,7 +90,8 @@ int YOLOv8RKNNDetector::processI8(int8_t* box_tensor, int32_t box_zp, float box_
                                   int8_t* score_sum_tensor, int32_t score_sum_zp, float score_sum_scale,
                                   int grid_h, int grid_w, int stride, int dfl_len,
                                   std::vector<float>& boxes, std::vector<float>& objProbs,
-                                  std::vector<int>& classId, float threshold) {
+                                  std::vector<int>& classId, float threshold,
+                                  const ClassMask& enabledClasses) {
     int validCount = 0;
     int grid_len = grid_h * grid_w;
     int8_t score_thres_i8 = qntF32ToAffine(threshold, score_zp, score_scale);
@@ -191,8 +118,8 @@ int YOLOv8RKNNDetector::processI8(int8_t* box_tensor, int32_t box_zp, float box_
                 offset += grid_len;
             }
 
-            // compute box
-            if (max_score > score_thres_i8) {
+            // compute box; disabled classes are dropped before DFL decoding and NMS
+            if (max_score > score_thres_i8 && isClassEnabled(enabledClasses, max_class_id)) {
                 offset = i * grid_w + j;
                 float box[4];
                 float before_dfl[dfl_len * 4];
@@ -447,31 +374,6 @@ std::vector<std::string> YOLOv8RKNNDetector::getModelInfo() const {
     return info;
 }
 
-cv::Mat YOLOv8RKNNDetector::preprocessImageWithLetterbox(const cv::Mat& image, LetterboxInfo& letterbox) {
-    // Calculate letterbox parameters to maintain aspect ratio
-    float scale_x = static_cast<float>(m_inputWidth) / image.cols;
-    float scale_y = static_cast<float>(m_inputHeight) / image.rows;
-    letterbox.scale = std::min(scale_x, scale_y);
-
-    int new_width = static_cast<int>(image.cols * letterbox.scale);
-    int new_height = static_cast<int>(image.rows * letterbox.scale);
-
-    letterbox.x_pad = (m_inputWidth - new_width) / 2.0f;
-    letterbox.y_pad = (m_inputHeight - new_height) / 2.0f;
-
-    // Resize image
-    cv::Mat resized;
-    cv::resize(image, resized, cv::Size(new_width, new_height));
-
-    // Create letterboxed image with padding
-    cv::Mat letterboxed = cv::Mat::zeros(m_inputHeight, m_inputWidth, CV_8UC3);
-    resized.copyTo(letterboxed(cv::Rect(static_cast<int>(letterbox.x_pad),
-                                       static_cast<int>(letterbox.y_pad),
-                                       new_width, new_height)));
-
-    return letterboxed;
-}
-
 std::vector<Detection> YOLOv8RKNNDetector::detectObjects(const cv::Mat& frame) {
     std::vector<Detection> detections;
 
@@ -483,9 +385,9 @@ std::vector<Detection> YOLOv8RKNNDetector::detectObjects(const cv::Mat& frame) {
 #ifdef HAVE_RKNN
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    // Preprocess image with letterbox
-    LetterboxInfo letterbox;
-    cv::Mat preprocessed = preprocessImageWithLetterbox(frame, letterbox);
+    // Letterbox into the reusable input canvas
+    LetterboxInfo letterbox = m_preprocessor.toInterleavedU8(frame, cv::Size(m_inputWidth, m_inputHeight), m_inputCanvas);
+    const cv::Mat& preprocessed = m_inputCanvas;
 
     // Prepare input
     rknn_input inputs[1];
@@ -573,6 +475,7 @@ std::vector<Detection> YOLOv8RKNNDetector::postprocessResults(rknn_output* outpu
     std::vector<float> boxes;
     std::vector<float> objProbs;
     std::vector<int> classId;
+    auto enabledClasses = getEnabledClassMask();
 
     // Process each scale (matching reference implementation exactly)
     for (int scale_idx = 0; scale_idx < 3; scale_idx++) {
@@ -610,7 +513,7 @@ std::vector<Detection> YOLOv8RKNNDetector::postprocessResults(rknn_output* outpu
                                   score_tensor, score_attr.zp, score_attr.scale,
                                   score_sum_tensor, score_sum_attr.zp, score_sum_attr.scale,
                                   grid_h, grid_w, stride, dfl_len,
-                                  boxes, objProbs, classId, m_confidenceThreshold);
+                                  boxes, objProbs, classId, m_confidenceThreshold, *enabledClasses);
 
         LOG_DEBUG() << "[YOLOv8RKNNDetector] Scale " << scale_idx << " produced " << validCount << " detections";
     }
@@ -623,25 +526,22 @@ std::vector<Detection> YOLOv8RKNNDetector::postprocessResults(rknn_output* outpu
 
     LOG_DEBUG() << "[YOLOv8RKNNDetector] Total detections before NMS: " << totalDetections;
 
-    // Prepare data for NMS
-    std::vector<int> order(totalDetections);
-    std::iota(order.begin(), order.end(), 0);
-
-    // Sort by confidence (descending)
-    std::vector<float> confidences = objProbs;
-    quickSortIndiceInverse(confidences, 0, totalDetections - 1, order);
-
-    // Apply NMS for each class
-    std::set<int> uniqueClasses(classId.begin(), classId.end());
-    for (int cls : uniqueClasses) {
-        nms(totalDetections, boxes, classId, order, cls, m_nmsThreshold);
+    // Class-aware NMS with the reference's pixel-inclusive IoU; kept boxes come back by descending score
+    m_nms.clear();
+    m_nms.reserve(totalDetections);
+    for (int i = 0; i < totalDetections; ++i) {
+        float x = boxes[i * 4];
+        float y = boxes[i * 4 + 1];
+        m_nms.add(x, y, x + boxes[i * 4 + 2], y + boxes[i * 4 + 3], objProbs[i], classId[i]);
     }
 
-    // Convert results to Detection objects and transform coordinates back to original image
-    for (int i = 0; i < totalDetections; i++) {
-        if (order[i] == -1) continue;  // Filtered out by NMS
+    NonMaxSuppression::Config nmsConfig;
+    nmsConfig.iouThreshold = m_nmsThreshold;
+    nmsConfig.inclusiveCoordinates = true;
+    const std::vector<int>& order = m_nms.run(nmsConfig);
 
-        int idx = order[i];
+    // Convert results to Detection objects and transform coordinates back to original image
+    for (int idx : order) {
         float x = boxes[idx * 4];
         float y = boxes[idx * 4 + 1];
         float w = boxes[idx * 4 + 2];
@@ -697,13 +597,7 @@ std::vector<Detection> YOLOv8RKNNDetector::postprocessResults(rknn_output* outpu
 
 #endif
 
-    // Apply category filtering before returning results
-    std::vector<Detection> filteredDetections = filterDetectionsByCategory(detections);
-
-    LOG_DEBUG() << "[YOLOv8RKNNDetector] Applied category filtering: "
-                << filteredDetections.size() << "/" << detections.size() << " detections kept";
-
-    return filteredDetections;
+    return detections;
 }
 
 void YOLOv8RKNNDetector::cleanup() {
@@ -10,6 +10,7 @@
 #define YOLOV8_RKNN_DETECTOR_H
 
 #include "YOLOv8Detector.h"
+#include "LetterboxPreprocessor.h"
 
 #ifdef HAVE_RKNN
 #include "rknn_api.h"
@@ -56,7 +57,8 @@ private:
     bool m_zeroCopyMode;
 
     // Helper methods based on reference implementation
-    cv::Mat preprocessImageWithLetterbox(const cv::Mat& image, LetterboxInfo& letterbox);
+    LetterboxPreprocessor m_preprocessor;
+    cv::Mat m_inputCanvas;      // Reused uint8 NHWC input, gray padded
     std::vector<Detection> postprocessResults(rknn_output* outputs,
                                             rknn_tensor_attr* output_attrs,
                                             uint32_t n_output,
@@ -69,16 +71,10 @@ private:
                   int8_t* score_sum_tensor, int32_t score_sum_zp, float score_sum_scale,
                   int grid_h, int grid_w, int stride, int dfl_len,
                   std::vector<float>& boxes, std::vector<float>& objProbs,
-                  std::vector<int>& classId, float threshold);
+                  std::vector<int>& classId, float threshold,
+                  const ClassMask& enabledClasses);
 
     // Utility functions (matching reference implementation)
-    static float calculateOverlap(float xmin0, float ymin0, float xmax0, float ymax0,
-                                 float xmin1, float ymin1, float xmax1, float ymax1);
-    static int nms(int validCount, std::vector<float>& outputLocations,
-                   std::vector<int>& classIds, std::vector<int>& order,
-                   int filterId, float threshold);
-    static int quickSortIndiceInverse(std::vector<float>& input, int left, int right,
-                                     std::vector<int>& indices);
     static void computeDFL(float* tensor, int dfl_len, float* box);
     static float deqntAffineToF32(int8_t qnt, int32_t zp, float scale);
     static int8_t qntF32ToAffine(float f32, int32_t zp, float scale);
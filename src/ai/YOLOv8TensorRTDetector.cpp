@@ -66,8 +66,12 @@ bool YOLOv8TensorRTDetector::initialize(const std::string& modelPath) {
     if (ext == "engine" || ext == "trt") {
         success = loadEngine(modelPath);
     } else if (ext == "onnx") {
-        // Build engine from ONNX
-        std::string enginePath = modelPath.substr(0, modelPath.find_last_of(".")) + ".engine";
+        // Build engine from ONNX (batched engines are cached separately)
+        std::string enginePath = modelPath.substr(0, modelPath.find_last_of("."));
+        if (m_maxBatchSize > 1) {
+            enginePath += "_b" + std::to_string(m_maxBatchSize);
+        }
+        enginePath += ".engine";
         if (!fileExists(enginePath)) {
             LOG_INFO() << "Building TensorRT engine from ONNX model...";
             if (!buildEngineFromONNX(modelPath, enginePath)) {
@@ -132,6 +136,27 @@ bool YOLOv8TensorRTDetector::buildEngineFromONNX(const std::string& onnxPath, co
     if (!config) return false;
     
     config->setMemoryPoolLimit(nvinfer1::MemoryPoolType::kWORKSPACE, m_workspaceSize);
+
+    // Dynamic-batch models need an optimization profile covering the batch sizes we will run
+    if (network->getNbInputs() > 0) {
+        nvinfer1::ITensor* input = network->getInput(0);
+        nvinfer1::Dims dims = input->getDimensions();
+        if (dims.nbDims == 4 && dims.d[0] == -1) {
+            nvinfer1::IOptimizationProfile* profile = builder->createOptimizationProfile();
+            nvinfer1::Dims minDims = dims;
+            nvinfer1::Dims maxDims = dims;
+            minDims.d[0] = 1;
+            maxDims.d[0] = std::max(1, m_maxBatchSize);
+            profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, minDims);
+            profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, maxDims);
+            profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, maxDims);
+            config->addOptimizationProfile(profile);
+            LOG_INFO() << "Dynamic batch input, optimization profile 1.." << maxDims.d[0];
+        } else if (m_maxBatchSize > 1) {
+            LOG_WARN() << "ONNX model has a static batch dimension; export with dynamic batch "
+                       << "to enable batched inference (max batch " << m_maxBatchSize << " ignored)";
+        }
+    }
     
     // Set precision
     if (m_precision == "FP16") {
@@ -246,7 +271,23 @@ bool YOLOv8TensorRTDetector::loadEngine(const std::string& enginePath) {
         LOG_ERROR() << "No input binding found";
         return false;
     }
-    
+
+    // Resolve the batch dimension. Dynamic-batch engines are sized for the
+    // profile maximum; the actual batch is set per inference call.
+    m_dynamicBatch = (m_inputDims.nbDims >= 4 && m_inputDims.d[0] == -1);
+    if (m_dynamicBatch) {
+        nvinfer1::Dims maxDims = m_engine->getProfileShape(
+            m_inputName.c_str(), 0, nvinfer1::OptProfileSelector::kMAX);
+        m_context->setInputShape(m_inputName.c_str(), maxDims);
+        m_inputDims = maxDims;
+        m_outputBoxesDims = m_context->getTensorShape(m_outputBoxesName.c_str());
+    }
+    m_engineBatchSize = std::max(1, static_cast<int>(m_inputDims.d[0]));
+    m_outputElementsPerImage = getSizeByDim(m_outputBoxesDims) / m_engineBatchSize;
+
+    LOG_INFO() << "Engine batch size: " << m_engineBatchSize
+               << (m_dynamicBatch ? " (dynamic)" : " (static)");
+
     // Allocate buffers
     return allocateBuffers();
 }
@@ -292,12 +333,11 @@ std::vector<Detection> YOLOv8TensorRTDetector::detectObjects(const cv::Mat& fram
     
     auto startTime = std::chrono::high_resolution_clock::now();
     
-    // Preprocess image
-    LetterboxInfo letterbox;
-    cv::Mat preprocessed = preprocessImageWithLetterbox(frame, letterbox);
-    
+    // Preprocess straight into the input tensor
+    LetterboxInfo letterbox = preprocessToInputBuffer(frame, 0);
+
     // Do inference
-    if (!doInference(preprocessed)) {
+    if (!runInference(1)) {
         LOG_ERROR() << "Inference failed";
         return {};
     }
@@ -320,7 +360,7 @@ std::vector<Detection> YOLOv8TensorRTDetector::detectObjects(const cv::Mat& fram
 
     // Debug logging for detection results
     if (!detections.empty()) {
-        LOG_DEBUG() << "[TensorRT] Raw detections before filtering: " << detections.size();
+        LOG_DEBUG() << "[TensorRT] Detections: " << detections.size();
         for (size_t i = 0; i < std::min(detections.size(), size_t(3)); ++i) {
             const auto& det = detections[i];
             LOG_DEBUG() << "  Detection " << i << ": class=" << det.classId
@@ -330,72 +370,32 @@ std::vector<Detection> YOLOv8TensorRTDetector::detectObjects(const cv::Mat& fram
         }
     }
 
-    // Filter by enabled categories
-    auto filteredDetections = filterDetectionsByCategory(detections);
-
-    // Debug logging for filtered results
-    if (detections.size() != filteredDetections.size()) {
-        LOG_DEBUG() << "[TensorRT] Filtered detections: " << filteredDetections.size()
-                    << " (from " << detections.size() << " raw detections)";
-    }
-
-    return filteredDetections;
+    return detections;
 }
 
-cv::Mat YOLOv8TensorRTDetector::preprocessImageWithLetterbox(const cv::Mat& image, LetterboxInfo& letterbox) {
-    // Calculate scale to fit the image into input size while maintaining aspect ratio
-    float scale_x = static_cast<float>(m_inputWidth) / image.cols;
-    float scale_y = static_cast<float>(m_inputHeight) / image.rows;
-    float scale = std::min(scale_x, scale_y);
-    
-    int new_width = static_cast<int>(image.cols * scale);
-    int new_height = static_cast<int>(image.rows * scale);
-    
-    // Resize image
-    cv::Mat resized;
-    cv::resize(image, resized, cv::Size(new_width, new_height), 0, 0, cv::INTER_LINEAR);
-    
-    // Create letterboxed image
-    cv::Mat letterboxed = cv::Mat::zeros(m_inputHeight, m_inputWidth, CV_8UC3);
-    letterboxed.setTo(cv::Scalar(114, 114, 114)); // Gray padding
-    
-    // Calculate padding
-    int pad_x = (m_inputWidth - new_width) / 2;
-    int pad_y = (m_inputHeight - new_height) / 2;
-    
-    // Copy resized image to center
-    resized.copyTo(letterboxed(cv::Rect(pad_x, pad_y, new_width, new_height)));
-    
-    // Update letterbox info
-    letterbox.scale = scale;
-    letterbox.x_pad = pad_x;
-    letterbox.y_pad = pad_y;
-    
-    // Convert to float and normalize
-    cv::Mat floatImg;
-    letterboxed.convertTo(floatImg, CV_32FC3, 1.0 / 255.0);
-    
-    return floatImg;
+LetterboxInfo YOLOv8TensorRTDetector::preprocessToInputBuffer(const cv::Mat& image, int batchIndex) {
+    // Resize, pad, normalize and HWC -> CHW in one pass, no intermediate images
+    size_t planeSize = static_cast<size_t>(m_inputWidth) * m_inputHeight;
+    float* imageBuffer = m_hostInputBuffer + batchIndex * planeSize * 3;
+    return m_preprocessor.toPlanarFloat(image, cv::Size(m_inputWidth, m_inputHeight), imageBuffer);
 }
 
-bool YOLOv8TensorRTDetector::doInference(const cv::Mat& input) {
-    // Convert OpenCV image to CHW format
-    size_t inputSize = m_inputWidth * m_inputHeight * 3;
+bool YOLOv8TensorRTDetector::runInference(int batchSize) {
+    size_t inputSize = static_cast<size_t>(batchSize) * m_inputWidth * m_inputHeight * 3;
+    size_t outputSize = static_cast<size_t>(batchSize) * m_outputElementsPerImage;
 
     // Use default stream if dedicated stream creation failed
     cudaStream_t stream = m_cudaStream ? m_cudaStream : 0;
-    
-    // Split channels and copy to host buffer
-    std::vector<cv::Mat> channels(3);
-    cv::split(input, channels);
-    
-    // Copy in CHW format
-    for (int c = 0; c < 3; ++c) {
-        std::memcpy(m_hostInputBuffer + c * m_inputWidth * m_inputHeight,
-                   channels[c].data,
-                   m_inputWidth * m_inputHeight * sizeof(float));
+
+    if (m_dynamicBatch) {
+        nvinfer1::Dims inputShape = m_inputDims;
+        inputShape.d[0] = batchSize;
+        if (!m_context->setInputShape(m_inputName.c_str(), inputShape)) {
+            LOG_ERROR() << "Failed to set TensorRT input shape for batch " << batchSize;
+            return false;
+        }
     }
-    
+
     // Copy input to device using stream
     if (stream) {
         CUDA_CHECK(cudaMemcpyAsync(m_deviceBuffers[m_inputIndex], m_hostInputBuffer,
@@ -417,7 +417,6 @@ bool YOLOv8TensorRTDetector::doInference(const cv::Mat& input) {
     }
 
     // Copy output back to host using stream
-    size_t outputSize = getSizeByDim(m_outputBoxesDims);
     if (stream) {
         CUDA_CHECK(cudaMemcpyAsync(m_hostOutputBuffer, m_deviceBuffers[m_outputBoxesIndex],
                                   outputSize * sizeof(float), cudaMemcpyDeviceToHost, stream));
@@ -427,10 +426,63 @@ bool YOLOv8TensorRTDetector::doInference(const cv::Mat& input) {
         CUDA_CHECK(cudaMemcpy(m_hostOutputBuffer, m_deviceBuffers[m_outputBoxesIndex],
                              outputSize * sizeof(float), cudaMemcpyDeviceToHost));
     }
-    
+
     return true;
 }
 
+std::vector<std::vector<Detection>> YOLOv8TensorRTDetector::detectObjectsBatch(const std::vector<cv::Mat>& frames) {
+    if (!m_initialized) {
+        LOG_ERROR() << "Detector not initialized";
+        return std::vector<std::vector<Detection>>(frames.size());
+    }
+
+    if (m_engineBatchSize <= 1) {
+        return YOLOv8Detector::detectObjectsBatch(frames);
+    }
+
+    std::vector<std::vector<Detection>> results(frames.size());
+    std::vector<LetterboxInfo> letterboxes(m_engineBatchSize);
+
+    // Run the frames through the engine in chunks of at most m_engineBatchSize
+    for (size_t offset = 0; offset < frames.size(); offset += m_engineBatchSize) {
+        int batchSize = static_cast<int>(std::min(frames.size() - offset, static_cast<size_t>(m_engineBatchSize)));
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        for (int i = 0; i < batchSize; ++i) {
+            letterboxes[i] = preprocessToInputBuffer(frames[offset + i], i);
+        }
+
+        if (!runInference(batchSize)) {
+            LOG_ERROR() << "Batch inference failed (batch " << batchSize << ")";
+            continue;
+        }
+
+        for (int i = 0; i < batchSize; ++i) {
+            auto detections = postprocessResults(
+                m_hostOutputBuffer + i * m_outputElementsPerImage, nullptr,
+                m_outputBoxesDims.d[1],
+                frames[offset + i].size(), letterboxes[i]);
+
+            m_detectionCount += detections.size();
+            results[offset + i] = std::move(detections);
+        }
+
+        // Record per-frame time so averages stay comparable with detectObjects()
+        auto endTime = std::chrono::high_resolution_clock::now();
+        m_inferenceTime = std::chrono::duration<double, std::milli>(endTime - startTime).count() / batchSize;
+        m_inferenceTimes.push_back(m_inferenceTime);
+        if (m_inferenceTimes.size() > 100) {
+            m_inferenceTimes.erase(m_inferenceTimes.begin());
+        }
+    }
+
+    return results;
+}
+
+int YOLOv8TensorRTDetector::getMaxBatchSize() const {
+    return m_engineBatchSize;
+}
+
 std::vector<Detection> YOLOv8TensorRTDetector::postprocessResults(
     float* output, float* scores,
     int numDetections,
@@ -475,6 +527,7 @@ std::vector<Detection> YOLOv8TensorRTDetector::postprocessResults(
     
     int validDetections = 0;
     int personDetections = 0;
+    auto enabledClasses = getEnabledClassMask();
 
     for (int i = 0; i < numDetections; ++i) {
         float cx, cy, w, h;
@@ -526,6 +579,11 @@ std::vector<Detection> YOLOv8TensorRTDetector::postprocessResults(
             continue;
         }
 
+        // Disabled classes never reach box decoding or NMS
+        if (!isClassEnabled(*enabledClasses, bestClass)) {
+            continue;
+        }
+
         validDetections++;
 
         // Debug: Print raw bbox coordinates for high-confidence detections
@@ -589,7 +647,7 @@ std::vector<Detection> YOLOv8TensorRTDetector::postprocessResults(
     }
 
     // Apply NMS
-    auto nmsResults = performNMS(detections);
+    auto nmsResults = applyNMS(detections);
 
     // Debug logging for NMS results
     if (frameCount % 30 == 0 && !nmsResults.empty()) {
@@ -599,65 +657,6 @@ std::vector<Detection> YOLOv8TensorRTDetector::postprocessResults(
     return nmsResults;
 }
 
-std::vector<Detection> YOLOv8TensorRTDetector::performNMS(const std::vector<Detection>& detections) {
-    if (detections.empty()) return {};
-    
-    // Group by class
-    std::map<int, std::vector<int>> classIndices;
-    for (size_t i = 0; i < detections.size(); ++i) {
-        classIndices[detections[i].classId].push_back(i);
-    }
-    
-    std::vector<Detection> result;
-    
-    for (const auto& [classId, indices] : classIndices) {
-        // Sort by confidence
-        std::vector<int> sortedIndices = indices;
-        std::sort(sortedIndices.begin(), sortedIndices.end(),
-            [&detections](int a, int b) {
-                return detections[a].confidence > detections[b].confidence;
-            });
-        
-        std::vector<bool> suppressed(sortedIndices.size(), false);
-        
-        for (size_t i = 0; i < sortedIndices.size(); ++i) {
-            if (suppressed[i]) continue;
-            
-            int idx1 = sortedIndices[i];
-            result.push_back(detections[idx1]);
-            
-            const cv::Rect& box1 = detections[idx1].bbox;
-            
-            for (size_t j = i + 1; j < sortedIndices.size(); ++j) {
-                if (suppressed[j]) continue;
-                
-                int idx2 = sortedIndices[j];
-                const cv::Rect& box2 = detections[idx2].bbox;
-                
-                // Calculate IoU
-                int x1 = std::max(box1.x, box2.x);
-                int y1 = std::max(box1.y, box2.y);
-                int x2 = std::min(box1.x + box1.width, box2.x + box2.width);
-                int y2 = std::min(box1.y + box1.height, box2.y + box2.height);
-                
-                int w = std::max(0, x2 - x1);
-                int h = std::max(0, y2 - y1);
-                
-                float inter = w * h;
-                float area1 = box1.width * box1.height;
-                float area2 = box2.width * box2.height;
-                float iou = inter / (area1 + area2 - inter);
-                
-                if (iou > m_nmsThreshold) {
-                    suppressed[j] = true;
-                }
-            }
-        }
-    }
-    
-    return result;
-}
-
 bool YOLOv8TensorRTDetector::isInitialized() const {
     return m_initialized;
 }
@@ -10,6 +10,7 @@
 #define YOLOV8_TENSORRT_DETECTOR_H
 
 #include "YOLOv8Detector.h"
+#include "LetterboxPreprocessor.h"
 #include <memory>
 #include <vector>
 #include <string>
@@ -36,6 +37,8 @@ public:
     // YOLOv8Detector interface implementation
     bool initialize(const std::string& modelPath) override;
     std::vector<Detection> detectObjects(const cv::Mat& frame) override;
+    std::vector<std::vector<Detection>> detectObjectsBatch(const std::vector<cv::Mat>& frames) override;
+    int getMaxBatchSize() const override;
     bool isInitialized() const override;
     InferenceBackend getCurrentBackend() const override;
     std::string getBackendName() const override;
@@ -74,7 +77,9 @@ private:
     cudaStream_t m_cudaStream;  // Dedicated CUDA stream for inference
     
     // Model properties
-    int m_maxBatchSize = 1;
+    int m_maxBatchSize = 1;         // Requested max batch (optimization profile for dynamic-batch models)
+    int m_engineBatchSize = 1;      // Max batch the loaded engine actually accepts
+    bool m_dynamicBatch = false;    // Engine input has a dynamic batch dimension
     size_t m_workspaceSize = 1ULL << 30; // 1GB default
     std::string m_precision = "FP16";
     int m_dlaCore = -1; // -1 means use GPU
@@ -88,9 +93,11 @@ private:
     nvinfer1::Dims m_inputDims;
     nvinfer1::Dims m_outputBoxesDims;
     nvinfer1::Dims m_outputScoresDims;
+    size_t m_outputElementsPerImage = 0;
     
     // Preprocessing and postprocessing
-    cv::Mat preprocessImageWithLetterbox(const cv::Mat& image, LetterboxInfo& letterbox);
+    LetterboxPreprocessor m_preprocessor;  // BGR order, [0,1], written straight into m_hostInputBuffer
+    LetterboxInfo preprocessToInputBuffer(const cv::Mat& image, int batchIndex);
     std::vector<Detection> postprocessResults(float* boxes, float* scores,
                                             int numDetections,
                                             const cv::Size& originalSize,
@@ -99,10 +106,7 @@ private:
     // Helper methods
     bool allocateBuffers();
     void freeBuffers();
-    bool doInference(const cv::Mat& input);
-    
-    // NMS implementation
-    std::vector<Detection> performNMS(const std::vector<Detection>& detections);
+    bool runInference(int batchSize);
     
     // Utility functions
     size_t getSizeByDim(const nvinfer1::Dims& dims);
@@ -732,6 +732,28 @@ void APIService::setupRoutes() {
         addCorsHeaders(res);
     });
 
+    // Continuous recording: GET .../clip?from=<epoch ms>&to=<epoch ms>
+    m_httpServer->Get(R"(/api/recordings/continuous/([^/]+)/clip$)", [this, addCorsHeaders](const httplib::Request& req, httplib::Response& res) {
+        std::string cameraId = req.matches[1];
+        int64_t fromMs = 0;
+        int64_t toMs = 0;
+        try {
+            fromMs = std::stoll(req.get_param_value("from"));
+            toMs = std::stoll(req.get_param_value("to"));
+        } catch (const std::exception&) {
+            fromMs = toMs = 0;
+        }
+        std::string response;
+        m_recordingController->handleGetClip(cameraId, fromMs, toMs, response);
+        res.set_content(stripHttpHeaders(response), "application/json");
+        addCorsHeaders(res);
+    });
+
+    m_httpServer->Get(R"(/api/recordings/continuous/([^/]+)/segments/([^/]+)$)", [this, addCorsHeaders](const httplib::Request& req, httplib::Response& res) {
+        m_recordingController->handleStreamSegment(req.matches[1], req.matches[2], res);
+        addCorsHeaders(res);
+    });
+
     // ========== Log management endpoints (NEW - Phase 3) ==========
     m_httpServer->Get("/api/logs", [this, addCorsHeaders](const httplib::Request& req, httplib::Response& res) {
         std::string response;
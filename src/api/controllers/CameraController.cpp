@@ -456,6 +456,24 @@ void CameraController::handlePostCameraConfig(const std::string& request, std::s
         ::DatabaseManager dbManager;
         if (dbManager.initialize()) {
             if (dbManager.saveCameraConfig(cameraId, request)) {
+                // Motion gate, detection cadence and region inference settings also apply
+                // to the running pipeline right away
+                auto pipeline = m_taskManager ? m_taskManager->getPipeline(cameraId) : nullptr;
+                if (pipeline) {
+                    auto motionPolicy = pipeline->getMotionGatePolicy();
+                    if (dbManager.getMotionGatePolicy(cameraId, motionPolicy)) {
+                        pipeline->setMotionGatePolicy(motionPolicy);
+                    }
+                    auto cadencePolicy = pipeline->getDetectionCadencePolicy();
+                    if (dbManager.getDetectionCadencePolicy(cameraId, cadencePolicy)) {
+                        pipeline->setDetectionCadencePolicy(cadencePolicy);
+                    }
+                    auto regionPolicy = pipeline->getRegionInferencePolicy();
+                    if (dbManager.getRegionInferencePolicy(cameraId, regionPolicy)) {
+                        pipeline->setRegionInferencePolicy(regionPolicy);
+                    }
+                }
+
                 response = createJsonResponse("{\"status\":\"success\",\"message\":\"Camera configuration saved to database\"}");
                 logInfo("Saved camera configuration to database: " + cameraId);
             } else {
@@ -1,9 +1,14 @@
 #include "RecordingController.h"
 #include "../../database/DatabaseManager.h"
+#include "../../core/TaskManager.h"
+#include "../../core/VideoPipeline.h"
+#include "../../output/SegmentIndex.h"
+#include "../../output/StorageManager.h"
 #include <nlohmann/json.hpp>
 #include <sstream>
 #include <filesystem>
 #include <fstream>
+#include <regex>
 
 using namespace AISecurityVision;
 
@@ -130,6 +135,86 @@ void RecordingController::handleDownloadRecording(const std::string& recordingId
     }
 }
 
+void RecordingController::handleGetClip(const std::string& cameraId, int64_t fromMs, int64_t toMs,
+                                        std::string& response) {
+    try {
+        if (!isValidCameraId(cameraId)) {
+            response = createErrorResponse("Invalid camera ID", 400);
+            return;
+        }
+        if (fromMs <= 0 || toMs < fromMs) {
+            response = createErrorResponse("'from' and 'to' must be epoch milliseconds with from <= to", 400);
+            return;
+        }
+
+        auto parts = SegmentIndex::findRange(getContinuousDirectory(cameraId), fromMs, toMs);
+
+        int64_t coveredMs = 0;
+        std::ostringstream json;
+        json << "{"
+             << "\"camera_id\":\"" << cameraId << "\","
+             << "\"from\":" << fromMs << ","
+             << "\"to\":" << toMs << ","
+             << "\"segments\":[";
+        for (size_t i = 0; i < parts.size(); ++i) {
+            const auto& part = parts[i];
+            coveredMs += part.toMs - part.fromMs;
+            if (i > 0) json << ",";
+            json << "{"
+                 << "\"file\":\"" << part.segment.fileName << "\","
+                 << "\"url\":\"/api/recordings/continuous/" << cameraId << "/segments/" << part.segment.fileName << "\","
+                 << "\"start_ms\":" << part.segment.startMs << ","
+                 << "\"end_ms\":" << part.segment.endMs << ","
+                 << "\"from_ms\":" << part.fromMs << ","
+                 << "\"to_ms\":" << part.toMs << ","
+                 << "\"seek_ms\":" << part.seekMs << ","
+                 << "\"byte_offset\":" << part.byteOffset << ","
+                 << "\"file_size\":" << part.segment.bytes << ","
+                 << "\"complete\":" << (part.segment.complete ? "true" : "false")
+                 << "}";
+        }
+        json << "],"
+             << "\"covered_ms\":" << coveredMs << ","
+             << "\"timestamp\":\"" << getCurrentTimestamp() << "\""
+             << "}";
+
+        response = createJsonResponse(json.str());
+        logDebug("Resolved clip " + std::to_string(fromMs) + "-" + std::to_string(toMs) + " to " +
+                 std::to_string(parts.size()) + " segments", cameraId);
+
+    } catch (const std::exception& e) {
+        response = createErrorResponse("Failed to resolve clip: " + std::string(e.what()), 500);
+    }
+}
+
+void RecordingController::handleStreamSegment(const std::string& cameraId, const std::string& fileName,
+                                              httplib::Response& res) {
+    if (!isValidCameraId(cameraId) || !isValidSegmentName(fileName)) {
+        res.status = 400;
+        res.set_content(stripHttpHeaders(createErrorResponse("Invalid camera ID or segment name", 400)), "application/json");
+        return;
+    }
+
+    // httplib cuts the requested ranges out of the mapping and answers 206;
+    // the bytes go from the page cache to the socket without a read copy
+    std::string path = getContinuousDirectory(cameraId) + "/" + fileName;
+    auto mapping = std::make_shared<httplib::detail::mmap>(path.c_str());
+    if (!mapping->is_open() || mapping->size() == 0) {
+        res.status = 404;
+        res.set_content(stripHttpHeaders(createErrorResponse("Segment not found", 404)), "application/json");
+        return;
+    }
+
+    bool matroska = fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".mkv") == 0;
+    res.set_header("Accept-Ranges", "bytes");
+    res.set_content_provider(
+        mapping->size(), matroska ? "video/x-matroska" : "video/mp4",
+        [mapping](size_t offset, size_t length, httplib::DataSink& sink) {
+            return sink.write(mapping->data() + offset, length);
+        });
+    logDebug("Streaming segment " + fileName, cameraId);
+}
+
 std::vector<RecordingController::RecordingInfo> RecordingController::getRecordingsFromDatabase() {
     std::vector<RecordingInfo> recordings;
 
@@ -180,6 +265,7 @@ bool RecordingController::deleteRecordingFile(const std::string& recordingId) {
         std::string filePath = getRecordingFilePath(recordingId);
         
         if (std::filesystem::exists(filePath)) {
+            StorageManager::getInstance().forgetFile(filePath);
             return std::filesystem::remove(filePath);
         }
         
@@ -197,6 +283,22 @@ std::string RecordingController::getRecordingFilePath(const std::string& recordi
     return "/var/recordings/" + recordingId + ".mp4";
 }
 
+std::string RecordingController::getContinuousDirectory(const std::string& cameraId) {
+    // The camera's own configuration, or the default for cameras not running now
+    RecordingConfig config;
+    if (m_taskManager) {
+        auto pipeline = m_taskManager->getPipeline(cameraId);
+        config = pipeline ? pipeline->getRecordingConfig() : m_taskManager->getDefaultRecordingConfig();
+    }
+    return config.continuousDirectory(cameraId);
+}
+
+bool RecordingController::isValidSegmentName(const std::string& fileName) {
+    // Plain file names of the segment directory only, no paths
+    static const std::regex segmentPattern("^[a-zA-Z0-9_-]+\\.(mp4|mkv)$");
+    return fileName.size() <= 128 && std::regex_match(fileName, segmentPattern);
+}
+
 std::string RecordingController::serializeRecording(const RecordingInfo& recording) {
     std::ostringstream json;
     json << "{"
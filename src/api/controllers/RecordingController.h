@@ -14,6 +14,8 @@ namespace AISecurityVision {
  * - Recording deletion
  * - Recording download
  * - Recording metadata management
+ * - Continuous recording: time-range lookup through the segment index and
+ *   segment playback with HTTP Range support
  */
 class RecordingController : public BaseController {
 public:
@@ -41,6 +43,17 @@ public:
     void handleDeleteRecording(const std::string& recordingId, std::string& response);
     void handleDownloadRecording(const std::string& recordingId, std::string& response);
 
+    // Continuous recording endpoints
+    /**
+     * @brief Resolve a wall-clock range (epoch ms) to the segments covering it
+     */
+    void handleGetClip(const std::string& cameraId, int64_t fromMs, int64_t toMs, std::string& response);
+
+    /**
+     * @brief Serve a segment file memory-mapped, so HTTP Range requests read straight from the page cache
+     */
+    void handleStreamSegment(const std::string& cameraId, const std::string& fileName, httplib::Response& res);
+
 private:
     std::string getControllerName() const override { return "RecordingController"; }
 
@@ -49,6 +62,8 @@ private:
     RecordingInfo getRecordingById(const std::string& recordingId);
     bool deleteRecordingFile(const std::string& recordingId);
     std::string getRecordingFilePath(const std::string& recordingId);
+    std::string getContinuousDirectory(const std::string& cameraId);
+    bool isValidSegmentName(const std::string& fileName);
     
     // JSON serialization
     std::string serializeRecording(const RecordingInfo& recording);
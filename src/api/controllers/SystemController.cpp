@@ -1,5 +1,9 @@
 #include "SystemController.h"
 #include "../../core/TaskManager.h"
+#include "../../core/VideoPipeline.h"
+#include "../../core/FramePool.h"
+#include "../../ai/InferenceScheduler.h"
+#include "../../output/StorageManager.h"
 #include "../../database/DatabaseManager.h"
 #include <nlohmann/json.hpp>
 #include <sstream>
@@ -152,17 +156,180 @@ void SystemController::handleGetPipelineStats(const std::string& request, std::s
 
             json << "{"
                  << "\"id\":\"" << pipelineId << "\","
-                 << "\"status\":\"" << (pipeline ? "active" : "inactive") << "\","
-                 << "\"current_fps\":" << (pipeline ? 25.0 : 0.0) << ","  // TODO: Implement getCurrentFPS
-                 << "\"processed_frames\":" << (pipeline ? 0 : 0) << ","   // TODO: Implement getProcessedFrameCount
-                 << "\"dropped_frames\":" << (pipeline ? 0 : 0) << ","     // TODO: Implement getDroppedFrameCount
-                 << "\"detection_count\":" << (pipeline ? 0 : 0) << ","    // TODO: Implement getTotalDetectionCount
+                 << "\"status\":\"" << (pipeline ? "active" : "inactive") << "\",";
+
+            if (!pipeline) {
+                json << "\"current_fps\":0.0,"
+                     << "\"processed_frames\":0,"
+                     << "\"dropped_frames\":0,"
+                     << "\"detection_count\":0,"
+                     << "\"pipelined\":false,"
+                     << "\"stages\":[],"
+                     << "\"last_frame_time\":\"" << getCurrentTimestamp() << "\""
+                     << "}";
+                continue;
+            }
+
+            auto detectionStats = pipeline->getDetectionStats();
+
+            json << "\"current_fps\":" << pipeline->getFrameRate() << ","
+                 << "\"processed_frames\":" << pipeline->getProcessedFrames() << ","
+                 << "\"dropped_frames\":" << pipeline->getDroppedFrames() << ","
+                 << "\"detection_count\":" << detectionStats.total_detections << ","
+                 << "\"pipelined\":" << (detectionStats.pipelined ? "true" : "false") << ","
+                 << "\"stage_queue_depth\":" << pipeline->getStageQueueDepth() << ","
+                 << "\"stages\":[";
+
+            for (size_t j = 0; j < detectionStats.stages.size(); ++j) {
+                if (j > 0) json << ",";
+
+                const auto& stage = detectionStats.stages[j];
+                json << "{"
+                     << "\"name\":\"" << stage.name << "\","
+                     << "\"queue_depth\":" << stage.queue_depth << ","
+                     << "\"queue_capacity\":" << stage.queue_capacity << ","
+                     << "\"dropped_frames\":" << stage.dropped_frames << ","
+                     << "\"processed_frames\":" << stage.processed_frames << ","
+                     << "\"avg_queue_wait_ms\":" << stage.avg_queue_wait_ms << ","
+                     << "\"avg_latency_ms\":" << stage.avg_latency_ms
+                     << "}";
+            }
+
+            auto poolStats = AISecurityVision::FramePool::getInstance().getStats(pipelineId);
+            const auto& decodeStats = detectionStats.decoder;
+
+            json << "],"
+                 << "\"frame_pool\":{"
+                 << "\"hits\":" << poolStats.hits << ","
+                 << "\"misses\":" << poolStats.misses << ","
+                 << "\"exhausted\":" << poolStats.exhausted << ","
+                 << "\"bytes_copied\":" << poolStats.bytesCopied << ","
+                 << "\"buffers\":" << poolStats.buffers << ","
+                 << "\"buffers_in_use\":" << poolStats.buffersInUse << ","
+                 << "\"capacity\":" << poolStats.capacity
+                 << "},"
+                 << "\"decoder\":{"
+                 << "\"decoded_frames\":" << decodeStats.decodedFrames << ","
+                 << "\"converted_frames\":" << decodeStats.convertedFrames << ","
+                 << "\"skipped_frames\":" << decodeStats.skippedFrames << ","
+                 << "\"dropped_packets\":" << decodeStats.droppedPackets << ","
+                 << "\"decode_time_ms\":" << decodeStats.decodeTimeMs << ","
+                 << "\"avg_pipeline_latency_ms\":" << decodeStats.avgLatencyMs << ","
+                 << "\"threads\":" << decodeStats.threadCount << ","
+                 << "\"frame_threading\":" << (decodeStats.frameThreading ? "true" : "false") << ","
+                 << "\"frame_skip\":\"" << DecodePolicy::frameSkipName(decodeStats.activeSkip) << "\","
+                 << "\"frame_interval\":" << decodeStats.activeInterval << ","
+                 << "\"adaptive_level\":" << decodeStats.adaptiveLevel
+                 << "},"
+                 << "\"motion_gate\":{"
+                 << "\"enabled\":" << (detectionStats.motionGate.enabled ? "true" : "false") << ","
+                 << "\"evaluated_frames\":" << detectionStats.motionGate.evaluatedFrames << ","
+                 << "\"skipped_frames\":" << detectionStats.motionGate.skippedFrames << ","
+                 << "\"skipped_ratio\":" << detectionStats.motionGate.skippedRatio << ","
+                 << "\"motion_score\":" << detectionStats.motionGate.lastMotionScore << ","
+                 << "\"static_frames\":" << detectionStats.motionGate.staticFrames << ","
+                 << "\"motion_vector_frames\":" << detectionStats.motionGate.motionVectorFrames
+                 << "},"
+                 << "\"detection_cadence\":{"
+                 << "\"interval\":" << detectionStats.cadence.activeInterval << ","
+                 << "\"detected_frames\":" << detectionStats.cadence.detectedFrames << ","
+                 << "\"propagated_frames\":" << detectionStats.cadence.propagatedFrames << ","
+                 << "\"propagated_ratio\":" << detectionStats.cadence.propagatedRatio << ","
+                 << "\"avg_inference_ms\":" << detectionStats.cadence.avgInferenceMs << ","
+                 << "\"track_speed\":" << detectionStats.cadence.trackSpeed
+                 << "},"
+                 << "\"inference_regions\":{"
+                 << "\"mode\":\"" << detectionStats.regions.mode << "\","
+                 << "\"region_frames\":" << detectionStats.regions.regionFrames << ","
+                 << "\"last_region_count\":" << detectionStats.regions.lastRegionCount
+                 << "},"
+                 << "\"reid_cache\":{"
+                 << "\"lookups\":" << detectionStats.reidCache.lookups << ","
+                 << "\"hits\":" << detectionStats.reidCache.hits << ","
+                 << "\"hit_rate\":" << detectionStats.reidCache.hitRate << ","
+                 << "\"avg_extraction_ms\":" << detectionStats.reidCache.avgExtractionMs << ","
+                 << "\"saved_ms\":" << detectionStats.reidCache.savedMs << ","
+                 << "\"entries\":" << detectionStats.reidCache.entries
+                 << "},"
+                 << "\"person_attributes\":{"
+                 << "\"persons\":" << detectionStats.personAttributes.persons << ","
+                 << "\"analysed\":" << detectionStats.personAttributes.analysed << ","
+                 << "\"hit_rate\":" << detectionStats.personAttributes.hitRate << ","
+                 << "\"tracks\":" << detectionStats.personAttributes.tracks << ","
+                 << "\"confident_tracks\":" << detectionStats.personAttributes.confidentTracks
+                 << "},"
+                 << "\"recording\":{"
+                 << "\"active\":" << (detectionStats.recording.recording ? "true" : "false") << ","
+                 << "\"continuous\":" << (detectionStats.recording.continuous ? "true" : "false") << ","
+                 << "\"backlog\":" << detectionStats.recording.backlog << ","
+                 << "\"queue_capacity\":" << detectionStats.recording.queueCapacity << ","
+                 << "\"dropped_items\":" << detectionStats.recording.droppedItems << ","
+                 << "\"dropped_frames\":" << detectionStats.recording.droppedFrames << ","
+                 << "\"resyncs\":" << detectionStats.recording.resyncs << ","
+                 << "\"write_latency_ms\":" << detectionStats.recording.writeLatencyMs << ","
+                 << "\"max_write_latency_ms\":" << detectionStats.recording.maxWriteLatencyMs << ","
+                 << "\"pre_event_bytes\":" << detectionStats.recording.preEventBytes << ","
+                 << "\"storage_bytes\":" << StorageManager::getInstance().getCameraBytes(pipelineId)
+                 << "},"
                  << "\"last_frame_time\":\"" << getCurrentTimestamp() << "\""
                  << "}";
         }
 
-        json << "],"
-             << "\"timestamp\":\"" << getCurrentTimestamp() << "\""
+        json << "],";
+
+        // Shared batched inference scheduler, if running
+        auto* scheduler = m_taskManager->getInferenceScheduler();
+        if (scheduler && scheduler->isRunning()) {
+            auto schedulerStats = scheduler->getStats();
+            const auto& waitBuckets = AISecurityVision::InferenceScheduler::getQueueWaitBucketsMs();
+
+            json << "\"inference_scheduler\":{"
+                 << "\"backend\":\"" << scheduler->getBackendName() << "\","
+                 << "\"max_batch_size\":" << scheduler->getConfig().maxBatchSize << ","
+                 << "\"max_wait_ms\":" << scheduler->getConfig().maxWaitMs << ","
+                 << "\"batches\":" << schedulerStats.batches << ","
+                 << "\"frames\":" << schedulerStats.frames << ","
+                 << "\"rejected\":" << schedulerStats.rejected << ","
+                 << "\"queue_depth\":" << schedulerStats.queueDepth << ","
+                 << "\"avg_batch_latency_ms\":" << schedulerStats.avgBatchLatencyMs << ","
+                 << "\"avg_queue_wait_ms\":" << schedulerStats.avgQueueWaitMs << ","
+                 << "\"batch_fill_histogram\":[";
+
+            for (size_t j = 0; j < schedulerStats.batchFillHistogram.size(); ++j) {
+                if (j > 0) json << ",";
+                json << schedulerStats.batchFillHistogram[j];
+            }
+
+            json << "],\"queue_wait_histogram\":[";
+
+            for (size_t j = 0; j < schedulerStats.queueWaitHistogram.size(); ++j) {
+                if (j > 0) json << ",";
+                json << "{\"le_ms\":";
+                if (j < waitBuckets.size()) {
+                    json << waitBuckets[j];
+                } else {
+                    json << "null";
+                }
+                json << ",\"count\":" << schedulerStats.queueWaitHistogram[j] << "}";
+            }
+
+            json << "]},";
+        }
+
+        // Recording storage across all cameras
+        auto storageStats = StorageManager::getInstance().getStats();
+        json << "\"recording_storage\":{"
+             << "\"total_bytes\":" << storageStats.totalBytes << ","
+             << "\"index_bytes\":" << storageStats.indexBytes << ","
+             << "\"pinned_bytes\":" << storageStats.pinnedBytes << ","
+             << "\"quota_bytes\":" << storageStats.quotaBytes << ","
+             << "\"files\":" << storageStats.files << ","
+             << "\"evicted_files\":" << storageStats.evictedFiles << ","
+             << "\"evicted_bytes\":" << storageStats.evictedBytes << ","
+             << "\"oldest_ms\":" << storageStats.oldestMs
+             << "},";
+
+        json << "\"timestamp\":\"" << getCurrentTimestamp() << "\""
              << "}";
 
         response = createJsonResponse(json.str());
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Bounded multi-producer/single-consumer hand-off queue
+ *
+ * Connects pipeline stages; any number of threads may push (all operations
+ * take the queue mutex), one thread pops. When the queue is full, push() discards the
+ * oldest queued item instead of blocking the producer, so a slow consumer
+ * never stalls an upstream stage (e.g. decode keeps draining the socket
+ * while inference is busy) and the consumer always sees the freshest data.
+ *
+ * close() wakes a blocked consumer so stage threads can exit promptly;
+ * reopen() makes the same queue usable again, so its owner can keep it for
+ * its whole lifetime and observers never see it replaced.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : m_capacity(capacity > 0 ? capacity : 1) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief Enqueue an item, dropping the oldest one if the queue is full
+     * @return false if the queue is closed or an older item was dropped
+     */
+    bool push(T item) {
+        bool dropped = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_closed) {
+                return false;
+            }
+            if (m_items.size() >= m_capacity) {
+                m_items.pop_front();
+                m_dropped.fetch_add(1);
+                dropped = true;
+            }
+            m_items.push_back(std::move(item));
+            m_size.store(m_items.size());
+        }
+        m_notEmpty.notify_one();
+        return !dropped;
+    }
+
+    /**
+     * @brief Dequeue the oldest item, waiting up to timeout for one to arrive
+     * @return false on timeout or if the queue was closed and is empty
+     */
+    bool pop(T& item, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_notEmpty.wait_for(lock, timeout, [this] { return !m_items.empty() || m_closed; })) {
+            return false;
+        }
+        if (m_items.empty()) {
+            return false;
+        }
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_size.store(m_items.size());
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notEmpty.notify_all();
+    }
+
+    /**
+     * @brief Discard queued items and accept pushes again with a new capacity
+     */
+    void reopen(size_t capacity) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_items.clear();
+        m_size.store(0);
+        m_capacity.store(capacity > 0 ? capacity : 1);
+        m_closed = false;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_items.clear();
+        m_size.store(0);
+    }
+
+    // Lock-free observers for statistics
+    size_t size() const { return m_size.load(); }
+    size_t capacity() const { return m_capacity.load(); }
+    uint64_t droppedCount() const { return m_dropped.load(); }
+
+private:
+    std::atomic<size_t> m_capacity;
+    std::deque<T> m_items;
+    bool m_closed = false;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+
+    std::atomic<size_t> m_size{0};
+    std::atomic<uint64_t> m_dropped{0};
+};
+
+} // namespace AISecurityVision
@@ -0,0 +1,96 @@
+#include "DetectionCadence.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AISecurityVision {
+
+DetectionCadence::DetectionCadence()
+    : m_policy(std::make_shared<const DetectionCadencePolicy>()) {
+}
+
+void DetectionCadence::setPolicy(const DetectionCadencePolicy& policy) {
+    DetectionCadencePolicy sanitized = policy;
+    sanitized.interval = std::min(DetectionCadencePolicy::MAX_INTERVAL, std::max(1, sanitized.interval));
+    sanitized.frameBudgetMs = std::max(0.0, sanitized.frameBudgetMs);
+    sanitized.maxDrift = std::max(0.0f, sanitized.maxDrift);
+
+    auto stored = std::make_shared<const DetectionCadencePolicy>(sanitized);
+    std::atomic_store(&m_policy, stored);
+    updateInterval(*stored);
+    m_forceNext.store(true);
+}
+
+DetectionCadencePolicy DetectionCadence::getPolicy() const {
+    return *std::atomic_load(&m_policy);
+}
+
+bool DetectionCadence::isDue() {
+    // A frame that was due but not detected (motion gate) keeps the next one due
+    if (m_forceNext.load() || ++m_framesSinceDetection >= m_interval.load()) {
+        return true;
+    }
+    m_propagatedFrames.fetch_add(1);
+    return false;
+}
+
+void DetectionCadence::onDetection(double inferenceMs) {
+    m_framesSinceDetection = 0;
+    m_forceNext.store(false);
+    m_detectedFrames.fetch_add(1);
+
+    double ema = m_latencyEma.load();
+    m_latencyEma.store(ema > 0.0 ? ema + LATENCY_EMA_ALPHA * (inferenceMs - ema) : inferenceMs);
+    updateInterval(*std::atomic_load(&m_policy));
+}
+
+void DetectionCadence::reportActivity(float trackSpeed, size_t newTracks) {
+    m_trackSpeed.store(trackSpeed);
+    m_newTracks.store(newTracks);
+    updateInterval(*std::atomic_load(&m_policy));
+}
+
+bool DetectionCadence::isOpticalFlowEnabled() const {
+    return std::atomic_load(&m_policy)->opticalFlow;
+}
+
+void DetectionCadence::updateInterval(const DetectionCadencePolicy& policy) {
+    const int upper = policy.interval;
+    if (!policy.adaptive) {
+        m_interval.store(upper);
+        return;
+    }
+
+    // Scene activity: frames until the fastest track drifts by maxDrift of its size
+    float speed = m_trackSpeed.load();
+    int activity = upper;
+    if (speed > 0.0f) {
+        activity = std::min(upper, std::max(1, static_cast<int>(policy.maxDrift / speed)));
+    }
+    if (m_newTracks.load() > 0) {
+        activity = std::max(1, activity / 2);
+    }
+
+    // Inference latency: never ask for detections faster than the engine delivers them
+    int latency = 1;
+    double latencyMs = m_latencyEma.load();
+    if (policy.frameBudgetMs > 0.0 && latencyMs > 0.0) {
+        latency = std::min(upper, std::max(1, static_cast<int>(std::ceil(latencyMs / policy.frameBudgetMs))));
+    }
+
+    m_interval.store(std::max(activity, latency));
+}
+
+DetectionCadenceStats DetectionCadence::getStats() const {
+    DetectionCadenceStats stats;
+    stats.activeInterval = m_interval.load();
+    stats.detectedFrames = m_detectedFrames.load();
+    stats.propagatedFrames = m_propagatedFrames.load();
+    uint64_t total = stats.detectedFrames + stats.propagatedFrames;
+    stats.propagatedRatio = total > 0 ? static_cast<double>(stats.propagatedFrames) / total : 0.0;
+    stats.avgInferenceMs = m_latencyEma.load();
+    stats.trackSpeed = m_trackSpeed.load();
+    return stats;
+}
+
+} // namespace AISecurityVision
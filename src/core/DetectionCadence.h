@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Per-camera detect-every-N-frames configuration
+ *
+ * Detection runs on one frame in interval; on the frames in between the
+ * tracker propagates the tracks (Kalman prediction, optionally corrected by
+ * sparse optical flow). With adaptive enabled, interval is an upper bound and
+ * the effective N follows the scene and the inference engine:
+ *  - activity: N is the number of frames the fastest track needs to drift by
+ *    maxDrift of its own size, halved while new tracks are being born, and
+ *    maxInterval on an empty scene
+ *  - latency: N is at least ceil(inference latency / frameBudgetMs), so a busy
+ *    shared engine is not asked for more than it can deliver
+ */
+struct DetectionCadencePolicy {
+    int interval = 1;               // Detect one frame in N (upper bound when adaptive)
+    bool adaptive = false;
+    double frameBudgetMs = 0.0;     // Inference time available per frame, 0 = source frame period
+    float maxDrift = 0.25f;         // Tolerated prediction drift between detections, in box sizes
+    bool opticalFlow = false;       // Refine propagated boxes with sparse optical flow
+
+    static constexpr int DEFAULT_ADAPTIVE_INTERVAL = 5;    // Upper bound when adaptive is enabled without one
+    static constexpr int MAX_INTERVAL = 30;
+};
+
+/**
+ * @brief Detection cadence counters and the interval currently in effect
+ */
+struct DetectionCadenceStats {
+    int activeInterval = 1;
+    uint64_t detectedFrames = 0;
+    uint64_t propagatedFrames = 0;  // Frames served by track propagation
+    double propagatedRatio = 0.0;
+    double avgInferenceMs = 0.0;
+    float trackSpeed = 0.0f;        // Fastest track, box sizes per frame
+};
+
+/**
+ * @brief Decides which frames run detection in detect-every-N mode
+ *
+ * isDue() is called by the inference stage for every frame, onDetection()
+ * after each detector run and reportActivity() by the analytics stage after
+ * each tracker update from real detections. The stages may run on different
+ * threads; state shared between them is atomic.
+ */
+class DetectionCadence {
+public:
+    DetectionCadence();
+
+    void setPolicy(const DetectionCadencePolicy& policy);
+    DetectionCadencePolicy getPolicy() const;
+
+    /**
+     * @brief Advance by one frame
+     * @return true if this frame should run detection
+     */
+    bool isDue();
+
+    /**
+     * @brief Record a detector run and its latency
+     */
+    void onDetection(double inferenceMs);
+
+    /**
+     * @brief Feed the activity estimate after a tracker update from detections
+     * @param trackSpeed Fastest track's displacement per frame relative to its box size, 0 without tracks
+     * @param newTracks Tracks born in this update
+     */
+    void reportActivity(float trackSpeed, size_t newTracks);
+
+    bool isOpticalFlowEnabled() const;
+
+    DetectionCadenceStats getStats() const;
+
+private:
+    void updateInterval(const DetectionCadencePolicy& policy);
+
+    std::shared_ptr<const DetectionCadencePolicy> m_policy;
+
+    std::atomic<int> m_interval{1};
+    int m_framesSinceDetection = 0;     // Inference stage only
+    std::atomic<bool> m_forceNext{true};    // Detect the next frame (start, policy change)
+
+    std::atomic<double> m_latencyEma{0.0};
+    std::atomic<float> m_trackSpeed{0.0f};
+    std::atomic<size_t> m_newTracks{0};
+
+    std::atomic<uint64_t> m_detectedFrames{0};
+    std::atomic<uint64_t> m_propagatedFrames{0};
+
+    static constexpr double LATENCY_EMA_ALPHA = 0.2;
+};
+
+} // namespace AISecurityVision
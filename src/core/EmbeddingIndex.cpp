@@ -0,0 +1,451 @@
+#include "EmbeddingIndex.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <xmmintrin.h>
+#endif
+
+namespace AISecurityVision {
+
+namespace {
+
+constexpr size_t FLOATS_PER_BLOCK = EmbeddingIndex::ALIGNMENT / sizeof(float);
+constexpr int KMEANS_ITERATIONS = 8;
+
+int64_t ticks(std::chrono::steady_clock::time_point t) {
+    return t.time_since_epoch().count();
+}
+
+float innerProduct(const std::vector<float>& a, const std::vector<float>& b) {
+    return std::inner_product(a.begin(), a.end(), b.begin(), 0.0f);
+}
+
+} // namespace
+
+void EmbeddingIndex::AlignedFree::operator()(float* p) const {
+    std::free(p);
+}
+
+EmbeddingIndex::EmbeddingIndex() : EmbeddingIndex(Config()) {}
+
+EmbeddingIndex::EmbeddingIndex(const Config& config)
+    : m_config(config), m_snapshot(std::make_shared<const Snapshot>()) {}
+
+EmbeddingIndex::~EmbeddingIndex() = default;
+
+EmbeddingIndex::AlignedBuffer EmbeddingIndex::allocateAligned(size_t floats) {
+    if (floats == 0) {
+        return nullptr;
+    }
+    // floats is a multiple of FLOATS_PER_BLOCK, so the size is a multiple of the alignment
+    auto* p = static_cast<float*>(std::aligned_alloc(ALIGNMENT, floats * sizeof(float)));
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    std::memset(p, 0, floats * sizeof(float));
+    return AlignedBuffer(p);
+}
+
+size_t EmbeddingIndex::paddedStride(size_t dimension) {
+    return (dimension + FLOATS_PER_BLOCK - 1) / FLOATS_PER_BLOCK * FLOATS_PER_BLOCK;
+}
+
+bool EmbeddingIndex::normalize(const std::vector<float>& in, std::vector<float>& out) {
+    float norm = std::sqrt(innerProduct(in, in));
+    if (!(norm > 0.0f) || !std::isfinite(norm)) {
+        return false;
+    }
+    out.resize(in.size());
+    const float inv = 1.0f / norm;
+    for (size_t i = 0; i < in.size(); ++i) {
+        out[i] = in[i] * inv;
+    }
+    return true;
+}
+
+// stride is a multiple of FLOATS_PER_BLOCK and the padding is zero on both sides
+float EmbeddingIndex::dot(const float* a, const float* b, size_t stride) {
+#if defined(__AVX2__) && defined(__FMA__)
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (size_t i = 0; i < stride; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#elif defined(__ARM_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    float32x4_t acc2 = vdupq_n_f32(0.0f);
+    float32x4_t acc3 = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < stride; i += 16) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        acc2 = vmlaq_f32(acc2, vld1q_f32(a + i + 8), vld1q_f32(b + i + 8));
+        acc3 = vmlaq_f32(acc3, vld1q_f32(a + i + 12), vld1q_f32(b + i + 12));
+    }
+    float32x4_t acc = vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3));
+#if defined(__aarch64__)
+    return vaddvq_f32(acc);
+#else
+    float32x2_t half = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+#elif defined(__SSE2__)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps();
+    __m128 acc3 = _mm_setzero_ps();
+    for (size_t i = 0; i < stride; i += 16) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+    }
+    __m128 sum = _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#else
+    float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < stride; i += 4) {
+        acc[0] += a[i] * b[i];
+        acc[1] += a[i + 1] * b[i + 1];
+        acc[2] += a[i + 2] * b[i + 2];
+        acc[3] += a[i + 3] * b[i + 3];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+
+uint64_t EmbeddingIndex::partitionBit(const std::string& partition) {
+    auto it = m_partitionBits.find(partition);
+    if (it != m_partitionBits.end()) {
+        return it->second;
+    }
+    // Partitions past MAX_PARTITIONS share the last bit; excluding one of them
+    // then excludes all of them, which only makes matching more conservative
+    size_t index = std::min(m_partitionBits.size(), MAX_PARTITIONS - 1);
+    uint64_t bit = uint64_t{1} << index;
+    m_partitionBits.emplace(partition, bit);
+    return bit;
+}
+
+void EmbeddingIndex::upsert(int id, const std::string& partition, const std::vector<float>& features,
+                            std::chrono::steady_clock::time_point lastSeen) {
+    if (features.empty()) {
+        return;
+    }
+
+    std::vector<float> normalized;
+    if (!normalize(features, normalized)) {
+        m_rejected.fetch_add(1);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (m_dimension == 0) {
+        m_dimension = normalized.size();
+    } else if (normalized.size() != m_dimension) {
+        m_rejected.fetch_add(1);
+        return;
+    }
+
+    if (m_pending.empty()) {
+        m_oldestPending = std::chrono::steady_clock::now();
+    }
+
+    auto [it, inserted] = m_pending.try_emplace(id);
+    Pending& pending = it->second;
+    if (pending.remove) {
+        pending = Pending();
+    }
+    if (inserted && m_entries.find(id) == m_entries.end()) {
+        m_pendingNewIds = true;
+    }
+    pending.features = std::move(normalized);
+    pending.partitionMask |= partitionBit(partition);
+    pending.lastSeen = std::max(pending.lastSeen, ticks(lastSeen));
+}
+
+void EmbeddingIndex::remove(int id) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (m_pending.empty()) {
+        m_oldestPending = std::chrono::steady_clock::now();
+    }
+    Pending& pending = m_pending[id];
+    pending = Pending();
+    pending.remove = true;
+}
+
+size_t EmbeddingIndex::commit() {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    return commitLocked();
+}
+
+size_t EmbeddingIndex::commitIfDue() {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (m_pending.empty()) {
+        return 0;
+    }
+    auto age = std::chrono::steady_clock::now() - m_oldestPending;
+    if (!m_pendingNewIds && m_pending.size() < m_config.commitBatchSize &&
+        age < std::chrono::milliseconds(m_config.commitIntervalMs)) {
+        return 0;
+    }
+    return commitLocked();
+}
+
+size_t EmbeddingIndex::commitLocked() {
+    size_t applied = m_pending.size();
+    if (applied == 0) {
+        return 0;
+    }
+
+    for (auto& [id, pending] : m_pending) {
+        if (pending.remove) {
+            m_entries.erase(id);
+            continue;
+        }
+        Entry& entry = m_entries[id];
+        entry.features = std::move(pending.features);
+        entry.partitionMask |= pending.partitionMask;
+        entry.lastSeen = std::max(entry.lastSeen, pending.lastSeen);
+    }
+    m_pending.clear();
+    m_pendingNewIds = false;
+
+    if (m_entries.empty()) {
+        m_dimension = 0;
+        m_centroids.clear();
+        m_trainedRows = 0;
+    }
+
+    std::atomic_store(&m_snapshot, buildSnapshot());
+    m_commits.fetch_add(1);
+    return applied;
+}
+
+void EmbeddingIndex::trainCentroids(size_t lists) {
+    // Spherical k-means seeded with evenly spaced rows
+    std::vector<const std::vector<float>*> rows;
+    rows.reserve(m_entries.size());
+    for (const auto& [id, entry] : m_entries) {
+        rows.push_back(&entry.features);
+    }
+
+    m_centroids.assign(lists, std::vector<float>());
+    for (size_t l = 0; l < lists; ++l) {
+        m_centroids[l] = *rows[l * rows.size() / lists];
+    }
+
+    std::vector<std::vector<float>> sums(lists, std::vector<float>(m_dimension));
+    for (int iter = 0; iter < KMEANS_ITERATIONS; ++iter) {
+        for (auto& sum : sums) {
+            std::fill(sum.begin(), sum.end(), 0.0f);
+        }
+        for (const auto* row : rows) {
+            size_t best = 0;
+            float bestSimilarity = -2.0f;
+            for (size_t l = 0; l < lists; ++l) {
+                float similarity = innerProduct(*row, m_centroids[l]);
+                if (similarity > bestSimilarity) {
+                    bestSimilarity = similarity;
+                    best = l;
+                }
+            }
+            for (size_t d = 0; d < m_dimension; ++d) {
+                sums[best][d] += (*row)[d];
+            }
+        }
+        for (size_t l = 0; l < lists; ++l) {
+            // An empty cluster keeps its previous centroid
+            normalize(sums[l], m_centroids[l]);
+        }
+    }
+
+    m_trainedRows = rows.size();
+}
+
+std::shared_ptr<const EmbeddingIndex::Snapshot> EmbeddingIndex::buildSnapshot() {
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->dimension = m_dimension;
+    snapshot->stride = paddedStride(m_dimension);
+    snapshot->rows = m_entries.size();
+    snapshot->partitionBits = m_partitionBits;
+
+    const size_t rows = snapshot->rows;
+    const size_t stride = snapshot->stride;
+
+    size_t lists = 0;
+    if (m_config.ivfLists > 0 && rows >= std::max(m_config.ivfMinRows, m_config.ivfLists)) {
+        lists = m_config.ivfLists;
+        bool stale = m_centroids.size() != lists ||
+                     m_centroids.front().size() != m_dimension ||
+                     rows > 2 * m_trainedRows || 2 * rows < m_trainedRows;
+        if (stale) {
+            trainCentroids(lists);
+        }
+    }
+
+    // Assign rows to lists and lay them out grouped by list
+    std::vector<std::pair<size_t, const std::pair<const int, Entry>*>> order;
+    order.reserve(rows);
+    for (const auto& item : m_entries) {
+        size_t list = 0;
+        if (lists > 0) {
+            float bestSimilarity = -2.0f;
+            for (size_t l = 0; l < lists; ++l) {
+                float similarity = innerProduct(item.second.features, m_centroids[l]);
+                if (similarity > bestSimilarity) {
+                    bestSimilarity = similarity;
+                    list = l;
+                }
+            }
+        }
+        order.emplace_back(list, &item);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    snapshot->matrix = allocateAligned(rows * stride);
+    snapshot->ids.reserve(rows);
+    snapshot->partitionMasks.reserve(rows);
+    snapshot->lastSeen.reserve(rows);
+    snapshot->listOffsets.assign(std::max<size_t>(lists, 1) + 1, 0);
+
+    for (size_t r = 0; r < rows; ++r) {
+        const auto& [list, item] = order[r];
+        const Entry& entry = item->second;
+        std::copy(entry.features.begin(), entry.features.end(), snapshot->matrix.get() + r * stride);
+        snapshot->ids.push_back(item->first);
+        snapshot->partitionMasks.push_back(entry.partitionMask);
+        snapshot->lastSeen.push_back(entry.lastSeen);
+        snapshot->listOffsets[list + 1]++;
+    }
+    std::partial_sum(snapshot->listOffsets.begin(), snapshot->listOffsets.end(),
+                     snapshot->listOffsets.begin());
+
+    if (lists > 0) {
+        snapshot->centroids = allocateAligned(lists * stride);
+        for (size_t l = 0; l < lists; ++l) {
+            std::copy(m_centroids[l].begin(), m_centroids[l].end(), snapshot->centroids.get() + l * stride);
+        }
+    }
+
+    return snapshot;
+}
+
+void EmbeddingIndex::scanRows(const Snapshot& snapshot, const float* query, size_t begin, size_t end,
+                              float minSimilarity, uint64_t excludeMask, int64_t seenSince,
+                              std::vector<Match>& out) const {
+    const float* row = snapshot.matrix.get() + begin * snapshot.stride;
+    for (size_t r = begin; r < end; ++r, row += snapshot.stride) {
+        if ((snapshot.partitionMasks[r] & excludeMask) || snapshot.lastSeen[r] < seenSince) {
+            continue;
+        }
+        float similarity = dot(query, row, snapshot.stride);
+        if (similarity >= minSimilarity) {
+            out.push_back({snapshot.ids[r], similarity});
+        }
+    }
+}
+
+std::vector<EmbeddingIndex::Match> EmbeddingIndex::search(const std::vector<float>& query, float minSimilarity,
+                                                          size_t maxResults, const std::string& excludePartition,
+                                                          std::chrono::steady_clock::time_point seenSince) const {
+    std::vector<Match> matches;
+    auto snapshot = std::atomic_load(&m_snapshot);
+    if (snapshot->rows == 0 || query.size() != snapshot->dimension) {
+        return matches;
+    }
+    m_searches.fetch_add(1, std::memory_order_relaxed);
+
+    // Padded, normalised copy of the query
+    thread_local std::vector<float> normalized;
+    if (!normalize(query, normalized)) {
+        return matches;
+    }
+    normalized.resize(snapshot->stride, 0.0f);
+    std::fill(normalized.begin() + snapshot->dimension, normalized.end(), 0.0f);
+
+    uint64_t excludeMask = 0;
+    if (!excludePartition.empty()) {
+        auto it = snapshot->partitionBits.find(excludePartition);
+        if (it != snapshot->partitionBits.end()) {
+            excludeMask = it->second;
+        }
+    }
+    const int64_t since = ticks(seenSince);
+    const size_t lists = snapshot->listOffsets.size() - 1;
+
+    if (!snapshot->centroids || lists <= m_config.ivfProbes) {
+        scanRows(*snapshot, normalized.data(), 0, snapshot->rows, minSimilarity, excludeMask, since, matches);
+    } else {
+        // Probe the lists whose centroids are closest to the query
+        std::vector<std::pair<float, size_t>> ranked(lists);
+        for (size_t l = 0; l < lists; ++l) {
+            ranked[l] = {dot(normalized.data(), snapshot->centroids.get() + l * snapshot->stride, snapshot->stride), l};
+        }
+        size_t probes = std::max<size_t>(m_config.ivfProbes, 1);
+        std::partial_sort(ranked.begin(), ranked.begin() + probes, ranked.end(),
+                          [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (size_t p = 0; p < probes; ++p) {
+            size_t l = ranked[p].second;
+            scanRows(*snapshot, normalized.data(), snapshot->listOffsets[l], snapshot->listOffsets[l + 1],
+                     minSimilarity, excludeMask, since, matches);
+        }
+    }
+
+    auto byScore = [](const Match& a, const Match& b) { return a.similarity > b.similarity; };
+    if (maxResults > 0 && matches.size() > maxResults) {
+        std::partial_sort(matches.begin(), matches.begin() + maxResults, matches.end(), byScore);
+        matches.resize(maxResults);
+    } else {
+        std::sort(matches.begin(), matches.end(), byScore);
+    }
+    return matches;
+}
+
+void EmbeddingIndex::clear() {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    m_entries.clear();
+    m_pending.clear();
+    m_partitionBits.clear();
+    m_centroids.clear();
+    m_dimension = 0;
+    m_trainedRows = 0;
+    m_pendingNewIds = false;
+    std::atomic_store(&m_snapshot, std::shared_ptr<const Snapshot>(std::make_shared<const Snapshot>()));
+}
+
+EmbeddingIndex::Stats EmbeddingIndex::getStats() const {
+    Stats stats;
+    auto snapshot = std::atomic_load(&m_snapshot);
+    stats.rows = snapshot->rows;
+    stats.dimension = snapshot->dimension;
+    stats.lists = snapshot->centroids ? snapshot->listOffsets.size() - 1 : 0;
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        stats.pending = m_pending.size();
+    }
+    stats.commits = m_commits.load();
+    stats.searches = m_searches.load();
+    stats.rejected = m_rejected.load();
+    return stats;
+}
+
+} // namespace AISecurityVision
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Cosine-similarity index over ReID embeddings for cross-camera matching
+ *
+ * Embeddings are L2-normalised on insertion and stored row by row in one
+ * contiguous, 64-byte aligned matrix whose row stride is padded to a whole
+ * number of SIMD registers, so similarity is a single dot product per row.
+ *
+ * Every row carries a bitmask of the partitions (cameras) it has been seen in
+ * and a last-seen timestamp, so a search can skip a camera's own tracks and
+ * expired tracks without consulting the caller's data structures.
+ *
+ * Readers never lock: search() works on an immutable snapshot obtained with an
+ * atomic shared_ptr load. Writers stage upserts and removals, which are
+ * coalesced per id and published as a new snapshot by commit(). Staged changes
+ * are invisible to search() until then.
+ *
+ * With ivfLists > 0 and enough rows, the snapshot is additionally organised as
+ * an inverted file: rows are clustered by spherical k-means and stored grouped
+ * by cluster, and a search only scans the ivfProbes clusters closest to the
+ * query. Below ivfMinRows the search is always exact.
+ */
+class EmbeddingIndex {
+public:
+    struct Config {
+        size_t ivfLists = 0;        // Coarse clusters; 0 = exact search only
+        size_t ivfProbes = 4;       // Clusters scanned per query
+        size_t ivfMinRows = 256;    // Row count from which clustering is used
+        size_t commitBatchSize = 64;    // Staged changes that trigger commitIfDue()
+        int commitIntervalMs = 100;     // Staging age that triggers commitIfDue()
+    };
+
+    struct Match {
+        int id;
+        float similarity;
+    };
+
+    struct Stats {
+        size_t rows = 0;            // Rows in the published snapshot
+        size_t dimension = 0;       // Embedding dimension (0 while empty)
+        size_t lists = 0;           // IVF clusters in use (0 = exact)
+        size_t pending = 0;         // Staged, unpublished changes
+        uint64_t commits = 0;
+        uint64_t searches = 0;
+        uint64_t rejected = 0;      // Upserts dropped (dimension mismatch or zero norm)
+    };
+
+    EmbeddingIndex();
+    explicit EmbeddingIndex(const Config& config);
+    ~EmbeddingIndex();
+
+    EmbeddingIndex(const EmbeddingIndex&) = delete;
+    EmbeddingIndex& operator=(const EmbeddingIndex&) = delete;
+
+    /**
+     * @brief Stage a new or refreshed embedding for an id seen in a partition
+     *
+     * The row's partition mask accumulates every partition it was upserted
+     * from. Embeddings whose dimension differs from the index's are rejected.
+     */
+    void upsert(int id, const std::string& partition, const std::vector<float>& features,
+                std::chrono::steady_clock::time_point lastSeen = std::chrono::steady_clock::now());
+
+    /**
+     * @brief Stage removal of an id
+     */
+    void remove(int id);
+
+    /**
+     * @brief Publish all staged changes as a new snapshot
+     * @return Number of staged changes applied
+     */
+    size_t commit();
+
+    /**
+     * @brief Commit if a new id is staged, the batch is full or the oldest
+     *        staged change exceeds the commit interval
+     */
+    size_t commitIfDue();
+
+    /**
+     * @brief Find rows whose cosine similarity to the query is at least minSimilarity
+     * @param query Raw (unnormalised) embedding
+     * @param minSimilarity Similarity threshold
+     * @param maxResults Maximum matches to return, 0 = all
+     * @param excludePartition Skip rows seen in this partition ("" = none)
+     * @param seenSince Skip rows last seen before this time
+     * @return Matches sorted by similarity, highest first
+     */
+    std::vector<Match> search(const std::vector<float>& query, float minSimilarity,
+                              size_t maxResults = 0, const std::string& excludePartition = "",
+                              std::chrono::steady_clock::time_point seenSince =
+                                  std::chrono::steady_clock::time_point::min()) const;
+
+    void clear();
+    Stats getStats() const;
+
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t MAX_PARTITIONS = 64;
+
+private:
+    struct AlignedFree {
+        void operator()(float* p) const;
+    };
+    using AlignedBuffer = std::unique_ptr<float[], AlignedFree>;
+
+    // Immutable once published
+    struct Snapshot {
+        size_t dimension = 0;
+        size_t stride = 0;                  // Floats per row, padded to ALIGNMENT
+        size_t rows = 0;
+        AlignedBuffer matrix;               // rows x stride, normalised
+        std::vector<int> ids;
+        std::vector<uint64_t> partitionMasks;
+        std::vector<int64_t> lastSeen;      // steady_clock ticks
+        AlignedBuffer centroids;            // lists x stride, normalised
+        std::vector<size_t> listOffsets;    // Row range of list l: [offsets[l], offsets[l + 1])
+        std::unordered_map<std::string, uint64_t> partitionBits;
+    };
+
+    struct Entry {
+        std::vector<float> features;        // Normalised, unpadded
+        uint64_t partitionMask = 0;
+        int64_t lastSeen = 0;
+    };
+
+    struct Pending {
+        bool remove = false;
+        std::vector<float> features;
+        uint64_t partitionMask = 0;
+        int64_t lastSeen = 0;
+    };
+
+    static AlignedBuffer allocateAligned(size_t floats);
+    static size_t paddedStride(size_t dimension);
+    static bool normalize(const std::vector<float>& in, std::vector<float>& out);
+    static float dot(const float* a, const float* b, size_t stride);
+
+    uint64_t partitionBit(const std::string& partition);
+    size_t commitLocked();
+    void trainCentroids(size_t lists);
+    std::shared_ptr<const Snapshot> buildSnapshot();
+    void scanRows(const Snapshot& snapshot, const float* query, size_t begin, size_t end,
+                  float minSimilarity, uint64_t excludeMask, int64_t seenSince,
+                  std::vector<Match>& out) const;
+
+    Config m_config;
+
+    // Published snapshot; read with std::atomic_load, replaced with std::atomic_store
+    std::shared_ptr<const Snapshot> m_snapshot;
+
+    // Writer state
+    mutable std::mutex m_writeMutex;
+    std::unordered_map<int, Entry> m_entries;
+    std::unordered_map<int, Pending> m_pending;
+    std::unordered_map<std::string, uint64_t> m_partitionBits;
+    size_t m_dimension = 0;
+    bool m_pendingNewIds = false;
+    std::chrono::steady_clock::time_point m_oldestPending;
+    std::vector<std::vector<float>> m_centroids;    // Normalised, unpadded
+    size_t m_trainedRows = 0;
+
+    std::atomic<uint64_t> m_commits{0};
+    mutable std::atomic<uint64_t> m_searches{0};
+    std::atomic<uint64_t> m_rejected{0};
+};
+
+} // namespace AISecurityVision
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <string>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Letterbox information for maintaining aspect ratio
+ *
+ * Maps letterboxed (model input) coordinates back to the source frame:
+ * source = (letterboxed - pad) / scale.
+ */
+struct LetterboxInfo {
+    float scale;    // Scale factor
+    float x_pad;    // X padding
+    float y_pad;    // Y padding
+
+    LetterboxInfo() : scale(1.0f), x_pad(0.0f), y_pad(0.0f) {}
+};
+
+/**
+ * @brief Aspect-preserving fit of a source frame into a model input
+ *
+ * The single letterbox convention of the tree (scale to fit, truncate the
+ * scaled size, centre with integer padding), so a letterbox produced by the
+ * decoder is identical to the one a detector would compute itself.
+ */
+struct LetterboxGeometry {
+    LetterboxInfo info;
+    cv::Size scaled;    // Size of the image area inside the padding
+
+    static LetterboxGeometry fit(const cv::Size& source, const cv::Size& target) {
+        LetterboxGeometry geometry;
+        if (source.width <= 0 || source.height <= 0) {
+            return geometry;
+        }
+
+        float scale = std::min(static_cast<float>(target.width) / source.width,
+                               static_cast<float>(target.height) / source.height);
+        geometry.scaled = cv::Size(std::max(1, static_cast<int>(source.width * scale)),
+                                   std::max(1, static_cast<int>(source.height * scale)));
+        geometry.info.scale = scale;
+        geometry.info.x_pad = static_cast<float>((target.width - geometry.scaled.width) / 2);
+        geometry.info.y_pad = static_cast<float>((target.height - geometry.scaled.height) / 2);
+        return geometry;
+    }
+
+    cv::Rect roi() const {
+        return cv::Rect(static_cast<int>(info.x_pad), static_cast<int>(info.y_pad), scaled.width, scaled.height);
+    }
+
+    /**
+     * @brief Fill the bands around roi() with PAD_VALUE, leaving the image area untouched
+     */
+    void fillPadding(cv::Mat& plane) const {
+        const cv::Rect content = roi();
+        const cv::Scalar pad = cv::Scalar::all(PAD_VALUE);
+        if (content.y > 0) {
+            plane.rowRange(0, content.y).setTo(pad);
+        }
+        if (content.y + content.height < plane.rows) {
+            plane.rowRange(content.y + content.height, plane.rows).setTo(pad);
+        }
+        cv::Mat band = plane.rowRange(content.y, content.y + content.height);
+        if (content.x > 0) {
+            band.colRange(0, content.x).setTo(pad);
+        }
+        if (content.x + content.width < plane.cols) {
+            band.colRange(content.x + content.width, plane.cols).setTo(pad);
+        }
+    }
+
+    static constexpr int PAD_VALUE = 114;   // YOLO letterbox grey
+};
+
+/**
+ * @brief Resolutions a pipeline's consumers need from every decoded frame
+ *
+ * An empty size means the plane is not produced.
+ */
+struct FramePlaneSpec {
+    bool full = true;       // Source resolution (recording, recognizers, overlays)
+    cv::Size model;         // Letterboxed detector input
+    cv::Size stream;        // Streamer output resolution
+
+    bool operator==(const FramePlaneSpec& other) const {
+        return full == other.full && model == other.model && stream == other.stream;
+    }
+    bool operator!=(const FramePlaneSpec& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief One decoded frame at every requested resolution
+ *
+ * The decoder converts each plane directly from the decoded picture, so
+ * consumers no longer downscale the full-resolution BGR frame themselves.
+ * Planes that were not requested are empty; the others are pooled buffers
+ * shared read-only downstream.
+ */
+struct FrameBundle {
+    cv::Mat full;
+    cv::Mat model;              // Letterboxed to FramePlaneSpec::model, padded with PAD_VALUE
+    cv::Mat stream;
+    LetterboxInfo letterbox;    // Maps model-plane coordinates to source coordinates
+    cv::Size sourceSize;
+    float motionActivity = -1.0f;   // Picture fraction covered by moving codec blocks, < 0 = no motion vectors
+
+    void release() {
+        full.release();
+        model.release();
+        stream.release();
+    }
+
+    // FramePool keys of the scaled planes, so buffers of different sizes
+    // never evict each other from the camera's own pool
+    static std::string modelPoolId(const std::string& cameraId) { return cameraId + "#model"; }
+    static std::string streamPoolId(const std::string& cameraId) { return cameraId + "#stream"; }
+};
+
+} // namespace AISecurityVision
@@ -0,0 +1,157 @@
+#include "FramePool.h"
+#include "Logger.h"
+#include <algorithm>
+
+namespace AISecurityVision {
+
+FramePool& FramePool::getInstance() {
+    static FramePool instance;
+    return instance;
+}
+
+bool FramePool::isIdle(const cv::Mat& buffer) {
+    // The pool's own header is the only reference left. Nobody else can take
+    // a new reference without already holding one, so once this reads 1 it
+    // stays 1 until the buffer is handed out again.
+    return buffer.u && CV_XADD(&buffer.u->refcount, 0) == 1;
+}
+
+std::shared_ptr<FramePool::CameraPool> FramePool::cameraPool(const std::string& cameraId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& pool = m_pools[cameraId];
+    if (!pool) {
+        pool = std::make_shared<CameraPool>();
+    }
+    return pool;
+}
+
+std::shared_ptr<FramePool::CameraPool> FramePool::findCameraPool(const std::string& cameraId) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_pools.find(cameraId);
+    return it != m_pools.end() ? it->second : nullptr;
+}
+
+cv::Mat FramePool::acquire(const std::string& cameraId, int rows, int cols, int type) {
+    auto pool = cameraPool(cameraId);
+    std::lock_guard<std::mutex> lock(pool->mutex);
+
+    cv::Mat* reusable = nullptr;
+    for (auto& buffer : pool->buffers) {
+        if (!isIdle(buffer)) {
+            continue;
+        }
+        if (buffer.rows == rows && buffer.cols == cols && buffer.type() == type) {
+            pool->hits.fetch_add(1);
+            return buffer;
+        }
+        // Idle but wrong geometry (e.g. the stream changed resolution)
+        reusable = &buffer;
+    }
+
+    pool->misses.fetch_add(1);
+
+    if (pool->buffers.size() < pool->capacity) {
+        pool->buffers.emplace_back(rows, cols, type);
+        return pool->buffers.back();
+    }
+
+    if (reusable) {
+        *reusable = cv::Mat(rows, cols, type);
+        return *reusable;
+    }
+
+    // Every pooled buffer is still referenced downstream; hand out an
+    // unpooled frame rather than stalling the decoder
+    pool->exhausted.fetch_add(1);
+    return cv::Mat(rows, cols, type);
+}
+
+cv::Mat FramePool::copyOf(const std::string& cameraId, const cv::Mat& frame) {
+    cv::Mat copy = frame.clone();
+    cameraPool(cameraId)->bytesCopied.fetch_add(copy.total() * copy.elemSize());
+    return copy;
+}
+
+void FramePool::setCameraCapacity(const std::string& cameraId, size_t maxBuffers) {
+    size_t capacity = std::max<size_t>(1, std::min(maxBuffers, MAX_CAMERA_CAPACITY));
+    auto pool = cameraPool(cameraId);
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->capacity = capacity;
+
+    // Shrink by forgetting buffers; referenced ones stay alive with their consumers
+    if (pool->buffers.size() > capacity) {
+        pool->buffers.resize(capacity);
+    }
+
+    LOG_DEBUG() << "[FramePool] Capacity for " << cameraId << " set to " << capacity;
+}
+
+void FramePool::reserveCameraCapacity(const std::string& cameraId, size_t minBuffers) {
+    if (minBuffers > getCameraCapacity(cameraId)) {
+        setCameraCapacity(cameraId, minBuffers);
+    }
+}
+
+size_t FramePool::getCameraCapacity(const std::string& cameraId) const {
+    auto pool = findCameraPool(cameraId);
+    if (!pool) {
+        return DEFAULT_CAMERA_CAPACITY;
+    }
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    return pool->capacity;
+}
+
+void FramePool::releaseCamera(const std::string& cameraId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pools.erase(cameraId);
+}
+
+FramePool::Stats FramePool::snapshot(CameraPool& pool) {
+    Stats stats;
+    stats.hits = pool.hits.load();
+    stats.misses = pool.misses.load();
+    stats.exhausted = pool.exhausted.load();
+    stats.bytesCopied = pool.bytesCopied.load();
+
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    stats.buffers = pool.buffers.size();
+    stats.capacity = pool.capacity;
+    stats.buffersInUse = std::count_if(pool.buffers.begin(), pool.buffers.end(),
+                                       [](const cv::Mat& buffer) { return !isIdle(buffer); });
+    return stats;
+}
+
+FramePool::Stats FramePool::getStats(const std::string& cameraId) const {
+    auto pool = findCameraPool(cameraId);
+    if (!pool) {
+        Stats stats;
+        stats.capacity = DEFAULT_CAMERA_CAPACITY;
+        return stats;
+    }
+    return snapshot(*pool);
+}
+
+FramePool::Stats FramePool::getTotalStats() const {
+    std::vector<std::shared_ptr<CameraPool>> pools;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : m_pools) {
+            pools.push_back(entry.second);
+        }
+    }
+
+    Stats total;
+    for (const auto& pool : pools) {
+        Stats stats = snapshot(*pool);
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.exhausted += stats.exhausted;
+        total.bytesCopied += stats.bytesCopied;
+        total.buffers += stats.buffers;
+        total.buffersInUse += stats.buffersInUse;
+        total.capacity += stats.capacity;
+    }
+    return total;
+}
+
+} // namespace AISecurityVision
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Per-camera pool of reusable, reference-counted frame buffers
+ *
+ * The decoder converts each frame straight into a buffer acquired here and
+ * every downstream stage (inference, analytics, recorder, streamer) shares
+ * that buffer through plain cv::Mat headers instead of cloning it. cv::Mat's
+ * own reference count tracks the consumers: a pooled buffer is handed out
+ * again only once the pool holds the last reference, so a frame can never be
+ * overwritten while a stage is still reading it.
+ *
+ * Frames from the pool are shared read-only. A stage that needs to draw on a
+ * frame must take a private copy with copyOf(), which is accounted for in the
+ * camera's bytes-copied counter.
+ *
+ * When every pooled buffer of a camera is still referenced and the camera's
+ * capacity is reached, acquire() falls back to an ordinary allocation so the
+ * decoder never blocks; such frames are counted as misses.
+ */
+class FramePool {
+public:
+    /**
+     * @brief Pool statistics snapshot
+     */
+    struct Stats {
+        uint64_t hits = 0;          // Acquisitions served by a recycled buffer
+        uint64_t misses = 0;        // Acquisitions that had to allocate
+        uint64_t exhausted = 0;     // Misses because the capacity limit was reached
+        uint64_t bytesCopied = 0;   // Bytes duplicated through copyOf()
+        size_t buffers = 0;         // Buffers currently owned by the pool
+        size_t buffersInUse = 0;    // Pooled buffers referenced by a consumer
+        size_t capacity = 0;        // Per-camera buffer limit
+    };
+
+    static FramePool& getInstance();
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    /**
+     * @brief Get a writable buffer for the next decoded frame of a camera
+     * @return Buffer with the requested geometry; contents are undefined
+     */
+    cv::Mat acquire(const std::string& cameraId, int rows, int cols, int type);
+
+    /**
+     * @brief Take a private, writable copy of a shared frame
+     */
+    cv::Mat copyOf(const std::string& cameraId, const cv::Mat& frame);
+
+    // Capacity management
+    void setCameraCapacity(const std::string& cameraId, size_t maxBuffers);
+    void reserveCameraCapacity(const std::string& cameraId, size_t minBuffers);
+    size_t getCameraCapacity(const std::string& cameraId) const;
+
+    /**
+     * @brief Drop a camera's idle buffers; frames still referenced stay valid
+     */
+    void releaseCamera(const std::string& cameraId);
+
+    Stats getStats(const std::string& cameraId) const;
+    Stats getTotalStats() const;
+
+    static constexpr size_t DEFAULT_CAMERA_CAPACITY = 8;
+    static constexpr size_t MAX_CAMERA_CAPACITY = 256;
+
+private:
+    FramePool() = default;
+
+    struct CameraPool {
+        std::mutex mutex;
+        std::vector<cv::Mat> buffers;
+        size_t capacity = DEFAULT_CAMERA_CAPACITY;
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> exhausted{0};
+        std::atomic<uint64_t> bytesCopied{0};
+    };
+
+    std::shared_ptr<CameraPool> cameraPool(const std::string& cameraId);
+    std::shared_ptr<CameraPool> findCameraPool(const std::string& cameraId) const;
+    static bool isIdle(const cv::Mat& buffer);
+    static Stats snapshot(CameraPool& pool);
+
+    std::unordered_map<std::string, std::shared_ptr<CameraPool>> m_pools;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace AISecurityVision
@@ -1,6 +1,7 @@
 #include "LockHierarchy.h"
 #include <sstream>
 #include <algorithm>
+#include <cstring>
 
 namespace AISecurityVision {
 
@@ -9,12 +10,11 @@ LockHierarchyEnforcer& LockHierarchyEnforcer::getInstance() {
     return instance;
 }
 
-bool LockHierarchyEnforcer::canAcquireLock(LockLevel level, const std::string& lockName) {
+bool LockHierarchyEnforcer::canAcquireLock(LockLevel level, const char* lockName) {
     if (!m_enabled.load()) {
         return true;
     }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
     const auto& threadInfo = getThreadLockInfo();
     
     // Check if we're trying to acquire a lock at a lower level than currently held
@@ -30,7 +30,7 @@ bool LockHierarchyEnforcer::canAcquireLock(LockLevel level, const std::string& l
         
         // Check for duplicate lock acquisition (potential recursive lock issue)
         for (const auto& heldLock : threadInfo.heldLocks) {
-            if (heldLock.first == level && heldLock.second == lockName) {
+            if (heldLock.level == level && std::strcmp(heldLock.name, lockName) == 0) {
                 LOG_WARN() << "[LockHierarchy] Attempting to acquire already held lock: " << lockName;
                 return false;
             }
@@ -40,38 +40,39 @@ bool LockHierarchyEnforcer::canAcquireLock(LockLevel level, const std::string& l
     return true;
 }
 
-void LockHierarchyEnforcer::recordLockAcquired(LockLevel level, const std::string& lockName) {
+void LockHierarchyEnforcer::recordLockAcquired(LockLevel level, const char* lockName) {
     if (!m_enabled.load()) {
         return;
     }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
     auto& threadInfo = getThreadLockInfo();
     
-    threadInfo.heldLocks.emplace_back(level, lockName);
+    threadInfo.heldLocks.push_back({level, lockName});
     
     // Update current max level
     if (threadInfo.heldLocks.empty() || static_cast<int>(level) > static_cast<int>(threadInfo.currentMaxLevel)) {
         threadInfo.currentMaxLevel = level;
     }
     
-    LOG_DEBUG() << "[LockHierarchy] Thread " << std::this_thread::get_id() 
-               << " acquired lock '" << lockName << "' at level " << static_cast<int>(level);
+    if (Logger::getInstance().isLevelEnabled(LogLevel::DEBUG)) {
+        LOG_DEBUG() << "[LockHierarchy] Thread " << std::this_thread::get_id() 
+                   << " acquired lock '" << lockName << "' at level " << static_cast<int>(level);
+    }
 }
 
-void LockHierarchyEnforcer::recordLockReleased(LockLevel level, const std::string& lockName) {
+void LockHierarchyEnforcer::recordLockReleased(LockLevel level, const char* lockName) {
     if (!m_enabled.load()) {
         return;
     }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
     auto& threadInfo = getThreadLockInfo();
     
-    // Find and remove the lock from held locks
-    auto it = std::find_if(threadInfo.heldLocks.begin(), threadInfo.heldLocks.end(),
-        [level, &lockName](const std::pair<LockLevel, std::string>& heldLock) {
-            return heldLock.first == level && heldLock.second == lockName;
+    // Find and remove the lock from held locks (usually the most recent one)
+    auto rit = std::find_if(threadInfo.heldLocks.rbegin(), threadInfo.heldLocks.rend(),
+        [level, lockName](const HeldLock& heldLock) {
+            return heldLock.level == level && std::strcmp(heldLock.name, lockName) == 0;
         });
+    auto it = rit == threadInfo.heldLocks.rend() ? threadInfo.heldLocks.end() : std::next(rit).base();
     
     if (it != threadInfo.heldLocks.end()) {
         threadInfo.heldLocks.erase(it);
@@ -83,12 +84,14 @@ void LockHierarchyEnforcer::recordLockReleased(LockLevel level, const std::strin
             threadInfo.currentMaxLevel = std::max_element(threadInfo.heldLocks.begin(), 
                                                          threadInfo.heldLocks.end(),
                 [](const auto& a, const auto& b) {
-                    return static_cast<int>(a.first) < static_cast<int>(b.first);
-                })->first;
+                    return static_cast<int>(a.level) < static_cast<int>(b.level);
+                })->level;
         }
         
-        LOG_DEBUG() << "[LockHierarchy] Thread " << std::this_thread::get_id() 
-                   << " released lock '" << lockName << "' at level " << static_cast<int>(level);
+        if (Logger::getInstance().isLevelEnabled(LogLevel::DEBUG)) {
+            LOG_DEBUG() << "[LockHierarchy] Thread " << std::this_thread::get_id() 
+                       << " released lock '" << lockName << "' at level " << static_cast<int>(level);
+        }
     } else {
         LOG_WARN() << "[LockHierarchy] Attempted to release lock '" << lockName 
                   << "' that was not recorded as held";
@@ -100,7 +103,6 @@ LockLevel LockHierarchyEnforcer::getCurrentLockLevel() const {
         return static_cast<LockLevel>(0);
     }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
     const auto& threadInfo = getThreadLockInfo();
     return threadInfo.currentMaxLevel;
 }
@@ -110,7 +112,6 @@ bool LockHierarchyEnforcer::hasLocksHeld() const {
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
     const auto& threadInfo = getThreadLockInfo();
     return !threadInfo.heldLocks.empty();
 }
@@ -120,7 +121,6 @@ std::string LockHierarchyEnforcer::getHeldLocksDebugInfo() const {
         return "Lock hierarchy checking disabled";
     }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
     const auto& threadInfo = getThreadLockInfo();
     
     if (threadInfo.heldLocks.empty()) {
@@ -132,7 +132,7 @@ std::string LockHierarchyEnforcer::getHeldLocksDebugInfo() const {
     for (size_t i = 0; i < threadInfo.heldLocks.size(); ++i) {
         if (i > 0) oss << ", ";
         const auto& heldLock = threadInfo.heldLocks[i];
-        oss << heldLock.second << "(L" << static_cast<int>(heldLock.first) << ")";
+        oss << heldLock.name << "(L" << static_cast<int>(heldLock.level) << ")";
     }
     
     return oss.str();
@@ -149,20 +149,8 @@ bool LockHierarchyEnforcer::isEnabled() const {
 }
 
 LockHierarchyEnforcer::ThreadLockInfo& LockHierarchyEnforcer::getThreadLockInfo() {
-    std::thread::id threadId = std::this_thread::get_id();
-    return m_threadLocks[threadId];
-}
-
-const LockHierarchyEnforcer::ThreadLockInfo& LockHierarchyEnforcer::getThreadLockInfo() const {
-    std::thread::id threadId = std::this_thread::get_id();
-    auto it = m_threadLocks.find(threadId);
-    if (it != m_threadLocks.end()) {
-        return it->second;
-    }
-    
-    // Return empty thread info if not found
-    static const ThreadLockInfo emptyInfo;
-    return emptyInfo;
+    thread_local ThreadLockInfo threadInfo;
+    return threadInfo;
 }
 
 std::string LockHierarchyEnforcer::lockLevelToString(LockLevel level) const {
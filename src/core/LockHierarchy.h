@@ -9,6 +9,21 @@
 #include <cassert>
 #include "Logger.h"
 
+/**
+ * LOCK_HIERARCHY_CHECKS selects whether HierarchicalLock consults the
+ * enforcer at all. It defaults to on in debug builds and off in release
+ * (NDEBUG) builds, where HierarchicalLock compiles down to a plain mutex
+ * guard. Configure with -DENABLE_LOCK_HIERARCHY_CHECKS=ON to keep the
+ * checks in a release build.
+ */
+#ifndef LOCK_HIERARCHY_CHECKS
+#ifdef NDEBUG
+#define LOCK_HIERARCHY_CHECKS 0
+#else
+#define LOCK_HIERARCHY_CHECKS 1
+#endif
+#endif
+
 namespace AISecurityVision {
 
 /**
@@ -42,11 +57,11 @@ enum class LockLevel : int {
  * prevent deadlocks.
  * 
  * Features:
- * - Per-thread lock order tracking
+ * - Per-thread lock order tracking in a thread_local stack (no shared lock)
  * - Deadlock detection and prevention
  * - Debug logging for lock violations
  * - Runtime assertion for development
- * - Minimal overhead in release builds
+ * - Compiled out of HierarchicalLock in release builds (LOCK_HIERARCHY_CHECKS)
  */
 class LockHierarchyEnforcer {
 public:
@@ -63,21 +78,21 @@ public:
      * @param lockName Name of the lock for debugging
      * @return true if safe to acquire, false if would cause deadlock
      */
-    bool canAcquireLock(LockLevel level, const std::string& lockName);
+    bool canAcquireLock(LockLevel level, const char* lockName);
     
     /**
      * @brief Record that a lock has been acquired
      * @param level Lock level acquired
      * @param lockName Name of the lock for debugging
      */
-    void recordLockAcquired(LockLevel level, const std::string& lockName);
+    void recordLockAcquired(LockLevel level, const char* lockName);
     
     /**
      * @brief Record that a lock has been released
      * @param level Lock level released
      * @param lockName Name of the lock for debugging
      */
-    void recordLockReleased(LockLevel level, const std::string& lockName);
+    void recordLockReleased(LockLevel level, const char* lockName);
     
     /**
      * @brief Get current lock level for this thread
@@ -114,20 +129,20 @@ private:
     LockHierarchyEnforcer() = default;
     ~LockHierarchyEnforcer() = default;
     
-    // Per-thread lock tracking
+    // Per-thread lock tracking; only ever touched by its own thread
+    struct HeldLock {
+        LockLevel level;
+        const char* name;
+    };
     struct ThreadLockInfo {
-        std::vector<std::pair<LockLevel, std::string>> heldLocks;
+        std::vector<HeldLock> heldLocks;
         LockLevel currentMaxLevel = static_cast<LockLevel>(0);
     };
     
-    // Thread-local storage for lock tracking
-    mutable std::mutex m_mutex;
-    std::unordered_map<std::thread::id, ThreadLockInfo> m_threadLocks;
     std::atomic<bool> m_enabled{true};
     
     // Helper methods
-    ThreadLockInfo& getThreadLockInfo();
-    const ThreadLockInfo& getThreadLockInfo() const;
+    static ThreadLockInfo& getThreadLockInfo();
     std::string lockLevelToString(LockLevel level) const;
 };
 
@@ -144,34 +159,11 @@ public:
      * @brief Constructor - acquires lock with hierarchy checking
      * @param mutex Mutex to lock
      * @param level Hierarchy level of this lock
-     * @param name Name of the lock for debugging
+     * @param name Name of the lock for debugging (must outlive the lock, e.g. a literal)
      */
-    HierarchicalLock(MutexType& mutex, LockLevel level, const std::string& name)
+    HierarchicalLock(MutexType& mutex, LockLevel level, const char* name)
         : m_mutex(mutex), m_level(level), m_name(name), m_locked(false) {
-        
-        auto& enforcer = LockHierarchyEnforcer::getInstance();
-        
-        if (enforcer.isEnabled()) {
-            if (!enforcer.canAcquireLock(level, name)) {
-                LOG_ERROR() << "[LockHierarchy] Potential deadlock detected! "
-                           << "Cannot acquire lock '" << name << "' at level " << static_cast<int>(level)
-                           << ". Current thread locks: " << enforcer.getHeldLocksDebugInfo();
-                
-                // In debug builds, assert to catch deadlocks early
-                assert(false && "Lock hierarchy violation detected");
-                
-                // In release builds, log error but continue
-                return;
-            }
-        }
-        
-        // Acquire the actual mutex
-        m_mutex.lock();
-        m_locked = true;
-        
-        if (enforcer.isEnabled()) {
-            enforcer.recordLockAcquired(level, name);
-        }
+        lock();
     }
     
     /**
@@ -192,12 +184,12 @@ public:
      */
     void unlock() {
         if (m_locked) {
-            auto& enforcer = LockHierarchyEnforcer::getInstance();
-
-            if (enforcer.isEnabled()) {
-                enforcer.recordLockReleased(m_level, m_name);
+#if LOCK_HIERARCHY_CHECKS
+            if (m_recorded) {
+                LockHierarchyEnforcer::getInstance().recordLockReleased(m_level, m_name);
+                m_recorded = false;
             }
-
+#endif
             m_mutex.unlock();
             m_locked = false;
         }
@@ -207,25 +199,37 @@ public:
      * @brief Manually lock the mutex (for compatibility with std::unique_lock interface)
      */
     void lock() {
-        if (!m_locked) {
-            auto& enforcer = LockHierarchyEnforcer::getInstance();
+        if (m_locked) {
+            return;
+        }
 
-            if (enforcer.isEnabled()) {
-                if (!enforcer.canAcquireLock(m_level, m_name)) {
-                    LOG_ERROR() << "[LockHierarchy] Potential deadlock detected! "
-                               << "Cannot acquire lock '" << m_name << "' at level " << static_cast<int>(m_level);
-                    assert(false && "Lock hierarchy violation detected");
-                    return;
-                }
-            }
+#if LOCK_HIERARCHY_CHECKS
+        auto& enforcer = LockHierarchyEnforcer::getInstance();
+        const bool checking = enforcer.isEnabled();
 
-            m_mutex.lock();
-            m_locked = true;
+        if (checking && !enforcer.canAcquireLock(m_level, m_name)) {
+            LOG_ERROR() << "[LockHierarchy] Potential deadlock detected! "
+                       << "Cannot acquire lock '" << m_name << "' at level " << static_cast<int>(m_level)
+                       << ". Current thread locks: " << enforcer.getHeldLocksDebugInfo();
 
-            if (enforcer.isEnabled()) {
-                enforcer.recordLockAcquired(m_level, m_name);
-            }
+            // In debug builds, assert to catch deadlocks early
+            assert(false && "Lock hierarchy violation detected");
+
+            // With NDEBUG, log error but continue
+            return;
+        }
+#endif
+
+        // Acquire the actual mutex
+        m_mutex.lock();
+        m_locked = true;
+
+#if LOCK_HIERARCHY_CHECKS
+        if (checking) {
+            enforcer.recordLockAcquired(m_level, m_name);
+            m_recorded = true;
         }
+#endif
     }
 
     /**
@@ -247,8 +251,11 @@ public:
 private:
     MutexType& m_mutex;
     LockLevel m_level;
-    std::string m_name;
+    const char* m_name;
     bool m_locked;
+#if LOCK_HIERARCHY_CHECKS
+    bool m_recorded = false;    // Whether the enforcer saw this acquisition
+#endif
 };
 
 // Convenience typedefs
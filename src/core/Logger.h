@@ -59,6 +59,11 @@ public:
      */
     void setLogLevel(LogLevel level);
 
+    /**
+     * @brief 检查某级别的日志是否会被输出（用于跳过热路径上的消息格式化）
+     */
+    bool isLevelEnabled(LogLevel level) const { return level >= m_logLevel; }
+
     /**
      * @brief 设置输出目标
      * @param target 输出目标（控制台/文件/两者）
@@ -0,0 +1,120 @@
+#include "MotionGate.h"
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+namespace AISecurityVision {
+
+MotionGate::MotionGate()
+    : m_policy(std::make_shared<const MotionGatePolicy>()) {
+}
+
+void MotionGate::setPolicy(const MotionGatePolicy& policy) {
+    MotionGatePolicy sanitized = policy;
+    sanitized.analysisWidth = std::max(16, sanitized.analysisWidth);
+    sanitized.staticFrames = std::max(1, sanitized.staticFrames);
+    sanitized.minDetectionIntervalMs = std::max(0, sanitized.minDetectionIntervalMs);
+    sanitized.backgroundRate = std::min(1.0f, std::max(0.0f, sanitized.backgroundRate));
+
+    std::atomic_store(&m_policy, std::shared_ptr<const MotionGatePolicy>(
+        std::make_shared<MotionGatePolicy>(sanitized)));
+    m_resetRequested.store(true);
+}
+
+MotionGatePolicy MotionGate::getPolicy() const {
+    return *std::atomic_load(&m_policy);
+}
+
+void MotionGate::reset() {
+    m_resetRequested.store(true);
+}
+
+bool MotionGate::evaluate(const cv::Mat& frame, float motionActivity) {
+    auto policy = std::atomic_load(&m_policy);
+    if (!policy->enabled) {
+        return true;
+    }
+
+    if (m_resetRequested.exchange(false)) {
+        m_hasBackground = false;
+        m_staticRun = 0;
+    }
+
+    float score;
+    bool moving;
+    if (policy->useMotionVectors && motionActivity >= 0.0f) {
+        score = motionActivity;
+        moving = score > policy->motionVectorThreshold;
+        m_motionVectorFrames.fetch_add(1);
+    } else {
+        score = pixelChange(frame, *policy);
+        moving = score > policy->motionThreshold;
+    }
+
+    m_staticRun = moving ? 0 : m_staticRun + 1;
+    bool detect = m_staticRun < policy->staticFrames;
+
+    // Minimum detection rate while the scene stays static
+    auto now = std::chrono::steady_clock::now();
+    if (!detect && policy->minDetectionIntervalMs > 0 &&
+        now - m_lastDetection >= std::chrono::milliseconds(policy->minDetectionIntervalMs)) {
+        detect = true;
+    }
+
+    if (detect) {
+        m_lastDetection = now;
+    } else {
+        m_skippedFrames.fetch_add(1);
+    }
+    m_evaluatedFrames.fetch_add(1);
+    m_lastScore.store(score);
+    m_staticFrames.store(m_staticRun);
+    return detect;
+}
+
+float MotionGate::pixelChange(const cv::Mat& frame, const MotionGatePolicy& policy) {
+    if (frame.empty()) {
+        return 1.0f;
+    }
+
+    // Area averaging doubles as the noise filter
+    int width = std::min(policy.analysisWidth, frame.cols);
+    int height = std::max(1, static_cast<int>(static_cast<int64_t>(frame.rows) * width / frame.cols));
+    cv::resize(frame, m_small, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+    if (m_small.channels() == 1) {
+        m_gray = m_small;
+    } else {
+        cv::cvtColor(m_small, m_gray, m_small.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    }
+
+    // The first frame (or a new geometry) becomes the background and counts as motion
+    if (!m_hasBackground || m_background.size() != m_gray.size()) {
+        m_gray.convertTo(m_background, CV_32F);
+        m_hasBackground = true;
+        return 1.0f;
+    }
+
+    m_background.convertTo(m_background8u, CV_8U);
+    cv::absdiff(m_gray, m_background8u, m_diff);
+    cv::threshold(m_diff, m_diff, policy.pixelThreshold, 255, cv::THRESH_BINARY);
+    int changed = cv::countNonZero(m_diff);
+
+    cv::accumulateWeighted(m_gray, m_background, policy.backgroundRate);
+
+    return static_cast<float>(changed) / static_cast<float>(m_gray.total());
+}
+
+MotionGateStats MotionGate::getStats() const {
+    MotionGateStats stats;
+    stats.enabled = std::atomic_load(&m_policy)->enabled;
+    stats.evaluatedFrames = m_evaluatedFrames.load();
+    stats.skippedFrames = m_skippedFrames.load();
+    stats.skippedRatio = stats.evaluatedFrames > 0
+        ? static_cast<double>(stats.skippedFrames) / stats.evaluatedFrames : 0.0;
+    stats.lastMotionScore = m_lastScore.load();
+    stats.staticFrames = m_staticFrames.load();
+    stats.motionVectorFrames = m_motionVectorFrames.load();
+    return stats;
+}
+
+} // namespace AISecurityVision
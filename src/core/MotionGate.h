@@ -0,0 +1,106 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Per-camera motion gate configuration
+ *
+ * A frame counts as moving when more than motionThreshold of the analysis
+ * image differs from the background by more than pixelThreshold grey levels
+ * (or, with codec motion vectors, when more than motionVectorThreshold of the
+ * picture is covered by displaced blocks). Detection is skipped once the scene
+ * has been static for staticFrames frames, but still runs at least every
+ * minDetectionIntervalMs so objects entering without visible change (lighting,
+ * slow drift into the background) are picked up.
+ */
+struct MotionGatePolicy {
+    bool enabled = false;
+    int analysisWidth = 160;            // Width of the downscaled grey analysis image
+    int pixelThreshold = 20;            // Grey-level difference that counts a pixel as changed
+    float motionThreshold = 0.003f;     // Changed-pixel fraction above which the frame moves
+    int staticFrames = 10;              // Consecutive static frames before detection is skipped
+    int minDetectionIntervalMs = 2000;  // Forced detection period while static, 0 = none
+    float backgroundRate = 0.05f;       // Running-average background learning rate
+    bool useMotionVectors = false;      // Prefer codec motion vectors when the decoder exports them
+    float motionVectorThreshold = 0.002f;   // Moving-block area fraction above which the frame moves
+};
+
+/**
+ * @brief Motion gate counters
+ */
+struct MotionGateStats {
+    bool enabled = false;
+    uint64_t evaluatedFrames = 0;   // Frames the gate decided on
+    uint64_t skippedFrames = 0;     // Frames whose detection was skipped
+    double skippedRatio = 0.0;
+    float lastMotionScore = 0.0f;   // Changed fraction of the last evaluated frame
+    int staticFrames = 0;           // Current run of static frames
+    uint64_t motionVectorFrames = 0;    // Decisions taken from codec motion vectors
+};
+
+/**
+ * @brief Cheap scene-change test that decides whether a frame needs detection
+ *
+ * The frame is area-downscaled to analysisWidth and converted to grey, then
+ * compared against a running-average background, so noise is averaged out
+ * and an object that stops moving fades into the background after a few
+ * seconds. When the decoder exports codec motion vectors the decision is
+ * taken from them instead and the frame is not touched at all; frames
+ * without vectors (intra frames) fall back to the pixel test.
+ *
+ * evaluate() is called by one thread (the inference stage); the policy and
+ * the statistics may be accessed from any thread.
+ */
+class MotionGate {
+public:
+    MotionGate();
+
+    void setPolicy(const MotionGatePolicy& policy);
+    MotionGatePolicy getPolicy() const;
+
+    /**
+     * @brief Decide whether the frame needs detection
+     * @param frame Any BGR plane of the frame; the smallest available is cheapest
+     * @param motionActivity Moving-block area fraction from codec motion vectors, < 0 if unknown
+     * @return false when detection can be skipped
+     */
+    bool evaluate(const cv::Mat& frame, float motionActivity);
+
+    /**
+     * @brief Forget the background, e.g. after a reconnect
+     */
+    void reset();
+
+    MotionGateStats getStats() const;
+
+private:
+    float pixelChange(const cv::Mat& frame, const MotionGatePolicy& policy);
+
+    std::shared_ptr<const MotionGatePolicy> m_policy;
+
+    // Analysis state (evaluating thread only)
+    cv::Mat m_small;
+    cv::Mat m_gray;
+    cv::Mat m_background;           // CV_32F running average
+    cv::Mat m_background8u;
+    cv::Mat m_diff;
+    bool m_hasBackground = false;
+    int m_staticRun = 0;
+    std::chrono::steady_clock::time_point m_lastDetection;
+    std::atomic<bool> m_resetRequested{false};
+
+    // Statistics
+    std::atomic<uint64_t> m_evaluatedFrames{0};
+    std::atomic<uint64_t> m_skippedFrames{0};
+    std::atomic<uint64_t> m_motionVectorFrames{0};
+    std::atomic<float> m_lastScore{0.0f};
+    std::atomic<int> m_staticFrames{0};
+};
+
+} // namespace AISecurityVision
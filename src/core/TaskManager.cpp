@@ -2,6 +2,11 @@
 #include "VideoPipeline.h"
 #include "MJPEGPortManager.h"
 #include "../output/AlarmTrigger.h"
+#include "../ai/InferenceScheduler.h"
+#include "../ai/YOLOv8DetectorFactory.h"
+#ifdef ENABLE_RKNN_NPU
+#include "../ai/YOLOv8RKNNDetector.h"
+#endif
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -82,6 +87,10 @@ void TaskManager::stop() {
         }
     }
     m_pipelines.clear();
+    lock.unlock();
+
+    // Pipelines are gone, nothing is waiting on the shared detector any more
+    shutdownInferenceScheduler();
 
     LOG_INFO() << "[TaskManager] Stopped successfully";
 }
@@ -144,6 +153,17 @@ bool TaskManager::addVideoSource(const VideoSource& source) {
 
         // Create pipeline object with dynamically allocated port
         auto pipeline = std::make_shared<VideoPipeline>(modifiedSource);
+        pipeline->setSharedInferenceEnabled(m_sharedInferenceEnabled.load());
+        pipeline->setPipelinedMode(m_defaultPipelinedMode.load());
+        if (m_defaultStageQueueDepth.load() > 0) {
+            pipeline->setStageQueueDepth(m_defaultStageQueueDepth.load());
+        }
+        pipeline->setDecodePolicy(getDefaultDecodePolicy());
+        pipeline->setMotionGatePolicy(getDefaultMotionGatePolicy());
+        pipeline->setDetectionCadencePolicy(getDefaultDetectionCadencePolicy());
+        pipeline->setRegionInferencePolicy(getDefaultRegionInferencePolicy());
+        pipeline->setReIDCachePolicy(getDefaultReIDCachePolicy());
+        pipeline->setRecordingConfig(getDefaultRecordingConfig());
 
         // Initialize pipeline (this may take time) - done outside lock
         bool initSuccess = false;
@@ -698,55 +718,71 @@ void TaskManager::resetMonitoringStats() {
 void TaskManager::reportTrackUpdate(const std::string& cameraId, int localTrackId,
                                    const std::vector<float>& reidFeatures, const cv::Rect& bbox,
                                    int classId, float confidence) {
-    if (!m_crossCameraTrackingEnabled.load() || reidFeatures.empty()) {
-        return;
+    std::vector<TrackUpdate> updates;
+    updates.push_back({localTrackId, reidFeatures, bbox, classId, confidence});
+    reportTrackUpdates(cameraId, std::move(updates));
+}
+
+std::vector<int> TaskManager::reportTrackUpdates(const std::string& cameraId, std::vector<TrackUpdate> updates) {
+    std::vector<int> globalIds(updates.size(), -1);
+    if (!m_crossCameraTrackingEnabled.load() || updates.empty()) {
+        return globalIds;
     }
 
-    AISecurityVision::HierarchicalMutexLock lock(m_crossCameraMutex, AISecurityVision::LockLevel::CROSS_CAMERA_TRACKING, "TaskManager::m_crossCameraMutex");
+    auto cameraMap = cameraTrackMap(cameraId);
 
-    // Check if this local track already has a global track ID
-    auto cameraIt = m_localToGlobalTrackMap.find(cameraId);
-    if (cameraIt != m_localToGlobalTrackMap.end()) {
-        auto trackIt = cameraIt->second.find(localTrackId);
-        if (trackIt != cameraIt->second.end()) {
-            // Update existing global track
-            int globalId = trackIt->second;
-            auto globalTrackIt = m_globalTracks.find(globalId);
-            if (globalTrackIt != m_globalTracks.end()) {
-                globalTrackIt->second->updateTrack(cameraId, localTrackId, reidFeatures, bbox, confidence);
-                return;
+    // Look up local tracks that already have a global track
+    {
+        std::lock_guard<std::mutex> lock(cameraMap->mutex);
+        for (size_t i = 0; i < updates.size(); ++i) {
+            if (updates[i].reidFeatures.empty()) {
+                continue;
+            }
+            auto it = cameraMap->localToGlobal.find(updates[i].localTrackId);
+            if (it != cameraMap->localToGlobal.end()) {
+                globalIds[i] = it->second;
             }
         }
     }
 
-    // Try to find a matching global track using ReID features
-    if (m_crossCameraMatchingEnabled.load()) {
-        auto bestMatch = findBestMatch(reidFeatures, cameraId);
-        if (bestMatch) {
-            // Match found - associate with existing global track
-            bestMatch->updateTrack(cameraId, localTrackId, reidFeatures, bbox, confidence);
-            m_localToGlobalTrackMap[cameraId][localTrackId] = bestMatch->globalTrackId;
-            m_totalCrossCameraMatches.fetch_add(1);
-
-            LOG_INFO() << "[TaskManager] Cross-camera match: camera " << cameraId
-                      << " local track " << localTrackId << " -> global track "
-                      << bestMatch->globalTrackId;
-            return;
+    // Refresh those global tracks; each update only locks its track's shard
+    std::vector<size_t> unassociated;
+    for (size_t i = 0; i < updates.size(); ++i) {
+        if (updates[i].reidFeatures.empty()) {
+            continue;
         }
+        if (globalIds[i] >= 0 && updateGlobalTrack(globalIds[i], cameraId, updates[i], false)) {
+            continue;
+        }
+        globalIds[i] = -1;
+        unassociated.push_back(i);
     }
 
-    // No match found - create new global track
-    int globalId = createNewGlobalTrack(cameraId, localTrackId, reidFeatures, bbox, classId, confidence);
-    m_localToGlobalTrackMap[cameraId][localTrackId] = globalId;
+    // New (or expired) local tracks: match against other cameras or start a global track
+    if (!unassociated.empty()) {
+        {
+            AISecurityVision::HierarchicalMutexLock lock(m_crossCameraMutex, AISecurityVision::LockLevel::CROSS_CAMERA_TRACKING, "TaskManager::m_crossCameraMutex");
+            for (size_t i : unassociated) {
+                globalIds[i] = associateTrack(cameraId, updates[i]);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(cameraMap->mutex);
+        for (size_t i : unassociated) {
+            cameraMap->localToGlobal[updates[i].localTrackId] = globalIds[i];
+        }
+    }
+
+    m_reidIndex.commitIfDue();
+    return globalIds;
 }
 
 int TaskManager::getGlobalTrackId(const std::string& cameraId, int localTrackId) const {
-    AISecurityVision::HierarchicalMutexLock lock(m_crossCameraMutex, AISecurityVision::LockLevel::CROSS_CAMERA_TRACKING, "TaskManager::m_crossCameraMutex");
-
-    auto cameraIt = m_localToGlobalTrackMap.find(cameraId);
-    if (cameraIt != m_localToGlobalTrackMap.end()) {
-        auto trackIt = cameraIt->second.find(localTrackId);
-        if (trackIt != cameraIt->second.end()) {
+    auto cameraMap = findCameraTrackMap(cameraId);
+    if (cameraMap) {
+        std::lock_guard<std::mutex> lock(cameraMap->mutex);
+        auto trackIt = cameraMap->localToGlobal.find(localTrackId);
+        if (trackIt != cameraMap->localToGlobal.end()) {
             return trackIt->second;
         }
     }
@@ -754,12 +790,14 @@ int TaskManager::getGlobalTrackId(const std::string& cameraId, int localTrackId)
 }
 
 std::vector<CrossCameraTrack> TaskManager::getActiveCrossCameraTracks() const {
-    AISecurityVision::HierarchicalMutexLock lock(m_crossCameraMutex, AISecurityVision::LockLevel::CROSS_CAMERA_TRACKING, "TaskManager::m_crossCameraMutex");
-
     std::vector<CrossCameraTrack> activeTracks;
-    for (const auto& [globalId, track] : m_globalTracks) {
-        if (track && track->isActive && !track->isExpired(m_maxTrackAge.load())) {
-            activeTracks.push_back(*track);
+    double maxAge = m_maxTrackAge.load();
+    for (auto& shard : m_trackShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [globalId, track] : shard.tracks) {
+            if (track && track->isActive && !track->isExpired(maxAge)) {
+                activeTracks.push_back(*track);
+            }
         }
     }
     return activeTracks;
@@ -767,39 +805,40 @@ std::vector<CrossCameraTrack> TaskManager::getActiveCrossCameraTracks() const {
 
 std::vector<ReIDMatch> TaskManager::findReIDMatches(const std::vector<float>& features,
                                                    const std::string& excludeCameraId) const {
-    AISecurityVision::HierarchicalMutexLock lock(m_crossCameraMutex, AISecurityVision::LockLevel::CROSS_CAMERA_TRACKING, "TaskManager::m_crossCameraMutex");
+    double maxAge = m_maxTrackAge.load();
+    auto seenSince = std::chrono::steady_clock::now() -
+                     std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(maxAge));
+
+    // Similarity search runs on the index snapshot without locking
+    auto candidates = m_reidIndex.search(features, m_reidSimilarityThreshold.load(), 0, excludeCameraId, seenSince);
 
+    // Candidates come sorted by similarity (highest first); the snapshot may
+    // lag slightly behind, so re-check each against the live track
     std::vector<ReIDMatch> matches;
-    float threshold = m_reidSimilarityThreshold.load();
+    for (const auto& candidate : candidates) {
+        auto& shard = trackShard(candidate.id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
 
-    for (const auto& [globalId, track] : m_globalTracks) {
-        if (!track || track->isExpired(m_maxTrackAge.load())) {
+        auto it = shard.tracks.find(candidate.id);
+        if (it == shard.tracks.end() || !it->second || it->second->isExpired(maxAge)) {
             continue;
         }
+        const auto& track = it->second;
 
         // Skip tracks from the excluded camera
         if (!excludeCameraId.empty() && track->hasCamera(excludeCameraId)) {
             continue;
         }
 
-        float similarity = computeReIDSimilarity(features, track->reidFeatures);
-        if (similarity >= threshold) {
-            // Find the camera and local track ID for this match
-            for (const auto& [cameraId, localId] : track->localTrackIds) {
-                if (cameraId != excludeCameraId) {
-                    matches.emplace_back(globalId, similarity, cameraId, localId);
-                    break; // Only add one match per global track
-                }
+        // Find the camera and local track ID for this match
+        for (const auto& [cameraId, localId] : track->localTrackIds) {
+            if (cameraId != excludeCameraId) {
+                matches.emplace_back(candidate.id, candidate.similarity, cameraId, localId);
+                break; // Only add one match per global track
             }
         }
     }
 
-    // Sort by similarity (highest first)
-    std::sort(matches.begin(), matches.end(),
-              [](const ReIDMatch& a, const ReIDMatch& b) {
-                  return a.similarity > b.similarity;
-              });
-
     return matches;
 }
 
@@ -842,18 +881,18 @@ double TaskManager::getMaxTrackAge() const {
 
 // Cross-camera tracking statistics methods
 size_t TaskManager::getGlobalTrackCount() const {
-    AISecurityVision::HierarchicalMutexLock lock(m_crossCameraMutex, AISecurityVision::LockLevel::CROSS_CAMERA_TRACKING, "TaskManager::m_crossCameraMutex");
-    return m_globalTracks.size();
+    return m_globalTrackCount.load();
 }
 
 size_t TaskManager::getActiveCrossCameraTrackCount() const {
-    AISecurityVision::HierarchicalMutexLock lock(m_crossCameraMutex, AISecurityVision::LockLevel::CROSS_CAMERA_TRACKING, "TaskManager::m_crossCameraMutex");
-
     size_t activeCount = 0;
     double maxAge = m_maxTrackAge.load();
-    for (const auto& [globalId, track] : m_globalTracks) {
-        if (track && track->isActive && !track->isExpired(maxAge)) {
-            activeCount++;
+    for (auto& shard : m_trackShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [globalId, track] : shard.tracks) {
+            if (track && track->isActive && !track->isExpired(maxAge)) {
+                activeCount++;
+            }
         }
     }
     return activeCount;
@@ -874,9 +913,9 @@ void TaskManager::resetCrossCameraTrackingStats() {
 
 // Task 75: CrossCameraTrack implementation
 CrossCameraTrack::CrossCameraTrack(int globalId, const std::string& cameraId, int localId,
-                                  const std::vector<float>& features, const cv::Rect& bbox,
+                                  std::vector<float> features, const cv::Rect& bbox,
                                   int cls, float conf)
-    : globalTrackId(globalId), primaryCameraId(cameraId), reidFeatures(features),
+    : globalTrackId(globalId), primaryCameraId(cameraId), reidFeatures(std::move(features)),
       lastBbox(bbox), classId(cls), confidence(conf), isActive(true) {
 
     auto now = std::chrono::steady_clock::now();
@@ -909,7 +948,7 @@ void CrossCameraTrack::updateTrack(const std::string& cameraId, int localId,
     // Update local track ID for this camera
     localTrackIds[cameraId] = localId;
 
-    LOG_INFO() << "[CrossCameraTrack] Updated global track " << globalTrackId
+    LOG_DEBUG() << "[CrossCameraTrack] Updated global track " << globalTrackId
               << " from camera " << cameraId << " local track " << localId;
 }
 
@@ -933,101 +972,146 @@ bool CrossCameraTrack::isExpired(double maxAgeSeconds) const {
 }
 
 // Task 75: Internal cross-camera tracking helper methods
-int TaskManager::createNewGlobalTrack(const std::string& cameraId, int localTrackId,
-                                     const std::vector<float>& reidFeatures, const cv::Rect& bbox,
-                                     int classId, float confidence) {
-    int globalId = m_nextGlobalTrackId.fetch_add(1);
+TaskManager::GlobalTrackShard& TaskManager::trackShard(int globalId) const {
+    return m_trackShards[static_cast<unsigned int>(globalId) % GLOBAL_TRACK_SHARDS];
+}
 
-    auto globalTrack = std::make_shared<CrossCameraTrack>(
-        globalId, cameraId, localTrackId, reidFeatures, bbox, classId, confidence);
+std::shared_ptr<TaskManager::CameraTrackMap> TaskManager::cameraTrackMap(const std::string& cameraId) {
+    std::lock_guard<std::mutex> lock(m_cameraTrackMapsMutex);
+    auto& cameraMap = m_cameraTrackMaps[cameraId];
+    if (!cameraMap) {
+        cameraMap = std::make_shared<CameraTrackMap>();
+    }
+    return cameraMap;
+}
 
-    m_globalTracks[globalId] = globalTrack;
+std::shared_ptr<TaskManager::CameraTrackMap> TaskManager::findCameraTrackMap(const std::string& cameraId) const {
+    std::lock_guard<std::mutex> lock(m_cameraTrackMapsMutex);
+    auto it = m_cameraTrackMaps.find(cameraId);
+    return it != m_cameraTrackMaps.end() ? it->second : nullptr;
+}
 
-    // Cleanup expired tracks if we're approaching the limit
-    if (m_globalTracks.size() > MAX_GLOBAL_TRACKS * 0.8) {
-        cleanupExpiredTracks();
+bool TaskManager::updateGlobalTrack(int globalId, const std::string& cameraId, const TrackUpdate& update,
+                                    bool asNewCamera) {
+    auto& shard = trackShard(globalId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.tracks.find(globalId);
+    if (it == shard.tracks.end() || !it->second) {
+        return false;
     }
+    auto& track = it->second;
 
-    LOG_INFO() << "[TaskManager] Created new global track " << globalId
-              << " for camera " << cameraId << " local track " << localTrackId;
+    // A match from another camera must be alive and not already seen by this camera
+    if (asNewCamera && (track->isExpired(m_maxTrackAge.load()) || track->hasCamera(cameraId))) {
+        return false;
+    }
 
-    return globalId;
+    track->updateTrack(cameraId, update.localTrackId, update.reidFeatures, update.bbox, update.confidence);
+    m_reidIndex.upsert(globalId, cameraId, track->reidFeatures, track->lastSeen);
+    return true;
 }
 
-std::shared_ptr<CrossCameraTrack> TaskManager::findBestMatch(const std::vector<float>& features,
-                                                           const std::string& excludeCameraId) const {
-    std::shared_ptr<CrossCameraTrack> bestMatch = nullptr;
-    float bestSimilarity = 0.0f;
-    float threshold = m_reidSimilarityThreshold.load();
-    double maxAge = m_maxTrackAge.load();
-
-    for (const auto& [globalId, track] : m_globalTracks) {
-        if (!track || track->isExpired(maxAge)) {
-            continue;
+int TaskManager::associateTrack(const std::string& cameraId, TrackUpdate& update) {
+    // Try to find a matching global track using ReID features
+    if (m_crossCameraMatchingEnabled.load()) {
+        double maxAge = m_maxTrackAge.load();
+        auto seenSince = std::chrono::steady_clock::now() -
+                         std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(maxAge));
+
+        auto candidates = m_reidIndex.search(update.reidFeatures, m_reidSimilarityThreshold.load(),
+                                             REID_MATCH_CANDIDATES, cameraId, seenSince);
+
+        // Best candidate that is still alive and not seen by the same camera
+        for (const auto& candidate : candidates) {
+            if (updateGlobalTrack(candidate.id, cameraId, update, true)) {
+                m_totalCrossCameraMatches.fetch_add(1);
+
+                LOG_INFO() << "[TaskManager] Cross-camera match: camera " << cameraId
+                          << " local track " << update.localTrackId << " -> global track "
+                          << candidate.id;
+                return candidate.id;
+            }
         }
+    }
 
-        // Skip tracks from the same camera
-        if (track->hasCamera(excludeCameraId)) {
-            continue;
-        }
+    // No match found - create new global track
+    return createNewGlobalTrack(cameraId, update);
+}
 
-        float similarity = computeReIDSimilarity(features, track->reidFeatures);
-        if (similarity >= threshold && similarity > bestSimilarity) {
-            bestSimilarity = similarity;
-            bestMatch = track;
-        }
+int TaskManager::createNewGlobalTrack(const std::string& cameraId, TrackUpdate& update) {
+    int globalId = m_nextGlobalTrackId.fetch_add(1);
+
+    auto globalTrack = std::make_shared<CrossCameraTrack>(
+        globalId, cameraId, update.localTrackId, std::move(update.reidFeatures),
+        update.bbox, update.classId, update.confidence);
+
+    {
+        auto& shard = trackShard(globalId);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.tracks[globalId] = globalTrack;
+        m_reidIndex.upsert(globalId, cameraId, globalTrack->reidFeatures, globalTrack->lastSeen);
+    }
+
+    // Cleanup expired tracks if we're approaching the limit
+    if (m_globalTrackCount.fetch_add(1) + 1 > MAX_GLOBAL_TRACKS * 0.8) {
+        cleanupExpiredTracks();
     }
 
-    return bestMatch;
+    // New tracks are published right away so other cameras can match them
+    m_reidIndex.commitIfDue();
+
+    LOG_INFO() << "[TaskManager] Created new global track " << globalId
+              << " for camera " << cameraId << " local track " << update.localTrackId;
+
+    return globalId;
 }
 
 void TaskManager::cleanupExpiredTracks() {
     double maxAge = m_maxTrackAge.load();
-    auto it = m_globalTracks.begin();
-
-    while (it != m_globalTracks.end()) {
-        if (!it->second || it->second->isExpired(maxAge)) {
-            // Remove from local-to-global mapping
-            for (const auto& [cameraId, localId] : it->second->localTrackIds) {
-                auto cameraIt = m_localToGlobalTrackMap.find(cameraId);
-                if (cameraIt != m_localToGlobalTrackMap.end()) {
-                    cameraIt->second.erase(localId);
-                    if (cameraIt->second.empty()) {
-                        m_localToGlobalTrackMap.erase(cameraIt);
-                    }
+    std::vector<std::shared_ptr<CrossCameraTrack>> expired;
+    size_t removed = 0;
+
+    for (auto& shard : m_trackShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.tracks.begin();
+        while (it != shard.tracks.end()) {
+            if (!it->second || it->second->isExpired(maxAge)) {
+                if (it->second) {
+                    expired.push_back(it->second);
                 }
+                m_reidIndex.remove(it->first);
+                removed++;
+                it = shard.tracks.erase(it);
+            } else {
+                ++it;
             }
-
-            LOG_INFO() << "[TaskManager] Cleaned up expired global track " << it->first;
-            it = m_globalTracks.erase(it);
-        } else {
-            ++it;
         }
     }
-}
 
-float TaskManager::computeReIDSimilarity(const std::vector<float>& features1,
-                                        const std::vector<float>& features2) const {
-    if (features1.empty() || features2.empty() || features1.size() != features2.size()) {
-        return 0.0f;
-    }
-
-    // Compute cosine similarity
-    float dotProduct = 0.0f;
-    float norm1 = 0.0f;
-    float norm2 = 0.0f;
-
-    for (size_t i = 0; i < features1.size(); ++i) {
-        dotProduct += features1[i] * features2[i];
-        norm1 += features1[i] * features1[i];
-        norm2 += features2[i] * features2[i];
+    if (removed == 0) {
+        return;
     }
+    m_globalTrackCount.fetch_sub(removed);
+
+    // Remove from local-to-global mapping unless the local track was re-associated since
+    for (const auto& track : expired) {
+        for (const auto& [cameraId, localId] : track->localTrackIds) {
+            auto cameraMap = findCameraTrackMap(cameraId);
+            if (!cameraMap) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(cameraMap->mutex);
+            auto it = cameraMap->localToGlobal.find(localId);
+            if (it != cameraMap->localToGlobal.end() && it->second == track->globalTrackId) {
+                cameraMap->localToGlobal.erase(it);
+            }
+        }
 
-    if (norm1 == 0.0f || norm2 == 0.0f) {
-        return 0.0f;
+        LOG_INFO() << "[TaskManager] Cleaned up expired global track " << track->globalTrackId;
     }
 
-    return dotProduct / (std::sqrt(norm1) * std::sqrt(norm2));
+    m_reidIndex.commit();
 }
 
 void TaskManager::updateCrossCameraTrackingStats() {
@@ -1035,15 +1119,7 @@ void TaskManager::updateCrossCameraTrackingStats() {
     // Currently, statistics are updated in real-time, but this provides
     // a hook for future batch updates if needed
 
-    // Count active tracks directly without acquiring lock again
-    size_t activeCount = 0;
-    double maxAge = m_maxTrackAge.load();
-    for (const auto& [globalId, track] : m_globalTracks) {
-        if (track && track->isActive && !track->isExpired(maxAge)) {
-            activeCount++;
-        }
-    }
-    m_activeCrossCameraTracks.store(activeCount);
+    m_activeCrossCameraTracks.store(getActiveCrossCameraTrackCount());
 }
 
 // Detection category filtering implementation
@@ -1123,6 +1199,155 @@ AlarmTrigger* TaskManager::getAlarmTrigger() const {
     return m_alarmTrigger.get();
 }
 
+// Shared batched inference implementation
+void TaskManager::setSharedInferenceEnabled(bool enabled) {
+    m_sharedInferenceEnabled.store(enabled);
+    LOG_INFO() << "[TaskManager] Shared inference " << (enabled ? "enabled" : "disabled")
+               << " for newly added pipelines";
+}
+
+bool TaskManager::isSharedInferenceEnabled() const {
+    return m_sharedInferenceEnabled.load();
+}
+
+void TaskManager::setSharedInferenceConfig(int maxBatchSize, int maxWaitMs) {
+    m_inferenceMaxBatchSize.store(std::max(1, std::min(maxBatchSize, static_cast<int>(MAX_PIPELINES))));
+    m_inferenceMaxWaitMs.store(std::max(0, maxWaitMs));
+    LOG_INFO() << "[TaskManager] Shared inference config: max batch " << m_inferenceMaxBatchSize.load()
+               << ", max wait " << m_inferenceMaxWaitMs.load() << "ms (applies when the scheduler starts)";
+}
+
+void TaskManager::setDefaultPipelinedMode(bool enabled, size_t stageQueueDepth) {
+    m_defaultPipelinedMode.store(enabled);
+    m_defaultStageQueueDepth.store(stageQueueDepth);
+    LOG_INFO() << "[TaskManager] Pipelined mode " << (enabled ? "enabled" : "disabled")
+               << (stageQueueDepth > 0 ? ", stage queue depth " + std::to_string(stageQueueDepth) : std::string())
+               << " for newly added pipelines";
+}
+
+bool TaskManager::isDefaultPipelinedMode() const {
+    return m_defaultPipelinedMode.load();
+}
+
+void TaskManager::setDefaultDecodePolicy(const DecodePolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    m_defaultDecodePolicy = policy;
+    LOG_INFO() << "[TaskManager] Decode policy " << DecodePolicy::frameSkipName(policy.frameSkip)
+               << (policy.adaptive ? " (adaptive)" : "") << " for newly added pipelines";
+}
+
+DecodePolicy TaskManager::getDefaultDecodePolicy() const {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    return m_defaultDecodePolicy;
+}
+
+void TaskManager::setDefaultMotionGatePolicy(const AISecurityVision::MotionGatePolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    m_defaultMotionGatePolicy = policy;
+    LOG_INFO() << "[TaskManager] Motion gate " << (policy.enabled ? "enabled" : "disabled")
+               << " for newly added pipelines";
+}
+
+AISecurityVision::MotionGatePolicy TaskManager::getDefaultMotionGatePolicy() const {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    return m_defaultMotionGatePolicy;
+}
+
+void TaskManager::setDefaultDetectionCadencePolicy(const AISecurityVision::DetectionCadencePolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    m_defaultCadencePolicy = policy;
+    LOG_INFO() << "[TaskManager] Detection every " << policy.interval << " frame(s)"
+               << (policy.adaptive ? " at most (adaptive)" : "") << " for newly added pipelines";
+}
+
+AISecurityVision::DetectionCadencePolicy TaskManager::getDefaultDetectionCadencePolicy() const {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    return m_defaultCadencePolicy;
+}
+
+void TaskManager::setDefaultRegionInferencePolicy(const AISecurityVision::RegionInferencePolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    m_defaultRegionPolicy = policy;
+    LOG_INFO() << "[TaskManager] Region inference mode " << AISecurityVision::RegionInferencePolicy::modeName(policy.mode)
+               << " for newly added pipelines";
+}
+
+AISecurityVision::RegionInferencePolicy TaskManager::getDefaultRegionInferencePolicy() const {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    return m_defaultRegionPolicy;
+}
+
+void TaskManager::setDefaultReIDCachePolicy(const AISecurityVision::ReIDCachePolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    m_defaultReIDCachePolicy = policy;
+    LOG_INFO() << "[TaskManager] ReID embedding refresh every " << policy.refreshFrames
+               << " detection frame(s) for newly added pipelines";
+}
+
+AISecurityVision::ReIDCachePolicy TaskManager::getDefaultReIDCachePolicy() const {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    return m_defaultReIDCachePolicy;
+}
+
+void TaskManager::setDefaultRecordingConfig(const RecordingConfig& config) {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    m_defaultRecordingConfig = config;
+    LOG_INFO() << "[TaskManager] Recording mode " << RecordingConfig::modeName(config.mode)
+               << (config.continuous ? " with continuous segments" : "")
+               << " for newly added pipelines";
+}
+
+RecordingConfig TaskManager::getDefaultRecordingConfig() const {
+    std::lock_guard<std::mutex> lock(m_decodePolicyMutex);
+    return m_defaultRecordingConfig;
+}
+
+AISecurityVision::InferenceScheduler* TaskManager::startInferenceScheduler() {
+    // Plain mutex: called from VideoPipeline::initialize() while the pipeline lock is held
+    std::lock_guard<std::mutex> lock(m_inferenceMutex);
+
+    if (m_inferenceScheduler && m_inferenceScheduler->isRunning()) {
+        return m_inferenceScheduler.get();
+    }
+
+    AISecurityVision::InferenceSchedulerConfig config;
+    config.maxBatchSize = m_inferenceMaxBatchSize.load();
+    config.maxWaitMs = m_inferenceMaxWaitMs.load();
+
+#ifdef ENABLE_RKNN_NPU
+    std::unique_ptr<AISecurityVision::YOLOv8Detector> detector = std::make_unique<AISecurityVision::YOLOv8RKNNDetector>();
+    const std::string modelPath = "models/yolov8n.rknn";
+#else
+    auto detector = AISecurityVision::YOLOv8DetectorFactory::createDetector(AISecurityVision::InferenceBackend::TENSORRT);
+    const std::string modelPath = "models/yolov8n.onnx";
+#endif
+
+    // The scheduler object outlives shutdown/restart so pipelines never hold a dangling pointer
+    if (!m_inferenceScheduler) {
+        m_inferenceScheduler = std::make_unique<AISecurityVision::InferenceScheduler>();
+    }
+
+    if (!m_inferenceScheduler->initialize(std::move(detector), modelPath, config)) {
+        LOG_ERROR() << "[TaskManager] Failed to start shared inference scheduler";
+        return nullptr;
+    }
+
+    return m_inferenceScheduler.get();
+}
+
+AISecurityVision::InferenceScheduler* TaskManager::getInferenceScheduler() const {
+    std::lock_guard<std::mutex> lock(m_inferenceMutex);
+    return m_inferenceScheduler.get();
+}
+
+void TaskManager::shutdownInferenceScheduler() {
+    std::lock_guard<std::mutex> lock(m_inferenceMutex);
+
+    if (m_inferenceScheduler) {
+        m_inferenceScheduler->shutdown();
+    }
+}
+
 void TaskManager::cleanupPipeline(const std::string& sourceId) {
     // This method is called internally to clean up failed pipelines
     // The actual cleanup is handled in removeVideoSource
@@ -8,15 +8,22 @@
 #include <atomic>
 #include <string>
 #include <vector>
+#include <array>
 #include <chrono>
 #include <opencv2/opencv.hpp>
 #include "LockHierarchy.h"
+#include "EmbeddingIndex.h"
+#include "VideoPipeline.h"  // For DecodePolicy
 
 // Forward declarations
 class VideoPipeline;
 class MJPEGPortManager;
 class AlarmTrigger;
 
+namespace AISecurityVision {
+    class InferenceScheduler;
+}
+
 // VideoSource is now defined in VideoPipeline.h
 struct VideoSource;
 
@@ -40,7 +47,7 @@ struct CrossCameraTrack {
     bool isActive;                                  // Whether track is currently active
 
     CrossCameraTrack(int globalId, const std::string& cameraId, int localId,
-                    const std::vector<float>& features, const cv::Rect& bbox,
+                    std::vector<float> features, const cv::Rect& bbox,
                     int cls, float conf);
 
     void updateTrack(const std::string& cameraId, int localId,
@@ -66,6 +73,17 @@ struct ReIDMatch {
         : globalTrackId(globalId), similarity(sim), matchedCameraId(cameraId), matchedLocalTrackId(localId) {}
 };
 
+/**
+ * @brief One local track observation reported for cross-camera tracking
+ */
+struct TrackUpdate {
+    int localTrackId;
+    std::vector<float> reidFeatures;                // Moved into the global track where possible
+    cv::Rect bbox;
+    int classId;
+    float confidence;
+};
+
 /**
  * @brief Singleton TaskManager for managing multiple VideoPipeline instances
  *
@@ -157,6 +175,12 @@ public:
                           const std::vector<float>& reidFeatures, const cv::Rect& bbox,
                           int classId, float confidence);
 
+    /**
+     * @brief Report every track of one camera frame in a single call
+     * @return Global track ID per update, in order (-1 for updates without ReID features)
+     */
+    std::vector<int> reportTrackUpdates(const std::string& cameraId, std::vector<TrackUpdate> updates);
+
     int getGlobalTrackId(const std::string& cameraId, int localTrackId) const;
     std::vector<CrossCameraTrack> getActiveCrossCameraTracks() const;
     std::vector<ReIDMatch> findReIDMatches(const std::vector<float>& features,
@@ -192,14 +216,54 @@ public:
     bool initializeAlarmTrigger();
     void shutdownAlarmTrigger();
 
+    // Shared batched inference (applies to pipelines added afterwards)
+    void setSharedInferenceEnabled(bool enabled);
+    bool isSharedInferenceEnabled() const;
+    void setSharedInferenceConfig(int maxBatchSize, int maxWaitMs);
+    AISecurityVision::InferenceScheduler* startInferenceScheduler();
+    AISecurityVision::InferenceScheduler* getInferenceScheduler() const;  // nullptr if never started
+    void shutdownInferenceScheduler();
+
+    // Pipelined stage threads (applies to pipelines added afterwards; depth 0 = pipeline default)
+    void setDefaultPipelinedMode(bool enabled, size_t stageQueueDepth = 0);
+    bool isDefaultPipelinedMode() const;
+
+    // Decoder threading and frame skipping (applies to pipelines added afterwards)
+    void setDefaultDecodePolicy(const DecodePolicy& policy);
+    DecodePolicy getDefaultDecodePolicy() const;
+
+    // Motion-gated detection (applies to pipelines added afterwards; per camera via VideoPipeline)
+    void setDefaultMotionGatePolicy(const AISecurityVision::MotionGatePolicy& policy);
+    AISecurityVision::MotionGatePolicy getDefaultMotionGatePolicy() const;
+
+    // Detect-every-N-frames mode (applies to pipelines added afterwards; per camera via VideoPipeline)
+    void setDefaultDetectionCadencePolicy(const AISecurityVision::DetectionCadencePolicy& policy);
+    AISecurityVision::DetectionCadencePolicy getDefaultDetectionCadencePolicy() const;
+
+    // ROI-restricted / tiled inference (applies to pipelines added afterwards; per camera via VideoPipeline)
+    void setDefaultRegionInferencePolicy(const AISecurityVision::RegionInferencePolicy& policy);
+    AISecurityVision::RegionInferencePolicy getDefaultRegionInferencePolicy() const;
+
+    // ReID embedding cache (applies to pipelines added afterwards)
+    void setDefaultReIDCachePolicy(const AISecurityVision::ReIDCachePolicy& policy);
+    AISecurityVision::ReIDCachePolicy getDefaultReIDCachePolicy() const;
+
+    // Recording mode and continuous segments (applies to pipelines added afterwards)
+    void setDefaultRecordingConfig(const RecordingConfig& config);
+    RecordingConfig getDefaultRecordingConfig() const;
+
     // Configuration constants
     static constexpr size_t MAX_PIPELINES = 16;
     static constexpr int MONITORING_INTERVAL_MS = 1000;
+    static constexpr int DEFAULT_INFERENCE_BATCH_SIZE = 4;
+    static constexpr int DEFAULT_INFERENCE_MAX_WAIT_MS = 8;
 
     // Cross-camera tracking constants
     static constexpr float DEFAULT_REID_SIMILARITY_THRESHOLD = 0.7f;
     static constexpr double DEFAULT_MAX_TRACK_AGE_SECONDS = 30.0;
     static constexpr size_t MAX_GLOBAL_TRACKS = 1000;
+    static constexpr size_t REID_MATCH_CANDIDATES = 8;
+    static constexpr size_t GLOBAL_TRACK_SHARDS = 16;
 
 private:
     // Private constructor for singleton
@@ -258,10 +322,26 @@ private:
     mutable std::atomic<bool> m_monitoringHealthy{true};
 
     // Task 75: Cross-camera tracking state
+    // Global tracks are sharded by ID and local-to-global maps by camera, each
+    // behind a leaf mutex, so per-frame updates of different cameras do not
+    // serialize. m_crossCameraMutex only orders association of new local
+    // tracks and expiry cleanup.
+    struct GlobalTrackShard {
+        std::mutex mutex;
+        std::unordered_map<int, std::shared_ptr<CrossCameraTrack>> tracks;
+    };
+    struct CameraTrackMap {
+        std::mutex mutex;
+        std::unordered_map<int, int> localToGlobal;     // localId -> globalId
+    };
+
     mutable std::mutex m_crossCameraMutex;
-    std::unordered_map<int, std::shared_ptr<CrossCameraTrack>> m_globalTracks;
-    std::unordered_map<std::string, std::unordered_map<int, int>> m_localToGlobalTrackMap; // [cameraId][localId] -> globalId
+    mutable std::array<GlobalTrackShard, GLOBAL_TRACK_SHARDS> m_trackShards;
+    std::unordered_map<std::string, std::shared_ptr<CameraTrackMap>> m_cameraTrackMaps;
+    mutable std::mutex m_cameraTrackMapsMutex;
+    std::atomic<size_t> m_globalTrackCount{0};
     std::atomic<int> m_nextGlobalTrackId{1};
+    AISecurityVision::EmbeddingIndex m_reidIndex;   // Features of all global tracks, searched without locking
 
     // Cross-camera tracking configuration
     std::atomic<bool> m_crossCameraTrackingEnabled{true};
@@ -274,22 +354,42 @@ private:
     mutable std::atomic<size_t> m_activeCrossCameraTracks{0};
 
     // Internal cross-camera tracking methods
-    int createNewGlobalTrack(const std::string& cameraId, int localTrackId,
-                           const std::vector<float>& reidFeatures, const cv::Rect& bbox,
-                           int classId, float confidence);
+    GlobalTrackShard& trackShard(int globalId) const;
+    std::shared_ptr<CameraTrackMap> cameraTrackMap(const std::string& cameraId);
+    std::shared_ptr<CameraTrackMap> findCameraTrackMap(const std::string& cameraId) const;
 
-    std::shared_ptr<CrossCameraTrack> findBestMatch(const std::vector<float>& features,
-                                                   const std::string& excludeCameraId) const;
+    bool updateGlobalTrack(int globalId, const std::string& cameraId, const TrackUpdate& update,
+                           bool asNewCamera);
+    int associateTrack(const std::string& cameraId, TrackUpdate& update);
+    int createNewGlobalTrack(const std::string& cameraId, TrackUpdate& update);
 
     void cleanupExpiredTracks();
-    float computeReIDSimilarity(const std::vector<float>& features1,
-                               const std::vector<float>& features2) const;
 
     void updateCrossCameraTrackingStats();
 
     // Alarm management
     std::unique_ptr<AlarmTrigger> m_alarmTrigger;
     mutable std::mutex m_alarmMutex;
+
+    // Shared batched inference
+    std::unique_ptr<AISecurityVision::InferenceScheduler> m_inferenceScheduler;
+    mutable std::mutex m_inferenceMutex;
+    std::atomic<bool> m_sharedInferenceEnabled{false};
+    std::atomic<int> m_inferenceMaxBatchSize{DEFAULT_INFERENCE_BATCH_SIZE};
+    std::atomic<int> m_inferenceMaxWaitMs{DEFAULT_INFERENCE_MAX_WAIT_MS};
+
+    // Pipelined mode for new pipelines
+    std::atomic<bool> m_defaultPipelinedMode{false};
+    std::atomic<size_t> m_defaultStageQueueDepth{0};
+
+    // Decode, motion gate, detection cadence, region inference and ReID cache policies for new pipelines
+    DecodePolicy m_defaultDecodePolicy;
+    AISecurityVision::MotionGatePolicy m_defaultMotionGatePolicy;  // Guarded by m_decodePolicyMutex
+    AISecurityVision::DetectionCadencePolicy m_defaultCadencePolicy;  // Guarded by m_decodePolicyMutex
+    AISecurityVision::RegionInferencePolicy m_defaultRegionPolicy;  // Guarded by m_decodePolicyMutex
+    AISecurityVision::ReIDCachePolicy m_defaultReIDCachePolicy;  // Guarded by m_decodePolicyMutex
+    RecordingConfig m_defaultRecordingConfig;  // Guarded by m_decodePolicyMutex
+    mutable std::mutex m_decodePolicyMutex;
 };
 
 // VideoSource is now defined in VideoPipeline.h
@@ -1,12 +1,17 @@
 #include "VideoPipeline.h"
 #include "TaskManager.h"
+#include "FramePool.h"
 #include "../video/FFmpegDecoder.h"
 #include "../ai/YOLOv8Detector.h"
 #include "../ai/YOLOv8DetectorFactory.h"
+#include "../ai/InferenceScheduler.h"
 #ifdef ENABLE_RKNN_NPU
 #include "../ai/YOLOv8RKNNDetector.h"
 #endif
 #include "../ai/ByteTracker.h"
+#include "../ai/TrackFlowRefiner.h"
+#include "../ai/RegionInference.h"
+#include "../ai/ReIDEmbeddingCache.h"
 #include "../ai/ReIDExtractor.h"
 #include "../recognition/FaceRecognizer.h"
 #include "../recognition/LicensePlateRecognizer.h"
@@ -24,11 +29,44 @@
 #include <sstream>
 #include <functional>
 #include <future>
+#include <algorithm>
+#include <cmath>
 
 #include "../core/Logger.h"
 using namespace AISecurityVision;
+
+/**
+ * @brief Unit of work handed between pipeline stages
+ */
+struct VideoPipeline::StageFrame {
+    FrameResult result;
+    std::vector<float> confidences;   // Per-detection confidence, for tracking
+    std::vector<int> classIds;        // Per-detection class ID, for tracking
+    cv::Mat modelFrame;               // Decoder-letterboxed detector input, if requested
+    AISecurityVision::LetterboxInfo letterbox;
+    float motionActivity = -1.0f;     // Codec motion-vector activity, < 0 if not exported
+    bool detectionSkipped = false;    // Motion gate or detection cadence: tracks are propagated instead
+    std::chrono::steady_clock::time_point enqueuedAt;
+    std::chrono::steady_clock::time_point decodedAt;   // For the decoder's adaptive frame skipping
+};
+
+namespace {
+
+const char* const STAGE_NAMES[] = {"decode", "inference", "analytics", "output"};
+constexpr double STAGE_EMA_ALPHA = 0.1;
+
+double elapsedMs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+} // namespace
+
 VideoPipeline::VideoPipeline(const VideoSource& source)
-    : m_source(source) {
+    : m_source(source)
+    , m_inferenceQueue(std::make_unique<StageQueue>(DEFAULT_STAGE_QUEUE_DEPTH))
+    , m_analyticsQueue(std::make_unique<StageQueue>(DEFAULT_STAGE_QUEUE_DEPTH))
+    , m_outputQueue(std::make_unique<StageQueue>(DEFAULT_STAGE_QUEUE_DEPTH))
+    , m_reidCache(std::make_unique<AISecurityVision::ReIDEmbeddingCache>()) {
     LOG_INFO() << "[VideoPipeline] Creating pipeline for: " << source.id;
 
     // Initialize health monitoring timestamps
@@ -48,52 +86,44 @@ bool VideoPipeline::initialize() {
     try {
         LOG_INFO() << "[VideoPipeline] Initializing pipeline: " << m_source.id;
 
+        // Per-camera motion gate, detection cadence and region inference configuration
+        // override the TaskManager defaults
+        try {
+            DatabaseManager dbManager;
+            auto motionPolicy = m_motionGate.getPolicy();
+            auto cadencePolicy = m_detectionCadence.getPolicy();
+            auto regionPolicy = getRegionInferencePolicy();
+            if (dbManager.initialize()) {
+                if (dbManager.getMotionGatePolicy(m_source.id, motionPolicy)) {
+                    m_motionGate.setPolicy(motionPolicy);
+                    LOG_INFO() << "[VideoPipeline] Loaded motion gate configuration for " << m_source.id;
+                }
+                if (dbManager.getDetectionCadencePolicy(m_source.id, cadencePolicy)) {
+                    setDetectionCadencePolicy(cadencePolicy);
+                }
+                if (dbManager.getRegionInferencePolicy(m_source.id, regionPolicy)) {
+                    setRegionInferencePolicy(regionPolicy);
+                }
+            }
+        } catch (const std::exception& e) {
+            LOG_WARN() << "[VideoPipeline] Failed to load motion gate / detection cadence / region inference configuration: "
+                       << e.what();
+        }
+
         // Initialize decoder
         m_decoder = std::make_unique<FFmpegDecoder>();
+        m_decoder->setDecodePolicy(m_decodePolicy);
+        auto motionPolicy = m_motionGate.getPolicy();
+        m_decoder->setMotionVectorExport(motionPolicy.enabled && motionPolicy.useMotionVectors);
         if (!m_decoder->initialize(m_source)) {
             handleError("Failed to initialize decoder");
             return false;
         }
 
-        // Initialize AI modules - choose between optimized and standard detector
-#ifdef ENABLE_RKNN_NPU
-        if (m_optimizedDetectionEnabled.load()) {
-            LOG_INFO() << "[VideoPipeline] Initializing RKNN YOLOv8 detector...";
-
-            m_optimizedDetector = std::make_unique<AISecurityVision::YOLOv8RKNNDetector>();
-            if (!m_optimizedDetector->initialize("models/yolov8n.rknn")) {
-                LOG_ERROR() << "[VideoPipeline] Failed to initialize RKNN detector, falling back to standard detector";
-                m_optimizedDetectionEnabled.store(false);
-
-                // Fallback to standard detector - create RKNN detector directly
-                m_detector = std::make_unique<AISecurityVision::YOLOv8RKNNDetector>();
-                if (!m_detector || !m_detector->initialize("models/yolov8n.rknn")) {
-                    handleError("Failed to initialize YOLOv8 detector");
-                    return false;
-                }
-            } else {
-                LOG_INFO() << "[VideoPipeline] RKNN YOLOv8 detector initialized successfully!";
-                // Enable multi-core NPU for better performance
-                auto rknnDetector = static_cast<AISecurityVision::YOLOv8RKNNDetector*>(m_optimizedDetector.get());
-                rknnDetector->enableMultiCore(true);
-                rknnDetector->setZeroCopyMode(true);
-            }
-        } else {
-            m_detector = std::make_unique<AISecurityVision::YOLOv8RKNNDetector>();
-            if (!m_detector || !m_detector->initialize("models/yolov8n.rknn")) {
-                handleError("Failed to initialize YOLOv8 detector");
-                return false;
-            }
-        }
-#else
-        // Use YOLOv8DetectorFactory for non-RKNN builds
-        LOG_INFO() << "[VideoPipeline] Initializing YOLOv8 detector using factory...";
-        m_detector = AISecurityVision::YOLOv8DetectorFactory::createDetector(AISecurityVision::InferenceBackend::TENSORRT);
-        if (!m_detector || !m_detector->initialize("models/yolov8n.onnx")) {
-            handleError("Failed to initialize YOLOv8 detector");
+        // Initialize AI modules - shared batched inference or a private detector
+        if (!initializeDetector()) {
             return false;
         }
-#endif
 
         // Load saved detection categories from database
         try {
@@ -180,12 +210,18 @@ bool VideoPipeline::initialize() {
             handleError("Failed to initialize output modules");
             return false;
         }
+        m_recorder->setConfig(m_recordingConfig);
+
+        updatePacketSink();
 
         // Enable streaming by default
         m_streamingEnabled.store(true);
 
         LOG_INFO() << "[VideoPipeline] MJPEG stream available at: " << m_streamer->getStreamUrl();
 
+        // Have the decoder emit the detector and stream resolutions directly
+        updateFramePlanes();
+
         LOG_INFO() << "[VideoPipeline] Pipeline initialized successfully: " << m_source.id;
         return true;
 
@@ -195,6 +231,65 @@ bool VideoPipeline::initialize() {
     }
 }
 
+bool VideoPipeline::initializeDetector() {
+    // Shared batched inference: submit frames to the TaskManager's scheduler
+    // instead of loading a private copy of the model
+    if (m_sharedInferenceEnabled.load()) {
+        m_inferenceScheduler = TaskManager::getInstance().startInferenceScheduler();
+        if (m_inferenceScheduler) {
+            LOG_INFO() << "[VideoPipeline] Using shared inference scheduler ("
+                      << m_inferenceScheduler->getBackendName() << ") for " << m_source.id;
+            return true;
+        }
+
+        LOG_WARN() << "[VideoPipeline] Shared inference unavailable, falling back to private detector for "
+                   << m_source.id;
+        m_sharedInferenceEnabled.store(false);
+    }
+
+    // Initialize AI modules - choose between optimized and standard detector
+#ifdef ENABLE_RKNN_NPU
+    if (m_optimizedDetectionEnabled.load()) {
+        LOG_INFO() << "[VideoPipeline] Initializing RKNN YOLOv8 detector...";
+
+        m_optimizedDetector = std::make_unique<AISecurityVision::YOLOv8RKNNDetector>();
+        if (!m_optimizedDetector->initialize("models/yolov8n.rknn")) {
+            LOG_ERROR() << "[VideoPipeline] Failed to initialize RKNN detector, falling back to standard detector";
+            m_optimizedDetectionEnabled.store(false);
+
+            // Fallback to standard detector - create RKNN detector directly
+            m_detector = std::make_unique<AISecurityVision::YOLOv8RKNNDetector>();
+            if (!m_detector || !m_detector->initialize("models/yolov8n.rknn")) {
+                handleError("Failed to initialize YOLOv8 detector");
+                return false;
+            }
+        } else {
+            LOG_INFO() << "[VideoPipeline] RKNN YOLOv8 detector initialized successfully!";
+            // Enable multi-core NPU for better performance
+            auto rknnDetector = static_cast<AISecurityVision::YOLOv8RKNNDetector*>(m_optimizedDetector.get());
+            rknnDetector->enableMultiCore(true);
+            rknnDetector->setZeroCopyMode(true);
+        }
+    } else {
+        m_detector = std::make_unique<AISecurityVision::YOLOv8RKNNDetector>();
+        if (!m_detector || !m_detector->initialize("models/yolov8n.rknn")) {
+            handleError("Failed to initialize YOLOv8 detector");
+            return false;
+        }
+    }
+#else
+    // Use YOLOv8DetectorFactory for non-RKNN builds
+    LOG_INFO() << "[VideoPipeline] Initializing YOLOv8 detector using factory...";
+    m_detector = AISecurityVision::YOLOv8DetectorFactory::createDetector(AISecurityVision::InferenceBackend::TENSORRT);
+    if (!m_detector || !m_detector->initialize("models/yolov8n.onnx")) {
+        handleError("Failed to initialize YOLOv8 detector");
+        return false;
+    }
+#endif
+
+    return true;
+}
+
 void VideoPipeline::start() {
     if (m_running.load()) {
         LOG_INFO() << "[VideoPipeline] Pipeline already running: " << m_source.id;
@@ -205,6 +300,34 @@ void VideoPipeline::start() {
     m_healthy.store(true);
     m_startTime = std::chrono::steady_clock::now();
 
+    if (m_pipelinedMode.load()) {
+        size_t depth = m_stageQueueDepth.load();
+        // The queues live as long as the pipeline; statistics read them without locking
+        m_inferenceQueue->reopen(depth);
+        m_analyticsQueue->reopen(depth);
+        m_outputQueue->reopen(depth);
+        m_pipelinedActive.store(true);
+
+        // Every queued or in-flight frame pins one pooled buffer per plane
+        size_t inFlight = depth * (STAGE_COUNT - 1) + STAGE_COUNT;
+        auto& framePool = AISecurityVision::FramePool::getInstance();
+        framePool.reserveCameraCapacity(m_source.id, inFlight);
+        framePool.reserveCameraCapacity(FrameBundle::modelPoolId(m_source.id), inFlight);
+        framePool.reserveCameraCapacity(FrameBundle::streamPoolId(m_source.id), inFlight);
+
+        m_inferenceThread = std::thread(&VideoPipeline::stageThread, this,
+                                        STAGE_INFERENCE, m_inferenceQueue.get(), m_analyticsQueue.get());
+        m_analyticsThread = std::thread(&VideoPipeline::stageThread, this,
+                                        STAGE_ANALYTICS, m_analyticsQueue.get(), m_outputQueue.get());
+        m_outputThread = std::thread(&VideoPipeline::stageThread, this,
+                                     STAGE_OUTPUT, m_outputQueue.get(), nullptr);
+
+        LOG_INFO() << "[VideoPipeline] Pipelined mode enabled with stage queue depth " << depth
+                  << ": " << m_source.id;
+    } else {
+        m_pipelinedActive.store(false);
+    }
+
     m_processingThread = std::thread(&VideoPipeline::processingThread, this);
 
     LOG_INFO() << "[VideoPipeline] Pipeline started: " << m_source.id;
@@ -239,6 +362,23 @@ void VideoPipeline::stop() {
         }
     }
 
+    // Closed queues wake the stage threads, which then finish their current frame
+    m_inferenceQueue->close();
+    m_analyticsQueue->close();
+    m_outputQueue->close();
+    for (std::thread* thread : {&m_inferenceThread, &m_analyticsThread, &m_outputThread}) {
+        if (thread->joinable()) {
+            thread->join();
+        }
+    }
+
+    m_pipelinedActive.store(false);
+
+    // Frames still referenced elsewhere keep their buffers alive
+    AISecurityVision::FramePool::getInstance().releaseCamera(m_source.id);
+    AISecurityVision::FramePool::getInstance().releaseCamera(FrameBundle::modelPoolId(m_source.id));
+    AISecurityVision::FramePool::getInstance().releaseCamera(FrameBundle::streamPoolId(m_source.id));
+
     LOG_INFO() << "[VideoPipeline] Pipeline stopped: " << m_source.id;
 }
 
@@ -253,7 +393,7 @@ bool VideoPipeline::isHealthy() const {
 void VideoPipeline::processingThread() {
     LOG_INFO() << "[VideoPipeline] Processing thread started: " << m_source.id;
 
-    cv::Mat frame;
+    AISecurityVision::FrameBundle bundle;
     int64_t timestamp;
     int reconnectAttempts = 0;
 
@@ -262,8 +402,11 @@ void VideoPipeline::processingThread() {
             // Check stream health periodically
             checkStreamHealth();
 
-            // Decode frame
-            if (!m_decoder->getNextFrame(frame, timestamp)) {
+            // Decode frame; drop the previous one first so planes the decoder no
+            // longer produces are not passed on stale and their buffers go back to the pool
+            bundle = AISecurityVision::FrameBundle();
+            auto decodeStart = std::chrono::steady_clock::now();
+            if (!m_decoder->getNextFrame(bundle, timestamp)) {
                 m_consecutiveErrors.fetch_add(1);
 
                 if (shouldReconnect() && (MAX_RECONNECT_ATTEMPTS == -1 || reconnectAttempts < MAX_RECONNECT_ATTEMPTS)) {
@@ -289,11 +432,22 @@ void VideoPipeline::processingThread() {
             reconnectAttempts = 0;
             m_consecutiveErrors.store(0);
 
+            recordStageTiming(STAGE_DECODE, elapsedMs(decodeStart));
+
             // Update health metrics
             updateHealthMetrics();
 
+            // In pipelined mode this thread is the decode stage: hand the frame
+            // to the inference stage and go straight back to decoding
+            if (m_pipelinedActive.load()) {
+                dispatchToStages(bundle, timestamp);
+                continue;
+            }
+
             // Process frame through pipeline
-            processFrame(frame, timestamp);
+            auto processStart = std::chrono::steady_clock::now();
+            processFrame(bundle, timestamp);
+            m_decoder->reportPipelineLatency(elapsedMs(processStart));
 
             // Update statistics
             m_processedFrames.fetch_add(1);
@@ -317,94 +471,280 @@ void VideoPipeline::processingThread() {
     LOG_INFO() << "[VideoPipeline] Processing thread stopped: " << m_source.id;
 }
 
-void VideoPipeline::processFrame(const cv::Mat& frame, int64_t timestamp) {
-    if (frame.empty()) {
+void VideoPipeline::processFrame(FrameBundle& bundle, int64_t timestamp) {
+    if (bundle.full.empty()) {
         return;
     }
 
-    FrameResult result;
-    result.frame = frame.clone();
-    result.timestamp = timestamp;
+    // The decoded planes are pooled buffers shared read-only by every stage
+    StageFrame item;
+    item.result.frame = bundle.full;
+    item.result.streamFrame = bundle.stream;
+    item.result.timestamp = timestamp;
+    item.modelFrame = bundle.model;
+    item.letterbox = bundle.letterbox;
+    item.motionActivity = bundle.motionActivity;
 
-    // Object detection - use optimized detector if available
+    runInferenceStage(item);
+    runAnalyticsStage(item);
+    runOutputStage(item);
+}
+
+void VideoPipeline::runInferenceStage(StageFrame& item) {
+    auto stageStart = std::chrono::steady_clock::now();
+    FrameResult& result = item.result;
+    const cv::Mat& frame = result.frame;
+
+    // Prefer the decoder's letterboxed model plane when it matches the detector's input
+    auto detect = [&item, &frame](AISecurityVision::YOLOv8Detector& detector) {
+        if (!item.modelFrame.empty() && item.modelFrame.size() == detector.getInputSize()) {
+            return detector.detectObjectsLetterboxed(item.modelFrame, item.letterbox, frame.size());
+        }
+        return detector.detectObjects(frame);
+    };
+
+    // Detection runs on every Nth frame (detection cadence) unless the scene is
+    // static (motion gate, evaluated on the smallest plane the decoder produced).
+    // Skipped frames also skip ReID; the analytics stage propagates the tracks
     if (m_detectionEnabled.load()) {
+        const cv::Mat* gatePlane = &frame;
+        for (const cv::Mat* plane : {&result.streamFrame, &item.modelFrame}) {
+            if (!plane->empty() && plane->total() < gatePlane->total()) {
+                gatePlane = plane;
+            }
+        }
+        bool due = m_detectionCadence.isDue();
+        bool moving = m_motionGate.evaluate(*gatePlane, item.motionActivity);
+        item.detectionSkipped = !(due && moving);
+    }
+
+    // Object detection - use optimized detector if available
+    if (m_detectionEnabled.load() && !item.detectionSkipped) {
+        auto detectStart = std::chrono::steady_clock::now();
         std::vector<AISecurityVision::Detection> detectionResults;
 
+        if (detectRegions(item, detectionResults)) {
+            // ROI crop or tiles, already merged in full-frame coordinates
+        } else if (m_inferenceScheduler) {
+            // Shared batched inference; the scheduler returns all categories.
+            // The model plane was sized for the scheduler's detector.
+            if (!item.modelFrame.empty()) {
+                detectionResults = m_inferenceScheduler->submit(m_source.id, item.modelFrame,
+                                                                item.letterbox, frame.size()).get();
+            } else {
+                detectionResults = m_inferenceScheduler->submit(m_source.id, frame).get();
+            }
+            filterSharedDetections(detectionResults);
+        }
 #ifdef ENABLE_RKNN_NPU
-        if (m_optimizedDetectionEnabled.load() && m_optimizedDetector) {
+        else if (m_optimizedDetectionEnabled.load() && m_optimizedDetector) {
             // Use optimized RKNN detector
-            detectionResults = m_optimizedDetector->detectObjects(frame);
+            detectionResults = detect(*m_optimizedDetector);
         } else if (m_detector) {
             // Use standard detector
-            detectionResults = m_detector->detectObjects(frame);
+            detectionResults = detect(*m_detector);
         }
 #else
-        if (m_detector) {
+        else if (m_detector) {
             // Use standard detector
-            detectionResults = m_detector->detectObjects(frame);
+            detectionResults = detect(*m_detector);
         }
 #endif
+        // Includes the shared scheduler's queueing, i.e. the engine's actual load
+        m_detectionCadence.onDetection(elapsedMs(detectStart));
 
-        // Extract bounding boxes and class information
+        // Extract bounding boxes, class information, confidences and class IDs for tracking
         for (const auto& detection : detectionResults) {
             result.detections.push_back(detection.bbox);
             result.labels.push_back(detection.className);
+            item.confidences.push_back(detection.confidence);
+            item.classIds.push_back(detection.classId);
         }
+    }
 
-        // Extract confidences and class IDs for tracking
-        std::vector<float> confidences;
-        std::vector<int> classIds;
-        for (const auto& detection : detectionResults) {
-            confidences.push_back(detection.confidence);
-            classIds.push_back(detection.classId);
+    recordStageTiming(STAGE_INFERENCE, elapsedMs(stageStart));
+}
+
+bool VideoPipeline::detectRegions(StageFrame& item, std::vector<AISecurityVision::Detection>& detections) {
+    auto policy = std::atomic_load(&m_regionPolicy);
+    if (!policy || policy->mode == AISecurityVision::RegionInferencePolicy::Mode::FULL_FRAME) {
+        return false;
+    }
+
+    AISecurityVision::YOLOv8Detector* detector = nullptr;
+    cv::Size inputSize;
+    if (m_inferenceScheduler) {
+        inputSize = m_inferenceScheduler->getInputSize();
+    } else {
+        detector = m_detector.get();
+#ifdef ENABLE_RKNN_NPU
+        if (m_optimizedDetectionEnabled.load() && m_optimizedDetector) {
+            detector = m_optimizedDetector.get();
         }
+#endif
+        if (!detector) {
+            return false;
+        }
+        inputSize = detector->getInputSize();
+    }
 
-        // ReID feature extraction
-        if (m_reidExtractor && !result.detections.empty()) {
-            auto reidEmbeddings = m_reidExtractor->extractFeatures(
-                frame, result.detections, {}, classIds, confidences);
+    cv::Rect roiBounds;
+    if (policy->mode == AISecurityVision::RegionInferencePolicy::Mode::ROI_CROP && m_behaviorAnalyzer) {
+        roiBounds = m_behaviorAnalyzer->getActiveROIBounds();
+    }
+
+    if (!m_regionInference) {
+        m_regionInference = std::make_unique<AISecurityVision::RegionInference>();
+    }
+    const cv::Mat& frame = item.result.frame;
+    const auto& regions = m_regionInference->prepare(frame, inputSize, *policy, roiBounds);
+    if (regions.empty()) {
+        return false;
+    }
+
+    if (m_inferenceScheduler) {
+        // Submitted together so the scheduler can batch the regions
+        std::vector<std::future<std::vector<AISecurityVision::Detection>>> pending;
+        pending.reserve(regions.size());
+        for (const auto& region : regions) {
+            pending.push_back(m_inferenceScheduler->submit(m_source.id, region.input, region.letterbox, frame.size()));
+        }
+        std::vector<std::vector<AISecurityVision::Detection>> perRegion;
+        perRegion.reserve(pending.size());
+        for (auto& result : pending) {
+            perRegion.push_back(result.get());
+        }
+        detections = m_regionInference->merge(perRegion, frame.size(), policy->mergeThreshold);
+        filterSharedDetections(detections);
+    } else {
+        detections = m_regionInference->detect(*detector, frame.size(), policy->mergeThreshold);
+    }
+
+    m_regionFrames.fetch_add(1);
+    m_lastRegionCount.store(regions.size());
+    return true;
+}
+
+void VideoPipeline::filterSharedDetections(std::vector<AISecurityVision::Detection>& detections) {
+    // The shared detector serves pipelines with different categories, so its
+    // output is masked per pipeline here rather than while decoding
+    auto enabledClasses = std::atomic_load(&m_sharedEnabledClasses);
+    if (enabledClasses) {
+        detections.erase(std::remove_if(detections.begin(), detections.end(),
+            [&enabledClasses](const AISecurityVision::Detection& detection) {
+                return !AISecurityVision::YOLOv8Detector::isClassEnabled(*enabledClasses, detection.classId);
+            }), detections.end());
+    }
+    m_sharedDetectionCount.fetch_add(detections.size());
+}
+
+void VideoPipeline::runAnalyticsStage(StageFrame& item) {
+    auto stageStart = std::chrono::steady_clock::now();
+    FrameResult& result = item.result;
+    const cv::Mat& frame = result.frame;
+    const std::vector<float>& confidences = item.confidences;
+    const std::vector<int>& classIds = item.classIds;
+
+    // Optical flow compares consecutive frames, so it sees every frame
+    if (m_detectionCadence.isOpticalFlowEnabled()) {
+        if (!m_flowRefiner) {
+            m_flowRefiner = std::make_unique<AISecurityVision::TrackFlowRefiner>();
+        }
+        m_flowRefiner->setFrame(frame);
+    } else {
+        m_flowRefiner.reset();
+    }
 
-            // Extract feature vectors for tracking
+    if (m_detectionEnabled.load() && item.detectionSkipped) {
+        propagateTracks(item);
+    } else if (m_detectionEnabled.load()) {
+        for (size_t i = 0; i < result.labels.size() && i < classIds.size(); ++i) {
+            m_classLabels.emplace(classIds[i], result.labels[i]);
+        }
+
+        // ReID feature extraction; detections continuing a track reuse its cached
+        // embedding unless the cache policy asks for a fresh one
+        if (m_reidExtractor && !result.detections.empty()) {
             std::vector<std::vector<float>> reidFeatures;
-            for (const auto& embedding : reidEmbeddings) {
-                reidFeatures.push_back(embedding.features);
-                result.reidEmbeddings.push_back(embedding.features);
+            const auto& extract = m_reidCache->plan(result.detections, classIds,
+                m_tracker ? m_tracker->getActiveTracks() : AISecurityVision::ReIDEmbeddingCache::TrackList(),
+                reidFeatures);
+
+            size_t extracted = 0;
+            if (!extract.empty()) {
+                // Crop indices travel as track IDs, so crops rejected as too small leave their slot empty
+                std::vector<cv::Rect> crops;
+                std::vector<int> cropIndices, cropClasses;
+                std::vector<float> cropConfidences;
+                for (size_t index : extract) {
+                    crops.push_back(result.detections[index]);
+                    cropIndices.push_back(static_cast<int>(cropIndices.size()));
+                    cropClasses.push_back(index < classIds.size() ? classIds[index] : -1);
+                    cropConfidences.push_back(index < confidences.size() ? confidences[index] : 1.0f);
+                }
+
+                auto extractStart = std::chrono::steady_clock::now();
+                auto reidEmbeddings = m_reidExtractor->extractFeatures(
+                    frame, crops, cropIndices, cropClasses, cropConfidences);
+                m_reidCache->recordExtraction(crops.size(), elapsedMs(extractStart));
+
+                for (auto& embedding : reidEmbeddings) {
+                    if (embedding.trackId >= 0 && embedding.trackId < static_cast<int>(extract.size())) {
+                        reidFeatures[extract[embedding.trackId]] = std::move(embedding.features);
+                        ++extracted;
+                    }
+                }
             }
+            result.reidEmbeddings = reidFeatures;
 
             // Object tracking with ReID features
             if (m_tracker) {
-                result.trackIds = m_tracker->updateWithReIDFeatures(
-                    result.detections, confidences, classIds, reidFeatures);
+                m_tracker->updateWithReIDFeatures(result.detections, confidences, classIds, reidFeatures);
+                result.trackIds = m_tracker->getDetectionTrackIds(result.detections);
+                reportTrackActivity();
+                m_reidCache->commit(result.detections, classIds, reidFeatures, m_tracker->getActiveTracks());
 
-                // Task 75: Report track updates to TaskManager for cross-camera tracking
-                TaskManager& taskManager = TaskManager::getInstance();
-                result.globalTrackIds.resize(result.trackIds.size(), -1);
+                // Task 75: Report this frame's tracks to TaskManager for cross-camera tracking
+                result.globalTrackIds.assign(result.trackIds.size(), -1);
 
+                std::vector<TrackUpdate> trackUpdates;
+                std::vector<size_t> updateIndices;
                 for (size_t i = 0; i < result.trackIds.size() && i < reidFeatures.size(); ++i) {
                     if (result.trackIds[i] >= 0 && !reidFeatures[i].empty()) {
-                        // Report track update to TaskManager
-                        taskManager.reportTrackUpdate(
-                            m_source.id, result.trackIds[i], reidFeatures[i],
-                            result.detections[i], classIds[i], confidences[i]);
+                        trackUpdates.push_back({result.trackIds[i], std::move(reidFeatures[i]),
+                                                result.detections[i], classIds[i], confidences[i]});
+                        updateIndices.push_back(i);
+                    }
+                }
 
-                        // Get global track ID
-                        result.globalTrackIds[i] = taskManager.getGlobalTrackId(m_source.id, result.trackIds[i]);
+                if (!trackUpdates.empty()) {
+                    auto globalIds = TaskManager::getInstance().reportTrackUpdates(m_source.id, std::move(trackUpdates));
+                    for (size_t k = 0; k < updateIndices.size(); ++k) {
+                        result.globalTrackIds[updateIndices[k]] = globalIds[k];
                     }
                 }
 
-                LOG_INFO() << "[VideoPipeline] Processed " << result.detections.size()
-                          << " detections with " << reidEmbeddings.size()
-                          << " ReID embeddings (dim="
-                          << (reidEmbeddings.empty() ? 0 : reidEmbeddings[0].getDimension())
-                          << "), global tracks: " << result.globalTrackIds.size();
+                // Propagated frames reuse these without asking TaskManager
+                m_globalTrackIds.clear();
+                for (size_t i = 0; i < result.trackIds.size(); ++i) {
+                    m_globalTrackIds[result.trackIds[i]] = result.globalTrackIds[i];
+                }
+
+                LOG_DEBUG() << "[VideoPipeline] Processed " << result.detections.size()
+                           << " detections, " << extracted << " ReID embeddings extracted, "
+                           << (result.detections.size() - extract.size()) << " from cache"
+                           << ", global tracks: " << result.globalTrackIds.size();
             }
         } else {
             // Fallback to regular tracking without ReID
             if (m_tracker) {
-                result.trackIds = m_tracker->updateWithClasses(result.detections, confidences, classIds);
+                m_tracker->updateWithClasses(result.detections, confidences, classIds);
+                result.trackIds = m_tracker->getDetectionTrackIds(result.detections);
+                reportTrackActivity();
 
                 // Initialize global track IDs as empty for non-ReID tracking
                 result.globalTrackIds.resize(result.trackIds.size(), -1);
+                m_globalTrackIds.clear();
             }
         }
     }
@@ -428,8 +768,86 @@ void VideoPipeline::processFrame(const cv::Mat& frame, int64_t timestamp) {
         result.activeROIs = m_behaviorAnalyzer->getActiveROIs();
     }
 
+    recordStageTiming(STAGE_ANALYTICS, elapsedMs(stageStart));
+}
+
+void VideoPipeline::propagateTracks(StageFrame& item) {
+    // No detections on this frame: the tracks' propagated boxes stand in for
+    // them, so behavior analysis and overlays still run at full frame rate
+    if (!m_tracker) {
+        return;
+    }
+    FrameResult& result = item.result;
+
+    std::vector<cv::Rect> previousBoxes;
+    std::vector<int> previousIds;
+    if (m_flowRefiner) {
+        for (const auto& track : m_tracker->getActiveTracks()) {
+            previousBoxes.push_back(track->bbox);
+            previousIds.push_back(track->trackId);
+        }
+    }
+
+    m_tracker->predict();
+
+    // Replace the Kalman extrapolation with the observed motion where flow is reliable
+    if (m_flowRefiner && !previousBoxes.empty()) {
+        auto moved = m_flowRefiner->refine(previousBoxes);
+        for (size_t i = 0; i < moved.size(); ++i) {
+            if (!moved[i].empty()) {
+                m_tracker->correctTrack(previousIds[i], moved[i]);
+            }
+        }
+    }
+
+    const cv::Rect frameRect(0, 0, result.frame.cols, result.frame.rows);
+    for (const auto& track : m_tracker->getActiveTracks()) {
+        cv::Rect box = track->bbox & frameRect;
+        if (box.empty()) {
+            continue;
+        }
+        auto label = m_classLabels.find(track->classId);
+        result.detections.push_back(box);
+        result.labels.push_back(label != m_classLabels.end() ? label->second : std::string());
+        result.trackIds.push_back(track->trackId);
+        item.confidences.push_back(track->confidence);
+        item.classIds.push_back(track->classId);
+    }
+
+    // Keep the cross-camera identities assigned on the last detection frame
+    result.globalTrackIds.clear();
+    for (int trackId : result.trackIds) {
+        auto globalId = m_globalTrackIds.find(trackId);
+        result.globalTrackIds.push_back(globalId != m_globalTrackIds.end() ? globalId->second : -1);
+    }
+}
+
+void VideoPipeline::reportTrackActivity() {
+    // Fastest track in box sizes per frame, and tracks born from this frame's detections
+    float speed = 0.0f;
+    size_t born = 0;
+    for (const auto& track : m_tracker->getActiveTracks()) {
+        float size = static_cast<float>(std::max(track->bbox.width, track->bbox.height));
+        if (size > 0.0f) {
+            speed = std::max(speed, std::hypot(track->velocity.x, track->velocity.y) / size);
+        }
+        if (track->state == ByteTracker::TrackState::New) {
+            ++born;
+        }
+    }
+    m_detectionCadence.reportActivity(speed, born);
+}
+
+void VideoPipeline::runOutputStage(StageFrame& item) {
+    auto stageStart = std::chrono::steady_clock::now();
+    FrameResult& result = item.result;
+
     // Output processing
     if (m_recordingEnabled.load() && m_recorder) {
+        if (result.hasAlarm && !result.events.empty()) {
+            const BehaviorEvent& event = result.events.front();
+            m_recorder->triggerEventRecording(event.eventType, event.confidence, event.metadata);
+        }
         m_recorder->processFrame(result);
     }
 
@@ -451,6 +869,92 @@ void VideoPipeline::processFrame(const cv::Mat& frame, int64_t timestamp) {
     if (m_personStatsEnabled.load() && !result.detections.empty()) {
         processPersonStatistics(result);
     }
+
+    recordStageTiming(STAGE_OUTPUT, elapsedMs(stageStart));
+}
+
+void VideoPipeline::dispatchToStages(FrameBundle& bundle, int64_t timestamp) {
+    if (bundle.full.empty()) {
+        return;
+    }
+
+    // The decoder hands out pooled buffers per frame, so they can be moved
+    // into the queue instead of cloned
+    auto item = std::make_unique<StageFrame>();
+    item->result.frame = std::move(bundle.full);
+    item->result.streamFrame = std::move(bundle.stream);
+    item->result.timestamp = timestamp;
+    item->modelFrame = std::move(bundle.model);
+    item->letterbox = bundle.letterbox;
+    item->motionActivity = bundle.motionActivity;
+    item->enqueuedAt = std::chrono::steady_clock::now();
+    item->decodedAt = item->enqueuedAt;
+
+    if (!m_inferenceQueue->push(std::move(item))) {
+        m_droppedFrames.fetch_add(1);
+    }
+}
+
+void VideoPipeline::stageThread(PipelineStage stage, StageQueue* input, StageQueue* output) {
+    LOG_INFO() << "[VideoPipeline] Stage thread " << STAGE_NAMES[stage] << " started: " << m_source.id;
+
+    while (m_running.load()) {
+        std::unique_ptr<StageFrame> item;
+        if (!input->pop(item, std::chrono::milliseconds(STAGE_POP_TIMEOUT_MS))) {
+            continue;
+        }
+
+        recordQueueWait(stage, elapsedMs(item->enqueuedAt));
+
+        try {
+            switch (stage) {
+                case STAGE_INFERENCE: runInferenceStage(*item); break;
+                case STAGE_ANALYTICS: runAnalyticsStage(*item); break;
+                case STAGE_OUTPUT:    runOutputStage(*item);    break;
+                default: break;
+            }
+        } catch (const std::exception& e) {
+            handleError("Exception in " + std::string(STAGE_NAMES[stage]) + " stage: " + e.what());
+            m_droppedFrames.fetch_add(1);
+            continue;
+        }
+
+        if (output) {
+            item->enqueuedAt = std::chrono::steady_clock::now();
+            if (!output->push(std::move(item))) {
+                m_droppedFrames.fetch_add(1);
+            }
+        } else {
+            m_processedFrames.fetch_add(1);
+            m_decoder->reportPipelineLatency(elapsedMs(item->decodedAt));
+        }
+    }
+
+    LOG_INFO() << "[VideoPipeline] Stage thread " << STAGE_NAMES[stage] << " stopped: " << m_source.id;
+}
+
+void VideoPipeline::recordStageTiming(PipelineStage stage, double latencyMs) {
+    // Exponential moving average, same smoothing as updateHealthMetrics().
+    // Each stage is written by exactly one thread, so load/store is sufficient.
+    StageMetrics& metrics = m_stageMetrics[stage];
+    double avg = metrics.avgLatencyMs.load();
+    metrics.avgLatencyMs.store(avg == 0.0 ? latencyMs : STAGE_EMA_ALPHA * latencyMs + (1.0 - STAGE_EMA_ALPHA) * avg);
+    metrics.processed.fetch_add(1);
+}
+
+void VideoPipeline::recordQueueWait(PipelineStage stage, double waitMs) {
+    StageMetrics& metrics = m_stageMetrics[stage];
+    double avg = metrics.avgQueueWaitMs.load();
+    metrics.avgQueueWaitMs.store(avg == 0.0 ? waitMs : STAGE_EMA_ALPHA * waitMs + (1.0 - STAGE_EMA_ALPHA) * avg);
+}
+
+VideoPipeline::StageQueue* VideoPipeline::stageInputQueue(PipelineStage stage) const {
+    switch (stage) {
+        case STAGE_INFERENCE: return m_inferenceQueue.get();
+        case STAGE_ANALYTICS: return m_analyticsQueue.get();
+        case STAGE_OUTPUT:    return m_outputQueue.get();
+        default:              return nullptr;
+    }
 }
 
 void VideoPipeline::processPersonStatistics(FrameResult& result) {
@@ -466,40 +970,66 @@ void VideoPipeline::processPersonStatistics(FrameResult& result) {
             }
         }
 
-        // Convert YOLOv8 detections to Detection format for PersonFilter
-        std::vector<AISecurityVision::Detection> detections;
+        // Select the persons to analyse: tracked persons are served from the
+        // attribute cache until a better shot comes along, so most frames
+        // crop and analyse nobody
+        const bool caching = m_enableCaching.load();
+        const cv::Size frameSize = result.frame.size();
+        std::vector<cv::Rect> personBoxes;
+        std::vector<int> personTracks;
+        std::vector<AISecurityVision::PersonDetection> persons;
+        std::vector<size_t> analysedIndices;    // Person index of each analysed crop
+        std::vector<float> analysedQuality;
+
+        m_personAttributes.beginFrame();
         for (size_t i = 0; i < result.detections.size() && i < result.labels.size(); ++i) {
-            AISecurityVision::Detection detection;
-            detection.bbox = result.detections[i];
-            detection.confidence = 0.8f;  // Default confidence if not available
-            detection.className = result.labels[i];
-
-            // Map class name to class ID (person = 0 in COCO)
-            if (result.labels[i] == "person") {
-                detection.classId = 0;
-            } else {
-                detection.classId = -1;  // Non-person class
+            if (result.labels[i] != "person") {
+                continue;
             }
 
-            detections.push_back(detection);
+            const cv::Rect& box = result.detections[i];
+            int trackId = caching && i < result.trackIds.size() ? result.trackIds[i] : -1;
+            float quality = AISecurityVision::PersonAttributeCache::cropQuality(box, frameSize);
+            if (m_personAttributes.wantsAnalysis(trackId, quality)) {
+                AISecurityVision::PersonDetection person(box, 0.8f, trackId);
+                person.timestamp = result.timestamp;
+                person.crop = AISecurityVision::PersonFilter::extractPersonCrop(result.frame, box);
+                if (person.crop.empty()) {
+                    continue;
+                }
+                analysedIndices.push_back(personBoxes.size());
+                analysedQuality.push_back(quality);
+                persons.push_back(std::move(person));
+            }
+            personBoxes.push_back(box);
+            personTracks.push_back(trackId);
         }
 
-        // Filter person detections
-        auto persons = AISecurityVision::PersonFilter::filterPersons(
-            detections, result.frame, result.trackIds, result.timestamp
-        );
-
-        if (persons.empty()) {
+        if (personBoxes.empty()) {
             // No persons detected, reset statistics
             result.personStats = FrameResult::PersonStats();
             return;
         }
 
-        // Analyze age and gender
-        auto attributes = m_ageGenderAnalyzer->analyze(persons);
+        // Analyze age and gender of the selected crops in one call
+        std::vector<AISecurityVision::PersonAttributes> attributes(personBoxes.size());
+        if (!persons.empty()) {
+            auto analysed = m_ageGenderAnalyzer->analyze(persons);
+            for (size_t k = 0; k < persons.size(); ++k) {
+                AISecurityVision::PersonAttributes attr =
+                    k < analysed.size() ? analysed[k] : AISecurityVision::PersonAttributes();
+                m_personAttributes.update(persons[k].trackId, attr, analysedQuality[k]);
+                attributes[analysedIndices[k]] = attr;
+            }
+        }
+        for (size_t i = 0; i < personTracks.size(); ++i) {
+            if (personTracks[i] >= 0) {
+                m_personAttributes.lookup(personTracks[i], attributes[i]);
+            }
+        }
 
         // Update person statistics
-        result.personStats.total_persons = static_cast<int>(persons.size());
+        result.personStats.total_persons = static_cast<int>(personBoxes.size());
         result.personStats.male_count = 0;
         result.personStats.female_count = 0;
         result.personStats.child_count = 0;
@@ -513,9 +1043,8 @@ void VideoPipeline::processPersonStatistics(FrameResult& result) {
         result.personStats.person_ages.clear();
 
         // Process each person
-        for (size_t i = 0; i < persons.size(); ++i) {
-            const auto& person = persons[i];
-            result.personStats.person_boxes.push_back(person.bbox);
+        for (size_t i = 0; i < personBoxes.size(); ++i) {
+            result.personStats.person_boxes.push_back(personBoxes[i]);
 
             // Add attributes if available
             if (i < attributes.size() && attributes[i].isValid()) {
@@ -590,6 +1119,7 @@ void VideoPipeline::attemptReconnection() {
     if (m_decoder) {
         m_decoder->reconnect();
     }
+    m_motionGate.reset();
 }
 
 // Getters
@@ -617,6 +1147,50 @@ void VideoPipeline::setDetectionEnabled(bool enabled) {
 
 void VideoPipeline::setRecordingEnabled(bool enabled) {
     m_recordingEnabled.store(enabled);
+    updatePacketSink();
+}
+
+void VideoPipeline::setRecordingConfig(const RecordingConfig& config) {
+    Recorder* recorder = nullptr;
+    {
+        AISecurityVision::HierarchicalMutexLock lock(m_mutex, AISecurityVision::LockLevel::VIDEO_PIPELINE, "VideoPipeline::m_mutex");
+        m_recordingConfig = config;
+        recorder = m_recorder.get();
+    }
+
+    // Outside m_mutex: the recorder applies it between writer jobs, which may wait on the disk
+    if (recorder) {
+        recorder->setConfig(config);
+        updatePacketSink();
+    }
+    LOG_INFO() << "[VideoPipeline] Recording for " << m_source.id << ": "
+               << RecordingConfig::modeName(config.mode)
+               << (config.mode == RecordingConfig::Mode::PASSTHROUGH ? " (" + config.container + ")" : std::string())
+               << (config.continuous ? ", continuous " + std::to_string(config.segmentDuration) + "s segments"
+                                     : std::string());
+}
+
+RecordingConfig VideoPipeline::getRecordingConfig() const {
+    AISecurityVision::HierarchicalMutexLock lock(m_mutex, AISecurityVision::LockLevel::VIDEO_PIPELINE, "VideoPipeline::m_mutex");
+    return m_recordingConfig;
+}
+
+void VideoPipeline::updatePacketSink() {
+    if (!m_decoder || !m_recorder) {
+        return;
+    }
+
+    // Packets are only copied out of the decoder while passthrough recording is enabled.
+    // The mode is read lock-free: getConfig() would wait for the recorder's disk I/O
+    // while callers hold m_mutex.
+    if (m_recordingEnabled.load() && m_recorder->isPassthroughMode()) {
+        Recorder* recorder = m_recorder.get();
+        m_decoder->setPacketSink([recorder](const AISecurityVision::EncodedPacketPtr& packet) {
+            recorder->processPacket(packet);
+        });
+    } else {
+        m_decoder->setPacketSink(nullptr);
+    }
 }
 
 void VideoPipeline::setStreamingEnabled(bool enabled) {
@@ -647,12 +1221,164 @@ int VideoPipeline::getDetectionThreads() const {
     return m_detectionThreads.load();
 }
 
+void VideoPipeline::setPipelinedMode(bool enabled) {
+    m_pipelinedMode.store(enabled);
+    LOG_INFO() << "[VideoPipeline] Pipelined mode "
+              << (enabled ? "enabled" : "disabled")
+              << " for pipeline: " << m_source.id
+              << (m_running.load() ? " (takes effect on restart)" : "");
+}
+
+bool VideoPipeline::isPipelinedMode() const {
+    return m_pipelinedMode.load();
+}
+
+void VideoPipeline::setStageQueueDepth(size_t depth) {
+    if (depth > 0 && depth <= MAX_STAGE_QUEUE_DEPTH) {
+        m_stageQueueDepth.store(depth);
+        LOG_INFO() << "[VideoPipeline] Stage queue depth set to " << depth
+                  << " for pipeline: " << m_source.id;
+    }
+}
+
+size_t VideoPipeline::getStageQueueDepth() const {
+    return m_stageQueueDepth.load();
+}
+
+void VideoPipeline::setSharedInferenceEnabled(bool enabled) {
+    if (m_detector || m_inferenceScheduler) {
+        LOG_WARN() << "[VideoPipeline] Shared inference must be configured before initialize(): " << m_source.id;
+        return;
+    }
+    m_sharedInferenceEnabled.store(enabled);
+}
+
+bool VideoPipeline::isSharedInferenceEnabled() const {
+    return m_inferenceScheduler != nullptr;
+}
+
+void VideoPipeline::setDecodePolicy(const DecodePolicy& policy) {
+    AISecurityVision::HierarchicalMutexLock lock(m_mutex, AISecurityVision::LockLevel::VIDEO_PIPELINE, "VideoPipeline::m_mutex");
+    m_decodePolicy = policy;
+    if (m_decoder) {
+        m_decoder->setDecodePolicy(policy);
+    }
+}
+
+void VideoPipeline::updateFramePlanes() {
+    if (!m_decoder) {
+        return;
+    }
+
+    AISecurityVision::FramePlaneSpec spec;
+    spec.full = true;  // Recording, recognizers and tracking work at source resolution
+
+    if (m_inferenceScheduler) {
+        spec.model = m_inferenceScheduler->getInputSize();
+    }
+#ifdef ENABLE_RKNN_NPU
+    else if (m_optimizedDetectionEnabled.load() && m_optimizedDetector) {
+        spec.model = m_optimizedDetector->getInputSize();
+    }
+#endif
+    else if (m_detector) {
+        spec.model = m_detector->getInputSize();
+    }
+
+    if (m_streamer && m_streamingEnabled.load()) {
+        StreamConfig config = m_streamer->getConfig();
+        spec.stream = cv::Size(config.width, config.height);
+    }
+
+    m_decoder->setFramePlanes(spec);
+}
+
+DecodePolicy VideoPipeline::getDecodePolicy() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_decodePolicy;
+}
+
+void VideoPipeline::setMotionGatePolicy(const AISecurityVision::MotionGatePolicy& policy) {
+    AISecurityVision::HierarchicalMutexLock lock(m_mutex, AISecurityVision::LockLevel::VIDEO_PIPELINE, "VideoPipeline::m_mutex");
+    m_motionGate.setPolicy(policy);
+    if (m_decoder) {
+        // Motion vector export is a codec open flag: applies from the next reconnect
+        m_decoder->setMotionVectorExport(policy.enabled && policy.useMotionVectors);
+    }
+
+    LOG_INFO() << "[VideoPipeline] Motion gate " << (policy.enabled ? "enabled" : "disabled")
+               << " for " << m_source.id << " (static frames " << policy.staticFrames
+               << ", min detection interval " << policy.minDetectionIntervalMs << " ms"
+               << (policy.useMotionVectors ? ", codec motion vectors" : "") << ")";
+}
+
+AISecurityVision::MotionGatePolicy VideoPipeline::getMotionGatePolicy() const {
+    return m_motionGate.getPolicy();
+}
+
+void VideoPipeline::setDetectionCadencePolicy(const AISecurityVision::DetectionCadencePolicy& policy) {
+    AISecurityVision::DetectionCadencePolicy effective = policy;
+    if (effective.frameBudgetMs <= 0.0 && m_source.fps > 0) {
+        effective.frameBudgetMs = 1000.0 / m_source.fps;
+    }
+    m_detectionCadence.setPolicy(effective);
+
+    LOG_INFO() << "[VideoPipeline] Detection every " << effective.interval << " frame(s)"
+               << (effective.adaptive ? " at most (adaptive)" : "") << " for " << m_source.id
+               << (effective.opticalFlow ? ", optical-flow propagation" : "");
+}
+
+AISecurityVision::DetectionCadencePolicy VideoPipeline::getDetectionCadencePolicy() const {
+    return m_detectionCadence.getPolicy();
+}
+
+void VideoPipeline::setRegionInferencePolicy(const AISecurityVision::RegionInferencePolicy& policy) {
+    AISecurityVision::RegionInferencePolicy sanitized = policy;
+    sanitized.roiMargin = std::max(0, sanitized.roiMargin);
+    sanitized.tileSize = std::max(0, sanitized.tileSize);
+    sanitized.tileOverlap = std::min(AISecurityVision::RegionInference::MAX_TILE_OVERLAP,
+                                     std::max(0.0f, sanitized.tileOverlap));
+    sanitized.mergeThreshold = std::min(1.0f, std::max(0.05f, sanitized.mergeThreshold));
+    std::atomic_store(&m_regionPolicy, std::shared_ptr<const AISecurityVision::RegionInferencePolicy>(
+        std::make_shared<AISecurityVision::RegionInferencePolicy>(sanitized)));
+
+    LOG_INFO() << "[VideoPipeline] Region inference mode " << AISecurityVision::RegionInferencePolicy::modeName(sanitized.mode)
+               << " for " << m_source.id;
+}
+
+AISecurityVision::RegionInferencePolicy VideoPipeline::getRegionInferencePolicy() const {
+    auto policy = std::atomic_load(&m_regionPolicy);
+    return policy ? *policy : AISecurityVision::RegionInferencePolicy();
+}
+
+void VideoPipeline::setReIDCachePolicy(const AISecurityVision::ReIDCachePolicy& policy) {
+    m_reidCache->setPolicy(policy);
+
+    LOG_INFO() << "[VideoPipeline] ReID embedding cache "
+               << (policy.refreshFrames > 0 ? "refreshes every " + std::to_string(policy.refreshFrames) + " detection frames"
+                                            : std::string("disabled"))
+               << " for " << m_source.id;
+}
+
+AISecurityVision::ReIDCachePolicy VideoPipeline::getReIDCachePolicy() const {
+    return m_reidCache->getPolicy();
+}
+
 // Internal version without mutex lock (for use during initialization)
 bool VideoPipeline::updateDetectionCategoriesInternal(const std::vector<std::string>& enabledCategories) {
     LOG_INFO() << "[VideoPipeline] updateDetectionCategoriesInternal called with " << enabledCategories.size() << " categories";
 
     bool success = true;
 
+    // Shared inference filters per pipeline, after the scheduler returns
+    if (m_inferenceScheduler) {
+        std::atomic_store(&m_sharedEnabledClasses,
+                          std::make_shared<const AISecurityVision::YOLOv8Detector::ClassMask>(
+                              AISecurityVision::YOLOv8Detector::compileClassMask(
+                                  m_inferenceScheduler->getAvailableCategories(), enabledCategories)));
+        LOG_INFO() << "[VideoPipeline] Updated shared inference categories for " << m_source.id;
+    }
+
     // Update standard detector if available
     if (m_detector) {
         LOG_INFO() << "[VideoPipeline] Updating standard detector categories...";
@@ -672,12 +1398,12 @@ bool VideoPipeline::updateDetectionCategoriesInternal(const std::vector<std::str
         LOG_INFO() << "[VideoPipeline] Optimized detector not available";
     }
 
-    if (!m_detector && !m_optimizedDetector) {
+    if (!m_detector && !m_optimizedDetector && !m_inferenceScheduler) {
         LOG_WARN() << "[VideoPipeline] No detectors available to update for " << m_source.id;
         success = false;
     }
 #else
-    if (!m_detector) {
+    if (!m_detector && !m_inferenceScheduler) {
         LOG_WARN() << "[VideoPipeline] No detectors available to update for " << m_source.id;
         success = false;
     }
@@ -694,6 +1420,15 @@ bool VideoPipeline::updateDetectionCategories(const std::vector<std::string>& en
 
     bool success = true;
 
+    // Shared inference filters per pipeline, after the scheduler returns
+    if (m_inferenceScheduler) {
+        std::atomic_store(&m_sharedEnabledClasses,
+                          std::make_shared<const AISecurityVision::YOLOv8Detector::ClassMask>(
+                              AISecurityVision::YOLOv8Detector::compileClassMask(
+                                  m_inferenceScheduler->getAvailableCategories(), enabledCategories)));
+        LOG_INFO() << "[VideoPipeline] Updated shared inference categories for " << m_source.id;
+    }
+
     // Update standard detector if available
     if (m_detector) {
         LOG_INFO() << "[VideoPipeline] Updating standard detector categories...";
@@ -713,12 +1448,12 @@ bool VideoPipeline::updateDetectionCategories(const std::vector<std::string>& en
         LOG_INFO() << "[VideoPipeline] Optimized detector not available";
     }
 
-    if (!m_detector && !m_optimizedDetector) {
+    if (!m_detector && !m_optimizedDetector && !m_inferenceScheduler) {
         LOG_WARN() << "[VideoPipeline] No detectors available to update for " << m_source.id;
         success = false;
     }
 #else
-    if (!m_detector) {
+    if (!m_detector && !m_inferenceScheduler) {
         LOG_WARN() << "[VideoPipeline] No detectors available to update for " << m_source.id;
         success = false;
     }
@@ -879,6 +1614,14 @@ std::string VideoSource::toString() const {
     return oss.str();
 }
 
+const char* DecodePolicy::frameSkipName(FrameSkip mode) {
+    switch (mode) {
+        case FrameSkip::EVERY_NTH:      return "every_nth";
+        case FrameSkip::KEYFRAMES_ONLY: return "keyframes_only";
+        default:                        return "none";
+    }
+}
+
 // Streaming configuration methods
 bool VideoPipeline::configureStreaming(const StreamConfig& config) {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -891,6 +1634,7 @@ bool VideoPipeline::configureStreaming(const StreamConfig& config) {
     try {
         // Update streamer configuration
         m_streamer->setConfig(config);
+        updateFramePlanes();
 
         // Restart streaming if it was running
         if (m_streamingEnabled.load()) {
@@ -957,6 +1701,7 @@ bool VideoPipeline::startStreaming() {
 
         if (success) {
             m_streamingEnabled.store(true);
+            updateFramePlanes();
             LOG_INFO() << "[VideoPipeline] Streaming started for " << m_source.id
                       << " at " << m_streamer->getStreamUrl();
         }
@@ -986,6 +1731,7 @@ bool VideoPipeline::stopStreaming() {
         m_streamer->stopServer();
         m_streamer->stopRtmpStream();
         m_streamingEnabled.store(false);
+        updateFramePlanes();
 
         LOG_INFO() << "[VideoPipeline] Streaming stopped for " << m_source.id;
         return true;
@@ -1200,6 +1946,13 @@ void VideoPipeline::setEnabledCategories(const std::vector<std::string>& enabled
 void VideoPipeline::setDetectionThresholds(float confidenceThreshold, float nmsThreshold) {
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    // The shared detector serves every pipeline, so this applies system-wide
+    if (m_inferenceScheduler) {
+        m_inferenceScheduler->setDetectionThresholds(confidenceThreshold, nmsThreshold);
+        LOG_INFO() << "[VideoPipeline] Updated shared detector thresholds from " << m_source.id
+                   << " (confidence=" << confidenceThreshold << ", nms=" << nmsThreshold << ")";
+    }
+
     // Update standard detector if available
     if (m_detector) {
         m_detector->setConfidenceThreshold(confidenceThreshold);
@@ -1217,11 +1970,11 @@ void VideoPipeline::setDetectionThresholds(float confidenceThreshold, float nmsT
                    << " (confidence=" << confidenceThreshold << ", nms=" << nmsThreshold << ")";
     }
 
-    if (!m_detector && !m_optimizedDetector) {
+    if (!m_detector && !m_optimizedDetector && !m_inferenceScheduler) {
         LOG_WARN() << "[VideoPipeline] No detectors available to update thresholds for " << m_source.id;
     }
 #else
-    if (!m_detector) {
+    if (!m_detector && !m_inferenceScheduler) {
         LOG_WARN() << "[VideoPipeline] No detectors available to update thresholds for " << m_source.id;
     }
 #endif
@@ -1233,6 +1986,16 @@ VideoPipeline::DetectionStats VideoPipeline::getDetectionStats() const {
 
     DetectionStats stats;
 
+    if (m_inferenceScheduler) {
+        auto schedulerStats = m_inferenceScheduler->getStats();
+        stats.total_detections = static_cast<int>(m_sharedDetectionCount.load());
+        stats.avg_processing_time = static_cast<float>(schedulerStats.avgBatchLatencyMs);
+
+        for (const auto& category : m_inferenceScheduler->getAvailableCategories()) {
+            stats.detections_by_class[category] = 0;
+        }
+    }
+
     // Get statistics from active detector
 #ifdef ENABLE_RKNN_NPU
     if (m_optimizedDetector && m_optimizedDetectionEnabled.load()) {
@@ -1259,5 +2022,42 @@ VideoPipeline::DetectionStats VideoPipeline::getDetectionStats() const {
         }
     }
 
+    // Per-stage statistics (stage latencies are tracked in serial mode too)
+    stats.pipelined = m_pipelinedActive.load();
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        PipelineStage stage = static_cast<PipelineStage>(i);
+        const StageMetrics& metrics = m_stageMetrics[i];
+
+        DetectionStats::StageStats stageStats;
+        stageStats.name = STAGE_NAMES[i];
+        stageStats.processed_frames = metrics.processed.load();
+        stageStats.avg_latency_ms = static_cast<float>(metrics.avgLatencyMs.load());
+        stageStats.avg_queue_wait_ms = static_cast<float>(metrics.avgQueueWaitMs.load());
+
+        if (stats.pipelined) {
+            if (StageQueue* queue = stageInputQueue(stage)) {
+                stageStats.queue_depth = queue->size();
+                stageStats.queue_capacity = queue->capacity();
+                stageStats.dropped_frames = queue->droppedCount();
+            }
+        }
+
+        stats.stages.push_back(stageStats);
+    }
+
+    if (m_decoder) {
+        stats.decoder = m_decoder->getDecodeStats();
+    }
+    stats.motionGate = m_motionGate.getStats();
+    stats.cadence = m_detectionCadence.getStats();
+    stats.regions.mode = AISecurityVision::RegionInferencePolicy::modeName(getRegionInferencePolicy().mode);
+    stats.regions.regionFrames = m_regionFrames.load();
+    stats.regions.lastRegionCount = m_lastRegionCount.load();
+    stats.reidCache = m_reidCache->getStats();
+    stats.personAttributes = m_personAttributes.getStats();
+    if (m_recorder) {
+        stats.recording = m_recorder->getStats();
+    }
+
     return stats;
 }
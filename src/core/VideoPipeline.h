@@ -6,8 +6,19 @@
 #include <mutex>
 #include <queue>
 #include <condition_variable>
+#include <array>
+#include <bitset>
+#include <unordered_map>
 #include <opencv2/opencv.hpp>
 #include "LockHierarchy.h"
+#include "BoundedQueue.h"
+#include "FrameBundle.h"
+#include "MotionGate.h"
+#include "DetectionCadence.h"
+#include "../ai/RegionInferencePolicy.h"
+#include "../ai/ReIDCachePolicy.h"
+#include "../ai/PersonAttributeCache.h"
+#include "../output/RecordingConfig.h"
 
 // Forward declarations
 class FFmpegDecoder;
@@ -15,10 +26,15 @@ class FFmpegDecoder;
 // AI Security Vision namespace forward declarations
 namespace AISecurityVision {
     class YOLOv8Detector;
+    class InferenceScheduler;
+    struct Detection;
 #ifdef ENABLE_RKNN_NPU
     class YOLOv8RKNNDetector;
 #endif
     class AgeGenderAnalyzer;  // Person statistics extension
+    class TrackFlowRefiner;
+    class RegionInference;
+    class ReIDEmbeddingCache;
 }
 
 class ByteTracker;
@@ -60,14 +76,61 @@ struct VideoSource {
     std::string toString() const;
 };
 
+/**
+ * @brief Software decode threading and frame selection for FFmpegDecoder
+ *
+ * Frames that will not be analyzed are dropped as early as possible:
+ * KEYFRAMES_ONLY drops inter-coded packets before they reach the codec,
+ * EVERY_NTH decodes every frame (later frames reference it) but only converts
+ * one in N to BGR. With adaptive enabled, the decoder escalates skipping
+ * (interval x2 up to MAX_ADAPTIVE_INTERVAL, then keyframes only) while the
+ * reported pipeline latency stays above targetLatencyMs, and backs off once
+ * it falls below half of it. The configured mode is the floor.
+ */
+struct DecodePolicy {
+    enum class FrameSkip { NONE, EVERY_NTH, KEYFRAMES_ONLY };
+
+    int threadCount = 0;            // Codec threads, 0 = auto (per core with frame threading, else bounded)
+    bool frameThreading = false;    // Frame + slice threading (throughput, one frame of delay per thread);
+                                    // false = slice only (no added delay, for live streams)
+    FrameSkip frameSkip = FrameSkip::NONE;
+    int frameInterval = 1;          // EVERY_NTH: analyze one frame in N
+    bool adaptive = false;
+    double targetLatencyMs = 200.0; // Decode-to-output latency the adaptive policy aims for
+
+    static constexpr int MAX_ADAPTIVE_INTERVAL = 8;
+    static constexpr int MAX_AUTO_SLICE_THREADS = 4;    // Auto thread count without frame threading
+
+    static const char* frameSkipName(FrameSkip mode);
+};
+
+/**
+ * @brief Decoder counters and the frame selection currently in effect
+ */
+struct DecodeStats {
+    uint64_t decodedFrames = 0;     // Frames produced by the codec
+    uint64_t convertedFrames = 0;   // Frames converted to BGR and returned
+    uint64_t skippedFrames = 0;     // Decoded but not converted (EVERY_NTH)
+    uint64_t droppedPackets = 0;    // Discarded before decoding (KEYFRAMES_ONLY / resync)
+    double decodeTimeMs = 0.0;      // Last returned frame: read + decode + convert
+    double avgLatencyMs = 0.0;      // Smoothed pipeline latency reported by the consumer
+    int threadCount = 0;            // Threads the codec actually uses
+    bool frameThreading = false;
+    DecodePolicy::FrameSkip activeSkip = DecodePolicy::FrameSkip::NONE;
+    int activeInterval = 1;
+    int adaptiveLevel = 0;          // Escalation steps above the configured mode
+};
+
 /**
  * @brief Main video processing pipeline for a single video stream
  *
  * This class implements the complete processing chain:
  * Input -> Decode -> Detect -> Track -> Recognize -> Analyze -> Output
  *
- * Each pipeline runs in its own thread and processes frames sequentially
- * through the AI modules with proper error handling and resource management.
+ * By default each pipeline runs in its own thread and processes frames
+ * sequentially through the AI modules. In pipelined mode, decode, inference,
+ * tracking/analytics and output run as separate stage threads connected by
+ * bounded queues (drop-oldest), so the slowest stage no longer stalls decode.
  */
 class VideoPipeline {
 public:
@@ -86,12 +149,46 @@ public:
     void setRecordingEnabled(bool enabled);
     void setStreamingEnabled(bool enabled);
 
+    // Recording mode (passthrough / burned-in), container and continuous segments
+    void setRecordingConfig(const RecordingConfig& config);
+    RecordingConfig getRecordingConfig() const;
+
     // AI Detection configuration
     void setOptimizedDetectionEnabled(bool enabled);
     bool isOptimizedDetectionEnabled() const;
     void setDetectionThreads(int threads);
     int getDetectionThreads() const;
 
+    // Pipelined processing mode (takes effect on next start())
+    void setPipelinedMode(bool enabled);
+    bool isPipelinedMode() const;
+    void setStageQueueDepth(size_t depth);
+    size_t getStageQueueDepth() const;
+
+    // Shared cross-camera batched inference (must be set before initialize())
+    void setSharedInferenceEnabled(bool enabled);
+    bool isSharedInferenceEnabled() const;
+
+    // Decoder threading and frame skipping (threading takes effect on initialize()/reconnect)
+    void setDecodePolicy(const DecodePolicy& policy);
+    DecodePolicy getDecodePolicy() const;
+
+    // Motion-gated detection: skip detection and ReID on static scenes
+    void setMotionGatePolicy(const AISecurityVision::MotionGatePolicy& policy);
+    AISecurityVision::MotionGatePolicy getMotionGatePolicy() const;
+
+    // Detect-every-N-frames: tracks are propagated on the frames in between
+    void setDetectionCadencePolicy(const AISecurityVision::DetectionCadencePolicy& policy);
+    AISecurityVision::DetectionCadencePolicy getDetectionCadencePolicy() const;
+
+    // ROI-restricted or tiled inference for high-resolution cameras
+    void setRegionInferencePolicy(const AISecurityVision::RegionInferencePolicy& policy);
+    AISecurityVision::RegionInferencePolicy getRegionInferencePolicy() const;
+
+    // Per-track ReID embedding reuse between extractions
+    void setReIDCachePolicy(const AISecurityVision::ReIDCachePolicy& policy);
+    AISecurityVision::ReIDCachePolicy getReIDCachePolicy() const;
+
     // Detection category filtering
     bool updateDetectionCategories(const std::vector<std::string>& enabledCategories);
     bool updateDetectionCategoriesInternal(const std::vector<std::string>& enabledCategories);
@@ -148,6 +245,27 @@ public:
         int total_detections = 0;
         float avg_processing_time = 0.0f;
         std::map<std::string, int> detections_by_class;
+
+        // Per-stage queue depth and latency
+        struct StageStats {
+            std::string name;
+            size_t queue_depth = 0;        // Frames waiting in the stage's input queue
+            size_t queue_capacity = 0;
+            uint64_t dropped_frames = 0;   // Frames discarded by the drop-oldest policy
+            uint64_t processed_frames = 0;
+            float avg_queue_wait_ms = 0.0f;
+            float avg_latency_ms = 0.0f;   // Time spent inside the stage
+        };
+        bool pipelined = false;
+        std::vector<StageStats> stages;
+
+        DecodeStats decoder;
+        AISecurityVision::MotionGateStats motionGate;
+        AISecurityVision::DetectionCadenceStats cadence;
+        AISecurityVision::RegionInferenceStats regions;
+        AISecurityVision::ReIDCacheStats reidCache;
+        AISecurityVision::PersonAttributeStats personAttributes;
+        RecorderStats recording;
     };
 
     // Detection statistics
@@ -170,7 +288,34 @@ public:
 private:
     // Processing thread
     void processingThread();
-    void processFrame(const cv::Mat& frame, int64_t timestamp);
+    void processFrame(AISecurityVision::FrameBundle& bundle, int64_t timestamp);
+    bool initializeDetector();
+    void filterSharedDetections(std::vector<AISecurityVision::Detection>& detections);
+
+    // Pipeline stages (shared by serial and pipelined modes)
+    struct StageFrame;
+    using StageQueue = AISecurityVision::BoundedQueue<std::unique_ptr<StageFrame>>;
+    enum PipelineStage : size_t {
+        STAGE_DECODE = 0,
+        STAGE_INFERENCE,
+        STAGE_ANALYTICS,
+        STAGE_OUTPUT,
+        STAGE_COUNT
+    };
+
+    void runInferenceStage(StageFrame& item);
+    void runAnalyticsStage(StageFrame& item);
+    void runOutputStage(StageFrame& item);
+    void propagateTracks(StageFrame& item);
+    void reportTrackActivity();
+    bool detectRegions(StageFrame& item, std::vector<AISecurityVision::Detection>& detections);
+    void stageThread(PipelineStage stage, StageQueue* input, StageQueue* output);
+    void dispatchToStages(AISecurityVision::FrameBundle& bundle, int64_t timestamp);
+    void updateFramePlanes();  // Caller holds m_mutex
+    void updatePacketSink();   // Feed the recorder the decoder's packets while recording is enabled
+    void recordStageTiming(PipelineStage stage, double latencyMs);
+    void recordQueueWait(PipelineStage stage, double waitMs);
+    StageQueue* stageInputQueue(PipelineStage stage) const;
 
     // Person statistics processing (optional extension)
     void processPersonStatistics(FrameResult& result);
@@ -189,14 +334,49 @@ private:
     std::thread m_processingThread;
     mutable std::mutex m_mutex;
 
+    // Pipelined mode: stage threads and the queues feeding them
+    std::atomic<bool> m_pipelinedMode{false};
+    std::atomic<bool> m_pipelinedActive{false};
+    std::atomic<size_t> m_stageQueueDepth{DEFAULT_STAGE_QUEUE_DEPTH};
+    const std::unique_ptr<StageQueue> m_inferenceQueue;     // Allocated once, reopened by start()
+    const std::unique_ptr<StageQueue> m_analyticsQueue;
+    const std::unique_ptr<StageQueue> m_outputQueue;
+    std::thread m_inferenceThread;
+    std::thread m_analyticsThread;
+    std::thread m_outputThread;
+
+    struct StageMetrics {
+        std::atomic<double> avgLatencyMs{0.0};
+        std::atomic<double> avgQueueWaitMs{0.0};
+        std::atomic<uint64_t> processed{0};
+    };
+    std::array<StageMetrics, STAGE_COUNT> m_stageMetrics;
+
     // Processing modules
     std::unique_ptr<FFmpegDecoder> m_decoder;
+    DecodePolicy m_decodePolicy;  // Guarded by m_mutex
+    RecordingConfig m_recordingConfig;  // Guarded by m_mutex, applied to the recorder
+    AISecurityVision::MotionGate m_motionGate;
+    AISecurityVision::DetectionCadence m_detectionCadence;
+    std::shared_ptr<const AISecurityVision::RegionInferencePolicy> m_regionPolicy;  // null = full frame
+    std::unique_ptr<AISecurityVision::RegionInference> m_regionInference;  // Inference stage only
+    std::atomic<uint64_t> m_regionFrames{0};
+    std::atomic<size_t> m_lastRegionCount{0};
     std::unique_ptr<AISecurityVision::YOLOv8Detector> m_detector;
 #ifdef ENABLE_RKNN_NPU
     std::unique_ptr<AISecurityVision::YOLOv8RKNNDetector> m_optimizedDetector;
 #endif
+    // Shared detector service owned by TaskManager (replaces m_detector when set)
+    AISecurityVision::InferenceScheduler* m_inferenceScheduler = nullptr;
+    std::atomic<bool> m_sharedInferenceEnabled{false};
+    std::shared_ptr<const std::bitset<1024>> m_sharedEnabledClasses;  // YOLOv8Detector::ClassMask, null = all enabled
+    std::atomic<size_t> m_sharedDetectionCount{0};
     std::unique_ptr<ByteTracker> m_tracker;
+    std::unordered_map<int, std::string> m_classLabels;  // Labels of coasted tracks, analytics stage only
+    std::unordered_map<int, int> m_globalTrackIds;       // Local -> global ID of the last detection frame, analytics stage only
+    std::unique_ptr<AISecurityVision::TrackFlowRefiner> m_flowRefiner;  // Analytics stage only
     std::unique_ptr<ReIDExtractor> m_reidExtractor;
+    std::unique_ptr<AISecurityVision::ReIDEmbeddingCache> m_reidCache;  // Analytics stage only
     std::unique_ptr<FaceRecognizer> m_faceRecognizer;
     std::unique_ptr<LicensePlateRecognizer> m_plateRecognizer;
     std::unique_ptr<BehaviorAnalyzer> m_behaviorAnalyzer;
@@ -208,6 +388,7 @@ private:
 
     // Person statistics modules (optional extension)
     std::unique_ptr<AISecurityVision::AgeGenderAnalyzer> m_ageGenderAnalyzer;
+    AISecurityVision::PersonAttributeCache m_personAttributes;  // Output stage only
     // Note: PersonFilter is a static utility class, no member needed
 
     // Configuration flags
@@ -222,7 +403,7 @@ private:
     std::atomic<float> m_genderThreshold{0.7f};
     std::atomic<float> m_ageThreshold{0.6f};
     std::atomic<int> m_batchSize{4};
-    std::atomic<bool> m_enableCaching{true};
+    std::atomic<bool> m_enableCaching{true};   // Per-track attribute cache
     mutable std::mutex m_personStatsMutex;
     PersonStats m_currentPersonStats;
 
@@ -250,6 +431,9 @@ private:
     static constexpr size_t MAX_CONSECUTIVE_ERRORS = 10;
     static constexpr double FRAME_TIMEOUT_S = 30.0;
     static constexpr double STABLE_FRAME_RATE_THRESHOLD = 0.5; // 50% of expected frame rate
+    static constexpr size_t DEFAULT_STAGE_QUEUE_DEPTH = 4;
+    static constexpr size_t MAX_STAGE_QUEUE_DEPTH = 64;
+    static constexpr int STAGE_POP_TIMEOUT_MS = 100;
 };
 
 /**
@@ -257,6 +441,7 @@ private:
  */
 struct FrameResult {
     cv::Mat frame;
+    cv::Mat streamFrame;  // Decoder-scaled copy at the stream resolution, if requested
     int64_t timestamp;
     std::vector<cv::Rect> detections;
     std::vector<int> trackIds;
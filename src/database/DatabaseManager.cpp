@@ -3,6 +3,9 @@
 #include <sstream>
 #include <cstring>
 #include <nlohmann/json.hpp>
+#include "../core/MotionGate.h"
+#include "../core/DetectionCadence.h"
+#include "../ai/RegionInferencePolicy.h"
 
 #include "../core/Logger.h"
 using namespace AISecurityVision;
@@ -728,6 +731,62 @@ bool DatabaseManager::deleteOldEvents(int daysOld) {
     return executeQuery(query);
 }
 
+std::vector<EventRecord> DatabaseManager::getEventsWithVideo() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<EventRecord> events;
+
+    const char* query = "SELECT id, camera_id, event_type, timestamp, video_path, confidence FROM events "
+                        "WHERE video_path IS NOT NULL AND video_path != ''";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(m_db, query, -1, &stmt, nullptr) != SQLITE_OK) {
+        m_lastError = "Failed to prepare select event videos query: " + std::string(sqlite3_errmsg(m_db));
+        return events;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        EventRecord event;
+        event.id = sqlite3_column_int(stmt, 0);
+        event.camera_id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        event.event_type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+
+        const char* timestamp = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        if (timestamp) event.timestamp = timestamp;
+
+        event.video_path = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+        event.confidence = sqlite3_column_double(stmt, 5);
+
+        events.push_back(event);
+    }
+
+    sqlite3_finalize(stmt);
+    return events;
+}
+
+bool DatabaseManager::clearEventVideoPath(const std::string& videoPath) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const char* query = "UPDATE events SET video_path = NULL WHERE video_path = ?";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(m_db, query, -1, &stmt, nullptr) != SQLITE_OK) {
+        m_lastError = "Failed to prepare clear event video query: " + std::string(sqlite3_errmsg(m_db));
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, videoPath.c_str(), -1, SQLITE_STATIC);
+
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE) {
+        m_lastError = "Failed to clear event video: " + std::string(sqlite3_errmsg(m_db));
+        return false;
+    }
+
+    return true;
+}
+
 bool DatabaseManager::insertFace(const FaceRecord& face) {
     std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -1538,6 +1597,92 @@ std::string DatabaseManager::getCameraConfig(const std::string& cameraId) {
     return "";
 }
 
+bool DatabaseManager::getMotionGatePolicy(const std::string& cameraId, AISecurityVision::MotionGatePolicy& policy) {
+    std::string configJson = getCameraConfig(cameraId);
+    if (configJson.empty()) {
+        return false;
+    }
+
+    try {
+        nlohmann::json config = nlohmann::json::parse(configJson);
+        if (!config.contains("motion_gate") || !config["motion_gate"].is_object()) {
+            return false;
+        }
+
+        const auto& gate = config["motion_gate"];
+        policy.enabled = gate.value("enabled", policy.enabled);
+        policy.analysisWidth = gate.value("analysis_width", policy.analysisWidth);
+        policy.pixelThreshold = gate.value("pixel_threshold", policy.pixelThreshold);
+        policy.motionThreshold = gate.value("motion_threshold", policy.motionThreshold);
+        policy.staticFrames = gate.value("static_frames", policy.staticFrames);
+        policy.minDetectionIntervalMs = gate.value("min_detection_interval_ms", policy.minDetectionIntervalMs);
+        policy.backgroundRate = gate.value("background_rate", policy.backgroundRate);
+        policy.useMotionVectors = gate.value("use_motion_vectors", policy.useMotionVectors);
+        policy.motionVectorThreshold = gate.value("motion_vector_threshold", policy.motionVectorThreshold);
+        return true;
+
+    } catch (const std::exception& e) {
+        LOG_ERROR() << "[DatabaseManager] Invalid motion gate configuration for " << cameraId << ": " << e.what();
+        return false;
+    }
+}
+
+bool DatabaseManager::getDetectionCadencePolicy(const std::string& cameraId, AISecurityVision::DetectionCadencePolicy& policy) {
+    std::string configJson = getCameraConfig(cameraId);
+    if (configJson.empty()) {
+        return false;
+    }
+
+    try {
+        nlohmann::json config = nlohmann::json::parse(configJson);
+        if (!config.contains("detection_cadence") || !config["detection_cadence"].is_object()) {
+            return false;
+        }
+
+        const auto& cadence = config["detection_cadence"];
+        policy.interval = cadence.value("interval", policy.interval);
+        policy.adaptive = cadence.value("adaptive", policy.adaptive);
+        policy.frameBudgetMs = cadence.value("frame_budget_ms", policy.frameBudgetMs);
+        policy.maxDrift = cadence.value("max_drift", policy.maxDrift);
+        policy.opticalFlow = cadence.value("optical_flow", policy.opticalFlow);
+        return true;
+
+    } catch (const std::exception& e) {
+        LOG_ERROR() << "[DatabaseManager] Invalid detection cadence configuration for " << cameraId << ": " << e.what();
+        return false;
+    }
+}
+
+bool DatabaseManager::getRegionInferencePolicy(const std::string& cameraId, AISecurityVision::RegionInferencePolicy& policy) {
+    std::string configJson = getCameraConfig(cameraId);
+    if (configJson.empty()) {
+        return false;
+    }
+
+    try {
+        nlohmann::json config = nlohmann::json::parse(configJson);
+        if (!config.contains("inference_regions") || !config["inference_regions"].is_object()) {
+            return false;
+        }
+
+        const auto& regions = config["inference_regions"];
+        std::string mode = regions.value("mode", std::string(AISecurityVision::RegionInferencePolicy::modeName(policy.mode)));
+        if (!AISecurityVision::RegionInferencePolicy::parseMode(mode, policy.mode)) {
+            LOG_WARN() << "[DatabaseManager] Unknown inference region mode for " << cameraId << ": " << mode;
+        }
+        policy.roiMargin = regions.value("roi_margin", policy.roiMargin);
+        policy.tileSize = regions.value("tile_size", policy.tileSize);
+        policy.tileOverlap = regions.value("tile_overlap", policy.tileOverlap);
+        policy.includeFullFrame = regions.value("include_full_frame", policy.includeFullFrame);
+        policy.mergeThreshold = regions.value("merge_threshold", policy.mergeThreshold);
+        return true;
+
+    } catch (const std::exception& e) {
+        LOG_ERROR() << "[DatabaseManager] Invalid inference region configuration for " << cameraId << ": " << e.what();
+        return false;
+    }
+}
+
 std::vector<std::string> DatabaseManager::getAllCameraIds() {
     std::lock_guard<std::mutex> lock(m_mutex);
     std::vector<std::string> cameraIds;
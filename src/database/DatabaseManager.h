@@ -8,6 +8,12 @@
 #include <chrono>
 #include <map>
 
+namespace AISecurityVision {
+    struct MotionGatePolicy;
+    struct DetectionCadencePolicy;
+    struct RegionInferencePolicy;
+}
+
 /**
  * @brief Event record structure for database storage
  */
@@ -192,6 +198,8 @@ public:
                                      int limit = 100);
     bool deleteEvent(int eventId);
     bool deleteOldEvents(int daysOld = 30);
+    std::vector<EventRecord> getEventsWithVideo();          // All events that still reference a clip
+    bool clearEventVideoPath(const std::string& videoPath); // The clip was deleted; the event stays
 
     // Face operations
     bool insertFace(const FaceRecord& face);
@@ -233,6 +241,24 @@ public:
     std::vector<std::string> getAllCameraIds();
     bool deleteCameraConfig(const std::string& cameraId);
 
+    /**
+     * @brief Overlay the "motion_gate" object of a camera's configuration onto a policy
+     * @return false if the camera has no motion gate configuration (policy left unchanged)
+     */
+    bool getMotionGatePolicy(const std::string& cameraId, AISecurityVision::MotionGatePolicy& policy);
+
+    /**
+     * @brief Overlay the "detection_cadence" object of a camera's configuration onto a policy
+     * @return false if the camera has no detection cadence configuration (policy left unchanged)
+     */
+    bool getDetectionCadencePolicy(const std::string& cameraId, AISecurityVision::DetectionCadencePolicy& policy);
+
+    /**
+     * @brief Overlay the "inference_regions" object of a camera's configuration onto a policy
+     * @return false if the camera has no region inference configuration (policy left unchanged)
+     */
+    bool getRegionInferencePolicy(const std::string& cameraId, AISecurityVision::RegionInferencePolicy& policy);
+
     // Detection category configuration operations
     bool saveDetectionCategories(const std::vector<std::string>& enabledCategories);
     std::vector<std::string> getDetectionCategories();
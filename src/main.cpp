@@ -4,7 +4,9 @@
 #include <chrono>
 #include <iomanip>
 #include <cstdlib>
+#include <cctype>
 #include <fstream>
+#include <unordered_set>
 #include <unistd.h>
 #include <sys/file.h>
 #include <sys/stat.h>
@@ -12,6 +14,7 @@
 #include <errno.h>
 #include "core/TaskManager.h"
 #include "core/VideoPipeline.h"
+#include "output/StorageManager.h"
 #include "api/APIService.h"
 #include "database/DatabaseManager.h"
 #include "nlohmann/json.hpp"
@@ -437,6 +440,43 @@ void printUsage(const char* programName) {
               << "  -p, --port       API server port (default: 8080)\n"
               << "  -c, --config     Configuration file path (fallback if database empty)\n"
               << "  -v, --verbose    Enable verbose logging\n"
+              << "  --shared-inference [batch]\n"
+              << "                   Batch inference across cameras with one shared detector\n"
+              << "  --pipelined         Run decode, inference, analytics and output on separate\n"
+              << "                   threads connected by bounded queues\n"
+              << "  --stage-queue-depth N  Frames buffered between pipelined stages (default: 4)\n"
+              << "  --decode-threads N  Software decoder threads per camera (default: auto)\n"
+              << "  --frame-threading   Decode several frames in parallel (more throughput for\n"
+              << "                   high-resolution streams, adds a frame of latency per thread)\n"
+              << "  --analyze-every N   Decode every frame but analyze only one in N\n"
+              << "  --keyframes-only    Decode and analyze keyframes only\n"
+              << "  --adaptive-skip [ms]\n"
+              << "                   Skip more frames while pipeline latency exceeds the target (default: 200)\n"
+              << "  --motion-gate [N]   Skip detection after N static frames (default: 10)\n"
+              << "  --motion-vectors    Gate on codec motion vectors where the stream provides them\n"
+              << "  --detect-every N    Detect on one frame in N, propagate tracks in between\n"
+              << "  --adaptive-detect [N]\n"
+              << "                   Adapt the detection interval, up to N (default: 5), to scene activity\n"
+              << "                   and inference latency\n"
+              << "  --track-flow        Refine propagated tracks with sparse optical flow\n"
+              << "  --roi-inference     Detect only inside the bounding box of the active ROIs\n"
+              << "  --tiled-inference [N]\n"
+              << "                   Detect on overlapping N-pixel tiles of large frames\n"
+              << "                   (default: twice the model input)\n"
+              << "  --reid-refresh K    Re-extract a track's ReID embedding at least every K\n"
+              << "                   detection frames, reuse it in between (default: 10, 0 = always)\n"
+              << "  --record-mode M     passthrough (remux camera packets, default) or burned-in\n"
+              << "                   (re-encode frames with overlays)\n"
+              << "  --record-container C  Passthrough container: mp4 (default) or mkv\n"
+              << "  --continuous-recording [S]\n"
+              << "                   Record recording-enabled cameras continuously in S-second\n"
+              << "                   segments (default: 300, passthrough only)\n"
+              << "  --storage-quota-gb G  Keep all recordings under G GB, evicting the oldest\n"
+              << "                   unpinned files (default: unlimited)\n"
+              << "  --camera-quota-gb G   Keep each camera's recordings under G GB\n"
+              << "  --alarm-retention-days D\n"
+              << "                   Protect alarm recordings from eviction for D days\n"
+              << "                   (default: 30, 0 = forever)\n"
               << "\nNote: All operational settings (cameras, detection, optimization)\n"
               << "      are now loaded from the database configuration.\n";
 }
@@ -460,6 +500,17 @@ int main(int argc, char* argv[]) {
     int apiPort = 8080;
     std::string configFile;
     bool cmdLineVerbose = false; // Command-line verbose flag
+    bool sharedInference = false;
+    int sharedInferenceBatch = 0;
+    bool pipelinedMode = false;
+    size_t stageQueueDepth = 0;
+    DecodePolicy decodePolicy;
+    AISecurityVision::MotionGatePolicy motionGatePolicy;
+    AISecurityVision::DetectionCadencePolicy cadencePolicy;
+    AISecurityVision::RegionInferencePolicy regionPolicy;
+    AISecurityVision::ReIDCachePolicy reidCachePolicy;
+    RecordingConfig recordingConfig;
+    StorageQuota storageQuota;
 
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -483,6 +534,111 @@ int main(int argc, char* argv[]) {
             }
         } else if (arg == "-v" || arg == "--verbose") {
             cmdLineVerbose = true;
+        } else if (arg == "--shared-inference") {
+            sharedInference = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                sharedInferenceBatch = std::atoi(argv[++i]);
+            }
+        } else if (arg == "--pipelined") {
+            pipelinedMode = true;
+        } else if (arg == "--stage-queue-depth") {
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+                stageQueueDepth = static_cast<size_t>(std::atoi(argv[++i]));
+            } else {
+                LOG_ERROR() << "Error: " << arg << " requires a positive number";
+                return 1;
+            }
+        } else if (arg == "--decode-threads" || arg == "--analyze-every") {
+            if (i + 1 < argc) {
+                int value = std::atoi(argv[++i]);
+                if (arg == "--decode-threads") {
+                    decodePolicy.threadCount = value;
+                } else {
+                    decodePolicy.frameSkip = DecodePolicy::FrameSkip::EVERY_NTH;
+                    decodePolicy.frameInterval = value;
+                }
+            } else {
+                LOG_ERROR() << "Error: " << arg << " requires a number";
+                return 1;
+            }
+        } else if (arg == "--frame-threading") {
+            decodePolicy.frameThreading = true;
+        } else if (arg == "--keyframes-only") {
+            decodePolicy.frameSkip = DecodePolicy::FrameSkip::KEYFRAMES_ONLY;
+        } else if (arg == "--adaptive-skip") {
+            decodePolicy.adaptive = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                decodePolicy.targetLatencyMs = std::atof(argv[++i]);
+            }
+        } else if (arg == "--motion-gate") {
+            motionGatePolicy.enabled = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                motionGatePolicy.staticFrames = std::atoi(argv[++i]);
+            }
+        } else if (arg == "--motion-vectors") {
+            motionGatePolicy.useMotionVectors = true;
+        } else if (arg == "--detect-every") {
+            if (i + 1 < argc) {
+                cadencePolicy.interval = std::atoi(argv[++i]);
+            } else {
+                LOG_ERROR() << "Error: " << arg << " requires a number";
+                return 1;
+            }
+        } else if (arg == "--adaptive-detect") {
+            cadencePolicy.adaptive = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                cadencePolicy.interval = std::atoi(argv[++i]);
+            } else if (cadencePolicy.interval == 1) {
+                cadencePolicy.interval = AISecurityVision::DetectionCadencePolicy::DEFAULT_ADAPTIVE_INTERVAL;
+            }
+        } else if (arg == "--track-flow") {
+            cadencePolicy.opticalFlow = true;
+        } else if (arg == "--roi-inference") {
+            regionPolicy.mode = AISecurityVision::RegionInferencePolicy::Mode::ROI_CROP;
+        } else if (arg == "--tiled-inference") {
+            regionPolicy.mode = AISecurityVision::RegionInferencePolicy::Mode::TILED;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                regionPolicy.tileSize = std::atoi(argv[++i]);
+            }
+        } else if (arg == "--reid-refresh") {
+            if (i + 1 < argc) {
+                reidCachePolicy.refreshFrames = std::atoi(argv[++i]);
+            } else {
+                LOG_ERROR() << "Error: " << arg << " requires a number";
+                return 1;
+            }
+        } else if (arg == "--record-mode") {
+            if (i + 1 >= argc || !RecordingConfig::parseMode(argv[++i], recordingConfig.mode)) {
+                LOG_ERROR() << "Error: " << arg << " requires passthrough or burned-in";
+                return 1;
+            }
+        } else if (arg == "--record-container") {
+            if (i + 1 < argc && (std::string(argv[i + 1]) == "mp4" || std::string(argv[i + 1]) == "mkv")) {
+                recordingConfig.container = argv[++i];
+            } else {
+                LOG_ERROR() << "Error: " << arg << " requires mp4 or mkv";
+                return 1;
+            }
+        } else if (arg == "--continuous-recording") {
+            recordingConfig.continuous = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                recordingConfig.segmentDuration = std::atoi(argv[++i]);
+            }
+        } else if (arg == "--storage-quota-gb" || arg == "--camera-quota-gb") {
+            if (i + 1 < argc && std::atof(argv[i + 1]) > 0.0) {
+                auto bytes = static_cast<uint64_t>(std::atof(argv[++i]) * 1024.0 * 1024.0 * 1024.0);
+                (arg == "--storage-quota-gb" ? storageQuota.totalBytes : storageQuota.cameraBytes) = bytes;
+            } else {
+                LOG_ERROR() << "Error: " << arg << " requires a size in GB";
+                return 1;
+            }
+        } else if (arg == "--alarm-retention-days") {
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                storageQuota.alarmRetentionDays = std::atoi(argv[++i]);
+            } else {
+                LOG_ERROR() << "Error: " << arg << " requires a number of days";
+                return 1;
+            }
         } else {
             LOG_ERROR() << "Error: Unknown argument: " << arg;
             printUsage(argv[0]);
@@ -508,6 +664,19 @@ int main(int argc, char* argv[]) {
         // Initialize TaskManager
         LOG_INFO() << "[Main] Initializing TaskManager...";
         TaskManager& taskManager = TaskManager::getInstance();
+        if (sharedInference) {
+            taskManager.setSharedInferenceEnabled(true);
+            if (sharedInferenceBatch > 0) {
+                taskManager.setSharedInferenceConfig(sharedInferenceBatch, TaskManager::DEFAULT_INFERENCE_MAX_WAIT_MS);
+            }
+        }
+        taskManager.setDefaultPipelinedMode(pipelinedMode, stageQueueDepth);
+        taskManager.setDefaultDecodePolicy(decodePolicy);
+        taskManager.setDefaultMotionGatePolicy(motionGatePolicy);
+        taskManager.setDefaultDetectionCadencePolicy(cadencePolicy);
+        taskManager.setDefaultRegionInferencePolicy(regionPolicy);
+        taskManager.setDefaultReIDCachePolicy(reidCachePolicy);
+        taskManager.setDefaultRecordingConfig(recordingConfig);
         taskManager.start();
 
         // Initialize API Service
@@ -528,6 +697,7 @@ int main(int argc, char* argv[]) {
 
         // Load cameras from database first, then config file as fallback
         std::vector<VideoSource> cameras;
+        std::unordered_set<std::string> recordingCameras;
 
         // Always try to load from database first
         LOG_INFO() << "[Main] Attempting to load cameras from database...";
@@ -555,6 +725,9 @@ int main(int argc, char* argv[]) {
                 camera.enabled = camConfig.enabled;
 
                 cameras.push_back(camera);
+                if (camConfig.recording_enabled) {
+                    recordingCameras.insert(camera.id);
+                }
 
                 LOG_INFO() << "[Main] Configured camera from database: " << camera.id
                           << " (MJPEG port will be dynamically allocated)";
@@ -586,6 +759,9 @@ int main(int argc, char* argv[]) {
                     camera.enabled = camConfig.enabled;
 
                     cameras.push_back(camera);
+                    if (camConfig.recording_enabled) {
+                        recordingCameras.insert(camera.id);
+                    }
 
                     LOG_INFO() << "[Main] Configured camera from file: " << camera.id
                               << " (MJPEG port will be dynamically allocated)";
@@ -595,12 +771,19 @@ int main(int argc, char* argv[]) {
             LOG_INFO() << "[Main] No cameras configured in database or config file";
         }
 
+        // Index the existing recordings once, then keep them within the quota
+        std::vector<std::string> cameraIds;
+        for (const auto& camera : cameras) {
+            cameraIds.push_back(camera.id);
+        }
+        StorageManager::getInstance().start(recordingConfig.outputDir, storageQuota, cameraIds);
+
         // Add cameras to TaskManager asynchronously to avoid blocking startup
         if (!cameras.empty()) {
             LOG_INFO() << "[Main] Starting asynchronous camera initialization for " << cameras.size() << " cameras...";
 
             // Start camera initialization in a separate thread
-            std::thread cameraInitThread([cameras, &taskManager, systemConfig]() {
+            std::thread cameraInitThread([cameras, recordingCameras, &taskManager, systemConfig]() {
                 for (const auto& camera : cameras) {
                     LOG_INFO() << "[Main] Adding camera: " << camera.id << " (" << camera.url << ")";
 
@@ -618,6 +801,13 @@ int main(int argc, char* argv[]) {
                             }
                         }
 
+                        if (recordingCameras.count(camera.id)) {
+                            if (auto pipeline = taskManager.getPipeline(camera.id)) {
+                                pipeline->setRecordingEnabled(true);
+                                LOG_INFO() << "[Main] Recording enabled for " << camera.id;
+                            }
+                        }
+
                         // Load person statistics configuration from database
                         loadPersonStatsConfig(camera.id, taskManager);
                     } else {
@@ -706,6 +896,7 @@ int main(int argc, char* argv[]) {
         // Stop task manager and all pipelines
         LOG_INFO() << "[Main] Stopping task manager...";
         taskManager.stop();
+        StorageManager::getInstance().stop();
 
         // Release single instance lock
         releaseSingleInstanceLock();
@@ -0,0 +1,61 @@
+#include "OverlaySidecar.h"
+
+#include "../core/Logger.h"
+#include <nlohmann/json.hpp>
+using namespace AISecurityVision;
+
+std::string OverlaySidecar::pathFor(const std::string& videoPath) {
+    size_t dot = videoPath.find_last_of('.');
+    size_t slash = videoPath.find_last_of('/');
+    std::string stem = (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+        ? videoPath.substr(0, dot) : videoPath;
+    return stem + ".overlays.jsonl";
+}
+
+bool OverlaySidecar::open(const std::string& videoPath, int64_t startWallMs) {
+    close();
+    std::string path = pathFor(videoPath);
+    m_file.open(path, std::ios::out | std::ios::trunc);
+    if (!m_file.is_open()) {
+        LOG_WARN() << "[OverlaySidecar] Failed to open " << path;
+        return false;
+    }
+    m_startWallMs = startWallMs;
+    return true;
+}
+
+void OverlaySidecar::write(int64_t wallTimeMs, const std::vector<cv::Rect>& detections,
+                           const std::vector<int>& trackIds, const std::vector<std::string>& labels) {
+    if (!m_file.is_open() || wallTimeMs < m_startWallMs) {
+        return;
+    }
+
+    nlohmann::json boxes = nlohmann::json::array();
+    for (size_t i = 0; i < detections.size(); ++i) {
+        const cv::Rect& box = detections[i];
+        boxes.push_back({
+            {"x", box.x}, {"y", box.y}, {"w", box.width}, {"h", box.height},
+            {"label", i < labels.size() ? labels[i] : std::string()},
+            {"track", i < trackIds.size() ? trackIds[i] : -1}
+        });
+    }
+
+    nlohmann::json line = {
+        {"t", wallTimeMs - m_startWallMs},
+        {"wall", wallTimeMs},
+        {"boxes", std::move(boxes)}
+    };
+    // Replace invalid UTF-8 in labels instead of throwing
+    m_file << line.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace) << '\n';
+}
+
+void OverlaySidecar::close() {
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_startWallMs = 0;
+}
+
+bool OverlaySidecar::isOpen() const {
+    return m_file.is_open();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+
+/**
+ * @brief Detections of a passthrough recording, stored next to the video
+ *
+ * One JSON object per analysed frame and line:
+ * {"t":<ms from the first video packet>,"wall":<epoch ms>,"boxes":[{"x":..,"y":..,"w":..,"h":..,"label":"..","track":..}]}
+ * so players and the API can draw the overlays the passthrough video does
+ * not have burned in.
+ */
+class OverlaySidecar {
+public:
+    /**
+     * @brief Sidecar path of a video: clip.mp4 -> clip.overlays.jsonl
+     */
+    static std::string pathFor(const std::string& videoPath);
+
+    bool open(const std::string& videoPath, int64_t startWallMs);
+    void write(int64_t wallTimeMs, const std::vector<cv::Rect>& detections,
+               const std::vector<int>& trackIds, const std::vector<std::string>& labels);
+    void close();
+    bool isOpen() const;
+
+private:
+    std::ofstream m_file;
+    int64_t m_startWallMs = 0;
+};
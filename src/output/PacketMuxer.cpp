@@ -0,0 +1,288 @@
+#include "PacketMuxer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAVE_FFMPEG
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+// The AVIO write callback takes const data since FFmpeg 7
+#if LIBAVFORMAT_VERSION_MAJOR >= 61
+#define AVIO_WRITE_DATA const uint8_t*
+#else
+#define AVIO_WRITE_DATA uint8_t*
+#endif
+#endif
+
+#include "../core/Logger.h"
+using namespace AISecurityVision;
+
+PacketMuxer::PacketMuxer() = default;
+
+PacketMuxer::~PacketMuxer() {
+    close();
+}
+
+bool PacketMuxer::open(const std::string& path, const std::shared_ptr<const EncodedStreamInfo>& stream,
+                       uint64_t preallocateBytes) {
+    close();
+    if (!stream) {
+        return false;
+    }
+
+#ifdef HAVE_FFMPEG
+    char errbuf[AV_ERROR_MAX_STRING_SIZE];
+    int ret = avformat_alloc_output_context2(&m_context, nullptr, nullptr, path.c_str());
+    if (ret < 0 || !m_context) {
+        av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
+        LOG_ERROR() << "[PacketMuxer] Failed to create output context for " << path << ": " << errbuf;
+        close();
+        return false;
+    }
+
+    m_stream = avformat_new_stream(m_context, nullptr);
+    if (!m_stream) {
+        LOG_ERROR() << "[PacketMuxer] Failed to create output stream for " << path;
+        close();
+        return false;
+    }
+
+    AVCodecParameters* parameters = m_stream->codecpar;
+    parameters->codec_type = AVMEDIA_TYPE_VIDEO;
+    parameters->codec_id = static_cast<AVCodecID>(stream->codecId);
+    parameters->width = stream->width;
+    parameters->height = stream->height;
+    if (!stream->extradata.empty()) {
+        parameters->extradata = static_cast<uint8_t*>(
+            av_mallocz(stream->extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (parameters->extradata) {
+            std::memcpy(parameters->extradata, stream->extradata.data(), stream->extradata.size());
+            parameters->extradata_size = static_cast<int>(stream->extradata.size());
+        }
+    }
+    m_stream->time_base = AVRational{stream->timeBaseNum, stream->timeBaseDen};
+    m_stream->avg_frame_rate = av_d2q(stream->frameRate, 1000);
+
+    if (!(m_context->oformat->flags & AVFMT_NOFILE)) {
+        m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (m_fd < 0) {
+            LOG_ERROR() << "[PacketMuxer] Failed to open " << path << ": " << std::strerror(errno);
+            close();
+            return false;
+        }
+
+        // Reserve the expected size without changing the file size; file
+        // systems without fallocate just grow the file as before
+        if (preallocateBytes > 0 &&
+            fallocate(m_fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(preallocateBytes)) == 0) {
+            m_preallocatedBytes = preallocateBytes;
+        }
+
+        auto* buffer = static_cast<unsigned char*>(av_malloc(IO_BUFFER_SIZE));
+        auto write = [](void* opaque, AVIO_WRITE_DATA data, int size) { return writeOutput(opaque, data, size); };
+        m_context->pb = buffer ? avio_alloc_context(buffer, IO_BUFFER_SIZE, 1, this, nullptr, write, &PacketMuxer::seekOutput)
+                               : nullptr;
+        if (!m_context->pb) {
+            av_free(buffer);
+            LOG_ERROR() << "[PacketMuxer] Failed to allocate the output buffer for " << path;
+            close();
+            return false;
+        }
+        m_context->flags |= AVFMT_FLAG_CUSTOM_IO;
+    }
+
+    ret = avformat_write_header(m_context, nullptr);
+    if (ret < 0) {
+        av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
+        LOG_ERROR() << "[PacketMuxer] Failed to write header of " << path << ": " << errbuf;
+        close();
+        return false;
+    }
+
+    // Allocated last: its presence means the header was written
+    m_packet = av_packet_alloc();
+    m_path = path;
+    m_info = stream;
+    return true;
+#else
+    LOG_WARN() << "[PacketMuxer] FFmpeg not available, cannot write " << path;
+    return false;
+#endif
+}
+
+bool PacketMuxer::write(const EncodedPacket& packet) {
+#ifdef HAVE_FFMPEG
+    if (!m_packet || packet.stream != m_info || packet.data.empty()) {
+        return false;
+    }
+
+    // Rebase to zero in the source time base, synthesizing missing timestamps
+    // from the frame rate and keeping dts strictly increasing
+    const int64_t frameTicks = std::max<int64_t>(1, static_cast<int64_t>(
+        m_info->timeBaseDen / (m_info->timeBaseNum * std::max(1.0, m_info->frameRate))));
+    int64_t dts = packet.dts;
+    int64_t pts = packet.pts;
+    if (dts == EncodedPacket::NO_TIMESTAMP) {
+        dts = m_lastDts == EncodedPacket::NO_TIMESTAMP ? 0 : m_lastDts + frameTicks;
+        pts = dts;
+    } else {
+        if (m_firstDts == EncodedPacket::NO_TIMESTAMP) {
+            m_firstDts = dts;
+        }
+        pts -= m_firstDts;
+        dts -= m_firstDts;
+    }
+    if (m_lastDts != EncodedPacket::NO_TIMESTAMP && dts <= m_lastDts) {
+        dts = m_lastDts + 1;
+    }
+    pts = std::max(pts, dts);
+    m_lastDts = dts;
+
+    // The packet is written synchronously and not kept, so it can borrow the data
+    m_packet->data = const_cast<uint8_t*>(packet.data.data());
+    m_packet->size = static_cast<int>(packet.data.size());
+    m_packet->stream_index = m_stream->index;
+    m_packet->flags = packet.keyframe ? AV_PKT_FLAG_KEY : 0;
+    m_packet->pts = pts;
+    m_packet->dts = dts;
+    m_packet->duration = packet.duration;
+    m_packet->pos = -1;
+    av_packet_rescale_ts(m_packet, AVRational{m_info->timeBaseNum, m_info->timeBaseDen}, m_stream->time_base);
+
+    int ret = av_write_frame(m_context, m_packet);
+    m_packet->data = nullptr;
+    m_packet->size = 0;
+    if (ret < 0) {
+        char errbuf[AV_ERROR_MAX_STRING_SIZE];
+        av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
+        LOG_ERROR() << "[PacketMuxer] Failed to write packet to " << m_path << ": " << errbuf;
+        return false;
+    }
+
+    if (m_packetCount++ == 0) {
+        m_firstWallMs = packet.wallTimeMs;
+    }
+    m_lastWallMs = packet.wallTimeMs;
+    return true;
+#else
+    (void)packet;
+    return false;
+#endif
+}
+
+void PacketMuxer::close() {
+#ifdef HAVE_FFMPEG
+    if (m_context) {
+        if (m_packet) {
+            av_write_trailer(m_context);
+        }
+        releaseOutput();
+        avformat_free_context(m_context);
+    }
+    if (m_packet) {
+        av_packet_free(&m_packet);
+    }
+#endif
+    if (m_fd >= 0) {
+        // Give back the reserved space past the end of the file
+        struct stat st;
+        if (m_preallocatedBytes > 0 && fstat(m_fd, &st) == 0 &&
+            static_cast<uint64_t>(st.st_size) < m_preallocatedBytes) {
+            fallocate(m_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, st.st_size,
+                      static_cast<off_t>(m_preallocatedBytes) - st.st_size);
+        }
+        ::close(m_fd);
+    }
+    m_fd = -1;
+    m_preallocatedBytes = 0;
+    m_context = nullptr;
+    m_stream = nullptr;
+    m_packet = nullptr;
+    m_path.clear();
+    m_info.reset();
+    m_firstDts = EncodedPacket::NO_TIMESTAMP;
+    m_lastDts = EncodedPacket::NO_TIMESTAMP;
+    m_firstWallMs = 0;
+    m_lastWallMs = 0;
+    m_packetCount = 0;
+}
+
+bool PacketMuxer::isOpen() const {
+    return m_packet != nullptr;
+}
+
+const std::string& PacketMuxer::getPath() const {
+    return m_path;
+}
+
+uint64_t PacketMuxer::getPacketCount() const {
+    return m_packetCount;
+}
+
+int64_t PacketMuxer::getStartWallMs() const {
+    return m_firstWallMs;
+}
+
+int64_t PacketMuxer::getDurationMs() const {
+    return m_lastWallMs - m_firstWallMs;
+}
+
+uint64_t PacketMuxer::getWritePosition() const {
+#ifdef HAVE_FFMPEG
+    if (m_context && m_context->pb) {
+        int64_t position = avio_tell(m_context->pb);
+        return position > 0 ? static_cast<uint64_t>(position) : 0;
+    }
+#endif
+    return 0;
+}
+
+void PacketMuxer::releaseOutput() {
+#ifdef HAVE_FFMPEG
+    if (m_context && m_context->pb && (m_context->flags & AVFMT_FLAG_CUSTOM_IO)) {
+        avio_flush(m_context->pb);
+        av_freep(&m_context->pb->buffer);
+        avio_context_free(&m_context->pb);
+    }
+#endif
+}
+
+int PacketMuxer::writeOutput(void* opaque, const uint8_t* data, int size) {
+    auto* muxer = static_cast<PacketMuxer*>(opaque);
+    int written = 0;
+    while (written < size) {
+        ssize_t ret = ::write(muxer->m_fd, data + written, static_cast<size_t>(size - written));
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+#ifdef HAVE_FFMPEG
+            return AVERROR(errno);
+#else
+            return -1;
+#endif
+        }
+        written += static_cast<int>(ret);
+    }
+    return written;
+}
+
+int64_t PacketMuxer::seekOutput(void* opaque, int64_t offset, int whence) {
+    auto* muxer = static_cast<PacketMuxer*>(opaque);
+#ifdef HAVE_FFMPEG
+    if (whence & AVSEEK_SIZE) {
+        struct stat st;
+        return fstat(muxer->m_fd, &st) == 0 ? static_cast<int64_t>(st.st_size) : AVERROR(errno);
+    }
+    whence &= ~AVSEEK_FORCE;
+#endif
+    off_t position = lseek(muxer->m_fd, static_cast<off_t>(offset), whence);
+    return position < 0 ? -1 : static_cast<int64_t>(position);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "../video/EncodedPacket.h"
+
+// FFmpeg forward declarations
+extern "C" {
+    struct AVFormatContext;
+    struct AVStream;
+    struct AVPacket;
+}
+
+/**
+ * @brief Writes compressed video packets into a container file without re-encoding
+ *
+ * The container follows the file extension (.mp4, .mkv). Timestamps are
+ * rebased so the file starts at zero and made strictly increasing, which
+ * absorbs the jitter of live sources. The first packet should be a keyframe.
+ *
+ * Output goes through a large write buffer, so the disk sees few big writes
+ * instead of one per packet, into a file whose expected size can be
+ * reserved up front (fallocate) to keep it contiguous.
+ */
+class PacketMuxer {
+public:
+    PacketMuxer();
+    ~PacketMuxer();
+
+    PacketMuxer(const PacketMuxer&) = delete;
+    PacketMuxer& operator=(const PacketMuxer&) = delete;
+
+    /**
+     * @param preallocateBytes Expected file size to reserve, 0 for none; the
+     *        unused part is released on close()
+     */
+    bool open(const std::string& path, const std::shared_ptr<const AISecurityVision::EncodedStreamInfo>& stream,
+              uint64_t preallocateBytes = 0);
+
+    /**
+     * @return false on a write error or for a packet of another stream
+     *         (decoder reopened); the file then needs to be closed
+     */
+    bool write(const AISecurityVision::EncodedPacket& packet);
+
+    /**
+     * @brief Finish the file (trailer, index) and close it
+     */
+    void close();
+
+    bool isOpen() const;
+    const std::string& getPath() const;
+    uint64_t getPacketCount() const;
+    int64_t getStartWallMs() const;    // Wall-clock time of the first written packet
+    int64_t getDurationMs() const;     // Wall-clock span of the written packets
+    uint64_t getWritePosition() const; // Bytes handed to the output so far (the next packet starts at or after it)
+
+private:
+    static int writeOutput(void* opaque, const uint8_t* data, int size);
+    static int64_t seekOutput(void* opaque, int64_t offset, int whence);
+    void releaseOutput();
+
+    AVFormatContext* m_context = nullptr;
+    AVStream* m_stream = nullptr;
+    AVPacket* m_packet = nullptr;
+    int m_fd = -1;
+    uint64_t m_preallocatedBytes = 0;
+
+    std::string m_path;
+    std::shared_ptr<const AISecurityVision::EncodedStreamInfo> m_info;
+    int64_t m_firstDts = AISecurityVision::EncodedPacket::NO_TIMESTAMP;
+    int64_t m_lastDts = AISecurityVision::EncodedPacket::NO_TIMESTAMP;
+    int64_t m_firstWallMs = 0;
+    int64_t m_lastWallMs = 0;
+    uint64_t m_packetCount = 0;
+
+    static constexpr int IO_BUFFER_SIZE = 1024 * 1024;
+};
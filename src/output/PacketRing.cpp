@@ -0,0 +1,103 @@
+#include "PacketRing.h"
+
+#include "../core/Logger.h"
+using namespace AISecurityVision;
+
+void PacketRing::setLimits(int64_t durationMs, size_t maxBytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_durationMs = durationMs > 0 ? durationMs : 0;
+    m_maxBytes = maxBytes;
+    if (m_durationMs == 0) {
+        m_packets.clear();
+        m_gopStarts.clear();
+        m_bytes = 0;
+        return;
+    }
+    while (m_gopStarts.size() > 1 &&
+           (m_packets.back()->wallTimeMs - m_gopStarts[1] >= m_durationMs ||
+            (m_maxBytes > 0 && m_bytes > m_maxBytes))) {
+        dropOldestGop();
+    }
+    enforceByteLimit();
+}
+
+void PacketRing::push(const PacketPtr& packet) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_packets.empty() && m_packets.back()->stream != packet->stream) {
+        m_packets.clear();
+        m_gopStarts.clear();
+        m_bytes = 0;
+    }
+    if (m_packets.empty() && !packet->keyframe) {
+        return;     // Undecodable without the preceding keyframe
+    }
+    if (m_durationMs == 0) {
+        return;
+    }
+
+    m_packets.push_back(packet);
+    m_bytes += packet->data.size();
+    if (packet->keyframe) {
+        m_gopStarts.push_back(packet->wallTimeMs);
+    }
+
+    // The GOPs after the oldest one already cover the window
+    while (m_gopStarts.size() > 1 &&
+           (packet->wallTimeMs - m_gopStarts[1] >= m_durationMs ||
+            (m_maxBytes > 0 && m_bytes > m_maxBytes))) {
+        dropOldestGop();
+    }
+    enforceByteLimit();
+}
+
+void PacketRing::enforceByteLimit() {
+    // Only one GOP is left and it alone exceeds the limit: start over at the
+    // next keyframe (push() drops packets until then)
+    if (m_maxBytes == 0 || m_bytes <= m_maxBytes) {
+        return;
+    }
+    if (!m_overflowLogged) {
+        LOG_WARN() << "[PacketRing] One GOP exceeds the " << m_maxBytes / 1024
+                   << " KB pre-event limit; the ring restarts at each keyframe";
+        m_overflowLogged = true;
+    }
+    m_packets.clear();
+    m_gopStarts.clear();
+    m_bytes = 0;
+}
+
+void PacketRing::dropOldestGop() {
+    do {
+        m_bytes -= m_packets.front()->data.size();
+        m_packets.pop_front();
+    } while (!m_packets.empty() && !m_packets.front()->keyframe);
+    m_gopStarts.pop_front();
+}
+
+std::vector<PacketRing::PacketPtr> PacketRing::snapshot() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::vector<PacketPtr>(m_packets.begin(), m_packets.end());
+}
+
+void PacketRing::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_packets.clear();
+    m_gopStarts.clear();
+    m_bytes = 0;
+}
+
+size_t PacketRing::getByteSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+size_t PacketRing::getPacketCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_packets.size();
+}
+
+int64_t PacketRing::getDurationMs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_packets.empty() ? 0 : m_packets.back()->wallTimeMs - m_packets.front()->wallTimeMs;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "../video/EncodedPacket.h"
+
+/**
+ * @brief Pre-event ring of compressed video packets, aligned to GOPs
+ *
+ * Holds the camera's original packets instead of decoded frames, so the
+ * pre-event window costs the stream's bitrate (a few MB for 30 s) rather than
+ * raw frames. The ring always starts at a keyframe and drops whole GOPs from
+ * the front: the oldest GOP goes once the remaining ones still cover the
+ * configured duration, or when the byte limit is exceeded. A single GOP over
+ * the byte limit (very long GOPs, intra refresh) empties the ring, which then
+ * waits for the next keyframe. A change of stream parameters (decoder
+ * reopened) clears it.
+ *
+ * push() is called on the decode thread, snapshot() by whoever starts a
+ * recording; both are serialized by an internal mutex.
+ */
+class PacketRing {
+public:
+    using PacketPtr = AISecurityVision::EncodedPacketPtr;
+
+    /**
+     * @param durationMs Pre-event time to cover
+     * @param maxBytes Hard memory limit, 0 = none
+     */
+    void setLimits(int64_t durationMs, size_t maxBytes);
+
+    void push(const PacketPtr& packet);
+
+    /**
+     * @brief Buffered packets, oldest first, starting at a keyframe
+     */
+    std::vector<PacketPtr> snapshot() const;
+
+    void clear();
+
+    size_t getByteSize() const;
+    size_t getPacketCount() const;
+    int64_t getDurationMs() const;
+
+private:
+    void dropOldestGop();
+    void enforceByteLimit();
+
+    std::deque<PacketPtr> m_packets;
+    std::deque<int64_t> m_gopStarts;    // Wall time of each buffered keyframe
+    size_t m_bytes = 0;
+    int64_t m_durationMs = 0;
+    size_t m_maxBytes = 0;
+    bool m_overflowLogged = false;
+    mutable std::mutex m_mutex;
+};
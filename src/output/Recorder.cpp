@@ -1,23 +1,50 @@
 #include "Recorder.h"
 #include "../core/VideoPipeline.h"
+#include "../core/FramePool.h"
 #include "../database/DatabaseManager.h"
+#include "StorageManager.h"
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
 
 #include "../core/Logger.h"
 using namespace AISecurityVision;
+
+const char* RecordingConfig::modeName(Mode mode) {
+    return mode == Mode::BURNED_IN ? "burned-in" : "passthrough";
+}
+
+std::string RecordingConfig::continuousDirectory(const std::string& sourceId) const {
+    return outputDir + "/continuous/" + sourceId;
+}
+
+bool RecordingConfig::parseMode(const std::string& name, Mode& mode) {
+    if (name == "passthrough") {
+        mode = Mode::PASSTHROUGH;
+    } else if (name == "burned-in") {
+        mode = Mode::BURNED_IN;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 Recorder::Recorder()
-    : m_bufferIndex(0), m_maxBufferSize(0), m_currentConfidence(0.0),
-      m_manualRecordingDuration(0) {
+    : m_currentConfidence(0.0), m_manualRecordingDuration(0) {
 }
 
 Recorder::~Recorder() {
+    // Writes what is still queued, then finishes the open files
+    stopWriter();
+
+    std::lock_guard<std::mutex> lock(m_recordingMutex);
     if (m_isRecording.load()) {
         stopRecording();
     }
+    closeSegment();
 }
 
 bool Recorder::initialize(const std::string& sourceId, std::shared_ptr<DatabaseManager> dbManager) {
@@ -36,15 +63,155 @@ bool Recorder::initialize(const std::string& sourceId, std::shared_ptr<DatabaseM
 
     // Initialize circular buffer
     initializeCircularBuffer();
+    startWriter();
 
     LOG_INFO() << "[Recorder] Initialized for " << sourceId
               << " with output directory: " << m_config.outputDir;
     return true;
 }
 
+void Recorder::startWriter() {
+    if (m_writerRunning.exchange(true)) {
+        return;
+    }
+    m_writerThread = std::thread(&Recorder::writerLoop, this);
+}
+
+void Recorder::stopWriter() {
+    if (!m_writerRunning.exchange(false)) {
+        return;
+    }
+    m_writeQueue.close();
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+}
+
+void Recorder::writerLoop() {
+    uint64_t seenDrops = 0;
+
+    while (true) {
+        WriteJob job;
+        bool popped = m_writeQueue.pop(job, WRITER_IDLE_TIMEOUT);
+        if (!popped && !m_writerRunning.load()) {
+            break;      // Closed and drained
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(m_recordingMutex);
+
+        // Overflow policy: the queue dropped its oldest items, so the packet
+        // stream has a hole; continue at the next keyframe
+        uint64_t drops = m_writeQueue.droppedCount();
+        if (drops != seenDrops) {
+            seenDrops = drops;
+            if (!m_resyncPackets) {
+                m_resyncPackets = true;
+                m_resyncs.fetch_add(1);
+                LOG_WARN() << "[Recorder] Writer behind for " << m_sourceId << " (" << drops
+                          << " items dropped so far), resuming at the next keyframe";
+            }
+        }
+
+        runControlCommands();
+
+        if (job.packet) {
+            writePacket(job.packet);
+        } else if (job.frame) {
+            writeFrame(*job.frame);
+        } else {
+            // Idle or woken for a command: recordings still end on time without input
+            if (m_isRecording.load()) {
+                checkRecordingEnd();
+            }
+            continue;
+        }
+
+        double latencyMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        double average = m_writeLatencyMs.load();
+        m_writeLatencyMs.store(average == 0.0 ? latencyMs
+                                              : average + LATENCY_EMA_ALPHA * (latencyMs - average));
+        if (latencyMs > m_maxWriteLatencyMs.load()) {
+            m_maxWriteLatencyMs.store(latencyMs);
+        }
+    }
+}
+
+void Recorder::enqueueControl(ControlCommand command) {
+    command.issuedAt = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        m_controlCommands.push_back(std::move(command));
+    }
+    // Wake an idle writer; a busy one picks the command up with its next item
+    if (m_writeQueue.size() == 0) {
+        m_writeQueue.push(WriteJob{});
+    }
+}
+
+void Recorder::runControlCommands() {
+    std::deque<ControlCommand> commands;
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        commands.swap(m_controlCommands);
+    }
+
+    for (const auto& command : commands) {
+        switch (command.type) {
+        case ControlCommand::Type::EVENT:
+            if (m_isRecording.load()) {
+                LOG_DEBUG() << "[Recorder] Already recording, ignoring event trigger";
+                break;
+            }
+            m_eventTriggerTime = command.issuedAt;
+            if (startRecording("Event triggered: " + command.eventType, command.eventType,
+                               command.confidence, command.metadata)) {
+                // Alarm footage: pin the finished segments of the pre-event
+                // window now, the open and upcoming ones when they close
+                int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+                m_alarmUntilMs = now + static_cast<int64_t>(m_config.postEventDuration) * 1000;
+                StorageManager::getInstance().pinRange(
+                    m_sourceId, now - static_cast<int64_t>(m_config.preEventDuration) * 1000, now);
+            }
+            break;
+
+        case ControlCommand::Type::START_MANUAL:
+            if (m_isRecording.load()) {
+                LOG_INFO() << "[Recorder] Already recording, cannot start manual recording";
+                break;
+            }
+            m_manualRecordingDuration = command.durationSeconds;
+            m_isManualRecording.store(true);
+            if (!startRecording("Manual recording", "manual", 0.0, "")) {
+                m_isManualRecording.store(false);
+            }
+            break;
+
+        case ControlCommand::Type::STOP_MANUAL:
+            if (m_isManualRecording.load()) {
+                m_isManualRecording.store(false);
+                stopRecording();
+            }
+            break;
+        }
+    }
+}
+
 void Recorder::setConfig(const RecordingConfig& config) {
     std::lock_guard<std::mutex> lock(m_recordingMutex);
     m_config = config;
+    if (m_config.container != "mp4" && m_config.container != "mkv") {
+        LOG_WARN() << "[Recorder] Unsupported container '" << m_config.container << "', using mp4";
+        m_config.container = "mp4";
+    }
+    m_config.segmentDuration = std::max(1, m_config.segmentDuration);
+    m_passthroughMode.store(m_config.mode == RecordingConfig::Mode::PASSTHROUGH);
+    m_continuousActive.store(m_config.continuous && m_config.mode == RecordingConfig::Mode::PASSTHROUGH);
+    if (!m_continuousActive.load()) {
+        closeSegment();
+    }
 
     // Recreate output directory if changed
     try {
@@ -58,25 +225,44 @@ void Recorder::setConfig(const RecordingConfig& config) {
 }
 
 void Recorder::initializeCircularBuffer() {
-    // Calculate buffer size based on pre-event duration
-    // Assuming 25 FPS, buffer size = preEventDuration * 25
-    m_maxBufferSize = static_cast<size_t>(m_config.preEventDuration * 25);
-
-    std::lock_guard<std::mutex> bufferLock(m_bufferMutex);
-    m_frameBuffer.clear();
-    m_frameBuffer.reserve(m_maxBufferSize);
-    m_bufferIndex = 0;
+    // The ring holds whole GOPs of compressed packets covering the pre-event duration
+    m_packetRing.setLimits(static_cast<int64_t>(m_config.preEventDuration) * 1000,
+                           static_cast<size_t>(std::max(0, m_config.preEventMaxMB)) * 1024 * 1024);
 
-    LOG_INFO() << "[Recorder] Circular buffer initialized with size: " << m_maxBufferSize;
+    LOG_INFO() << "[Recorder] Pre-event packet ring initialized: " << m_config.preEventDuration
+              << "s, limit " << m_config.preEventMaxMB << " MB";
 }
 
 void Recorder::processFrame(const FrameResult& result) {
-    // Convert FrameResult to FrameData
-    FrameData frameData;
-    frameData.frame = result.frame.clone();
+    // Frames only feed open recordings and segment sidecars
+    if (!m_isRecording.load() && !m_continuousActive.load()) {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        if (m_controlCommands.empty()) {
+            return;
+        }
+    }
+
+    // Convert FrameResult to FrameData. Pixels are only attached when they
+    // may be re-encoded: a queued passthrough frame would otherwise pin a
+    // full-resolution pooled buffer for nothing but its detections.
+    auto frame = std::make_unique<FrameData>();
+    FrameData& frameData = *frame;
+    // Frames give way before packets: once MAX_QUEUED_PIXEL_FRAMES are waiting,
+    // further frames are queued without pixels (their detections still reach
+    // the sidecar) rather than letting a slow disk pin gigabytes of buffers.
+    if (!m_passthroughMode.load() || !m_receivingPackets.load() || m_encodingFrames.load()) {
+        if (m_queuedPixelFrames.fetch_add(1) < MAX_QUEUED_PIXEL_FRAMES) {
+            frameData.pixelSlot.reset(&m_queuedPixelFrames);
+            frameData.frame = result.frame;  // Shared read-only; overlays are drawn on a copy
+        } else {
+            m_queuedPixelFrames.fetch_sub(1);
+            m_droppedPixelFrames.fetch_add(1);
+        }
+    }
     frameData.detections = result.detections;
     frameData.trackIds = result.trackIds;
     frameData.labels = result.labels;
+    frameData.wallTimeMs = result.timestamp;
     frameData.frameTime = std::chrono::duration<double>(
         std::chrono::steady_clock::now().time_since_epoch()).count();
 
@@ -91,70 +277,183 @@ void Recorder::processFrame(const FrameResult& result) {
     ss << "." << std::setfill('0') << std::setw(3) << ms.count();
     frameData.timestamp = ss.str();
 
-    // Add to circular buffer
-    addFrameToBuffer(frameData);
+    WriteJob job;
+    job.frame = std::move(frame);
+    m_writeQueue.push(std::move(job));
+}
+
+void Recorder::processPacket(const AISecurityVision::EncodedPacketPtr& packet) {
+    WriteJob job;
+    job.packet = packet;
+    m_writeQueue.push(std::move(job));
+}
 
-    // If recording, write frame to video
+void Recorder::writeFrame(const FrameData& frameData) {
+    // Passthrough files get their video from the packets, the frame only
+    // contributes its detections to the sidecars
     if (m_isRecording.load()) {
-        writeFrameToVideo(frameData);
+        if (m_muxer.isOpen()) {
+            m_sidecar.write(frameData.wallTimeMs, frameData.detections, frameData.trackIds, frameData.labels);
+        } else {
+            writeFrameToVideo(frameData);
+        }
+        checkRecordingEnd();
+    }
+    m_segmentSidecar.write(frameData.wallTimeMs, frameData.detections, frameData.trackIds, frameData.labels);
+}
 
-        // Check if manual recording should stop
-        if (m_isManualRecording.load()) {
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                std::chrono::steady_clock::now() - m_recordingStartTime).count();
+void Recorder::writePacket(const AISecurityVision::EncodedPacketPtr& packet) {
+    // Ring and muxer are fed by the writer thread alone, so a recording that
+    // starts in between neither misses nor duplicates a packet
+    if (m_resyncPackets) {
+        if (!packet->keyframe) {
+            return;
+        }
+        m_resyncPackets = false;
+    }
+    m_receivingPackets.store(true);
+    m_lastStream = packet->stream;
+    m_packetRing.push(packet);
 
-            if (elapsed >= m_manualRecordingDuration) {
-                stopManualRecording();
-            }
+    if (m_config.continuous && m_config.mode == RecordingConfig::Mode::PASSTHROUGH) {
+        writeContinuousPacket(packet);
+    }
+
+    if (!m_isRecording.load() || !m_muxer.isOpen()) {
+        return;
+    }
+
+    if (m_awaitKeyframe) {
+        if (!packet->keyframe) {
+            return;
+        }
+        m_awaitKeyframe = false;
+        if (m_config.overlaySidecar) {
+            m_sidecar.open(m_currentOutputPath, packet->wallTimeMs);
         }
+    }
+    if (!m_muxer.write(*packet)) {
+        LOG_WARN() << "[Recorder] Stream changed or write failed, closing " << m_currentOutputPath;
+        m_isManualRecording.store(false);
+        stopRecording();
+        return;
+    }
+    checkRecordingEnd();
+}
 
-        // Check if event recording should stop (post-event duration)
-        if (!m_isManualRecording.load() && !m_currentEventType.empty()) {
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                std::chrono::steady_clock::now() - m_eventTriggerTime).count();
+void Recorder::writeContinuousPacket(const AISecurityVision::EncodedPacketPtr& packet) {
+    // Segments start at keyframes: cut at the first one after segmentDuration
+    if (m_segmentMuxer.isOpen() && packet->keyframe &&
+        packet->wallTimeMs - m_segmentStartMs >= static_cast<int64_t>(m_config.segmentDuration) * 1000) {
+        closeSegment();
+    }
+    if (!m_segmentMuxer.isOpen()) {
+        if (!packet->keyframe) {
+            return;
+        }
+        openSegment(packet);
+    }
 
-            if (elapsed >= m_config.postEventDuration) {
-                stopRecording();
+    if (m_segmentMuxer.isOpen() && !writeSegmentPacket(*packet)) {
+        // Stream parameters changed (decoder reopened): start a new segment
+        closeSegment();
+        if (packet->keyframe) {
+            openSegment(packet);
+            if (m_segmentMuxer.isOpen()) {
+                writeSegmentPacket(*packet);
             }
         }
     }
 }
 
-void Recorder::addFrameToBuffer(const FrameData& frameData) {
-    std::lock_guard<std::mutex> lock(m_bufferMutex);
+bool Recorder::writeSegmentPacket(const AISecurityVision::EncodedPacket& packet) {
+    uint64_t position = m_segmentMuxer.getWritePosition();
+    if (!m_segmentMuxer.write(packet)) {
+        return false;
+    }
+    if (packet.keyframe) {
+        m_segmentIndex.addKeyframe(packet.wallTimeMs, packet.wallTimeMs - m_segmentStartMs, position);
+    }
+    return true;
+}
 
-    if (m_frameBuffer.size() < m_maxBufferSize) {
-        m_frameBuffer.push_back(frameData);
-    } else {
-        // Circular buffer - overwrite oldest frame
-        m_frameBuffer[m_bufferIndex] = frameData;
-        m_bufferIndex = (m_bufferIndex + 1) % m_maxBufferSize;
+void Recorder::openSegment(const AISecurityVision::EncodedPacketPtr& packet) {
+    // The index creates the directory; segments are recorded without it if it fails
+    std::string path = generateSegmentPath(packet->wallTimeMs);
+    m_segmentIndex.open(m_config.continuousDirectory(m_sourceId));
+    if (!m_segmentMuxer.open(path, packet->stream,
+                             estimateFileBytes(static_cast<int64_t>(m_config.segmentDuration) * 1000))) {
+        return;
     }
+    m_segmentStartMs = packet->wallTimeMs;
+    m_segmentIndex.beginSegment(std::filesystem::path(path).filename().string(), m_segmentStartMs);
+    if (m_config.overlaySidecar) {
+        m_segmentSidecar.open(path, packet->wallTimeMs);
+    }
+    LOG_DEBUG() << "[Recorder] Continuous segment started: " << path;
 }
 
-bool Recorder::startManualRecording(int durationSeconds) {
-    std::lock_guard<std::mutex> lock(m_recordingMutex);
+void Recorder::closeSegment() {
+    if (m_segmentMuxer.isOpen()) {
+        std::string path = m_segmentMuxer.getPath();
+        int64_t durationMs = m_segmentMuxer.getDurationMs();
+        int64_t segment = m_segmentIndex.getCurrentSegment();
+        m_segmentMuxer.close();
+
+        std::error_code ec;
+        auto bytes = std::filesystem::file_size(path, ec);
+        m_segmentIndex.endSegment(m_segmentStartMs + durationMs, ec ? 0 : static_cast<uint64_t>(bytes));
+        bool alarm = m_alarmUntilMs > 0 && m_segmentStartMs <= m_alarmUntilMs;
+        StorageManager::getInstance().addFile(m_sourceId, path, m_segmentStartMs, m_segmentStartMs + durationMs,
+                                              alarm, segment);
+        LOG_DEBUG() << "[Recorder] Continuous segment closed: " << path << " (" << durationMs << " ms)";
+    }
+    m_segmentSidecar.close();
+}
+
+void Recorder::checkRecordingEnd() {
+    auto now = std::chrono::steady_clock::now();
+
+    // Check if manual recording should stop
+    if (m_isManualRecording.load()) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - m_recordingStartTime).count();
+        if (elapsed >= m_manualRecordingDuration) {
+            m_isManualRecording.store(false);
+            stopRecording();
+        }
+        return;
+    }
 
+    // Check if event recording should stop (post-event duration)
+    if (!m_currentEventType.empty()) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - m_eventTriggerTime).count();
+        if (elapsed >= m_config.postEventDuration) {
+            stopRecording();
+        }
+    }
+}
+
+bool Recorder::startManualRecording(int durationSeconds) {
     if (m_isRecording.load()) {
         LOG_INFO() << "[Recorder] Already recording, cannot start manual recording";
         return false;
     }
 
-    m_manualRecordingDuration = durationSeconds;
-    m_isManualRecording.store(true);
-
-    return startRecording("Manual recording", "manual", 0.0, "");
+    ControlCommand command;
+    command.type = ControlCommand::Type::START_MANUAL;
+    command.durationSeconds = durationSeconds;
+    enqueueControl(std::move(command));
+    return true;
 }
 
 bool Recorder::stopManualRecording() {
-    std::lock_guard<std::mutex> lock(m_recordingMutex);
-
     if (!m_isManualRecording.load()) {
         return false;
     }
 
-    m_isManualRecording.store(false);
-    stopRecording();
+    ControlCommand command;
+    command.type = ControlCommand::Type::STOP_MANUAL;
+    enqueueControl(std::move(command));
     return true;
 }
 
@@ -164,55 +463,73 @@ bool Recorder::isRecording() const {
 
 void Recorder::triggerEventRecording(const std::string& eventType, double confidence,
                                     const std::string& metadata) {
-    std::lock_guard<std::mutex> lock(m_recordingMutex);
-
     if (m_isRecording.load()) {
-        LOG_INFO() << "[Recorder] Already recording, ignoring event trigger";
+        LOG_DEBUG() << "[Recorder] Already recording, ignoring event trigger";
         return;
     }
 
-    m_eventTriggerTime = std::chrono::steady_clock::now();
-    startRecording("Event triggered: " + eventType, eventType, confidence, metadata);
+    ControlCommand command;
+    command.type = ControlCommand::Type::EVENT;
+    command.eventType = eventType;
+    command.confidence = confidence;
+    command.metadata = metadata;
+    enqueueControl(std::move(command));
 }
 
 bool Recorder::startRecording(const std::string& reason, const std::string& eventType,
                              double confidence, const std::string& metadata) {
     // Generate output path
-    m_currentOutputPath = generateOutputPath(eventType);
+    const bool passthrough = m_config.mode == RecordingConfig::Mode::PASSTHROUGH &&
+                             m_receivingPackets.load() && m_lastStream;
+    m_currentOutputPath = generateOutputPath(eventType, passthrough ? m_config.container : "mp4");
     m_currentEventType = eventType;
     m_currentConfidence = confidence;
     m_currentMetadata = metadata;
 
-    // Initialize video writer
-    cv::Size frameSize(1920, 1080); // Default size, should be configurable
-    int fourcc = cv::VideoWriter::fourcc('H', '2', '6', '4');
-    double fps = 25.0;
+    if (passthrough) {
+        // Remux the camera's own packets: the pre-event ring first, then live
+        // packets from processPacket (starting at a keyframe if the ring is empty)
+        int64_t expectedMs = static_cast<int64_t>(m_config.preEventDuration) * 1000 +
+            static_cast<int64_t>(m_isManualRecording.load() ? m_manualRecordingDuration : m_config.postEventDuration) * 1000;
+        if (!m_muxer.open(m_currentOutputPath, m_lastStream, estimateFileBytes(expectedMs))) {
+            LOG_ERROR() << "[Recorder] Failed to open muxer: " << m_currentOutputPath;
+            return false;
+        }
 
-    if (!m_videoWriter.open(m_currentOutputPath, fourcc, fps, frameSize)) {
-        LOG_ERROR() << "[Recorder] Failed to open video writer: " << m_currentOutputPath;
-        return false;
+        size_t preEventPackets = 0;
+        for (const auto& packet : m_packetRing.snapshot()) {
+            if (packet->stream == m_lastStream && m_muxer.write(*packet)) {
+                ++preEventPackets;
+            }
+        }
+        m_awaitKeyframe = preEventPackets == 0;
+        if (!m_awaitKeyframe && m_config.overlaySidecar) {
+            m_sidecar.open(m_currentOutputPath, m_muxer.getStartWallMs());
+        }
+
+        LOG_INFO() << "[Recorder] Flushed " << preEventPackets << " pre-event packets ("
+                  << m_muxer.getDurationMs() << " ms) to " << m_currentOutputPath;
+    } else {
+        // Burned-in mode or no packet feed: re-encode frames from now on
+        cv::Size frameSize(1920, 1080); // Default size, should be configurable
+        int fourcc = cv::VideoWriter::fourcc('H', '2', '6', '4');
+        double fps = 25.0;
+
+        if (!m_videoWriter.open(m_currentOutputPath, fourcc, fps, frameSize)) {
+            LOG_ERROR() << "[Recorder] Failed to open video writer: " << m_currentOutputPath;
+            return false;
+        }
+        m_encodingFrames.store(true);
     }
 
     m_recordingStartTime = std::chrono::steady_clock::now();
+    m_recordingStartWallMs = m_muxer.getPacketCount() > 0 ? m_muxer.getStartWallMs()
+        : std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::system_clock::now().time_since_epoch()).count();
     m_isRecording.store(true);
 
     LOG_INFO() << "[Recorder] Started recording: " << reason
               << " -> " << m_currentOutputPath;
-
-    // Write pre-event frames from circular buffer
-    {
-        std::lock_guard<std::mutex> bufferLock(m_bufferMutex);
-
-        // Write frames in chronological order
-        size_t startIdx = m_frameBuffer.size() < m_maxBufferSize ? 0 : m_bufferIndex;
-        size_t count = std::min(m_frameBuffer.size(), m_maxBufferSize);
-
-        for (size_t i = 0; i < count; ++i) {
-            size_t idx = (startIdx + i) % m_frameBuffer.size();
-            writeFrameToVideo(m_frameBuffer[idx]);
-        }
-    }
-
     return true;
 }
 
@@ -223,10 +540,28 @@ void Recorder::stopRecording() {
 
     m_isRecording.store(false);
 
-    // Close video writer
+    // Close muxer or video writer
+    int64_t endWallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (m_muxer.isOpen()) {
+        LOG_DEBUG() << "[Recorder] Remuxed " << m_muxer.getPacketCount() << " packets ("
+                   << m_muxer.getDurationMs() << " ms)";
+        if (m_muxer.getPacketCount() > 0) {
+            m_recordingStartWallMs = m_muxer.getStartWallMs();
+            endWallMs = m_recordingStartWallMs + m_muxer.getDurationMs();
+        }
+        m_muxer.close();
+    }
+    m_sidecar.close();
+    m_awaitKeyframe = false;
     if (m_videoWriter.isOpened()) {
         m_videoWriter.release();
     }
+    m_encodingFrames.store(false);
+
+    // Everything but manual recordings was triggered by an alarm and stays pinned
+    StorageManager::getInstance().addFile(m_sourceId, m_currentOutputPath, m_recordingStartWallMs, endWallMs,
+                                          m_currentEventType != "manual");
 
     // Save event to database
     if (!m_currentEventType.empty() && m_dbManager) {
@@ -244,11 +579,19 @@ void Recorder::stopRecording() {
 }
 
 void Recorder::writeFrameToVideo(const FrameData& frameData) {
-    if (!m_videoWriter.isOpened()) {
+    // Frames queued just before a switch to re-encoding carry no pixels
+    if (!m_videoWriter.isOpened() || frameData.frame.empty()) {
         return;
     }
 
-    cv::Mat outputFrame = frameData.frame.clone();
+    bool drawBBoxes = m_config.enableBBoxOverlay && !frameData.detections.empty();
+    if (!m_config.enableTimestamp && !drawBBoxes) {
+        m_videoWriter.write(frameData.frame);
+        return;
+    }
+
+    // Buffered frames are shared with other stages, draw overlays on a private copy
+    cv::Mat outputFrame = FramePool::getInstance().copyOf(m_sourceId, frameData.frame);
 
     // Add timestamp overlay
     if (m_config.enableTimestamp) {
@@ -256,7 +599,7 @@ void Recorder::writeFrameToVideo(const FrameData& frameData) {
     }
 
     // Add bounding box overlay
-    if (m_config.enableBBoxOverlay && !frameData.detections.empty()) {
+    if (drawBBoxes) {
         addBBoxOverlay(outputFrame, frameData.detections, frameData.labels);
     }
 
@@ -320,7 +663,7 @@ void Recorder::addBBoxOverlay(cv::Mat& frame, const std::vector<cv::Rect>& detec
     }
 }
 
-std::string Recorder::generateOutputPath(const std::string& eventType) {
+std::string Recorder::generateOutputPath(const std::string& eventType, const std::string& extension) {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
     auto tm = *std::localtime(&time_t);
@@ -330,7 +673,20 @@ std::string Recorder::generateOutputPath(const std::string& eventType) {
     ss << m_sourceId << "_";
     ss << eventType << "_";
     ss << std::put_time(&tm, "%Y%m%d_%H%M%S");
-    ss << ".mp4";
+    ss << "." << extension;
+
+    return ss.str();
+}
+
+std::string Recorder::generateSegmentPath(int64_t wallTimeMs) const {
+    std::time_t seconds = static_cast<std::time_t>(wallTimeMs / 1000);
+    auto tm = *std::localtime(&seconds);
+
+    std::stringstream ss;
+    ss << m_config.continuousDirectory(m_sourceId) << "/";
+    ss << m_sourceId << "_";
+    ss << std::put_time(&tm, "%Y%m%d_%H%M%S");
+    ss << "." << m_config.container;
 
     return ss.str();
 }
@@ -365,12 +721,41 @@ RecordingConfig Recorder::getConfig() const {
     return m_config;
 }
 
+bool Recorder::isPassthroughMode() const {
+    return m_passthroughMode.load();
+}
+
+uint64_t Recorder::estimateFileBytes(int64_t durationMs) const {
+    // Camera bitrate as seen by the pre-event ring, capped at maxFileSize
+    int64_t ringMs = m_packetRing.getDurationMs();
+    if (ringMs <= 0 || durationMs <= 0) {
+        return 0;
+    }
+    double bytesPerMs = static_cast<double>(m_packetRing.getByteSize()) / static_cast<double>(ringMs);
+    uint64_t estimate = static_cast<uint64_t>(bytesPerMs * static_cast<double>(durationMs) * 1.1);
+    return std::min<uint64_t>(estimate, static_cast<uint64_t>(std::max(0, m_config.maxFileSize)) * 1024 * 1024);
+}
+
 size_t Recorder::getBufferSize() const {
-    std::lock_guard<std::mutex> lock(m_bufferMutex);
-    return m_frameBuffer.size();
+    return m_packetRing.getByteSize();
 }
 
 std::string Recorder::getCurrentRecordingPath() const {
     std::lock_guard<std::mutex> lock(m_recordingMutex);
     return m_currentOutputPath;
 }
+
+RecorderStats Recorder::getStats() const {
+    RecorderStats stats;
+    stats.backlog = m_writeQueue.size();
+    stats.queueCapacity = m_writeQueue.capacity();
+    stats.droppedItems = m_writeQueue.droppedCount();
+    stats.droppedFrames = m_droppedPixelFrames.load();
+    stats.resyncs = m_resyncs.load();
+    stats.writeLatencyMs = m_writeLatencyMs.load();
+    stats.maxWriteLatencyMs = m_maxWriteLatencyMs.load();
+    stats.preEventBytes = m_packetRing.getByteSize();
+    stats.recording = m_isRecording.load();
+    stats.continuous = m_continuousActive.load();
+    return stats;
+}
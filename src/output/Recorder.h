@@ -6,31 +6,38 @@
 #include <mutex>
 #include <atomic>
 #include <chrono>
+#include <deque>
+#include <thread>
 #include <opencv2/opencv.hpp>
+#include "../core/BoundedQueue.h"
+#include "RecordingConfig.h"
+#include "PacketRing.h"
+#include "PacketMuxer.h"
+#include "OverlaySidecar.h"
+#include "SegmentIndex.h"
 
 struct FrameResult;
 class DatabaseManager;
 
-/**
- * @brief Event recording configuration
- */
-struct RecordingConfig {
-    int preEventDuration = 30;   // seconds before event
-    int postEventDuration = 30;  // seconds after event
-    std::string outputDir = "./recordings";
-    int maxFileSize = 100;       // MB
-    bool enableTimestamp = true;
-    bool enableBBoxOverlay = true;
-};
-
 /**
  * @brief Video recorder with event-triggered recording and database integration
  *
  * This class handles:
- * - Circular buffer for pre/post-event recording
- * - MP4 file generation with timestamp and bbox overlays
+ * - Pre-event ring of the camera's compressed packets (see PacketRing)
+ * - Passthrough recording: event clips and continuous segments remuxed from
+ *   those packets, detections in an OverlaySidecar next to each file;
+ *   continuous segments are time-indexed by a SegmentIndex
+ * - Burned-in recording (or sources without a packet feed): frames
+ *   re-encoded with timestamp and bbox overlays
  * - Database integration for event metadata storage
+ * - Reporting finished files to the StorageManager (quota, alarm pins)
  * - Manual recording API support
+ *
+ * All file I/O runs on a writer thread owned by the recorder. The decode and
+ * pipeline threads only enqueue packets, frames and commands, so a slow disk
+ * never lowers the detection rate. The queue is bounded: when the writer
+ * falls behind, the oldest items are dropped and packet writing (ring, clips,
+ * segments) resumes at the next keyframe so the files stay decodable.
  */
 class Recorder {
 public:
@@ -41,42 +48,86 @@ public:
     bool initialize(const std::string& sourceId, std::shared_ptr<DatabaseManager> dbManager = nullptr);
     void setConfig(const RecordingConfig& config);
 
-    // Frame processing
+    // Frame processing (queued for the writer thread)
     void processFrame(const FrameResult& result);
 
-    // Manual recording control
+    /**
+     * @brief Feed one compressed packet of the camera stream (decode thread, queued)
+     */
+    void processPacket(const AISecurityVision::EncodedPacketPtr& packet);
+
+    // Manual recording control; applied by the writer thread in order with the queued data
     bool startManualRecording(int durationSeconds = 60);
     bool stopManualRecording();
     bool isRecording() const;
 
-    // Event-triggered recording
+    // Event-triggered recording (queued)
     void triggerEventRecording(const std::string& eventType, double confidence = 0.0,
                               const std::string& metadata = "");
 
     // Configuration
     void updateConfig(const RecordingConfig& config);
-    RecordingConfig getConfig() const;
+    RecordingConfig getConfig() const;     // Waits for the writer thread's current job
+    bool isPassthroughMode() const;        // Lock-free
 
     // Statistics
-    size_t getBufferSize() const;
+    size_t getBufferSize() const;       // Pre-event ring memory, bytes
     std::string getCurrentRecordingPath() const;
+    RecorderStats getStats() const;
 
 private:
     // Internal structures
+    // Returns a frame's pixel slot to m_queuedPixelFrames when the frame is
+    // written or dropped by the write queue
+    struct PixelSlotRelease {
+        void operator()(std::atomic<size_t>* count) const { count->fetch_sub(1); }
+    };
+
     struct FrameData {
         cv::Mat frame;
+        std::unique_ptr<std::atomic<size_t>, PixelSlotRelease> pixelSlot;  // Held while frame is set
         std::string timestamp;
         std::vector<cv::Rect> detections;
         std::vector<int> trackIds;
         std::vector<std::string> labels;
         double frameTime;
+        int64_t wallTimeMs;     // Decode time, system clock (aligns with packet times)
 
-        FrameData() : frameTime(0.0) {}
+        FrameData() : frameTime(0.0), wallTimeMs(0) {}
+    };
+
+    // Unit of work of the writer thread: a packet, a frame, or neither (wake-up)
+    struct WriteJob {
+        AISecurityVision::EncodedPacketPtr packet;
+        std::unique_ptr<FrameData> frame;
+    };
+
+    struct ControlCommand {
+        enum class Type { EVENT, START_MANUAL, STOP_MANUAL };
+
+        Type type = Type::EVENT;
+        std::string eventType;
+        double confidence = 0.0;
+        std::string metadata;
+        int durationSeconds = 0;
+        std::chrono::steady_clock::time_point issuedAt;
     };
 
     // Internal methods
+    void startWriter();
+    void stopWriter();
+    void writerLoop();
+    void enqueueControl(ControlCommand command);
+    void runControlCommands();
+    void writeFrame(const FrameData& frameData);
+    void writePacket(const AISecurityVision::EncodedPacketPtr& packet);
+    uint64_t estimateFileBytes(int64_t durationMs) const;
     void initializeCircularBuffer();
-    void addFrameToBuffer(const FrameData& frameData);
+    void checkRecordingEnd();
+    void writeContinuousPacket(const AISecurityVision::EncodedPacketPtr& packet);
+    void openSegment(const AISecurityVision::EncodedPacketPtr& packet);
+    bool writeSegmentPacket(const AISecurityVision::EncodedPacket& packet);
+    void closeSegment();
     bool startRecording(const std::string& reason, const std::string& eventType = "",
                        double confidence = 0.0, const std::string& metadata = "");
     void stopRecording();
@@ -84,7 +135,9 @@ private:
     void addTimestampOverlay(cv::Mat& frame, const std::string& timestamp);
     void addBBoxOverlay(cv::Mat& frame, const std::vector<cv::Rect>& detections,
                        const std::vector<std::string>& labels);
-    std::string generateOutputPath(const std::string& eventType = "manual");
+    std::string generateOutputPath(const std::string& eventType = "manual",
+                                   const std::string& extension = "mp4");
+    std::string generateSegmentPath(int64_t wallTimeMs) const;
     bool saveEventToDatabase(const std::string& videoPath, const std::string& eventType,
                            double confidence, const std::string& metadata);
 
@@ -93,26 +146,61 @@ private:
     RecordingConfig m_config;
     std::shared_ptr<DatabaseManager> m_dbManager;
 
-    // Circular buffer for pre-event frames
-    std::vector<FrameData> m_frameBuffer;
-    size_t m_bufferIndex;
-    size_t m_maxBufferSize;
-    mutable std::mutex m_bufferMutex;
+    // Pre-event ring of compressed packets, filled while packets arrive
+    PacketRing m_packetRing;
+    std::atomic<bool> m_receivingPackets{false};
+    std::shared_ptr<const AISecurityVision::EncodedStreamInfo> m_lastStream;
 
     // Recording state
     std::atomic<bool> m_isRecording{false};
     std::atomic<bool> m_isManualRecording{false};
-    cv::VideoWriter m_videoWriter;
+    std::atomic<bool> m_passthroughMode{true};     // m_config.mode, readable without m_recordingMutex
+    std::atomic<bool> m_encodingFrames{false};     // A recording is re-encoding frames (m_videoWriter)
+    PacketMuxer m_muxer;                // Remuxes packets when the source provides them
+    OverlaySidecar m_sidecar;
+    bool m_awaitKeyframe = false;       // Muxer opened without pre-event packets
+    cv::VideoWriter m_videoWriter;      // Fallback: re-encoded frames
     std::string m_currentOutputPath;
     std::string m_currentEventType;
     double m_currentConfidence;
     std::string m_currentMetadata;
 
+    // Continuous recording (passthrough), guarded by m_recordingMutex
+    PacketMuxer m_segmentMuxer;
+    OverlaySidecar m_segmentSidecar;
+    SegmentIndex m_segmentIndex;        // Time index of the segments (see RecordingConfig::continuousDirectory)
+    int64_t m_segmentStartMs = 0;
+    int64_t m_alarmUntilMs = 0;         // Segments starting before this cover an alarm (pinned)
+
     // Timing
     std::chrono::steady_clock::time_point m_recordingStartTime;
+    int64_t m_recordingStartWallMs = 0;
     std::chrono::steady_clock::time_point m_eventTriggerTime;
     int m_manualRecordingDuration;
 
+    // Writer thread and its input; the writer holds m_recordingMutex while it works.
+    // Queued frames with pixels are bounded separately (declared first: they
+    // hold slots of this counter until the queue is destroyed).
+    std::atomic<size_t> m_queuedPixelFrames{0};
+    std::atomic<uint64_t> m_droppedPixelFrames{0};
+    AISecurityVision::BoundedQueue<WriteJob> m_writeQueue{WRITE_QUEUE_CAPACITY};
+    std::thread m_writerThread;
+    std::atomic<bool> m_writerRunning{false};
+    std::mutex m_controlMutex;
+    std::deque<ControlCommand> m_controlCommands;   // Guarded by m_controlMutex
+    std::atomic<bool> m_continuousActive{false};
+    bool m_resyncPackets = false;       // Packets were dropped: skip to the next keyframe
+
+    // Write-path statistics
+    std::atomic<uint64_t> m_resyncs{0};
+    std::atomic<double> m_writeLatencyMs{0.0};
+    std::atomic<double> m_maxWriteLatencyMs{0.0};
+
     // Thread safety
     mutable std::mutex m_recordingMutex;
+
+    static constexpr size_t WRITE_QUEUE_CAPACITY = 512;        // ~10 s of packets and frames at 25 fps
+    static constexpr size_t MAX_QUEUED_PIXEL_FRAMES = 8;       // ~50 MB of 1080p frames awaiting re-encode
+    static constexpr auto WRITER_IDLE_TIMEOUT = std::chrono::milliseconds(200);
+    static constexpr double LATENCY_EMA_ALPHA = 0.05;
 };
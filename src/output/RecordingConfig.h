@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Event recording configuration
+ *
+ * PASSTHROUGH remuxes the camera's compressed packets (no decode, no
+ * re-encode) and stores the detections in a sidecar file next to each video;
+ * BURNED_IN re-encodes the analysed frames with the overlays drawn in. Pre-event
+ * footage and continuous segments need PASSTHROUGH. MKV survives an unclean
+ * stop (MP4 needs its trailer to be playable).
+ */
+struct RecordingConfig {
+    enum class Mode { PASSTHROUGH, BURNED_IN };
+
+    int preEventDuration = 30;   // seconds before event
+    int postEventDuration = 30;  // seconds after event
+    int preEventMaxMB = 32;      // Memory limit of the pre-event packet ring
+    std::string outputDir = "./recordings";
+    int maxFileSize = 100;       // MB
+    bool enableTimestamp = true;
+    bool enableBBoxOverlay = true;
+
+    Mode mode = Mode::PASSTHROUGH;
+    std::string container = "mp4";  // Passthrough container: "mp4" or "mkv"
+    bool overlaySidecar = true;     // Passthrough: detections as JSON lines (<video>.overlays.jsonl)
+    bool continuous = false;        // Passthrough: record all the time in fixed-duration segments
+    int segmentDuration = 300;      // seconds per continuous segment (cut at the next keyframe)
+
+    /**
+     * @brief Directory of a camera's continuous segments and their SegmentIndex
+     */
+    std::string continuousDirectory(const std::string& sourceId) const;
+
+    static const char* modeName(Mode mode);
+    static bool parseMode(const std::string& name, Mode& mode);
+};
+
+/**
+ * @brief Recorder write-path statistics of one camera
+ */
+struct RecorderStats {
+    size_t backlog = 0;             // Packets and frames waiting for the writer thread
+    size_t queueCapacity = 0;
+    uint64_t droppedItems = 0;      // Discarded by the drop-oldest overflow policy
+    uint64_t droppedFrames = 0;     // Frames not re-encoded because too many were queued
+    uint64_t resyncs = 0;           // Times packet writing resumed at a keyframe after drops
+    double writeLatencyMs = 0.0;    // Average time to write one queued item
+    double maxWriteLatencyMs = 0.0;
+    size_t preEventBytes = 0;
+    bool recording = false;
+    bool continuous = false;
+};
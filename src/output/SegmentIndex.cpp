@@ -0,0 +1,593 @@
+#include "SegmentIndex.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../core/Logger.h"
+using namespace AISecurityVision;
+
+namespace {
+
+// Record layouts of the index files (native byte order, never reordered)
+struct SegmentRecord {
+    int64_t startMs;
+    int64_t endMs;
+    uint64_t bytes;
+    uint32_t flags;
+    uint32_t number;        // Segment number with FLAG_NUMBERED, else the record index (never compacted)
+    char fileName[96];
+};
+static_assert(sizeof(SegmentRecord) == 128, "segments.idx record size is part of the file format");
+
+struct KeyframeRecord {
+    int64_t wallMs;
+    int64_t offsetMs;
+    uint64_t byteOffset;
+    uint32_t segment;
+    uint32_t reserved;
+};
+static_assert(sizeof(KeyframeRecord) == 32, "keyframes.idx record size is part of the file format");
+
+constexpr uint32_t FLAG_COMPLETE = 1;
+constexpr uint32_t FLAG_PINNED = 2;
+constexpr uint32_t FLAG_DELETED = 4;
+constexpr uint32_t FLAG_NUMBERED = 8;
+
+constexpr size_t COPY_CHUNK_RECORDS = 4096;     // Keyframe records copied per read during compaction
+
+struct ReadOnlyFile {
+    explicit ReadOnlyFile(const std::string& path) : fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC)) {}
+    ~ReadOnlyFile() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    int fd;
+};
+
+template <typename Record>
+uint64_t recordCount(int fd) {
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(st.st_size) / sizeof(Record);
+}
+
+template <typename Record>
+bool readRecord(int fd, uint64_t index, Record& record) {
+    return pread(fd, &record, sizeof(Record), static_cast<off_t>(index * sizeof(Record)))
+        == static_cast<ssize_t>(sizeof(Record));
+}
+
+/**
+ * Index of the last record whose key is <= value, -1 if there is none.
+ * Keys are non-decreasing because records are appended in time order.
+ */
+template <typename Record, typename Key>
+int64_t lastAtOrBefore(int fd, uint64_t count, int64_t value, Key key) {
+    uint64_t low = 0;
+    uint64_t high = count;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        Record record;
+        if (readRecord(fd, mid, record) && key(record) <= value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return static_cast<int64_t>(low) - 1;
+}
+
+uint32_t recordNumber(const SegmentRecord& record, uint64_t index) {
+    return (record.flags & FLAG_NUMBERED) ? record.number : static_cast<uint32_t>(index);
+}
+
+/**
+ * Record index of a segment number, -1 if it is not in the file.
+ * Numbers increase with the record index; compaction only leaves gaps.
+ */
+int64_t findRecord(int fd, uint32_t number) {
+    uint64_t count = recordCount<SegmentRecord>(fd);
+    uint64_t low = 0;
+    uint64_t high = count;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        SegmentRecord record;
+        if (!readRecord(fd, mid, record)) {
+            return -1;
+        }
+        uint32_t midNumber = recordNumber(record, mid);
+        if (midNumber == number) {
+            return static_cast<int64_t>(mid);
+        }
+        if (midNumber < number) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return -1;
+}
+
+bool updateFlags(const std::string& directory, uint32_t number, uint32_t set, uint32_t clear) {
+    int fd = ::open((directory + "/" + SegmentIndex::SEGMENTS_FILE).c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Only finished records are updated; the writer no longer touches them
+    SegmentRecord record;
+    bool updated = false;
+    int64_t index = findRecord(fd, number);
+    if (index >= 0 && readRecord(fd, static_cast<uint64_t>(index), record) && (record.flags & FLAG_COMPLETE)) {
+        uint32_t flags = (record.flags | set) & ~clear;
+        off_t position = static_cast<off_t>(index) * sizeof(SegmentRecord) + offsetof(SegmentRecord, flags);
+        updated = pwrite(fd, &flags, sizeof(flags), position) == static_cast<ssize_t>(sizeof(flags));
+    }
+    ::close(fd);
+    return updated;
+}
+
+bool writeAll(int fd, const void* data, size_t size) {
+    return write(fd, data, size) == static_cast<ssize_t>(size);
+}
+
+bool replaceFile(int fd, const std::string& tempPath, const std::string& path) {
+    bool ok = fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t sizeOrZero(const std::string& path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+}
+
+bool lastKeyframe(int fd, KeyframeRecord& record) {
+    uint64_t count = recordCount<KeyframeRecord>(fd);
+    return count > 0 && readRecord(fd, count - 1, record);
+}
+
+SegmentIndex::Segment toSegment(uint32_t number, const SegmentRecord& record, int keyframesFd) {
+    SegmentIndex::Segment segment;
+    segment.number = number;
+    segment.startMs = record.startMs;
+    segment.endMs = record.endMs;
+    segment.bytes = record.bytes;
+    segment.complete = (record.flags & FLAG_COMPLETE) != 0;
+    segment.pinned = (record.flags & FLAG_PINNED) != 0;
+    segment.fileName.assign(record.fileName, strnlen(record.fileName, sizeof(record.fileName)));
+
+    // Still being written: it reaches at least its latest keyframe
+    if (!segment.complete) {
+        KeyframeRecord keyframe;
+        segment.endMs = segment.startMs;
+        if (lastKeyframe(keyframesFd, keyframe) && keyframe.segment == number) {
+            segment.endMs = std::max(segment.startMs, keyframe.wallMs);
+        }
+    }
+    return segment;
+}
+
+} // namespace
+
+/**
+ * @brief Serializes the writer, flag updates and compaction of one index directory
+ *
+ * compact() replaces the files, so the writer reopens them when the
+ * generation changes. Readers open the files per call and need no lock:
+ * every version of a file is complete and segment numbers never change.
+ */
+struct SegmentIndex::DirectoryLock {
+    std::mutex mutex;
+    uint64_t generation = 0;
+};
+
+std::shared_ptr<SegmentIndex::DirectoryLock> SegmentIndex::lockFor(const std::string& directory) {
+    static std::mutex registryMutex;
+    static std::unordered_map<std::string, std::shared_ptr<DirectoryLock>> registry;
+
+    std::error_code ec;
+    auto canonical = std::filesystem::weakly_canonical(directory, ec);
+    std::string key = ec ? std::filesystem::path(directory).lexically_normal().string() : canonical.string();
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto& entry = registry[key];
+    if (!entry) {
+        entry = std::make_shared<DirectoryLock>();
+    }
+    return entry;
+}
+
+SegmentIndex::SegmentIndex() = default;
+
+SegmentIndex::~SegmentIndex() {
+    close();
+}
+
+bool SegmentIndex::open(const std::string& directory) {
+    if (isOpen() && directory == m_directory) {
+        return true;
+    }
+    close();
+
+    try {
+        std::filesystem::create_directories(directory);
+    } catch (const std::exception& e) {
+        LOG_ERROR() << "[SegmentIndex] Failed to create " << directory << ": " << e.what();
+        return false;
+    }
+
+    m_directory = directory;
+    m_lock = lockFor(directory);
+    std::lock_guard<std::mutex> lock(m_lock->mutex);
+    m_generation = m_lock->generation;
+    if (!openFiles()) {
+        LOG_ERROR() << "[SegmentIndex] Failed to open the index files in " << directory
+                    << ": " << std::strerror(errno);
+        closeFiles();
+        m_lock.reset();
+        m_directory.clear();
+        return false;
+    }
+
+    // Drop a record torn by a crash mid-write
+    if (ftruncate(m_segmentsFd, static_cast<off_t>(m_segmentCount) * sizeof(SegmentRecord)) != 0 ||
+        ftruncate(m_keyframesFd, static_cast<off_t>(recordCount<KeyframeRecord>(m_keyframesFd)) * sizeof(KeyframeRecord)) != 0) {
+        LOG_WARN() << "[SegmentIndex] Failed to trim the index files in " << directory;
+    }
+
+    SegmentRecord last;
+    m_nextNumber = 0;
+    if (m_segmentCount > 0 && readRecord(m_segmentsFd, m_segmentCount - 1, last)) {
+        m_nextNumber = recordNumber(last, m_segmentCount - 1) + 1;
+    }
+
+    repairUnfinishedSegment();
+    return true;
+}
+
+bool SegmentIndex::openFiles() {
+    // segments.idx is rewritten in place when a segment ends, so it is not
+    // O_APPEND (Linux pwrite ignores the offset on O_APPEND files)
+    std::string segmentsPath = m_directory + "/" + SEGMENTS_FILE;
+    std::string keyframesPath = m_directory + "/" + KEYFRAMES_FILE;
+    m_segmentsFd = ::open(segmentsPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    m_keyframesFd = ::open(keyframesPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    m_segmentCount = static_cast<uint32_t>(recordCount<SegmentRecord>(m_segmentsFd));
+    return m_segmentsFd >= 0 && m_keyframesFd >= 0;
+}
+
+void SegmentIndex::closeFiles() {
+    if (m_segmentsFd >= 0) {
+        ::close(m_segmentsFd);
+    }
+    if (m_keyframesFd >= 0) {
+        ::close(m_keyframesFd);
+    }
+    m_segmentsFd = -1;
+    m_keyframesFd = -1;
+    m_segmentCount = 0;
+}
+
+void SegmentIndex::followCompaction() {
+    // Called with the directory lock held. Compaction keeps the last record,
+    // so a segment being written is still the last one after reopening.
+    if (m_generation == m_lock->generation) {
+        return;
+    }
+    m_generation = m_lock->generation;
+    closeFiles();
+    if (!openFiles()) {
+        LOG_ERROR() << "[SegmentIndex] Failed to reopen the compacted index in " << m_directory
+                    << ": " << std::strerror(errno);
+        closeFiles();
+        m_segmentOpen = false;
+    }
+}
+
+void SegmentIndex::close() {
+    closeFiles();
+    m_segmentOpen = false;
+    m_lock.reset();
+    m_directory.clear();
+}
+
+bool SegmentIndex::isOpen() const {
+    return m_segmentsFd >= 0;
+}
+
+const std::string& SegmentIndex::getDirectory() const {
+    return m_directory;
+}
+
+void SegmentIndex::beginSegment(const std::string& fileName, int64_t startMs) {
+    if (!m_lock) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_lock->mutex);
+    followCompaction();
+    if (!isOpen()) {
+        return;
+    }
+
+    SegmentRecord record{};
+    record.startMs = startMs;
+    record.flags = FLAG_NUMBERED;
+    record.number = m_nextNumber;
+    std::strncpy(record.fileName, fileName.c_str(), sizeof(record.fileName) - 1);
+    if (pwrite(m_segmentsFd, &record, sizeof(record), static_cast<off_t>(m_segmentCount) * sizeof(record))
+        != static_cast<ssize_t>(sizeof(record))) {
+        LOG_ERROR() << "[SegmentIndex] Failed to index segment " << fileName << ": " << std::strerror(errno);
+        m_segmentOpen = false;
+        return;
+    }
+    ++m_segmentCount;
+    m_currentNumber = m_nextNumber++;
+    m_currentFlags = record.flags;
+    m_segmentOpen = true;
+}
+
+void SegmentIndex::addKeyframe(int64_t wallMs, int64_t offsetMs, uint64_t byteOffset) {
+    if (!m_segmentOpen) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_lock->mutex);
+    followCompaction();
+    if (!m_segmentOpen) {
+        return;
+    }
+
+    KeyframeRecord record{};
+    record.wallMs = wallMs;
+    record.offsetMs = offsetMs;
+    record.byteOffset = byteOffset;
+    record.segment = m_currentNumber;
+    if (write(m_keyframesFd, &record, sizeof(record)) != static_cast<ssize_t>(sizeof(record))) {
+        LOG_WARN() << "[SegmentIndex] Failed to index keyframe: " << std::strerror(errno);
+    }
+}
+
+int64_t SegmentIndex::getCurrentSegment() const {
+    return m_segmentOpen ? static_cast<int64_t>(m_currentNumber) : -1;
+}
+
+void SegmentIndex::endSegment(int64_t endMs, uint64_t bytes) {
+    if (!m_segmentOpen) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_lock->mutex);
+    followCompaction();
+    if (!m_segmentOpen) {
+        return;
+    }
+    m_segmentOpen = false;
+
+    // Rewrite the tail of the record only; readers of the other fields are unaffected
+    struct {
+        int64_t endMs;
+        uint64_t bytes;
+        uint32_t flags;
+    } tail{endMs, bytes, m_currentFlags | FLAG_COMPLETE};
+    off_t position = static_cast<off_t>(m_segmentCount - 1) * sizeof(SegmentRecord) + offsetof(SegmentRecord, endMs);
+    if (pwrite(m_segmentsFd, &tail, offsetof(SegmentRecord, number) - offsetof(SegmentRecord, endMs), position) < 0) {
+        LOG_ERROR() << "[SegmentIndex] Failed to finish segment record: " << std::strerror(errno);
+    }
+}
+
+void SegmentIndex::repairUnfinishedSegment() {
+    // Called by open() with the directory lock held.
+    // A segment left open by a crash ends at its last indexed keyframe.
+    SegmentRecord record;
+    if (m_segmentCount == 0 || !readRecord(m_segmentsFd, m_segmentCount - 1, record) ||
+        (record.flags & FLAG_COMPLETE)) {
+        return;
+    }
+    uint32_t number = recordNumber(record, m_segmentCount - 1);
+
+    ReadOnlyFile keyframes(m_directory + "/" + KEYFRAMES_FILE);
+    KeyframeRecord keyframe;
+    int64_t endMs = record.startMs;
+    if (lastKeyframe(keyframes.fd, keyframe) && keyframe.segment == number) {
+        endMs = std::max(endMs, keyframe.wallMs);
+    }
+    std::error_code ec;
+    auto bytes = std::filesystem::file_size(m_directory + "/" + record.fileName, ec);
+
+    struct {
+        int64_t endMs;
+        uint64_t bytes;
+        uint32_t flags;
+    } tail{endMs, ec ? 0 : static_cast<uint64_t>(bytes), record.flags | FLAG_COMPLETE};
+    off_t position = static_cast<off_t>(m_segmentCount - 1) * sizeof(SegmentRecord) + offsetof(SegmentRecord, endMs);
+    if (pwrite(m_segmentsFd, &tail, offsetof(SegmentRecord, number) - offsetof(SegmentRecord, endMs), position) < 0) {
+        LOG_ERROR() << "[SegmentIndex] Failed to finish segment record: " << std::strerror(errno);
+        return;
+    }
+    LOG_INFO() << "[SegmentIndex] Closed unfinished segment " << record.fileName << " in " << m_directory;
+}
+
+std::vector<SegmentIndex::ClipPart> SegmentIndex::findRange(const std::string& directory,
+                                                            int64_t fromMs, int64_t toMs) {
+    std::vector<ClipPart> parts;
+    ReadOnlyFile segments(directory + "/" + SEGMENTS_FILE);
+    ReadOnlyFile keyframes(directory + "/" + KEYFRAMES_FILE);
+    uint64_t segmentCount = recordCount<SegmentRecord>(segments.fd);
+    if (fromMs > toMs || segmentCount == 0) {
+        return parts;
+    }
+
+    // The segment containing fromMs is the last one starting at or before it
+    int64_t first = lastAtOrBefore<SegmentRecord>(segments.fd, segmentCount, fromMs,
+                                                  [](const SegmentRecord& r) { return r.startMs; });
+    uint64_t keyframeCount = recordCount<KeyframeRecord>(keyframes.fd);
+
+    for (uint64_t i = static_cast<uint64_t>(std::max<int64_t>(first, 0)); i < segmentCount; ++i) {
+        SegmentRecord record;
+        if (!readRecord(segments.fd, i, record) || record.startMs > toMs) {
+            break;
+        }
+        if (record.flags & FLAG_DELETED) {
+            continue;
+        }
+        Segment segment = toSegment(recordNumber(record, i), record, keyframes.fd);
+        if (segment.endMs < fromMs) {
+            continue;   // Ends in a gap before the range
+        }
+
+        ClipPart part;
+        part.fromMs = std::max(fromMs, segment.startMs);
+        part.toMs = std::min(toMs, segment.endMs);
+        if (part.fromMs > segment.startMs) {
+            int64_t k = lastAtOrBefore<KeyframeRecord>(keyframes.fd, keyframeCount, part.fromMs,
+                                                       [](const KeyframeRecord& r) { return r.wallMs; });
+            KeyframeRecord keyframe;
+            if (k >= 0 && readRecord(keyframes.fd, static_cast<uint64_t>(k), keyframe) &&
+                keyframe.segment == segment.number) {
+                part.seekMs = keyframe.offsetMs;
+                part.byteOffset = keyframe.byteOffset;
+            }
+        }
+        part.segment = std::move(segment);
+        parts.push_back(std::move(part));
+    }
+    return parts;
+}
+
+std::vector<SegmentIndex::Segment> SegmentIndex::listSegments(const std::string& directory) {
+    std::vector<Segment> result;
+    ReadOnlyFile segments(directory + "/" + SEGMENTS_FILE);
+    ReadOnlyFile keyframes(directory + "/" + KEYFRAMES_FILE);
+    uint64_t count = recordCount<SegmentRecord>(segments.fd);
+    result.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        SegmentRecord record;
+        if (readRecord(segments.fd, i, record) && !(record.flags & FLAG_DELETED)) {
+            result.push_back(toSegment(recordNumber(record, i), record, keyframes.fd));
+        }
+    }
+    return result;
+}
+
+bool SegmentIndex::setPinned(const std::string& directory, uint32_t number, bool pinned) {
+    auto directoryLock = lockFor(directory);
+    std::lock_guard<std::mutex> lock(directoryLock->mutex);
+    return updateFlags(directory, number, pinned ? FLAG_PINNED : 0, pinned ? 0 : FLAG_PINNED);
+}
+
+bool SegmentIndex::markDeleted(const std::string& directory, uint32_t number) {
+    auto directoryLock = lockFor(directory);
+    std::lock_guard<std::mutex> lock(directoryLock->mutex);
+    return updateFlags(directory, number, FLAG_DELETED, FLAG_PINNED);
+}
+
+bool SegmentIndex::compact(const std::string& directory, uint32_t minDeleted) {
+    auto directoryLock = lockFor(directory);
+    std::lock_guard<std::mutex> lock(directoryLock->mutex);
+
+    std::string segmentsPath = directory + "/" + SEGMENTS_FILE;
+    std::string keyframesPath = directory + "/" + KEYFRAMES_FILE;
+    ReadOnlyFile segments(segmentsPath);
+    uint64_t count = recordCount<SegmentRecord>(segments.fd);
+
+    // Keep every live record and always the last one, which the writer may
+    // still be finishing and which carries the next segment number
+    std::vector<SegmentRecord> kept;
+    std::vector<uint32_t> deleted;      // Ascending
+    kept.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        SegmentRecord record;
+        if (!readRecord(segments.fd, i, record)) {
+            return false;
+        }
+        record.number = recordNumber(record, i);
+        record.flags |= FLAG_NUMBERED;
+        if ((record.flags & FLAG_DELETED) && i + 1 < count) {
+            deleted.push_back(record.number);
+        } else {
+            kept.push_back(record);
+        }
+    }
+    if (deleted.empty() || deleted.size() < minDeleted) {
+        return false;
+    }
+
+    // Keyframes are copied in chunks: the file can be far larger than segments.idx
+    std::string keyframesTemp = keyframesPath + ".tmp";
+    int keyframesOut = ::open(keyframesTemp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (keyframesOut < 0) {
+        LOG_WARN() << "[SegmentIndex] Failed to compact " << directory << ": " << std::strerror(errno);
+        return false;
+    }
+    ReadOnlyFile keyframes(keyframesPath);
+    uint64_t keyframeCount = recordCount<KeyframeRecord>(keyframes.fd);
+    uint64_t keptKeyframes = 0;
+    bool ok = true;
+    std::vector<KeyframeRecord> chunk(COPY_CHUNK_RECORDS);
+    for (uint64_t offset = 0; ok && offset < keyframeCount; offset += COPY_CHUNK_RECORDS) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(COPY_CHUNK_RECORDS, keyframeCount - offset));
+        ssize_t bytes = pread(keyframes.fd, chunk.data(), n * sizeof(KeyframeRecord),
+                              static_cast<off_t>(offset * sizeof(KeyframeRecord)));
+        if (bytes != static_cast<ssize_t>(n * sizeof(KeyframeRecord))) {
+            ok = false;
+            break;
+        }
+        auto end = std::remove_if(chunk.begin(), chunk.begin() + n, [&deleted](const KeyframeRecord& r) {
+            return std::binary_search(deleted.begin(), deleted.end(), r.segment);
+        });
+        size_t live = static_cast<size_t>(end - chunk.begin());
+        keptKeyframes += live;
+        ok = writeAll(keyframesOut, chunk.data(), live * sizeof(KeyframeRecord));
+    }
+    if (!ok) {
+        ::close(keyframesOut);
+        ::unlink(keyframesTemp.c_str());
+    }
+    if (!ok || !replaceFile(keyframesOut, keyframesTemp, keyframesPath)) {
+        LOG_WARN() << "[SegmentIndex] Failed to compact the keyframes of " << directory;
+        return false;
+    }
+
+    // Dropped keyframes only belonged to deleted segments, so the new
+    // keyframes.idx is valid with the old segments.idx in the meantime
+    std::string segmentsTemp = segmentsPath + ".tmp";
+    int segmentsOut = ::open(segmentsTemp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (segmentsOut < 0 || !writeAll(segmentsOut, kept.data(), kept.size() * sizeof(SegmentRecord))) {
+        if (segmentsOut >= 0) {
+            ::close(segmentsOut);
+            ::unlink(segmentsTemp.c_str());
+        }
+        ++directoryLock->generation;    // keyframes.idx was replaced
+        LOG_WARN() << "[SegmentIndex] Failed to compact the segments of " << directory;
+        return false;
+    }
+    bool replaced = replaceFile(segmentsOut, segmentsTemp, segmentsPath);
+    ++directoryLock->generation;
+    if (!replaced) {
+        LOG_WARN() << "[SegmentIndex] Failed to compact the segments of " << directory;
+        return false;
+    }
+
+    LOG_INFO() << "[SegmentIndex] Compacted " << directory << ": dropped " << deleted.size()
+              << " deleted segments and " << (keyframeCount - keptKeyframes) << " keyframes";
+    return true;
+}
+
+uint64_t SegmentIndex::diskBytes(const std::string& directory) {
+    return sizeOrZero(directory + "/" + SEGMENTS_FILE) + sizeOrZero(directory + "/" + KEYFRAMES_FILE);
+}
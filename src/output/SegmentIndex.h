@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief On-disk time index of one camera's continuous recording segments
+ *
+ * Two append-only files of fixed-size records live next to the segments:
+ * - segments.idx: one record per segment (first/last packet wall time, size, file name)
+ * - keyframes.idx: wall time, offset into the segment and byte position of every keyframe
+ *
+ * Records are appended in time order, so a wall-clock range resolves with
+ * binary searches over the records (pread, O(log n)) without listing the
+ * directory or opening a video. The camera's Recorder is the only writer;
+ * readers (API) work on the files directly and only ever see whole records.
+ * StorageManager flags finished segments as pinned or deleted in place;
+ * deleted segments are skipped by the readers, and compact() drops them from
+ * both files (rewritten and renamed into place) so the index stays bounded.
+ * Segment numbers are stored in the records and survive compaction.
+ */
+class SegmentIndex {
+public:
+    struct Segment {
+        uint32_t number = 0;        // Segment number, stable across compaction
+        int64_t startMs = 0;        // Wall time of the first packet
+        int64_t endMs = 0;          // Wall time of the last packet (last keyframe while recording)
+        uint64_t bytes = 0;         // File size, 0 while recording
+        bool complete = false;      // Closed; an open MP4 is not playable yet
+        bool pinned = false;        // Referenced by an alarm (see StorageManager)
+        std::string fileName;
+    };
+
+    /**
+     * @brief The part of one segment that covers (part of) a requested range
+     */
+    struct ClipPart {
+        Segment segment;
+        int64_t fromMs = 0;         // Requested range clipped to the segment, wall time
+        int64_t toMs = 0;
+        int64_t seekMs = 0;         // Offset into the segment of the keyframe at or before fromMs
+        uint64_t byteOffset = 0;    // Muxer output position at or before that keyframe's data
+    };
+
+    SegmentIndex();
+    ~SegmentIndex();
+
+    SegmentIndex(const SegmentIndex&) = delete;
+    SegmentIndex& operator=(const SegmentIndex&) = delete;
+
+    // Writer (Recorder)
+    bool open(const std::string& directory);
+    void close();
+    bool isOpen() const;
+    const std::string& getDirectory() const;
+
+    void beginSegment(const std::string& fileName, int64_t startMs);
+    void addKeyframe(int64_t wallMs, int64_t offsetMs, uint64_t byteOffset);
+    void endSegment(int64_t endMs, uint64_t bytes);
+    int64_t getCurrentSegment() const;      // Number of the segment being written, -1 if none
+
+    // Readers
+    /**
+     * @brief Segments overlapping [fromMs, toMs] in time order, with the seek point into the first one
+     */
+    static std::vector<ClipPart> findRange(const std::string& directory, int64_t fromMs, int64_t toMs);
+
+    /**
+     * @brief All segments that were not deleted, oldest first
+     */
+    static std::vector<Segment> listSegments(const std::string& directory);
+
+    // Flags of finished segments, written in place
+    static bool setPinned(const std::string& directory, uint32_t number, bool pinned);
+    static bool markDeleted(const std::string& directory, uint32_t number);
+
+    /**
+     * @brief Rewrite the index without deleted segments and their keyframes
+     * @return true if at least minDeleted segments were dropped
+     */
+    static bool compact(const std::string& directory, uint32_t minDeleted);
+
+    /**
+     * @brief Size of the index files on disk
+     */
+    static uint64_t diskBytes(const std::string& directory);
+
+    static constexpr const char* SEGMENTS_FILE = "segments.idx";
+    static constexpr const char* KEYFRAMES_FILE = "keyframes.idx";
+
+private:
+    struct DirectoryLock;
+    static std::shared_ptr<DirectoryLock> lockFor(const std::string& directory);
+
+    bool openFiles();
+    void closeFiles();
+    void followCompaction();
+    void repairUnfinishedSegment();
+
+    std::string m_directory;
+    std::shared_ptr<DirectoryLock> m_lock;     // Shared with compact() and the flag updates
+    uint64_t m_generation = 0;                 // Compactions seen; the files are reopened after one
+    int m_segmentsFd = -1;
+    int m_keyframesFd = -1;
+    uint32_t m_segmentCount = 0;               // Records in segments.idx
+    uint32_t m_nextNumber = 0;
+    uint32_t m_currentNumber = 0;
+    uint32_t m_currentFlags = 0;
+    bool m_segmentOpen = false;
+};
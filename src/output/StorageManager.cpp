@@ -0,0 +1,546 @@
+#include "StorageManager.h"
+#include "SegmentIndex.h"
+#include "OverlaySidecar.h"
+#include "../database/DatabaseManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <unordered_map>
+
+#include "../core/Logger.h"
+using namespace AISecurityVision;
+
+namespace {
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint64_t sizeOrZero(const std::string& path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+}
+
+std::string parentDirectory(const std::string& path) {
+    return std::filesystem::path(path).parent_path().string();
+}
+
+std::string normalizedPath(const std::string& path) {
+    return std::filesystem::path(path).lexically_normal().string();
+}
+
+bool isVideoFile(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    return extension == ".mp4" || extension == ".mkv" || extension == ".avi";
+}
+
+} // namespace
+
+StorageManager& StorageManager::getInstance() {
+    static StorageManager instance;
+    return instance;
+}
+
+StorageManager::~StorageManager() {
+    stop();
+}
+
+void StorageManager::start(const std::string& outputDir, const StorageQuota& quota,
+                           const std::vector<std::string>& cameraIds) {
+    if (m_running.load()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_outputDir = outputDir;
+        m_quota = quota;
+    }
+
+    // Used by start() and the eviction thread only
+    m_database = std::make_unique<DatabaseManager>();
+    if (!m_database->initialize()) {
+        LOG_WARN() << "[StorageManager] Database unavailable: event clips are not pinned and their events "
+                   << "keep the paths of evicted clips";
+        m_database.reset();
+    }
+    loadExisting(cameraIds);
+
+    m_running.store(true);
+    m_thread = std::thread(&StorageManager::evictionLoop, this);
+
+    StorageStats stats = getStats();
+    LOG_INFO() << "[StorageManager] Indexed " << stats.files << " recordings (" << stats.totalBytes / (1024 * 1024)
+              << " MB) in " << outputDir << ", quota " << quota.totalBytes / (1024 * 1024) << " MB total, "
+              << quota.cameraBytes / (1024 * 1024) << " MB per camera (0 = unlimited)";
+}
+
+void StorageManager::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_dirty = true;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void StorageManager::setQuota(const StorageQuota& quota) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quota = quota;
+        m_dirty = true;
+    }
+    m_wake.notify_one();
+}
+
+StorageQuota StorageManager::getQuota() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_quota;
+}
+
+void StorageManager::setCameraQuota(const std::string& cameraId, uint64_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cameras[cameraId].quotaBytes = bytes;
+        m_dirty = true;
+    }
+    m_wake.notify_one();
+}
+
+void StorageManager::addFile(const std::string& cameraId, const std::string& path, int64_t startMs, int64_t endMs,
+                             bool alarm, int64_t segment) {
+    // Sizes are read here, on the recorder's writer thread, not under the lock
+    Entry entry;
+    entry.path = path;
+    entry.startMs = startMs;
+    entry.endMs = std::max(startMs, endMs);
+    entry.bytes = sizeOrZero(path) + sizeOrZero(OverlaySidecar::pathFor(path));
+    entry.segment = segment;
+    if (entry.bytes == 0) {
+        return;     // Nothing was written
+    }
+    uint64_t indexBytes = segment >= 0 ? SegmentIndex::diskBytes(parentDirectory(path)) : 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (alarm) {
+            entry.pinnedUntilMs = pinDeadline(entry.endMs);
+        }
+        insert(cameraId, std::move(entry));
+        if (segment >= 0) {
+            setIndexBytes(cameraId, indexBytes);
+        }
+        m_dirty = true;
+    }
+    m_wake.notify_one();
+
+    if (alarm && segment >= 0) {
+        SegmentIndex::setPinned(parentDirectory(path), static_cast<uint32_t>(segment), true);
+    }
+}
+
+void StorageManager::pinRange(const std::string& cameraId, int64_t fromMs, int64_t toMs) {
+    std::vector<std::pair<std::string, int64_t>> segments;     // Index directory, number
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_cameras.find(cameraId);
+        if (it == m_cameras.end()) {
+            return;
+        }
+
+        // Clips and segments share the index, so overlapping entries may start
+        // anywhere up to the camera's longest entry before fromMs
+        auto& entries = it->second.entries;
+        auto entry = entries.lower_bound(fromMs - it->second.maxDurationMs);
+        for (; entry != entries.end() && entry->first <= toMs; ++entry) {
+            if (entry->second.endMs < fromMs) {
+                continue;
+            }
+            setPinnedUntil(it->first, it->second, entry,
+                           std::max(entry->second.pinnedUntilMs, pinDeadline(entry->second.endMs)));
+            if (entry->second.segment >= 0) {
+                segments.emplace_back(parentDirectory(entry->second.path), entry->second.segment);
+            }
+        }
+    }
+
+    for (const auto& segment : segments) {
+        SegmentIndex::setPinned(segment.first, static_cast<uint32_t>(segment.second), true);
+    }
+}
+
+void StorageManager::unpinFile(const std::string& path) {
+    int64_t segment = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto location = m_byPath.find(path);
+        if (location == m_byPath.end()) {
+            return;
+        }
+        Camera& camera = m_cameras[location->second.first];
+        auto range = camera.entries.equal_range(location->second.second);
+        for (auto entry = range.first; entry != range.second; ++entry) {
+            if (entry->second.path == path) {
+                setPinnedUntil(location->second.first, camera, entry, 0);
+                segment = entry->second.segment;
+                break;
+            }
+        }
+        m_dirty = true;
+    }
+    m_wake.notify_one();
+
+    if (segment >= 0) {
+        SegmentIndex::setPinned(parentDirectory(path), static_cast<uint32_t>(segment), false);
+    }
+}
+
+void StorageManager::forgetFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto location = m_byPath.find(path);
+    if (location == m_byPath.end()) {
+        return;
+    }
+    Camera& camera = m_cameras[location->second.first];
+    auto range = camera.entries.equal_range(location->second.second);
+    for (auto entry = range.first; entry != range.second; ++entry) {
+        if (entry->second.path == path) {
+            unindexEntry(location->second.first, camera, entry);
+            camera.bytes -= entry->second.bytes;
+            m_totalBytes -= entry->second.bytes;
+            camera.entries.erase(entry);
+            break;
+        }
+    }
+    m_byPath.erase(location);
+}
+
+StorageStats StorageManager::getStats() const {
+    StorageStats stats;
+    int64_t now = nowMs();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.totalBytes = m_totalBytes;
+    stats.quotaBytes = m_quota.totalBytes;
+    stats.files = m_byPath.size();
+    stats.cameras = m_cameras.size();
+    stats.evictedFiles = m_evictedFiles.load();
+    stats.evictedBytes = m_evictedBytes.load();
+
+    // Pins expired since the last eviction pass are still in m_pins
+    stats.pinnedBytes = m_pinnedBytes;
+    for (auto pin = m_pins.begin(); pin != m_pins.end() && pin->first.first <= now; ++pin) {
+        stats.pinnedBytes -= pin->second.entry->second.bytes;
+    }
+    for (const auto& camera : m_cameras) {
+        stats.indexBytes += camera.second.indexBytes;
+        if (!camera.second.entries.empty()) {
+            int64_t oldest = camera.second.entries.begin()->first;
+            stats.oldestMs = stats.oldestMs == 0 ? oldest : std::min(stats.oldestMs, oldest);
+        }
+    }
+    return stats;
+}
+
+uint64_t StorageManager::getCameraBytes(const std::string& cameraId) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_cameras.find(cameraId);
+    return it != m_cameras.end() ? it->second.bytes : 0;
+}
+
+void StorageManager::loadExisting(const std::vector<std::string>& cameraIds) {
+    // The only directory walk: continuous segments come from their indexes,
+    // event clips from the top level of the output directory
+    namespace fs = std::filesystem;
+    std::vector<std::string> knownCameras = cameraIds;
+    std::error_code ec;
+    int64_t now = nowMs();
+
+    // Clips recorded for an event: camera, whether any of their events is an
+    // alarm (manual recordings are not), and the path as the events table has it
+    struct ClipEvent {
+        std::string cameraId;
+        std::string videoPath;
+        bool alarm = false;
+    };
+    std::unordered_map<std::string, ClipEvent> clipEvents;
+    if (m_database) {
+        for (const auto& event : m_database->getEventsWithVideo()) {
+            ClipEvent& clip = clipEvents[normalizedPath(event.video_path)];
+            clip.cameraId = event.camera_id;
+            clip.videoPath = event.video_path;
+            clip.alarm = clip.alarm || event.event_type != "manual";
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    fs::path continuous = fs::path(m_outputDir) / "continuous";
+    for (fs::directory_iterator it(continuous, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_directory()) {
+            continue;
+        }
+        std::string cameraId = it->path().filename().string();
+        knownCameras.push_back(cameraId);
+        std::string directory = it->path().string();
+        SegmentIndex::compact(directory, COMPACT_MIN_DELETED);
+        for (const auto& segment : SegmentIndex::listSegments(directory)) {
+            if (!segment.complete) {
+                continue;
+            }
+            Entry entry;
+            entry.path = directory + "/" + segment.fileName;
+            entry.startMs = segment.startMs;
+            entry.endMs = segment.endMs;
+            entry.bytes = segment.bytes + sizeOrZero(OverlaySidecar::pathFor(entry.path));
+            entry.segment = segment.number;
+            if (segment.pinned) {
+                entry.pinnedUntilMs = pinDeadline(segment.endMs);
+            }
+            insert(cameraId, std::move(entry));
+        }
+        setIndexBytes(cameraId, SegmentIndex::diskBytes(directory));
+    }
+
+    // Clips belong to the camera of their event. Clips without one are named
+    // <camera>_<event>_<date>_<time>: the longest known camera prefix wins,
+    // unknown ones only count against the global quota. Only clips with an
+    // alarm event are pinned.
+    std::sort(knownCameras.begin(), knownCameras.end(),
+              [](const std::string& a, const std::string& b) { return a.size() > b.size(); });
+    for (fs::directory_iterator it(m_outputDir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file() || !isVideoFile(it->path())) {
+            continue;
+        }
+        std::string name = it->path().filename().string();
+        auto clipEvent = clipEvents.find(normalizedPath(it->path().string()));
+        std::string cameraId;
+        if (clipEvent != clipEvents.end()) {
+            cameraId = clipEvent->second.cameraId;
+        } else {
+            for (const auto& known : knownCameras) {
+                if (name.compare(0, known.size() + 1, known + "_") == 0) {
+                    cameraId = known;
+                    break;
+                }
+            }
+        }
+
+        std::error_code timeEc;
+        auto modified = fs::last_write_time(it->path(), timeEc);
+        int64_t endMs = now;
+        if (!timeEc) {
+            auto age = fs::file_time_type::clock::now() - modified;
+            endMs = now - std::chrono::duration_cast<std::chrono::milliseconds>(age).count();
+        }
+
+        // Keep the events table's spelling of the path, eviction clears it by path
+        Entry entry;
+        entry.path = clipEvent != clipEvents.end() ? clipEvent->second.videoPath : it->path().string();
+        entry.startMs = endMs;
+        entry.endMs = endMs;
+        entry.bytes = sizeOrZero(entry.path) + sizeOrZero(OverlaySidecar::pathFor(entry.path));
+        if (clipEvent != clipEvents.end() && clipEvent->second.alarm) {
+            entry.pinnedUntilMs = pinDeadline(endMs);
+        }
+        insert(cameraId, std::move(entry));
+    }
+    m_dirty = true;
+}
+
+void StorageManager::insert(const std::string& cameraId, Entry entry) {
+    auto existing = m_byPath.find(entry.path);
+    if (existing != m_byPath.end()) {
+        return;     // Already indexed (e.g. at start())
+    }
+    Camera& camera = m_cameras[cameraId];
+    camera.bytes += entry.bytes;
+    camera.maxDurationMs = std::max(camera.maxDurationMs, entry.endMs - entry.startMs);
+    m_totalBytes += entry.bytes;
+    m_byPath.emplace(entry.path, std::make_pair(cameraId, entry.startMs));
+    entry.id = m_nextEntryId++;
+    indexEntry(cameraId, camera, camera.entries.emplace(entry.startMs, std::move(entry)));
+}
+
+void StorageManager::evictionLoop() {
+    while (m_running.load()) {
+        std::vector<Victim> victims;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait_for(lock, RECHECK_INTERVAL, [this] { return m_dirty || !m_running.load(); });
+            if (!m_running.load()) {
+                break;
+            }
+            m_dirty = false;
+            victims = selectVictims(nowMs());
+        }
+
+        for (const auto& victim : victims) {
+            deleteFiles(victim);
+            if (victim.entry.segment >= 0) {
+                std::string directory = parentDirectory(victim.entry.path);
+                if (++m_deletedSegments[directory] >= COMPACT_MIN_DELETED) {
+                    compactIndex(victim.cameraId, directory);
+                }
+            }
+        }
+
+        // A full batch means the quota may still be exceeded: go again
+        // without waiting, giving writers the lock in between
+        if (victims.size() == EVICTION_BATCH) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_dirty = true;
+        }
+    }
+}
+
+std::vector<StorageManager::Victim> StorageManager::selectVictims(int64_t nowMs) {
+    std::vector<Victim> victims;
+    expirePins(nowMs);
+
+    auto take = [this, &victims](const std::string& cameraId, Camera& camera, EntryIt entry) {
+        unindexEntry(cameraId, camera, entry);
+        camera.bytes -= entry->second.bytes;
+        m_totalBytes -= entry->second.bytes;
+        m_byPath.erase(entry->second.path);
+        victims.push_back(Victim{cameraId, std::move(entry->second)});
+        camera.entries.erase(entry);
+    };
+
+    // Per-camera quotas first: they only evict the camera's own files. Clips
+    // of unknown cameras (indexed under "") only count against the global quota.
+    for (auto& [cameraId, camera] : m_cameras) {
+        if (cameraId.empty()) {
+            continue;
+        }
+        uint64_t quota = cameraQuota(camera);
+        while (quota > 0 && camera.bytes > quota && victims.size() < EVICTION_BATCH) {
+            if (camera.unpinned.empty()) {
+                break;
+            }
+            take(cameraId, camera, camera.unpinned.begin()->second);
+        }
+    }
+
+    // Then the global quota: the oldest unpinned file of any camera
+    while (m_quota.totalBytes > 0 && m_totalBytes > m_quota.totalBytes && victims.size() < EVICTION_BATCH) {
+        if (m_unpinnedHeads.empty()) {
+            break;      // Everything left is pinned
+        }
+        std::string cameraId = m_unpinnedHeads.begin()->second;
+        Camera& camera = m_cameras[cameraId];
+        take(cameraId, camera, camera.unpinned.begin()->second);
+    }
+
+    if (victims.empty() && m_quota.totalBytes > 0 && m_totalBytes > m_quota.totalBytes) {
+        LOG_WARN() << "[StorageManager] Over quota (" << m_totalBytes / (1024 * 1024) << " of "
+                  << m_quota.totalBytes / (1024 * 1024) << " MB) but all recordings are pinned";
+    }
+    return victims;
+}
+
+void StorageManager::indexEntry(const std::string& cameraId, Camera& camera, EntryIt entry) {
+    if (entry->second.pinnedUntilMs != 0) {
+        m_pins.emplace(EntryKey(entry->second.pinnedUntilMs, entry->second.id), Pin{cameraId, entry});
+        m_pinnedBytes += entry->second.bytes;
+    } else {
+        camera.unpinned.emplace(EntryKey(entry->first, entry->second.id), entry);
+        updateHead(cameraId, camera);
+    }
+}
+
+void StorageManager::unindexEntry(const std::string& cameraId, Camera& camera, EntryIt entry) {
+    if (entry->second.pinnedUntilMs != 0) {
+        m_pins.erase(EntryKey(entry->second.pinnedUntilMs, entry->second.id));
+        m_pinnedBytes -= entry->second.bytes;
+    } else {
+        camera.unpinned.erase(EntryKey(entry->first, entry->second.id));
+        updateHead(cameraId, camera);
+    }
+}
+
+void StorageManager::setPinnedUntil(const std::string& cameraId, Camera& camera, EntryIt entry,
+                                    int64_t pinnedUntilMs) {
+    if (entry->second.pinnedUntilMs == pinnedUntilMs) {
+        return;
+    }
+    unindexEntry(cameraId, camera, entry);
+    entry->second.pinnedUntilMs = pinnedUntilMs;
+    indexEntry(cameraId, camera, entry);
+}
+
+void StorageManager::updateHead(const std::string& cameraId, Camera& camera) {
+    if (camera.headQueued) {
+        m_unpinnedHeads.erase(std::make_pair(camera.headMs, cameraId));
+        camera.headQueued = false;
+    }
+    if (!camera.unpinned.empty()) {
+        camera.headMs = camera.unpinned.begin()->first.first;
+        camera.headQueued = true;
+        m_unpinnedHeads.emplace(camera.headMs, cameraId);
+    }
+}
+
+void StorageManager::expirePins(int64_t nowMs) {
+    while (!m_pins.empty() && m_pins.begin()->first.first <= nowMs) {
+        Pin pin = m_pins.begin()->second;
+        setPinnedUntil(pin.cameraId, m_cameras[pin.cameraId], pin.entry, 0);
+    }
+}
+
+uint64_t StorageManager::cameraQuota(const Camera& camera) const {
+    return camera.quotaBytes > 0 ? camera.quotaBytes : m_quota.cameraBytes;
+}
+
+int64_t StorageManager::pinDeadline(int64_t endMs) const {
+    if (m_quota.alarmRetentionDays <= 0) {
+        return std::numeric_limits<int64_t>::max();
+    }
+    return endMs + static_cast<int64_t>(m_quota.alarmRetentionDays) * 24 * 3600 * 1000;
+}
+
+void StorageManager::deleteFiles(const Victim& victim) {
+    std::error_code ec;
+    std::filesystem::remove(victim.entry.path, ec);
+    if (ec) {
+        LOG_WARN() << "[StorageManager] Failed to delete " << victim.entry.path << ": " << ec.message();
+    }
+    std::filesystem::remove(OverlaySidecar::pathFor(victim.entry.path), ec);
+
+    if (victim.entry.segment >= 0) {
+        SegmentIndex::markDeleted(parentDirectory(victim.entry.path), static_cast<uint32_t>(victim.entry.segment));
+    } else if (m_database && !m_database->clearEventVideoPath(victim.entry.path)) {
+        LOG_WARN() << "[StorageManager] Failed to clear the event of " << victim.entry.path << ": "
+                  << m_database->getErrorMessage();
+    }
+
+    m_evictedFiles.fetch_add(1);
+    m_evictedBytes.fetch_add(victim.entry.bytes);
+    LOG_DEBUG() << "[StorageManager] Evicted " << victim.entry.path << " ("
+               << victim.entry.bytes / 1024 << " KB, camera " << victim.cameraId << ")";
+}
+
+void StorageManager::setIndexBytes(const std::string& cameraId, uint64_t bytes) {
+    Camera& camera = m_cameras[cameraId];
+    camera.bytes = camera.bytes - camera.indexBytes + bytes;
+    m_totalBytes = m_totalBytes - camera.indexBytes + bytes;
+    camera.indexBytes = bytes;
+}
+
+void StorageManager::compactIndex(const std::string& cameraId, const std::string& directory) {
+    // Eviction thread, outside the lock: the rewrite only blocks the camera's index writer
+    m_deletedSegments[directory] = 0;
+    SegmentIndex::compact(directory, 1);
+    uint64_t bytes = SegmentIndex::diskBytes(directory);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    setIndexBytes(cameraId, bytes);
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class DatabaseManager;
+
+/**
+ * @brief Recording storage limits
+ */
+struct StorageQuota {
+    uint64_t totalBytes = 0;        // All cameras together, 0 = unlimited
+    uint64_t cameraBytes = 0;       // Default per camera, 0 = unlimited
+    int alarmRetentionDays = 30;    // Alarm recordings stay pinned this long, 0 = forever
+};
+
+struct StorageStats {
+    uint64_t totalBytes = 0;        // Recordings, sidecars and segment indexes
+    uint64_t indexBytes = 0;        // Segment index files alone
+    uint64_t pinnedBytes = 0;
+    uint64_t quotaBytes = 0;
+    size_t files = 0;
+    size_t cameras = 0;
+    uint64_t evictedFiles = 0;
+    uint64_t evictedBytes = 0;
+    int64_t oldestMs = 0;           // Start of the oldest recording kept
+};
+
+/**
+ * @brief Keeps the recordings under global and per-camera quotas
+ *
+ * Holds a byte-accounted index of every finished recording (event clips and
+ * continuous segments), per camera and ordered by start time. Recorders add
+ * files as they close them, so the index is built by walking the recording
+ * directory once at start() and never again. Quotas are enforced by a
+ * background thread that removes the oldest unpinned files a small batch at
+ * a time and deletes them outside the index lock: writers only ever wait for
+ * an O(log n) index update. Unpinned files are indexed apart from pinned
+ * ones, and the oldest unpinned file of each camera is kept in a global
+ * order, so choosing a victim is O(log n) as well. For write-once
+ * recordings, oldest-first is least-recently-used.
+ *
+ * Continuous segment indexes count against the quotas too, and are
+ * compacted once enough of their segments were evicted.
+ *
+ * Files referenced by alarms (event clips and the continuous segments around
+ * an alarm) are pinned for StorageQuota::alarmRetentionDays and skipped by
+ * eviction; segment pins survive restarts through SegmentIndex, clip pins
+ * through the events table. Evicting a clip clears its event's video path.
+ */
+class StorageManager {
+public:
+    static StorageManager& getInstance();
+
+    /**
+     * @brief Index the existing recordings below outputDir and start enforcing the quota
+     * @param cameraIds Known cameras, used to attribute existing event clips by file name
+     */
+    void start(const std::string& outputDir, const StorageQuota& quota,
+               const std::vector<std::string>& cameraIds = {});
+    void stop();
+
+    void setQuota(const StorageQuota& quota);
+    StorageQuota getQuota() const;
+    void setCameraQuota(const std::string& cameraId, uint64_t bytes);    // 0 = use the default
+
+    /**
+     * @brief Account a finished recording (Recorder writer thread)
+     * @param alarm Pin the file for the alarm retention period
+     * @param segment Number in the camera's SegmentIndex for continuous segments, -1 for clips
+     */
+    void addFile(const std::string& cameraId, const std::string& path, int64_t startMs, int64_t endMs,
+                 bool alarm, int64_t segment = -1);
+
+    /**
+     * @brief Pin a camera's indexed recordings overlapping [fromMs, toMs] (alarm footage)
+     */
+    void pinRange(const std::string& cameraId, int64_t fromMs, int64_t toMs);
+    void unpinFile(const std::string& path);
+
+    /**
+     * @brief Drop a file deleted by someone else from the index
+     */
+    void forgetFile(const std::string& path);
+
+    StorageStats getStats() const;
+    uint64_t getCameraBytes(const std::string& cameraId) const;
+
+private:
+    StorageManager() = default;
+    ~StorageManager();
+
+    StorageManager(const StorageManager&) = delete;
+    StorageManager& operator=(const StorageManager&) = delete;
+
+    struct Entry {
+        std::string path;
+        int64_t startMs = 0;
+        int64_t endMs = 0;
+        uint64_t bytes = 0;             // Video and overlay sidecar
+        int64_t pinnedUntilMs = 0;      // Wall time, 0 = not pinned (reset once expired)
+        int64_t segment = -1;
+        uint64_t id = 0;                // Insertion order, breaks ties in the eviction indexes
+    };
+
+    using EntryIt = std::multimap<int64_t, Entry>::iterator;
+    using EntryKey = std::pair<int64_t, uint64_t>;     // Start or pin deadline, Entry::id
+
+    struct Camera {
+        std::multimap<int64_t, Entry> entries;     // By start time, oldest first
+        std::map<EntryKey, EntryIt> unpinned;      // Unpinned entries by start time
+        int64_t headMs = 0;                        // Start of unpinned.begin() in m_unpinnedHeads
+        bool headQueued = false;
+        uint64_t bytes = 0;                        // Entries plus indexBytes
+        uint64_t indexBytes = 0;                   // Continuous segment index files
+        uint64_t quotaBytes = 0;                   // 0 = StorageQuota::cameraBytes
+        int64_t maxDurationMs = 0;                 // Longest entry indexed, bounds overlap lookups
+    };
+
+    // A pinned entry waiting for its deadline
+    struct Pin {
+        std::string cameraId;
+        EntryIt entry;
+    };
+
+    // A file taken out of the index, deleted outside the lock
+    struct Victim {
+        std::string cameraId;
+        Entry entry;
+    };
+
+    void loadExisting(const std::vector<std::string>& cameraIds);
+    void insert(const std::string& cameraId, Entry entry);
+    void evictionLoop();
+    std::vector<Victim> selectVictims(int64_t nowMs);
+    void indexEntry(const std::string& cameraId, Camera& camera, EntryIt entry);
+    void unindexEntry(const std::string& cameraId, Camera& camera, EntryIt entry);
+    void setPinnedUntil(const std::string& cameraId, Camera& camera, EntryIt entry, int64_t pinnedUntilMs);
+    void updateHead(const std::string& cameraId, Camera& camera);
+    void expirePins(int64_t nowMs);
+    uint64_t cameraQuota(const Camera& camera) const;
+    int64_t pinDeadline(int64_t endMs) const;
+    void deleteFiles(const Victim& victim);
+    void setIndexBytes(const std::string& cameraId, uint64_t bytes);
+    void compactIndex(const std::string& cameraId, const std::string& directory);
+
+    std::unique_ptr<DatabaseManager> m_database;   // Event rows of the clips, nullptr without a database
+
+    std::string m_outputDir;
+    StorageQuota m_quota;
+    std::map<std::string, Camera> m_cameras;
+    std::unordered_map<std::string, std::pair<std::string, int64_t>> m_byPath;    // path -> camera, start
+    uint64_t m_totalBytes = 0;
+    std::set<std::pair<int64_t, std::string>> m_unpinnedHeads;     // Oldest unpinned start per camera
+    std::map<EntryKey, Pin> m_pins;     // By deadline: pinned entries, moved to Camera::unpinned on expiry
+    uint64_t m_pinnedBytes = 0;         // Entries in m_pins
+    uint64_t m_nextEntryId = 0;
+    mutable std::mutex m_mutex;     // Guards everything above
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::condition_variable m_wake;
+    bool m_dirty = false;           // Files added or quota changed since the last pass
+
+    std::unordered_map<std::string, uint32_t> m_deletedSegments;   // Index directory -> evicted since compaction (eviction thread)
+
+    std::atomic<uint64_t> m_evictedFiles{0};
+    std::atomic<uint64_t> m_evictedBytes{0};
+
+    static constexpr size_t EVICTION_BATCH = 8;             // Files removed per pass
+    static constexpr auto RECHECK_INTERVAL = std::chrono::seconds(30);   // Pin expiry
+    static constexpr uint32_t COMPACT_MIN_DELETED = 64;     // Evicted segments before an index is rewritten
+};
@@ -1,5 +1,6 @@
 #include "Streamer.h"
 #include "../core/VideoPipeline.h"
+#include "../core/FramePool.h"
 #include "../ai/BehaviorAnalyzer.h"
 #include <iostream>
 #include <sstream>
@@ -143,15 +144,31 @@ void Streamer::processFrame(const FrameResult& result) {
     // Create frame data
     FrameData frameData;
 
+    // The decoder can scale straight to the stream resolution; only fall
+    // back to downscaling the full frame when it did not
+    const bool useStreamPlane = !result.streamFrame.empty() &&
+                                result.streamFrame.cols == m_config.width &&
+                                result.streamFrame.rows == m_config.height;
+
     // Render overlays if enabled
     if (m_config.enableOverlays) {
-        frameData.frame = renderOverlays(result.frame, result);
+        if (useStreamPlane) {
+            FrameResult scaled = scaleOverlayGeometry(result,
+                static_cast<double>(result.streamFrame.cols) / result.frame.cols,
+                static_cast<double>(result.streamFrame.rows) / result.frame.rows);
+            frameData.frame = renderOverlays(result.streamFrame, scaled);
+        } else {
+            frameData.frame = renderOverlays(result.frame, result);
+        }
     } else {
-        frameData.frame = result.frame.clone();
+        // Shared read-only with the rest of the pipeline; encoding does not modify it
+        frameData.frame = useStreamPlane ? result.streamFrame : result.frame;
     }
 
     // Resize frame to target resolution
-    frameData.frame = resizeFrame(frameData.frame, m_config.width, m_config.height);
+    if (!useStreamPlane) {
+        frameData.frame = resizeFrame(frameData.frame, m_config.width, m_config.height);
+    }
 
     // Process based on protocol
     if (m_config.protocol == StreamProtocol::MJPEG) {
@@ -492,7 +509,7 @@ void Streamer::frameProcessingThread() {
 }
 
 cv::Mat Streamer::renderOverlays(const cv::Mat& frame, const FrameResult& result) {
-    cv::Mat overlayFrame = frame.clone();
+    cv::Mat overlayFrame = FramePool::getInstance().copyOf(m_sourceId, frame);
 
     // Draw ROIs first (background layer)
     drawROIs(overlayFrame, result);
@@ -637,6 +654,42 @@ std::vector<uint8_t> Streamer::encodeJpeg(const cv::Mat& frame) {
     return jpegData;
 }
 
+FrameResult Streamer::scaleOverlayGeometry(const FrameResult& result, double scaleX, double scaleY) {
+    auto scaleRect = [scaleX, scaleY](const cv::Rect& rect) {
+        return cv::Rect(cv::Point(cvRound(rect.x * scaleX), cvRound(rect.y * scaleY)),
+                        cv::Point(cvRound((rect.x + rect.width) * scaleX), cvRound((rect.y + rect.height) * scaleY)));
+    };
+
+    // Only what renderOverlays() draws; embeddings and the frames are not needed
+    FrameResult scaled;
+    scaled.timestamp = result.timestamp;
+    scaled.labels = result.labels;
+    scaled.trackIds = result.trackIds;
+    scaled.globalTrackIds = result.globalTrackIds;
+    scaled.faceIds = result.faceIds;
+    scaled.plateNumbers = result.plateNumbers;
+    scaled.hasAlarm = result.hasAlarm;
+
+    scaled.detections.reserve(result.detections.size());
+    for (const auto& bbox : result.detections) {
+        scaled.detections.push_back(scaleRect(bbox));
+    }
+
+    scaled.events = result.events;
+    for (auto& event : scaled.events) {
+        event.boundingBox = scaleRect(event.boundingBox);
+    }
+
+    scaled.activeROIs = result.activeROIs;
+    for (auto& roi : scaled.activeROIs) {
+        for (auto& point : roi.polygon) {
+            point = cv::Point(cvRound(point.x * scaleX), cvRound(point.y * scaleY));
+        }
+    }
+
+    return scaled;
+}
+
 cv::Mat Streamer::resizeFrame(const cv::Mat& frame, int targetWidth, int targetHeight) {
     if (frame.empty()) {
         return frame;
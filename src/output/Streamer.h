@@ -147,6 +147,7 @@ private:
 
     std::vector<uint8_t> encodeJpeg(const cv::Mat& frame);
     cv::Mat resizeFrame(const cv::Mat& frame, int targetWidth, int targetHeight);
+    static FrameResult scaleOverlayGeometry(const FrameResult& result, double scaleX, double scaleY);
 
     void addFrameToBuffer(const FrameData& frameData);
     bool getLatestFrame(FrameData& frameData);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace AISecurityVision {
+
+/**
+ * @brief Codec parameters of a demuxed video stream
+ *
+ * What a muxer needs to write the stream's packets without decoding them.
+ * A new instance is created whenever the decoder (re)opens its input, so a
+ * consumer can tell from the pointer that the parameters may have changed.
+ */
+struct EncodedStreamInfo {
+    int codecId = 0;                    // AVCodecID
+    std::string codecName;
+    int width = 0;
+    int height = 0;
+    int timeBaseNum = 1;                // Time base of the packet timestamps
+    int timeBaseDen = 90000;
+    double frameRate = 25.0;
+    std::vector<uint8_t> extradata;     // SPS/PPS (VPS) in the container's format
+};
+
+/**
+ * @brief One compressed video packet as read from the source, before any frame skipping
+ */
+struct EncodedPacket {
+    std::vector<uint8_t> data;
+    int64_t pts = NO_TIMESTAMP;         // Stream time base; each falls back to the other
+    int64_t dts = NO_TIMESTAMP;
+    int64_t duration = 0;
+    bool keyframe = false;
+    int64_t wallTimeMs = 0;             // Reception time, system clock
+    std::shared_ptr<const EncodedStreamInfo> stream;
+
+    static constexpr int64_t NO_TIMESTAMP = INT64_MIN;  // AV_NOPTS_VALUE
+};
+
+using EncodedPacketPtr = std::shared_ptr<const EncodedPacket>;
+
+/**
+ * @brief Receives every video packet on the decode thread; must not block
+ */
+using EncodedPacketSink = std::function<void(const EncodedPacketPtr&)>;
+
+} // namespace AISecurityVision
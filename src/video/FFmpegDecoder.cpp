@@ -1,8 +1,11 @@
 #include "FFmpegDecoder.h"
 #include "../core/TaskManager.h"
+#include "../core/FramePool.h"
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <algorithm>
+#include <cstdlib>
 
 #include "../core/Logger.h"
 using namespace AISecurityVision;
@@ -38,9 +41,7 @@ FFmpegDecoder::FFmpegDecoder()
     , m_videoStream(nullptr)
     , m_codec(nullptr)
     , m_frame(nullptr)
-    , m_frameRGB(nullptr)
     , m_packet(nullptr)
-    , m_buffer(nullptr)
     , m_useHardwareDecoding(true) {
 
     static FFmpegRAII ffmpegInit;
@@ -52,6 +53,8 @@ FFmpegDecoder::~FFmpegDecoder() {
 
 bool FFmpegDecoder::initialize(const VideoSource& source) {
     m_source = source;
+    m_frameCounter = 0;
+    m_awaitKeyframe = false;
     LOG_INFO() << "[FFmpegDecoder] Initializing decoder for: " << source.url;
 
 #ifdef HAVE_FFMPEG
@@ -63,9 +66,7 @@ bool FFmpegDecoder::initialize(const VideoSource& source) {
     m_codecContext = nullptr;
     m_swsContext = nullptr;
     m_frame = nullptr;
-    m_frameRGB = nullptr;
     m_packet = nullptr;
-    m_buffer = nullptr;
 
     // Open input stream
     if (!openStream()) {
@@ -100,89 +101,123 @@ bool FFmpegDecoder::initialize(const VideoSource& source) {
 }
 
 bool FFmpegDecoder::getNextFrame(cv::Mat& frame, int64_t& timestamp) {
+    FrameBundle bundle;
+    if (!getNextFrame(bundle, timestamp)) {
+        return false;
+    }
+    frame = bundle.full;
+    return true;
+}
+
+bool FFmpegDecoder::getNextFrame(FrameBundle& bundle, int64_t& timestamp) {
     if (!m_connected.load() || !m_initialized.load()) {
         return false;
     }
 
+    if (m_planesChanged.exchange(false)) {
+        std::lock_guard<std::mutex> lock(m_planeMutex);
+        m_planes = m_requestedPlanes;
+    }
+
     auto start = std::chrono::high_resolution_clock::now();
 
 #ifdef HAVE_FFMPEG
     // Real FFmpeg frame decoding
-    if (!m_formatContext || !m_codecContext || !m_frame || !m_frameRGB) {
+    if (!m_formatContext || !m_codecContext || !m_frame) {
         return false;
     }
 
-    // Read packet
-    int ret = av_read_frame(m_formatContext, m_packet);
-    if (ret < 0) {
-        if (ret == AVERROR_EOF) {
-            LOG_INFO() << "[FFmpegDecoder] End of stream reached";
-        } else {
-            char errbuf[AV_ERROR_MAX_STRING_SIZE];
-            av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
-            LOG_ERROR() << "[FFmpegDecoder] Error reading frame: " << errbuf;
+    // Drain the codec before feeding it: with frame threading one packet
+    // can complete several frames, or none until the thread pipeline fills
+    while (true) {
+        int ret = avcodec_receive_frame(m_codecContext, m_frame);
+        if (ret == 0) {
+            m_decodedFrames.fetch_add(1);
+
+            // Every-Nth: the frame had to be decoded because later frames
+            // reference it, but frames that won't be analyzed skip sws_scale
+            int interval = keyframesOnly() ? 1 : frameInterval();
+            if (interval > 1 && (m_frameCounter++ % interval) != 0) {
+                m_skippedFrames.fetch_add(1);
+                av_frame_unref(m_frame);
+                continue;
+            }
+
+            convertPlanes(bundle);
+            av_frame_unref(m_frame);
+
+            // Set timestamp
+            timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+
+            auto end = std::chrono::high_resolution_clock::now();
+            m_decodeTime.store(std::chrono::duration<double, std::milli>(end - start).count());
+            m_convertedFrames.fetch_add(1);
+            return true;
         }
-        return false;
-    }
 
-    // Check if packet belongs to video stream
-    if (m_packet->stream_index != m_videoStreamIndex) {
-        av_packet_unref(m_packet);
-        return getNextFrame(frame, timestamp); // Recursively try next packet
-    }
+        if (ret != AVERROR(EAGAIN)) {
+            if (ret == AVERROR_EOF) {
+                LOG_INFO() << "[FFmpegDecoder] End of stream reached";
+            } else {
+                char errbuf[AV_ERROR_MAX_STRING_SIZE];
+                av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
+                LOG_ERROR() << "[FFmpegDecoder] Error receiving frame: " << errbuf;
+            }
+            return false;
+        }
 
-    // Send packet to decoder
-    ret = avcodec_send_packet(m_codecContext, m_packet);
-    if (ret < 0) {
-        char errbuf[AV_ERROR_MAX_STRING_SIZE];
-        av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
-        LOG_ERROR() << "[FFmpegDecoder] Error sending packet: " << errbuf;
-        av_packet_unref(m_packet);
-        return false;
-    }
+        // Codec needs more input: read the next video packet
+        ret = av_read_frame(m_formatContext, m_packet);
+        if (ret < 0) {
+            if (ret == AVERROR_EOF) {
+                // Enter draining mode so frames still buffered in the codec
+                // (frame threading) are returned before end of stream; once
+                // drained, avcodec_receive_frame() reports AVERROR_EOF above
+                if (avcodec_send_packet(m_codecContext, nullptr) == 0) {
+                    continue;
+                }
+            } else {
+                char errbuf[AV_ERROR_MAX_STRING_SIZE];
+                av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
+                LOG_ERROR() << "[FFmpegDecoder] Error reading frame: " << errbuf;
+            }
+            return false;
+        }
 
-    // Receive frame from decoder
-    ret = avcodec_receive_frame(m_codecContext, m_frame);
-    if (ret < 0) {
-        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+        if (m_packet->stream_index == m_videoStreamIndex) {
+            publishPacket(m_packet);
+        }
+        if (m_packet->stream_index != m_videoStreamIndex || !acceptPacket(m_packet, keyframesOnly())) {
             av_packet_unref(m_packet);
-            return getNextFrame(frame, timestamp); // Try next packet
-        } else {
+            continue;
+        }
+
+        // Send packet to decoder
+        ret = avcodec_send_packet(m_codecContext, m_packet);
+        av_packet_unref(m_packet);
+        if (ret < 0) {
             char errbuf[AV_ERROR_MAX_STRING_SIZE];
             av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
-            LOG_ERROR() << "[FFmpegDecoder] Error receiving frame: " << errbuf;
-            av_packet_unref(m_packet);
+            LOG_ERROR() << "[FFmpegDecoder] Error sending packet: " << errbuf;
             return false;
         }
     }
-
-    // Convert frame to BGR format
-    sws_scale(m_swsContext, (uint8_t const * const *)m_frame->data,
-              m_frame->linesize, 0, m_codecContext->height,
-              m_frameRGB->data, m_frameRGB->linesize);
-
-    // Create OpenCV Mat from frame data
-    frame = cv::Mat(m_codecContext->height, m_codecContext->width, CV_8UC3, m_frameRGB->data[0], m_frameRGB->linesize[0]);
-    frame = frame.clone(); // Make a copy to avoid data corruption
-
-    // Set timestamp
-    timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-
-    // Cleanup
-    av_packet_unref(m_packet);
-
-    auto end = std::chrono::high_resolution_clock::now();
-    m_decodeTime.store(std::chrono::duration<double, std::milli>(end - start).count());
-    m_decodedFrames.fetch_add(1);
-
-    return true;
 #else
     // Stub implementation - create a test frame
-    frame = cv::Mat::zeros(480, 640, CV_8UC3);
+    cv::Mat frame = FramePool::getInstance().acquire(m_source.id, 480, 640, CV_8UC3);
+    frame.setTo(cv::Scalar::all(0));
     cv::putText(frame, "Test Frame - No FFmpeg", cv::Point(50, 240),
                 cv::FONT_HERSHEY_SIMPLEX, 1, cv::Scalar(0, 255, 0), 2);
 
+    // Simulated decode of the frames an every-Nth policy skips
+    int interval = keyframesOnly() ? 1 : frameInterval();
+    while (interval > 1 && (m_frameCounter++ % interval) != 0) {
+        m_decodedFrames.fetch_add(1);
+        m_skippedFrames.fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    }
+
     // Add timestamp
     std::string timeStr = "Frame: " + std::to_string(m_decodedFrames.load());
     cv::putText(frame, timeStr, cv::Point(50, 280),
@@ -192,12 +227,33 @@ bool FFmpegDecoder::getNextFrame(cv::Mat& frame, int64_t& timestamp) {
     int x = (m_decodedFrames.load() * 2) % (640 - 100);
     cv::rectangle(frame, cv::Point(x, 350), cv::Point(x + 100, 400), cv::Scalar(255, 0, 0), -1);
 
+    // Derive the scaled planes from the test frame
+    bundle.sourceSize = frame.size();
+    if (!m_planes.model.empty()) {
+        auto geometry = LetterboxGeometry::fit(bundle.sourceSize, m_planes.model);
+        bundle.model = FramePool::getInstance().acquire(FrameBundle::modelPoolId(m_source.id),
+                                                        m_planes.model.height, m_planes.model.width, CV_8UC3);
+        cv::Mat content = bundle.model(geometry.roi());
+        cv::resize(frame, content, geometry.scaled, 0, 0, cv::INTER_LINEAR);
+        geometry.fillPadding(bundle.model);
+        bundle.letterbox = geometry.info;
+    }
+    if (!m_planes.stream.empty()) {
+        bundle.stream = FramePool::getInstance().acquire(FrameBundle::streamPoolId(m_source.id),
+                                                         m_planes.stream.height, m_planes.stream.width, CV_8UC3);
+        cv::resize(frame, bundle.stream, m_planes.stream, 0, 0, cv::INTER_LINEAR);
+    }
+    if (m_planes.full) {
+        bundle.full = frame;
+    }
+
     timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
 
     auto end = std::chrono::high_resolution_clock::now();
     m_decodeTime.store(std::chrono::duration<double, std::milli>(end - start).count());
     m_decodedFrames.fetch_add(1);
+    m_convertedFrames.fetch_add(1);
 
     // Simulate frame rate
     std::this_thread::sleep_for(std::chrono::milliseconds(40)); // ~25 FPS
@@ -206,6 +262,106 @@ bool FFmpegDecoder::getNextFrame(cv::Mat& frame, int64_t& timestamp) {
 #endif
 }
 
+#ifdef HAVE_FFMPEG
+namespace {
+
+// Convert the decoded picture into a BGR destination (possibly a sub-rectangle of a larger Mat)
+void scaleInto(SwsContext* context, const AVFrame* source, int sourceHeight, cv::Mat& destination) {
+    uint8_t* dstData[4] = {destination.data, nullptr, nullptr, nullptr};
+    int dstLinesize[4] = {static_cast<int>(destination.step[0]), 0, 0, 0};
+    sws_scale(context, (uint8_t const * const *)source->data, source->linesize, 0, sourceHeight,
+              dstData, dstLinesize);
+}
+
+// Share of the predicted block area displaced by at least one pixel; -1 without motion vectors.
+// Bi-predicted blocks report one vector per direction, hence the ratio to the reported area
+float movingBlockFraction(const AVFrame* frame) {
+    const AVFrameSideData* sideData = av_frame_get_side_data(frame, AV_FRAME_DATA_MOTION_VECTORS);
+    if (!sideData) {
+        return -1.0f;
+    }
+
+    const auto* vectors = reinterpret_cast<const AVMotionVector*>(sideData->data);
+    const size_t count = sideData->size / sizeof(AVMotionVector);
+    double reportedArea = 0.0;
+    double movingArea = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const AVMotionVector& mv = vectors[i];
+        double area = static_cast<double>(mv.w) * mv.h;
+        reportedArea += area;
+        if (mv.motion_scale > 0 && std::abs(mv.motion_x) + std::abs(mv.motion_y) >= static_cast<int>(mv.motion_scale)) {
+            movingArea += area;
+        }
+    }
+    return reportedArea > 0.0 ? static_cast<float>(movingArea / reportedArea) : -1.0f;
+}
+
+} // namespace
+
+void FFmpegDecoder::convertPlanes(FrameBundle& bundle) {
+    // Every plane is converted directly from the decoded picture into a pooled
+    // buffer, so no consumer has to downscale the full-resolution frame again
+    const int width = m_codecContext->width;
+    const int height = m_codecContext->height;
+    auto& pool = FramePool::getInstance();
+    bundle.sourceSize = cv::Size(width, height);
+
+    if (m_planes.full) {
+        bundle.full = pool.acquire(m_source.id, height, width, CV_8UC3);
+        scaleInto(m_swsContext, m_frame, height, bundle.full);
+    }
+
+    if (!m_planes.model.empty()) {
+        auto geometry = LetterboxGeometry::fit(bundle.sourceSize, m_planes.model);
+        m_modelSwsContext = sws_getCachedContext(m_modelSwsContext, width, height, m_codecContext->pix_fmt,
+                                                 geometry.scaled.width, geometry.scaled.height, AV_PIX_FMT_BGR24,
+                                                 SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (m_modelSwsContext) {
+            bundle.model = pool.acquire(FrameBundle::modelPoolId(m_source.id),
+                                        m_planes.model.height, m_planes.model.width, CV_8UC3);
+            cv::Mat content = bundle.model(geometry.roi());
+            scaleInto(m_modelSwsContext, m_frame, height, content);
+            geometry.fillPadding(bundle.model);
+            bundle.letterbox = geometry.info;
+        }
+    }
+
+    if (!m_planes.stream.empty()) {
+        m_streamSwsContext = sws_getCachedContext(m_streamSwsContext, width, height, m_codecContext->pix_fmt,
+                                                  m_planes.stream.width, m_planes.stream.height, AV_PIX_FMT_BGR24,
+                                                  SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (m_streamSwsContext) {
+            bundle.stream = pool.acquire(FrameBundle::streamPoolId(m_source.id),
+                                         m_planes.stream.height, m_planes.stream.width, CV_8UC3);
+            scaleInto(m_streamSwsContext, m_frame, height, bundle.stream);
+        }
+    }
+
+    bundle.motionActivity = m_exportMotionVectors.load() ? movingBlockFraction(m_frame) : -1.0f;
+}
+#endif
+
+void FFmpegDecoder::setFramePlanes(const FramePlaneSpec& spec) {
+    {
+        std::lock_guard<std::mutex> lock(m_planeMutex);
+        if (spec == m_requestedPlanes) {
+            return;
+        }
+        m_requestedPlanes = spec;
+    }
+    m_planesChanged.store(true);
+
+    LOG_INFO() << "[FFmpegDecoder] Output planes for " << m_source.id << ": full "
+               << (spec.full ? "yes" : "no")
+               << ", model " << spec.model.width << "x" << spec.model.height
+               << ", stream " << spec.stream.width << "x" << spec.stream.height;
+}
+
+FramePlaneSpec FFmpegDecoder::getFramePlanes() const {
+    std::lock_guard<std::mutex> lock(m_planeMutex);
+    return m_requestedPlanes;
+}
+
 bool FFmpegDecoder::openStream() {
 #ifdef HAVE_FFMPEG
     // Open input stream
@@ -243,6 +399,7 @@ bool FFmpegDecoder::openStream() {
     m_videoStream = m_formatContext->streams[m_videoStreamIndex];
     LOG_INFO() << "[FFmpegDecoder] Found video stream: " << m_videoStreamIndex
               << " (" << m_videoStream->codecpar->width << "x" << m_videoStream->codecpar->height << ")";
+    updateStreamInfo();
 
     return true;
 #else
@@ -275,6 +432,23 @@ bool FFmpegDecoder::setupDecoder() {
         return false;
     }
 
+    // Software decode threading. Frame threading scales best but delays
+    // output by one frame per extra thread; slice threading adds no delay
+    // but only helps streams encoded with multiple slices. Auto slice
+    // threading is bounded so many cameras don't each start a thread per core
+    int threadCount = m_threadCount;
+    if (threadCount == 0 && !m_frameThreading) {
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        threadCount = std::min(DecodePolicy::MAX_AUTO_SLICE_THREADS, std::max(1, cores));
+    }
+    m_codecContext->thread_count = threadCount;
+    m_codecContext->thread_type = m_frameThreading ? (FF_THREAD_FRAME | FF_THREAD_SLICE) : FF_THREAD_SLICE;
+
+    // Motion vectors as frame side data, for motion-gated detection
+    if (m_exportMotionVectors.load()) {
+        m_codecContext->flags2 |= AV_CODEC_FLAG2_EXPORT_MVS;
+    }
+
     // Open codec
     ret = avcodec_open2(m_codecContext, m_codec, nullptr);
     if (ret < 0) {
@@ -286,9 +460,8 @@ bool FFmpegDecoder::setupDecoder() {
 
     // Allocate frames
     m_frame = av_frame_alloc();
-    m_frameRGB = av_frame_alloc();
-    if (!m_frame || !m_frameRGB) {
-        LOG_ERROR() << "[FFmpegDecoder] Failed to allocate frames";
+    if (!m_frame) {
+        LOG_ERROR() << "[FFmpegDecoder] Failed to allocate frame";
         return false;
     }
 
@@ -299,8 +472,13 @@ bool FFmpegDecoder::setupDecoder() {
         return false;
     }
 
+    m_activeThreadCount.store(m_codecContext->thread_count);
+    m_activeFrameThreading.store((m_codecContext->active_thread_type & FF_THREAD_FRAME) != 0);
+
     LOG_INFO() << "[FFmpegDecoder] Decoder setup complete: " << m_codec->name
-              << " (" << m_codecContext->width << "x" << m_codecContext->height << ")";
+              << " (" << m_codecContext->width << "x" << m_codecContext->height << ", "
+              << m_codecContext->thread_count << " threads, "
+              << (m_activeFrameThreading.load() ? "frame" : "slice") << " threading)";
 
     return true;
 #else
@@ -310,18 +488,7 @@ bool FFmpegDecoder::setupDecoder() {
 
 bool FFmpegDecoder::setupScaler() {
 #ifdef HAVE_FFMPEG
-    // Calculate buffer size for RGB frame
-    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_BGR24, m_codecContext->width, m_codecContext->height, 1);
-    m_buffer = (uint8_t*)av_malloc(numBytes * sizeof(uint8_t));
-    if (!m_buffer) {
-        LOG_ERROR() << "[FFmpegDecoder] Failed to allocate buffer";
-        return false;
-    }
-
-    // Assign buffer to frame
-    av_image_fill_arrays(m_frameRGB->data, m_frameRGB->linesize, m_buffer,
-                        AV_PIX_FMT_BGR24, m_codecContext->width, m_codecContext->height, 1);
-
+    // Output buffers come from the FramePool per frame, only the scaler is set up here
     // Initialize scaler context
     m_swsContext = sws_getContext(
         m_codecContext->width, m_codecContext->height, m_codecContext->pix_fmt,
@@ -349,14 +516,14 @@ void FFmpegDecoder::cleanup() {
         m_swsContext = nullptr;
     }
 
-    if (m_buffer) {
-        av_free(m_buffer);
-        m_buffer = nullptr;
+    if (m_modelSwsContext) {
+        sws_freeContext(m_modelSwsContext);
+        m_modelSwsContext = nullptr;
     }
 
-    if (m_frameRGB) {
-        av_frame_free(&m_frameRGB);
-        m_frameRGB = nullptr;
+    if (m_streamSwsContext) {
+        sws_freeContext(m_streamSwsContext);
+        m_streamSwsContext = nullptr;
     }
 
     if (m_frame) {
@@ -391,6 +558,199 @@ bool FFmpegDecoder::reconnect() {
     return initialize(m_source);
 }
 
+void FFmpegDecoder::setDecodePolicy(const DecodePolicy& policy) {
+    m_threadCount = std::max(0, policy.threadCount);
+    m_frameThreading = policy.frameThreading;
+    m_frameInterval.store(std::max(1, policy.frameInterval));
+    m_frameSkip.store(static_cast<int>(policy.frameSkip));
+    m_targetLatencyMs.store(policy.targetLatencyMs > 0.0 ? policy.targetLatencyMs : 200.0);
+    m_adaptive.store(policy.adaptive);
+    if (!policy.adaptive) {
+        m_adaptiveLevel.store(0);
+    }
+
+    LOG_INFO() << "[FFmpegDecoder] Decode policy for " << m_source.id << ": "
+               << DecodePolicy::frameSkipName(policy.frameSkip)
+               << (policy.frameSkip == DecodePolicy::FrameSkip::EVERY_NTH
+                       ? " 1/" + std::to_string(std::max(1, policy.frameInterval)) : std::string())
+               << ", threads " << (m_threadCount == 0 ? std::string("auto") : std::to_string(m_threadCount))
+               << (m_frameThreading ? " (frame+slice)" : " (slice)")
+               << (policy.adaptive ? ", adaptive target " + std::to_string(m_targetLatencyMs.load()) + " ms"
+                                   : std::string());
+}
+
+DecodePolicy FFmpegDecoder::getDecodePolicy() const {
+    DecodePolicy policy;
+    policy.threadCount = m_threadCount;
+    policy.frameThreading = m_frameThreading;
+    policy.frameSkip = static_cast<DecodePolicy::FrameSkip>(m_frameSkip.load());
+    policy.frameInterval = m_frameInterval.load();
+    policy.adaptive = m_adaptive.load();
+    policy.targetLatencyMs = m_targetLatencyMs.load();
+    return policy;
+}
+
+void FFmpegDecoder::setMotionVectorExport(bool enabled) {
+    m_exportMotionVectors.store(enabled);
+}
+
+bool FFmpegDecoder::isMotionVectorExportEnabled() const {
+    return m_exportMotionVectors.load();
+}
+
+void FFmpegDecoder::setPacketSink(EncodedPacketSink sink) {
+    std::shared_ptr<const EncodedPacketSink> shared;
+    if (sink) {
+        shared = std::make_shared<const EncodedPacketSink>(std::move(sink));
+    }
+    std::atomic_store(&m_packetSink, shared);
+}
+
+std::shared_ptr<const EncodedStreamInfo> FFmpegDecoder::getStreamInfo() const {
+    return std::atomic_load(&m_streamInfo);
+}
+
+namespace {
+
+// Doublings of the configured interval until MAX_ADAPTIVE_INTERVAL is reached
+int intervalLevels(int baseInterval) {
+    int levels = 0;
+    for (int interval = baseInterval; interval < DecodePolicy::MAX_ADAPTIVE_INTERVAL; interval *= 2) {
+        ++levels;
+    }
+    return levels;
+}
+
+} // namespace
+
+bool FFmpegDecoder::keyframesOnly() const {
+    auto mode = static_cast<DecodePolicy::FrameSkip>(m_frameSkip.load());
+    if (mode == DecodePolicy::FrameSkip::KEYFRAMES_ONLY) {
+        return true;
+    }
+    if (!m_adaptive.load()) {
+        return false;
+    }
+    int base = mode == DecodePolicy::FrameSkip::EVERY_NTH ? m_frameInterval.load() : 1;
+    return m_adaptiveLevel.load() > intervalLevels(base);
+}
+
+int FFmpegDecoder::frameInterval() const {
+    auto mode = static_cast<DecodePolicy::FrameSkip>(m_frameSkip.load());
+    int base = mode == DecodePolicy::FrameSkip::EVERY_NTH ? m_frameInterval.load() : 1;
+    if (!m_adaptive.load()) {
+        return base;
+    }
+    int interval = base;
+    for (int level = m_adaptiveLevel.load(); level > 0 && interval < DecodePolicy::MAX_ADAPTIVE_INTERVAL; --level) {
+        interval *= 2;
+    }
+    return std::min(interval, std::max(base, DecodePolicy::MAX_ADAPTIVE_INTERVAL));
+}
+
+void FFmpegDecoder::reportPipelineLatency(double latencyMs) {
+    if (!m_adaptive.load()) {
+        return;
+    }
+
+    // Single reporter, so load/store is sufficient
+    double ema = m_latencyEma.load();
+    ema = ema == 0.0 ? latencyMs : LATENCY_EMA_ALPHA * latencyMs + (1.0 - LATENCY_EMA_ALPHA) * ema;
+    m_latencyEma.store(ema);
+    adaptFrameSkip(ema);
+}
+
+void FFmpegDecoder::adaptFrameSkip(double avgLatencyMs) {
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_lastAdaptation < std::chrono::milliseconds(ADAPT_INTERVAL_MS)) {
+        return;
+    }
+
+    auto mode = static_cast<DecodePolicy::FrameSkip>(m_frameSkip.load());
+    if (mode == DecodePolicy::FrameSkip::KEYFRAMES_ONLY) {
+        return;  // Nothing left to skip
+    }
+    int base = mode == DecodePolicy::FrameSkip::EVERY_NTH ? m_frameInterval.load() : 1;
+    int maxLevel = intervalLevels(base) + 1;  // Last step: keyframes only
+
+    double target = m_targetLatencyMs.load();
+    int level = m_adaptiveLevel.load();
+    if (avgLatencyMs > target && level < maxLevel) {
+        ++level;
+    } else if (avgLatencyMs < target * ADAPT_RELAX_RATIO && level > 0) {
+        --level;
+    } else {
+        return;
+    }
+
+    m_adaptiveLevel.store(level);
+    m_lastAdaptation = now;
+    LOG_INFO() << "[FFmpegDecoder] Pipeline latency " << avgLatencyMs << " ms (target " << target
+               << " ms) for " << m_source.id << ", now analyzing "
+               << (keyframesOnly() ? std::string("keyframes only") : "1/" + std::to_string(frameInterval()) + " frames");
+}
+
+#ifdef HAVE_FFMPEG
+bool FFmpegDecoder::acceptPacket(const AVPacket* packet, bool dropInterFrames) {
+    bool isKey = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+
+    // Inter-coded packets never reach the codec in keyframe-only mode. After
+    // leaving it, keep dropping until the next keyframe so the codec is never
+    // fed frames whose references were discarded.
+    if (dropInterFrames) {
+        m_awaitKeyframe = true;
+    } else if (m_awaitKeyframe && isKey) {
+        m_awaitKeyframe = false;
+    }
+
+    if (!isKey && m_awaitKeyframe) {
+        m_droppedPackets.fetch_add(1);
+        return false;
+    }
+    return true;
+}
+#endif
+
+#ifdef HAVE_FFMPEG
+void FFmpegDecoder::updateStreamInfo() {
+    const AVCodecParameters* parameters = m_videoStream->codecpar;
+    auto info = std::make_shared<EncodedStreamInfo>();
+    info->codecId = parameters->codec_id;
+    info->codecName = avcodec_get_name(parameters->codec_id);
+    info->width = parameters->width;
+    info->height = parameters->height;
+    info->timeBaseNum = m_videoStream->time_base.num;
+    info->timeBaseDen = m_videoStream->time_base.den;
+    AVRational fps = m_videoStream->avg_frame_rate.den > 0 ? m_videoStream->avg_frame_rate
+                                                           : m_videoStream->r_frame_rate;
+    if (fps.num > 0 && fps.den > 0) {
+        info->frameRate = av_q2d(fps);
+    }
+    if (parameters->extradata && parameters->extradata_size > 0) {
+        info->extradata.assign(parameters->extradata, parameters->extradata + parameters->extradata_size);
+    }
+    std::atomic_store(&m_streamInfo, std::shared_ptr<const EncodedStreamInfo>(std::move(info)));
+}
+
+void FFmpegDecoder::publishPacket(const AVPacket* packet) {
+    auto sink = std::atomic_load(&m_packetSink);
+    if (!sink || packet->size <= 0) {
+        return;
+    }
+
+    auto encoded = std::make_shared<EncodedPacket>();
+    encoded->data.assign(packet->data, packet->data + packet->size);
+    encoded->dts = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+    encoded->pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : encoded->dts;
+    encoded->duration = packet->duration;
+    encoded->keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+    encoded->wallTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    encoded->stream = std::atomic_load(&m_streamInfo);
+    (*sink)(encoded);
+}
+#endif
+
 void FFmpegDecoder::logError(const std::string& message, int errorCode) {
     if (errorCode != 0) {
         LOG_ERROR() << "[FFmpegDecoder] " << message << " (error code: " << errorCode << ")";
@@ -452,4 +812,52 @@ std::string FFmpegDecoder::getCodecName() const {
 
 size_t FFmpegDecoder::getDecodedFrames() const { return m_decodedFrames.load(); }
 double FFmpegDecoder::getDecodeTime() const { return m_decodeTime.load(); }
-bool FFmpegDecoder::seekToTimestamp(int64_t timestamp) { return false; }
+
+DecodeStats FFmpegDecoder::getDecodeStats() const {
+    DecodeStats stats;
+    stats.decodedFrames = m_decodedFrames.load();
+    stats.convertedFrames = m_convertedFrames.load();
+    stats.skippedFrames = m_skippedFrames.load();
+    stats.droppedPackets = m_droppedPackets.load();
+    stats.decodeTimeMs = m_decodeTime.load();
+    stats.avgLatencyMs = m_latencyEma.load();
+    stats.threadCount = m_activeThreadCount.load();
+    stats.frameThreading = m_activeFrameThreading.load();
+    stats.adaptiveLevel = m_adaptive.load() ? m_adaptiveLevel.load() : 0;
+    if (keyframesOnly()) {
+        stats.activeSkip = DecodePolicy::FrameSkip::KEYFRAMES_ONLY;
+    } else {
+        stats.activeInterval = frameInterval();
+        stats.activeSkip = stats.activeInterval > 1 ? DecodePolicy::FrameSkip::EVERY_NTH
+                                                    : DecodePolicy::FrameSkip::NONE;
+    }
+    return stats;
+}
+bool FFmpegDecoder::seekToTimestamp(int64_t timestamp) {
+#ifdef HAVE_FFMPEG
+    // Called from the decode thread, like getNextFrame()
+    if (!m_formatContext || !m_videoStream || !m_codecContext) {
+        return false;
+    }
+
+    // Milliseconds from the start of the stream, to the keyframe at or before them
+    int64_t target = av_rescale_q(timestamp, AVRational{1, 1000}, m_videoStream->time_base);
+    if (m_videoStream->start_time != AV_NOPTS_VALUE) {
+        target += m_videoStream->start_time;
+    }
+    int ret = av_seek_frame(m_formatContext, m_videoStreamIndex, target, AVSEEK_FLAG_BACKWARD);
+    if (ret < 0) {
+        char errbuf[AV_ERROR_MAX_STRING_SIZE];
+        av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
+        LOG_WARN() << "[FFmpegDecoder] Seek to " << timestamp << " ms failed for " << m_source.id << ": " << errbuf;
+        return false;
+    }
+
+    avcodec_flush_buffers(m_codecContext);
+    m_frameCounter = 0;
+    return true;
+#else
+    (void)timestamp;
+    return false;
+#endif
+}
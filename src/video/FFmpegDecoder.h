@@ -4,7 +4,10 @@
 #include <string>
 #include <memory>
 #include <atomic>
+#include <mutex>
 #include "../core/VideoPipeline.h"  // For VideoSource definition
+#include "../core/FrameBundle.h"
+#include "EncodedPacket.h"
 
 #ifdef HAVE_FFMPEG
 extern "C" {
@@ -12,6 +15,7 @@ extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libswscale/swscale.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/motion_vector.h>
 }
 #endif
 
@@ -25,6 +29,11 @@ extern "C" {
  *
  * Features:
  * - Hardware-accelerated decoding (CUDA/NVDEC)
+ * - Multi-threaded software decoding (frame and/or slice threads)
+ * - Frame skipping (every Nth frame, keyframes only), optionally adapted
+ *   to the pipeline latency reported by the consumer
+ * - Multi-resolution output: full-size, letterboxed model-input and
+ *   stream-size planes converted directly from the decoded picture
  * - Automatic format detection
  * - Frame rate control
  * - Error recovery and reconnection
@@ -39,7 +48,14 @@ public:
     void cleanup();
 
     // Frame operations
-    bool getNextFrame(cv::Mat& frame, int64_t& timestamp);
+    bool getNextFrame(AISecurityVision::FrameBundle& bundle, int64_t& timestamp);
+    bool getNextFrame(cv::Mat& frame, int64_t& timestamp);   // Full-resolution plane only
+
+    /**
+     * @brief Seek a file source to the keyframe at or before timestamp (ms from the stream start)
+     *
+     * Call from the decoding thread. Live streams usually cannot seek and return false.
+     */
     bool seekToTimestamp(int64_t timestamp);
 
     // Stream control
@@ -53,9 +69,44 @@ public:
     int64_t getDuration() const;
     std::string getCodecName() const;
 
+    /**
+     * @brief Declare the planes the consumers need; applied from the next frame on
+     *
+     * Only requested planes are produced. The default is the full-resolution plane only.
+     */
+    void setFramePlanes(const AISecurityVision::FramePlaneSpec& spec);
+    AISecurityVision::FramePlaneSpec getFramePlanes() const;
+
+    // Threading and frame selection (threading takes effect on the next initialize())
+    void setDecodePolicy(const DecodePolicy& policy);
+    DecodePolicy getDecodePolicy() const;
+
+    /**
+     * @brief Feed the adaptive frame-skip policy with one frame's decode-to-output latency
+     *
+     * Called by the single consumer of getNextFrame(); ignored unless the policy is adaptive.
+     */
+    void reportPipelineLatency(double latencyMs);
+
+    /**
+     * @brief Export codec motion vectors as FrameBundle::motionActivity (takes effect on the next initialize())
+     */
+    void setMotionVectorExport(bool enabled);
+    bool isMotionVectorExportEnabled() const;
+
+    /**
+     * @brief Hand every demuxed video packet (before frame skipping) to a sink, or stop with nullptr
+     *
+     * The sink runs on the decode thread. Used by the recorder to keep and
+     * write the camera's original compressed stream.
+     */
+    void setPacketSink(AISecurityVision::EncodedPacketSink sink);
+    std::shared_ptr<const AISecurityVision::EncodedStreamInfo> getStreamInfo() const;
+
     // Statistics
-    size_t getDecodedFrames() const;
-    double getDecodeTime() const;
+    size_t getDecodedFrames() const;    // Frames produced by the codec, including skipped ones
+    double getDecodeTime() const;       // Last returned frame: read + decode + convert, ms
+    DecodeStats getDecodeStats() const;
 
 private:
     // Internal methods
@@ -67,22 +118,26 @@ private:
 #ifdef HAVE_FFMPEG
     AVFrame* decodeFrame();
     bool convertFrame(AVFrame* avFrame, cv::Mat& cvFrame);
+    bool acceptPacket(const AVPacket* packet, bool dropInterFrames);
+    void convertPlanes(AISecurityVision::FrameBundle& bundle);
+    void publishPacket(const AVPacket* packet);
+    void updateStreamInfo();
 
     // FFmpeg contexts
     AVFormatContext* m_formatContext;
     AVCodecContext* m_codecContext;
     SwsContext* m_swsContext;
+    SwsContext* m_modelSwsContext = nullptr;    // Recreated by sws_getCachedContext on change
+    SwsContext* m_streamSwsContext = nullptr;
 
     // Stream information
     int m_videoStreamIndex;
     AVStream* m_videoStream;
     const AVCodec* m_codec;
 
-    // Frames and packets
+    // Decoded frame and packet
     AVFrame* m_frame;
-    AVFrame* m_frameRGB;
     AVPacket* m_packet;
-    uint8_t* m_buffer;
 #else
     // Stub implementation without FFmpeg
     void* m_formatContext;
@@ -92,22 +147,54 @@ private:
     void* m_videoStream;
     void* m_codec;
     void* m_frame;
-    void* m_frameRGB;
     void* m_packet;
-    void* m_buffer;
 #endif
 
+    // Effective frame selection: configured floor plus adaptive escalation
+    bool keyframesOnly() const;
+    int frameInterval() const;
+    void adaptFrameSkip(double avgLatencyMs);
+
     // Configuration
     VideoSource m_source;
     bool m_useHardwareDecoding;
+    int m_threadCount = 0;
+    bool m_frameThreading = false;
+    std::atomic<int> m_frameSkip{static_cast<int>(DecodePolicy::FrameSkip::NONE)};
+    std::atomic<int> m_frameInterval{1};
+    std::atomic<bool> m_adaptive{false};
+    std::atomic<double> m_targetLatencyMs{200.0};
+    std::atomic<bool> m_exportMotionVectors{false};
+
+    // Compressed packet tap: sink swapped atomically, stream info replaced on every open
+    std::shared_ptr<const AISecurityVision::EncodedPacketSink> m_packetSink;
+    std::shared_ptr<const AISecurityVision::EncodedStreamInfo> m_streamInfo;
+
+    // Output planes: requested by any thread, picked up by the decode thread
+    mutable std::mutex m_planeMutex;
+    AISecurityVision::FramePlaneSpec m_requestedPlanes;
+    std::atomic<bool> m_planesChanged{false};
+    AISecurityVision::FramePlaneSpec m_planes;
 
     // State
     std::atomic<bool> m_connected{false};
     std::atomic<bool> m_initialized{false};
 
+    // Frame selection state (decode thread only, except where atomic)
+    uint64_t m_frameCounter = 0;        // EVERY_NTH phase
+    bool m_awaitKeyframe = false;       // Drop packets until the next keyframe after KEYFRAMES_ONLY
+    std::atomic<int> m_adaptiveLevel{0};
+    std::atomic<double> m_latencyEma{0.0};
+    std::chrono::steady_clock::time_point m_lastAdaptation;
+
     // Statistics
     mutable std::atomic<size_t> m_decodedFrames{0};
     mutable std::atomic<double> m_decodeTime{0.0};
+    std::atomic<uint64_t> m_convertedFrames{0};
+    std::atomic<uint64_t> m_skippedFrames{0};
+    std::atomic<uint64_t> m_droppedPackets{0};
+    std::atomic<int> m_activeThreadCount{0};
+    std::atomic<bool> m_activeFrameThreading{false};
 
     // Timing
     std::chrono::steady_clock::time_point m_lastDecodeTime;
@@ -116,6 +203,9 @@ private:
     static constexpr int BUFFER_SIZE = 1024 * 1024; // 1MB buffer
     static constexpr int MAX_DECODE_ERRORS = 10;
     static constexpr int RECONNECT_TIMEOUT_MS = 5000;
+    static constexpr double LATENCY_EMA_ALPHA = 0.2;
+    static constexpr int ADAPT_INTERVAL_MS = 1000;      // Minimum time between escalation steps
+    static constexpr double ADAPT_RELAX_RATIO = 0.5;    // De-escalate below this fraction of the target
 };
 
 /**
@@ -0,0 +1,151 @@
+/**
+ * @file benchmark_lock_hierarchy.cpp
+ * @brief Microbenchmark: cost of HierarchicalMutexLock bookkeeping under thread contention
+ *
+ * Every thread repeatedly takes two nested locks of its own (levels
+ * CROSS_CAMERA_TRACKING then VIDEO_PIPELINE), so the mutexes themselves are
+ * never contended and any slowdown with more threads comes from the
+ * hierarchy bookkeeping. Compares:
+ *   plain     std::lock_guard, which is what HierarchicalMutexLock compiles
+ *             to in release builds (LOCK_HIERARCHY_CHECKS=0)
+ *   checked   HierarchicalMutexLock with checks on (thread_local lock stack)
+ *   global    the former enforcer: one process-wide mutex guarding a map of
+ *             per-thread lock lists
+ */
+
+// Measure the checked variant regardless of the build type
+#undef LOCK_HIERARCHY_CHECKS
+#define LOCK_HIERARCHY_CHECKS 1
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+
+#include "core/LockHierarchy.h"
+
+using namespace AISecurityVision;
+
+namespace {
+
+constexpr int ITERATIONS = 200000;
+
+// Former LockHierarchyEnforcer bookkeeping, reduced to its locking pattern
+class GlobalEnforcer {
+public:
+    bool canAcquire(LockLevel level, const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& held = m_threadLocks[std::this_thread::get_id()];
+        for (const auto& h : held) {
+            if (static_cast<int>(level) < static_cast<int>(h.first) || (h.first == level && h.second == name)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void acquired(LockLevel level, const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_threadLocks[std::this_thread::get_id()].emplace_back(level, name);
+    }
+
+    void released(LockLevel level, const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& held = m_threadLocks[std::this_thread::get_id()];
+        auto it = std::find(held.begin(), held.end(), std::make_pair(level, name));
+        if (it != held.end()) {
+            held.erase(it);
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::thread::id, std::vector<std::pair<LockLevel, std::string>>> m_threadLocks;
+};
+
+GlobalEnforcer g_globalEnforcer;
+
+class GlobalLock {
+public:
+    GlobalLock(std::mutex& mutex, LockLevel level, const std::string& name)
+        : m_mutex(mutex), m_level(level), m_name(name) {
+        g_globalEnforcer.canAcquire(m_level, m_name);
+        m_mutex.lock();
+        g_globalEnforcer.acquired(m_level, m_name);
+    }
+    ~GlobalLock() {
+        g_globalEnforcer.released(m_level, m_name);
+        m_mutex.unlock();
+    }
+
+private:
+    std::mutex& m_mutex;
+    LockLevel m_level;
+    std::string m_name;
+};
+
+struct ThreadMutexes {
+    std::mutex outer;
+    std::mutex inner;
+};
+
+template<typename Body>
+double run(int threads, Body body) {
+    std::vector<ThreadMutexes> mutexes(threads);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&mutexes, t, &body]() {
+            for (int i = 0; i < ITERATIONS; ++i) {
+                body(mutexes[t]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    // Wall time per nested pair, per thread
+    return ns / ITERATIONS;
+}
+
+} // namespace
+
+int main() {
+    auto plain = [](ThreadMutexes& m) {
+        std::lock_guard<std::mutex> outer(m.outer);
+        std::lock_guard<std::mutex> inner(m.inner);
+    };
+    auto checked = [](ThreadMutexes& m) {
+        HierarchicalMutexLock outer(m.outer, LockLevel::CROSS_CAMERA_TRACKING, "bench::outer");
+        HierarchicalMutexLock inner(m.inner, LockLevel::VIDEO_PIPELINE, "bench::inner");
+    };
+    auto global = [](ThreadMutexes& m) {
+        GlobalLock outer(m.outer, LockLevel::CROSS_CAMERA_TRACKING, "bench::outer");
+        GlobalLock inner(m.inner, LockLevel::VIDEO_PIPELINE, "bench::inner");
+    };
+
+    std::cout << "Lock hierarchy benchmark (" << ITERATIONS << " nested lock pairs per thread)\n\n";
+    std::cout << std::left << std::setw(10) << "threads"
+              << std::setw(14) << "plain ns"
+              << std::setw(14) << "checked ns"
+              << "global ns\n";
+
+    unsigned int maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        int n = static_cast<int>(threads);
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(10) << threads
+                  << std::setw(14) << run(n, plain)
+                  << std::setw(14) << run(n, checked)
+                  << run(n, global) << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file benchmark_nms.cpp
+ * @brief Microbenchmark: shared NonMaxSuppression vs. the former per-backend loops
+ *
+ * Generates crowded-scene candidates (clusters of jittered boxes around
+ * objects of 80 classes, like raw YOLOv8 output) at 100, 1k and 8k
+ * candidates and compares:
+ *   rknn      the former RKNN loop: recursive quicksort of all scores, then
+ *             one O(n^2) pass over the whole list per class, pixel-inclusive IoU
+ *   tensorrt  the former TensorRT loop: std::map grouping by class, sort,
+ *             greedy suppression on cv::Rect
+ *   shared    NonMaxSuppression configured like each of the above
+ * and checks that the shared module keeps exactly the same boxes.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <map>
+#include <set>
+#include <numeric>
+#include <algorithm>
+
+#include "ai/NonMaxSuppression.h"
+
+using namespace AISecurityVision;
+
+namespace {
+
+constexpr float NMS_THRESHOLD = 0.45f;
+constexpr int NUM_CLASSES = 80;
+
+struct Candidate {
+    float x, y, w, h;   // Network input pixels
+    float score;
+    int classId;
+};
+
+std::vector<Candidate> makeCandidates(size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> position(0.0f, 600.0f);
+    std::uniform_real_distribution<float> size(16.0f, 200.0f);
+    std::normal_distribution<float> jitter(0.0f, 6.0f);
+    std::uniform_real_distribution<float> score(0.25f, 1.0f);
+    std::uniform_int_distribution<int> cls(0, NUM_CLASSES - 1);
+
+    // Roughly 20 raw candidates per object, as after confidence thresholding
+    std::vector<Candidate> candidates;
+    candidates.reserve(count);
+    while (candidates.size() < count) {
+        Candidate object{position(rng), position(rng), size(rng), size(rng), 0.0f, cls(rng)};
+        for (int k = 0; k < 20 && candidates.size() < count; ++k) {
+            Candidate c = object;
+            c.x += jitter(rng);
+            c.y += jitter(rng);
+            c.w = std::max(4.0f, c.w + jitter(rng));
+            c.h = std::max(4.0f, c.h + jitter(rng));
+            c.score = score(rng);
+            candidates.push_back(c);
+        }
+    }
+    return candidates;
+}
+
+// Former YOLOv8RKNNDetector::calculateOverlap / nms / quickSortIndiceInverse
+float rknnOverlap(float xmin0, float ymin0, float xmax0, float ymax0,
+                  float xmin1, float ymin1, float xmax1, float ymax1) {
+    float w = std::max(0.0f, std::min(xmax0, xmax1) - std::max(xmin0, xmin1) + 1.0f);
+    float h = std::max(0.0f, std::min(ymax0, ymax1) - std::max(ymin0, ymin1) + 1.0f);
+    float i = w * h;
+    float u = (xmax0 - xmin0 + 1.0f) * (ymax0 - ymin0 + 1.0f) +
+              (xmax1 - xmin1 + 1.0f) * (ymax1 - ymin1 + 1.0f) - i;
+    return u <= 0.0f ? 0.0f : (i / u);
+}
+
+void rknnNms(int validCount, const std::vector<float>& locations, const std::vector<int>& classIds,
+             std::vector<int>& order, int filterId, float threshold) {
+    for (int i = 0; i < validCount; ++i) {
+        int n = order[i];
+        if (n == -1 || classIds[n] != filterId) {
+            continue;
+        }
+        for (int j = i + 1; j < validCount; ++j) {
+            int m = order[j];
+            if (m == -1 || classIds[m] != filterId) {
+                continue;
+            }
+            float iou = rknnOverlap(locations[n * 4], locations[n * 4 + 1],
+                                    locations[n * 4] + locations[n * 4 + 2], locations[n * 4 + 1] + locations[n * 4 + 3],
+                                    locations[m * 4], locations[m * 4 + 1],
+                                    locations[m * 4] + locations[m * 4 + 2], locations[m * 4 + 1] + locations[m * 4 + 3]);
+            if (iou > threshold) {
+                order[j] = -1;
+            }
+        }
+    }
+}
+
+int quickSortIndiceInverse(std::vector<float>& input, int left, int right, std::vector<int>& indices) {
+    int low = left;
+    int high = right;
+    if (left < right) {
+        int keyIndex = indices[left];
+        float key = input[left];
+        while (low < high) {
+            while (low < high && input[high] <= key) {
+                high--;
+            }
+            input[low] = input[high];
+            indices[low] = indices[high];
+            while (low < high && input[low] >= key) {
+                low++;
+            }
+            input[high] = input[low];
+            indices[high] = indices[low];
+        }
+        input[low] = key;
+        indices[low] = keyIndex;
+        quickSortIndiceInverse(input, left, low - 1, indices);
+        quickSortIndiceInverse(input, low + 1, right, indices);
+    }
+    return low;
+}
+
+std::set<int> formerRknn(const std::vector<Candidate>& candidates) {
+    std::vector<float> locations;
+    std::vector<float> scores;
+    std::vector<int> classIds;
+    for (const auto& c : candidates) {
+        locations.insert(locations.end(), {c.x, c.y, c.w, c.h});
+        scores.push_back(c.score);
+        classIds.push_back(c.classId);
+    }
+    int count = static_cast<int>(candidates.size());
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    quickSortIndiceInverse(scores, 0, count - 1, order);
+    std::set<int> classes(classIds.begin(), classIds.end());
+    for (int cls : classes) {
+        rknnNms(count, locations, classIds, order, cls, NMS_THRESHOLD);
+    }
+    std::set<int> kept;
+    for (int idx : order) {
+        if (idx != -1) {
+            kept.insert(idx);
+        }
+    }
+    return kept;
+}
+
+// Former YOLOv8TensorRTDetector::performNMS
+std::set<int> formerTensorRT(const std::vector<cv::Rect>& boxes, const std::vector<Candidate>& candidates) {
+    std::map<int, std::vector<int>> classIndices;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        classIndices[candidates[i].classId].push_back(static_cast<int>(i));
+    }
+    std::set<int> kept;
+    for (const auto& entry : classIndices) {
+        std::vector<int> sorted = entry.second;
+        std::sort(sorted.begin(), sorted.end(), [&candidates](int a, int b) {
+            return candidates[a].score > candidates[b].score;
+        });
+        std::vector<bool> suppressed(sorted.size(), false);
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            if (suppressed[i]) continue;
+            kept.insert(sorted[i]);
+            const cv::Rect& box1 = boxes[sorted[i]];
+            for (size_t j = i + 1; j < sorted.size(); ++j) {
+                if (suppressed[j]) continue;
+                const cv::Rect& box2 = boxes[sorted[j]];
+                int x1 = std::max(box1.x, box2.x);
+                int y1 = std::max(box1.y, box2.y);
+                int x2 = std::min(box1.x + box1.width, box2.x + box2.width);
+                int y2 = std::min(box1.y + box1.height, box2.y + box2.height);
+                float inter = std::max(0, x2 - x1) * std::max(0, y2 - y1);
+                float area1 = box1.width * box1.height;
+                float area2 = box2.width * box2.height;
+                if (inter / (area1 + area2 - inter) > NMS_THRESHOLD) {
+                    suppressed[j] = true;
+                }
+            }
+        }
+    }
+    return kept;
+}
+
+template<typename Body>
+double timeUs(int iterations, Body body) {
+    body();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        body();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(7);
+    NonMaxSuppression nms;
+
+    std::cout << "NMS benchmark (80 classes, IoU threshold " << NMS_THRESHOLD << ")\n\n";
+    std::cout << std::left << std::setw(12) << "candidates"
+              << std::setw(12) << "rknn us"
+              << std::setw(12) << "shared us"
+              << std::setw(14) << "tensorrt us"
+              << std::setw(12) << "shared us"
+              << "identical\n";
+
+    for (size_t count : {100, 1000, 8000}) {
+        auto candidates = makeCandidates(count, rng);
+        std::vector<cv::Rect> rects;
+        for (const auto& c : candidates) {
+            rects.emplace_back(static_cast<int>(c.x), static_cast<int>(c.y), static_cast<int>(c.w), static_cast<int>(c.h));
+        }
+        const int iterations = count >= 8000 ? 5 : 200;
+
+        NonMaxSuppression::Config rknnConfig;
+        rknnConfig.iouThreshold = NMS_THRESHOLD;
+        rknnConfig.inclusiveCoordinates = true;
+        NonMaxSuppression::Config rectConfig;
+        rectConfig.iouThreshold = NMS_THRESHOLD;
+
+        std::set<int> rknnKept;
+        std::set<int> trtKept;
+        std::set<int> sharedRknnKept;
+        std::set<int> sharedTrtKept;
+
+        double rknnUs = timeUs(iterations, [&]() { rknnKept = formerRknn(candidates); });
+        double sharedRknnUs = timeUs(iterations, [&]() {
+            nms.clear();
+            for (const auto& c : candidates) {
+                nms.add(c.x, c.y, c.x + c.w, c.y + c.h, c.score, c.classId);
+            }
+            const auto& keep = nms.run(rknnConfig);
+            sharedRknnKept = std::set<int>(keep.begin(), keep.end());
+        });
+        double trtUs = timeUs(iterations, [&]() { trtKept = formerTensorRT(rects, candidates); });
+        double sharedTrtUs = timeUs(iterations, [&]() {
+            nms.clear();
+            for (size_t i = 0; i < rects.size(); ++i) {
+                nms.add(rects[i], candidates[i].score, candidates[i].classId);
+            }
+            const auto& keep = nms.run(rectConfig);
+            sharedTrtKept = std::set<int>(keep.begin(), keep.end());
+        });
+
+        bool identical = rknnKept == sharedRknnKept && trtKept == sharedTrtKept;
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(12) << count
+                  << std::setw(12) << rknnUs
+                  << std::setw(12) << sharedRknnUs
+                  << std::setw(14) << trtUs
+                  << std::setw(12) << sharedTrtUs
+                  << (identical ? "yes" : "NO") << "\n";
+        if (!identical) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file benchmark_preprocess.cpp
+ * @brief Microbenchmark: fused letterbox preprocessing vs. the former multi-pass chain
+ *
+ * Letterboxes synthetic 1080p and 720p BGR frames into a 640x640 planar
+ * float tensor and compares:
+ *   multipass  the former TensorRT path: cv::resize, gray canvas, copyTo,
+ *              convertTo(CV_32F, 1/255), cv::split and one memcpy per plane
+ *   blob       the former CPU path: resize into a reused canvas, then
+ *              cv::dnn::blobFromImage (only with OpenCV DNN)
+ *   fused      LetterboxPreprocessor::toPlanarFloat into the same tensor
+ * and reports the largest absolute difference between fused and multipass.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#ifndef DISABLE_OPENCV_DNN
+#include <opencv2/dnn.hpp>
+#endif
+
+#include "ai/LetterboxPreprocessor.h"
+
+using namespace AISecurityVision;
+
+namespace {
+
+constexpr int ITERATIONS = 200;
+const cv::Size INPUT_SIZE(640, 640);
+
+void multipass(const cv::Mat& image, float* tensor) {
+    LetterboxGeometry geometry = LetterboxGeometry::fit(image.size(), INPUT_SIZE);
+
+    cv::Mat resized;
+    cv::resize(image, resized, geometry.scaled, 0, 0, cv::INTER_LINEAR);
+    cv::Mat letterboxed = cv::Mat::zeros(INPUT_SIZE, CV_8UC3);
+    letterboxed.setTo(cv::Scalar(114, 114, 114));
+    resized.copyTo(letterboxed(geometry.roi()));
+
+    cv::Mat floatImg;
+    letterboxed.convertTo(floatImg, CV_32FC3, 1.0 / 255.0);
+
+    std::vector<cv::Mat> channels(3);
+    cv::split(floatImg, channels);
+    size_t planeSize = static_cast<size_t>(INPUT_SIZE.area());
+    for (int c = 0; c < 3; ++c) {
+        std::memcpy(tensor + c * planeSize, channels[c].data, planeSize * sizeof(float));
+    }
+}
+
+template<typename Body>
+double timeMs(Body body) {
+    body();     // Warm up caches and lookup tables
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        body();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / ITERATIONS;
+}
+
+} // namespace
+
+int main() {
+    const std::vector<cv::Size> sources = {cv::Size(1920, 1080), cv::Size(1280, 720)};
+    const size_t tensorSize = static_cast<size_t>(INPUT_SIZE.area()) * 3;
+
+    std::cout << "Letterbox preprocessing benchmark (" << ITERATIONS << " frames into "
+              << INPUT_SIZE.width << "x" << INPUT_SIZE.height << ")\n\n";
+    std::cout << std::left << std::setw(12) << "source"
+              << std::setw(16) << "multipass ms"
+#ifndef DISABLE_OPENCV_DNN
+              << std::setw(12) << "blob ms"
+#endif
+              << std::setw(12) << "fused ms"
+              << "max abs diff\n";
+
+    for (const auto& size : sources) {
+        cv::Mat image(size, CV_8UC3);
+        cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(256));
+        cv::GaussianBlur(image, image, cv::Size(5, 5), 0);  // Camera-like local correlation
+
+        std::vector<float> reference(tensorSize);
+        std::vector<float> fusedTensor(tensorSize);
+        LetterboxPreprocessor preprocessor;
+
+        double multipassMs = timeMs([&]() { multipass(image, reference.data()); });
+        double fusedMs = timeMs([&]() { preprocessor.toPlanarFloat(image, INPUT_SIZE, fusedTensor.data()); });
+
+#ifndef DISABLE_OPENCV_DNN
+        cv::Mat canvas(INPUT_SIZE, CV_8UC3);
+        cv::Mat blob;
+        LetterboxGeometry geometry = LetterboxGeometry::fit(image.size(), INPUT_SIZE);
+        double blobMs = timeMs([&]() {
+            canvas.setTo(cv::Scalar(114, 114, 114));
+            cv::Mat roi = canvas(geometry.roi());
+            cv::resize(image, roi, roi.size(), 0, 0, cv::INTER_LINEAR);
+            cv::dnn::blobFromImage(canvas, blob, 1.0 / 255.0, cv::Size(), cv::Scalar(), false, false, CV_32F);
+        });
+#endif
+
+        float maxDiff = 0.0f;
+        for (size_t i = 0; i < tensorSize; ++i) {
+            maxDiff = std::max(maxDiff, std::fabs(reference[i] - fusedTensor[i]));
+        }
+
+        std::string label = std::to_string(size.width) + "x" + std::to_string(size.height);
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::setw(12) << label
+                  << std::setw(16) << multipassMs
+#ifndef DISABLE_OPENCV_DNN
+                  << std::setw(12) << blobMs
+#endif
+                  << std::setw(12) << fusedMs
+                  << std::setprecision(5) << maxDiff << "\n";
+    }
+
+    return 0;
+}